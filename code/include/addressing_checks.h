@@ -0,0 +1,167 @@
+//==================================================================================================
+//  File:
+//      addressing_checks.h
+//
+//  Summary:
+//      Defines optional validity checks for the addressing models, which report synthetic
+//      pointers that refer to missing segments, lie beyond the end of their segments, or are
+//      moved by arithmetic from one segment into another.
+//
+//  Copyright (c) 2017 Bob Steagall, KEWB Computing
+//==================================================================================================
+//
+#ifndef ADDRESSING_CHECKS_H_DEFINED
+#define ADDRESSING_CHECKS_H_DEFINED
+
+#include <cstddef>
+#include <cstdint>
+
+#include "storage_base.h"
+
+//- The addressing models check their pointers only when RHX_CHECKED_ADDRESSING is defined;
+//  otherwise the checking statements vanish, and the models compile to their unchecked code.
+//
+#ifdef RHX_CHECKED_ADDRESSING
+    #define RHX_CHECK_ADDRESS(...)      __VA_ARGS__
+#else
+    #define RHX_CHECK_ADDRESS(...)
+#endif
+
+//- The based models' assign_from() locates its argument among the segments without reading
+//  through it.  GCC otherwise assumes that a function taking a pointer to const reads what it
+//  points to, and so warns when std::basic_string converts the address of its not yet written
+//  local buffer.  The argument is numbered counting the implicit this pointer as 1.
+//
+#if defined(__GNUC__) && !defined(__clang__) && (__GNUC__ >= 11)
+    #define RHX_ADDRESS_ONLY_ARG(n)     __attribute__((access(none, n)))
+#else
+    #define RHX_ADDRESS_ONLY_ARG(n)
+#endif
+
+//--------------------------------------------------------------------------------------------------
+//  Struct:
+//      addressing_fault
+//
+//  Summary:
+//      This struct describes a failed addressing check: the segment and offset of the pointer
+//      before the failing operation, and the distance it was being moved, if any.
+//--------------------------------------------------------------------------------------------------
+//
+struct addressing_fault
+{
+    enum kind_type : int
+    {
+        missing_segment,    //- The segment index is out of range, or its segment not allocated
+        offset_overflow,    //- The offset lies beyond the end of the segment
+        segment_crossing    //- Pointer arithmetic left the bounds of the segment
+    };
+
+    kind_type       m_kind;
+    std::size_t     m_segment;
+    std::size_t     m_offset;
+    std::ptrdiff_t  m_delta;
+};
+
+//--------------------------------------------------------------------------------------------------
+//  Class:
+//      addressing_checks
+//
+//  Summary:
+//      This class implements the checks made by the addressing models when they are built with
+//      RHX_CHECKED_ADDRESSING defined.  A pointer may refer to any byte of an allocated segment,
+//      or to the position just past its end; arithmetic must keep it within those bounds.  The
+//      null pointer, and pointers outside the segments in models that can represent them, are
+//      not checked.
+//
+//      A failed check is passed to the fault handler, which by default describes the fault on
+//      stderr and aborts.  Since the models' operations are noexcept, a replacement handler
+//      cannot throw.  If it returns, a pointer that failed its location check converts to the
+//      null pointer, rather than to an address computed from a bad segment index, and failed
+//      arithmetic proceeds as it would without checks.
+//--------------------------------------------------------------------------------------------------
+//
+class addressing_checks
+{
+  public:
+    using size_type       = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using handler_type    = void (*)(addressing_fault const& fault);
+
+  public:
+    static  constexpr   bool    enabled();
+
+    static  handler_type    set_handler(handler_type handler) noexcept;
+
+    template<class SM>
+    static  bool    check_location(size_type segment, size_type offset) noexcept;
+    template<class SM>
+    static  void    check_step(size_type segment, size_type offset, difference_type delta) noexcept;
+    static  void    check_native_step(void const* p, difference_type delta) noexcept;
+
+    static  void    report(addressing_fault::kind_type kind, size_type segment, size_type offset,
+                           difference_type delta) noexcept;
+
+  private:
+    static  void    default_handler(addressing_fault const& fault);
+
+    static  handler_type    sm_handler;
+};
+
+//------
+//
+constexpr inline bool
+addressing_checks::enabled()
+{
+#ifdef RHX_CHECKED_ADDRESSING
+    return true;
+#else
+    return false;
+#endif
+}
+
+//------
+//- Checks a segment:offset pair about to be turned into an address, returning false if it
+//  fails.  Segment zero holds the pointers that lie outside the segments.
+//
+template<class SM> inline
+bool
+addressing_checks::check_location(size_type segment, size_type offset) noexcept
+{
+    if (segment == 0)
+    {
+        return true;
+    }
+    if (segment > SM::last_segment_index()  ||  SM::segment_address(segment) == nullptr)
+    {
+        report(addressing_fault::missing_segment, segment, offset, 0);
+        return false;
+    }
+    if (offset > SM::segment_size(segment))
+    {
+        report(addressing_fault::offset_overflow, segment, offset, 0);
+        return false;
+    }
+    return true;
+}
+
+//- Checks that moving a segment:offset pair by the given distance keeps it in its segment.
+//
+template<class SM> inline
+void
+addressing_checks::check_step(size_type segment, size_type offset, difference_type delta) noexcept
+{
+    if (segment == 0)
+    {
+        return;
+    }
+    if (segment > SM::last_segment_index()  ||  SM::segment_address(segment) == nullptr)
+    {
+        report(addressing_fault::missing_segment, segment, offset, delta);
+    }
+    else if (delta < -(difference_type) offset  ||  (difference_type) (offset + delta) > (difference_type) SM::segment_size(segment))
+    {
+        report(addressing_fault::segment_crossing, segment, offset, delta);
+    }
+}
+
+#endif  //- ADDRESSING_CHECKS_H_DEFINED
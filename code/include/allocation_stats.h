@@ -0,0 +1,228 @@
+//==================================================================================================
+//  File:
+//      allocation_stats.h
+//
+//  Summary:
+//      Defines optional allocation statistics for the allocation strategies.
+//
+//  Copyright (c) 2017 Bob Steagall, KEWB Computing
+//==================================================================================================
+//
+#ifndef ALLOCATION_STATS_H_DEFINED
+#define ALLOCATION_STATS_H_DEFINED
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+#include "storage_base.h"
+
+//- The strategies record statistics only when RHX_ALLOCATION_STATS is defined; otherwise the
+//  recording statements vanish, and the strategies compile exactly as they would without them.
+//
+#ifdef RHX_ALLOCATION_STATS
+    #define RHX_STATS(...)      __VA_ARGS__
+#else
+    #define RHX_STATS(...)
+#endif
+
+//--------------------------------------------------------------------------------------------------
+//  Class:
+//      allocation_stats
+//
+//  Summary:
+//      This class holds the allocation statistics for one allocation strategy and storage model
+//      combination.  Every instance links itself into a list when constructed, so that all of
+//      them can be dumped together, and it is expected to live for the life of the program.
+//
+//      Request sizes are counted in power-of-two histogram bins, and rounded chunk sizes in
+//      16-byte size classes up to 256 bytes, with a final class for everything larger.  Bytes in
+//      use include the waste due to rounding, alignment padding, and space abandoned at the end
+//      of a segment when allocation rolls over to the next one, since all of those take up room
+//      in the segments; the high-water mark is the greatest number of bytes in use, and is what
+//      a segment must be sized to hold.
+//--------------------------------------------------------------------------------------------------
+//
+class allocation_stats
+{
+  public:
+    using counter   = uint64_t;
+    using size_type = std::size_t;
+
+    enum : size_type
+    {
+        class_granularity = 16,
+        class_count       = 17,                                 //- 16 to 256 bytes, and larger
+        histogram_bins    = 32,                                 //- [2^i, 2^(i+1)) bytes
+        segment_slots     = storage_model_base::max_segments + 2
+    };
+
+  public:
+    allocation_stats(char const* strategy, char const* model);
+
+    allocation_stats(allocation_stats const&) = delete;
+    allocation_stats&   operator =(allocation_stats const&) = delete;
+
+    void    record_allocate(size_type requested, size_type allocated, size_type padding);
+    void    record_deallocate(size_type requested, size_type allocated);
+    void    record_expand(size_type old_size, size_type new_size);
+    void    record_rollover(size_type abandoned);
+    void    record_release(size_type bytes);
+    void    record_reset();
+    void    record_fill(size_type segment, size_type used);
+
+    void    clear();
+    void    print(FILE* fp) const;
+
+    bool    empty() const;
+    double  fill_level(size_type segment) const;
+
+    allocation_stats const*         next() const;
+    static  allocation_stats const* first();
+    static  size_type               size_class(size_type n);
+    static  size_type               histogram_bin(size_type n);
+
+  public:
+    char const* m_strategy;
+    char const* m_model;
+
+    counter     m_allocations;
+    counter     m_deallocations;
+    counter     m_expansions;
+    counter     m_rollovers;
+    counter     m_resets;
+
+    counter     m_bytes_requested;      //- Sum of the sizes asked for
+    counter     m_bytes_rounding;       //- Added by rounding sizes up to the chunk granularity
+    counter     m_bytes_padding;        //- Skipped to align chunks
+    counter     m_bytes_abandoned;      //- Left unused at the ends of segments
+    counter     m_bytes_freed;          //- Returned by deallocation
+    counter     m_bytes_in_use;
+    counter     m_high_water;
+
+    counter     m_class_allocs[class_count];
+    counter     m_class_frees[class_count];
+    counter     m_histogram[histogram_bins];
+    counter     m_segment_peak[segment_slots];
+
+  private:
+    allocation_stats*   m_next;
+
+    static  allocation_stats*   sm_first;
+};
+
+void    dump_allocation_stats(FILE* fp = stdout);
+void    dump_allocation_stats_at_exit();
+
+//------
+//
+inline void
+allocation_stats::record_allocate(size_type requested, size_type allocated, size_type padding)
+{
+    ++m_allocations;
+    ++m_class_allocs[size_class(allocated)];
+    ++m_histogram[histogram_bin(requested)];
+
+    m_bytes_requested += requested;
+    m_bytes_rounding  += allocated - requested;
+    m_bytes_padding   += padding;
+    m_bytes_in_use    += allocated + padding;
+
+    if (m_bytes_in_use > m_high_water)
+    {
+        m_high_water = m_bytes_in_use;
+    }
+}
+
+inline void
+allocation_stats::record_deallocate(size_type, size_type allocated)
+{
+    ++m_deallocations;
+    ++m_class_frees[size_class(allocated)];
+
+    m_bytes_freed  += allocated;
+    m_bytes_in_use -= allocated;
+}
+
+inline void
+allocation_stats::record_expand(size_type old_size, size_type new_size)
+{
+    ++m_expansions;
+
+    m_bytes_in_use += new_size - old_size;
+
+    if (m_bytes_in_use > m_high_water)
+    {
+        m_high_water = m_bytes_in_use;
+    }
+}
+
+inline void
+allocation_stats::record_rollover(size_type abandoned)
+{
+    ++m_rollovers;
+
+    m_bytes_abandoned += abandoned;
+    m_bytes_in_use    += abandoned;
+}
+
+//- Records the bulk release of memory, such as by rolling back to a marker.
+//
+inline void
+allocation_stats::record_release(size_type bytes)
+{
+    m_bytes_freed  += bytes;
+    m_bytes_in_use -= bytes;
+}
+
+inline void
+allocation_stats::record_reset()
+{
+    ++m_resets;
+    m_bytes_in_use = 0;
+}
+
+inline void
+allocation_stats::record_fill(size_type segment, size_type used)
+{
+    if (segment < segment_slots  &&  used > m_segment_peak[segment])
+    {
+        m_segment_peak[segment] = used;
+    }
+}
+
+//------
+//
+inline allocation_stats const*
+allocation_stats::next() const
+{
+    return m_next;
+}
+
+inline allocation_stats const*
+allocation_stats::first()
+{
+    return sm_first;
+}
+
+inline allocation_stats::size_type
+allocation_stats::size_class(size_type n)
+{
+    return (n == 0) ? 0 : (n > (class_count - 1)*class_granularity) ? (class_count - 1)
+                                                                      : ((n - 1) / class_granularity);
+}
+
+inline allocation_stats::size_type
+allocation_stats::histogram_bin(size_type n)
+{
+    size_type   bin = 0;
+
+    while (n > 1  &&  bin < histogram_bins - 1)
+    {
+        n >>= 1;
+        ++bin;
+    }
+    return bin;
+}
+
+#endif  //- ALLOCATION_STATS_H_DEFINED
@@ -0,0 +1,218 @@
+//==================================================================================================
+//  File:
+//      allocation_trace.h
+//
+//  Summary:
+//      Defines a compact binary trace of the allocations made through rhx_allocator, and a
+//      reader for it.
+//
+//  Copyright (c) 2017 Bob Steagall, KEWB Computing
+//==================================================================================================
+//
+#ifndef ALLOCATION_TRACE_H_DEFINED
+#define ALLOCATION_TRACE_H_DEFINED
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+//- rhx_allocator records its calls only when RHX_ALLOCATION_TRACE is defined; otherwise the
+//  recording statements vanish.  The trace writer and reader themselves are always available.
+//
+#ifdef RHX_ALLOCATION_TRACE
+    #define RHX_TRACE(...)      __VA_ARGS__
+#else
+    #define RHX_TRACE(...)
+#endif
+
+//- One traced call.  The address identifies the chunk, so that a deallocation can be matched
+//  with the allocation that produced it; the size is in bytes; the type is an index into the
+//  trace's type table; and the call site, an index into its site table, shares a field with
+//  the operation.  The time is in nanoseconds since the trace was started.
+//
+struct trace_record
+{
+    enum : uint16_t
+    {
+        allocate_op   = 0,
+        deallocate_op = 1,
+        expand_op     = 2,      //- Successful in-place resize; the size is the new size
+        op_shift      = 14,
+        site_mask     = (1u << op_shift) - 1
+    };
+
+    uint64_t    m_time;
+    uint64_t    m_address;
+    uint32_t    m_size;
+    uint16_t    m_type;
+    uint16_t    m_site_op;
+
+    uint16_t    op() const      { return m_site_op >> op_shift; }
+    uint16_t    site() const    { return m_site_op & site_mask; }
+};
+
+//- The description of a traced type.
+//
+struct trace_type_info
+{
+    std::string     m_name;
+    uint32_t        m_size;
+    uint32_t        m_align;
+};
+
+//--------------------------------------------------------------------------------------------------
+//  Class:
+//      allocation_trace
+//
+//  Summary:
+//      This class writes the trace.  Records are buffered in memory and written in blocks while
+//      a trace is active; when the trace is stopped, the type and call site tables follow them,
+//      and a short trailer locates the tables.  Types and call sites can be registered at any
+//      time, so the ids used in the records stay the same across traces in the same run.
+//
+//      Call sites are named regions of code, entered with RHX_TRACE_SITE().  The containers
+//      of this library enter default sites with RHX_TRACE_DEFAULT_SITE() where they allocate,
+//      which name the container and operation unless the caller has already entered a site.
+//      Other allocations made outside any region, such as those of the standard containers,
+//      have site 0, "unknown".  Tracing is not thread-safe.
+//--------------------------------------------------------------------------------------------------
+//
+class allocation_trace
+{
+  public:
+    static  bool        start(char const* file_name);
+    static  void        stop();
+    static  bool        active();
+
+    static  uint16_t    register_type(char const* name, std::size_t size, std::size_t align);
+    static  uint16_t    register_site(char const* name);
+
+    static  uint16_t    current_site();
+    static  void        set_current_site(uint16_t site);
+
+    static  void        record(uint16_t op, void const* p, std::size_t size, uint16_t type);
+
+  private:
+    static  void        flush();
+
+    static  FILE*                           sm_file;
+    static  uint64_t                        sm_count;
+    static  uint16_t                        sm_site;
+    static  std::vector<trace_record>       sm_buffer;
+    static  std::vector<trace_type_info>    sm_types;
+    static  std::vector<std::string>        sm_sites;
+};
+
+//------
+//
+inline bool
+allocation_trace::active()
+{
+    return sm_file != nullptr;
+}
+
+inline uint16_t
+allocation_trace::current_site()
+{
+    return sm_site;
+}
+
+inline void
+allocation_trace::set_current_site(uint16_t site)
+{
+    sm_site = site;
+}
+
+//- Returns the trace's id for type T, registering it on first use.
+//
+template<class T>
+uint16_t
+trace_type_id()
+{
+    static uint16_t const   id = allocation_trace::register_type(typeid(T).name(), sizeof(T), alignof(T));
+    return id;
+}
+
+//- Records a call made through rhx_allocator<T>, if a trace is active.
+//
+template<class T> inline
+void
+trace_allocation(uint16_t op, void const* p, std::size_t size)
+{
+    if (allocation_trace::active())
+    {
+        allocation_trace::record(op, p, size, trace_type_id<T>());
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+//  Class:
+//      trace_site_scope
+//
+//  Summary:
+//      This class makes a call site current for the duration of a scope, and then restores
+//      the previous one.  A default site is made current only if no other site is.  It is
+//      normally used by way of the RHX_TRACE_SITE() and RHX_TRACE_DEFAULT_SITE() macros.
+//--------------------------------------------------------------------------------------------------
+//
+class trace_site_scope
+{
+  public:
+    explicit trace_site_scope(uint16_t site, bool is_default = false)
+    :   m_prev(allocation_trace::current_site())
+    {
+        if (!is_default  ||  m_prev == 0)
+        {
+            allocation_trace::set_current_site(site);
+        }
+    }
+
+    ~trace_site_scope()
+    {
+        allocation_trace::set_current_site(m_prev);
+    }
+
+    trace_site_scope(trace_site_scope const&) = delete;
+    trace_site_scope&   operator =(trace_site_scope const&) = delete;
+
+  private:
+    uint16_t    m_prev;
+};
+
+#define RHX_TRACE_SITE_CAT2(a, b)   a##b
+#define RHX_TRACE_SITE_CAT(a, b)    RHX_TRACE_SITE_CAT2(a, b)
+
+#define RHX_TRACE_SITE(name)                                                                    \
+    static uint16_t const   RHX_TRACE_SITE_CAT(rhx_trace_site_, __LINE__) =                     \
+                                allocation_trace::register_site(name);                          \
+    trace_site_scope        RHX_TRACE_SITE_CAT(rhx_trace_scope_, __LINE__)(                     \
+                                RHX_TRACE_SITE_CAT(rhx_trace_site_, __LINE__))
+
+#define RHX_TRACE_DEFAULT_SITE(name)                                                            \
+    static uint16_t const   RHX_TRACE_SITE_CAT(rhx_trace_site_, __LINE__) =                     \
+                                allocation_trace::register_site(name);                          \
+    trace_site_scope        RHX_TRACE_SITE_CAT(rhx_trace_scope_, __LINE__)(                     \
+                                RHX_TRACE_SITE_CAT(rhx_trace_site_, __LINE__), true)
+
+//--------------------------------------------------------------------------------------------------
+//  Class:
+//      trace_file
+//
+//  Summary:
+//      This class reads a complete trace into memory.
+//--------------------------------------------------------------------------------------------------
+//
+class trace_file
+{
+  public:
+    bool    read(char const* file_name);
+
+    std::vector<trace_record>       m_records;
+    std::vector<trace_type_info>    m_types;
+    std::vector<std::string>        m_sites;
+};
+
+#endif  //- ALLOCATION_TRACE_H_DEFINED
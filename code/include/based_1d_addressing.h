@@ -14,6 +14,8 @@
 #include <cstddef>
 #include <cstdint>
 
+#include "addressing_checks.h"
+
 //--------------------------------------------------------------------------------------------------
 //  Class:
 //      based_1d_addressing_model
@@ -23,6 +25,9 @@
 //      as a 64-bit integer, and the base address is provided by a segment address from an 
 //      instance of the template argument SM.
 //
+//      When built with RHX_CHECKED_ADDRESSING defined, the offset of a non-null pointer is
+//      checked against the size of the segment whenever it is converted or moved.
+//
 //      Note that the comparison helper functions include several that define the "greater_than"
 //      relationship.  They are included because they are trivial, and make the code for any
 //      synthetic pointer wrapper class comparison operators easier to implement and read.
@@ -63,7 +68,7 @@ class based_1d_addressing_model
     bool        less_than(void const* p) const noexcept;
     bool        less_than(based_1d_addressing_model const& other) const noexcept;
 
-    void        assign_from(void const* p);
+    void        assign_from(void const* p) RHX_ADDRESS_ONLY_ARG(2);
 
     void        decrement(difference_type dec) noexcept;
     void        increment(difference_type inc) noexcept;
@@ -100,6 +105,7 @@ template<typename SM> inline
 void*
 based_1d_addressing_model<SM>::address() const noexcept
 {
+    RHX_CHECK_ADDRESS(if (m_offset != null_offset  &&  !addressing_checks::check_location<SM>(SM::first_segment_index(), m_offset)) return nullptr);
     return (m_offset == null_offset) ? nullptr : SM::first_segment_address() + m_offset;
 }
 
@@ -188,7 +194,7 @@ based_1d_addressing_model<SM>::assign_from(void const* p)
     char const*     p_data  = static_cast<char const*>(p);
     char const*     p_lower = SM::first_segment_address();
 
-    m_offset = p_data - p_lower;
+    m_offset = (p_data == nullptr) ? null_offset : (p_data - p_lower);
 }
 
 //------
@@ -197,6 +203,7 @@ template<typename SM> inline
 void
 based_1d_addressing_model<SM>::decrement(difference_type dec) noexcept
 {
+    RHX_CHECK_ADDRESS(if (m_offset != null_offset) addressing_checks::check_step<SM>(SM::first_segment_index(), m_offset, -dec));
     m_offset -= dec;
 }
 
@@ -204,6 +211,7 @@ template<typename SM> inline
 void
 based_1d_addressing_model<SM>::increment(difference_type inc) noexcept
 {
+    RHX_CHECK_ADDRESS(if (m_offset != null_offset) addressing_checks::check_step<SM>(SM::first_segment_index(), m_offset, inc));
     m_offset += inc;
 }
 
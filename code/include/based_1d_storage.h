@@ -22,6 +22,11 @@
 //      This base class implements a based 1D storage model using the facilities provided by
 //      the "storage_model_base" base class.  For this model, all allocations occur from the
 //      first segment, making it appear as if there is only one segment.
+//
+//      A based 1D pointer holds only an offset from the start of the first segment, so it
+//      cannot refer to any other segment.  The model therefore reports a single segment, and
+//      refuses to create others, so that a strategy that fills the first segment throws
+//      std::bad_alloc instead of handing out pointers that alias the first segment.
 //--------------------------------------------------------------------------------------------------
 //
 class based_1d_storage_model : public storage_model_base
@@ -29,15 +34,44 @@ class based_1d_storage_model : public storage_model_base
   public:
     using addressing_model = based_1d_addressing_model<based_1d_storage_model>;
 
+    static  bool                ensure_segment(size_type segment);
     static  addressing_model    segment_pointer(size_type, size_type offset);
+    static  char const*         model_name() noexcept;
+
+    static  constexpr   size_type   last_segment_index();
+    static  constexpr   size_type   max_segment_count();
 };
 
 //------
 //
+inline bool
+based_1d_storage_model::ensure_segment(size_type segment)
+{
+    return segment == first_segment_index()  &&  storage_model_base::ensure_segment(segment);
+}
+
 inline based_1d_storage_model::addressing_model
-based_1d_storage_model::segment_pointer(size_type, size_type offset) 
+based_1d_storage_model::segment_pointer(size_type, size_type offset)
 {
     return addressing_model{offset};
 }
 
+inline char const*
+based_1d_storage_model::model_name() noexcept
+{
+    return "based_1d";
+}
+
+constexpr inline based_1d_storage_model::size_type
+based_1d_storage_model::last_segment_index()
+{
+    return first_segment_index();
+}
+
+constexpr inline based_1d_storage_model::size_type
+based_1d_storage_model::max_segment_count()
+{
+    return 1;
+}
+
 #endif  //- BASED_1D_STORAGE_H_DEFINED
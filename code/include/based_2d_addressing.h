@@ -14,6 +14,8 @@
 #include <cstddef>
 #include <cstdint>
 
+#include "addressing_checks.h"
+
 //--------------------------------------------------------------------------------------------------
 //  Class:
 //      based_2d_addressing_model
@@ -24,6 +26,10 @@
 //      Assigning from a pointer outside the segments assumes that the actual maximum physical
 //      address space is 48 bits or less.
 //
+//      When built with RHX_CHECKED_ADDRESSING defined, address() verifies that the segment
+//      index refers to an allocated segment and that the offset lies within it, and arithmetic
+//      is verified to stay within the segment (see addressing_checks).
+//
 //      Note that the comparison helper functions include several that define the "greater_than"
 //      relationship.  They are included because they are trivial, and make the code for any
 //      synthetic pointer wrapper class comparison operators easier to implement and read.
@@ -65,7 +71,7 @@ class based_2d_addressing_model
     bool        less_than(void const* p) const noexcept;
     bool        less_than(based_2d_addressing_model const& other) const noexcept;
 
-    void        assign_from(void const* p);
+    void        assign_from(void const* p) RHX_ADDRESS_ONLY_ARG(2);
 
     void        decrement(difference_type dec) noexcept;
     void        increment(difference_type inc) noexcept;
@@ -124,6 +130,7 @@ template<typename SM> inline
 void*
 based_2d_addressing_model<SM>::address() const noexcept
 {
+    RHX_CHECK_ADDRESS(if (!addressing_checks::check_location<SM>(m_bits.m_segment, m_addr & offset_mask)) return nullptr);
     return SM::segment_address(m_bits.m_segment) + (m_addr & offset_mask);
 }
 
@@ -244,6 +251,7 @@ template<typename SM> inline
 void
 based_2d_addressing_model<SM>::decrement(difference_type dec) noexcept
 {
+    RHX_CHECK_ADDRESS(addressing_checks::check_step<SM>(m_bits.m_segment, m_addr & offset_mask, -dec));
     m_addr -= dec;
 }
 
@@ -251,6 +259,7 @@ template<typename SM> inline
 void
 based_2d_addressing_model<SM>::increment(difference_type inc) noexcept
 {
+    RHX_CHECK_ADDRESS(addressing_checks::check_step<SM>(m_bits.m_segment, m_addr & offset_mask, inc));
     m_addr += inc;
 }
 
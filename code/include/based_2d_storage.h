@@ -29,6 +29,7 @@ class based_2d_storage_model : public storage_model_base
     using addressing_model = based_2d_addressing_model<based_2d_storage_model>;
 
     static  addressing_model    segment_pointer(size_type segment, size_type offset=0);
+    static  char const*         model_name() noexcept;
 };
 
 //------
@@ -39,4 +40,10 @@ based_2d_storage_model::segment_pointer(size_type segment, size_type offset)
     return addressing_model{segment, offset};
 }
 
+inline char const*
+based_2d_storage_model::model_name() noexcept
+{
+    return "based_2d";
+}
+
 #endif  //- BASED_2D_STORAGE_H_DEFINED
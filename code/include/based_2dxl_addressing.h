@@ -14,6 +14,8 @@
 #include <cstddef>
 #include <cstdint>
 
+#include "addressing_checks.h"
+
 //--------------------------------------------------------------------------------------------------
 //  Class:
 //      based_2dxl_addressing_model
@@ -22,6 +24,9 @@
 //      This class template implements a based (segment:offset) addressing model in two 64-bit
 //      integers.  One integer represents an offset, and the other represents a segment index.
 //
+//      When built with RHX_CHECKED_ADDRESSING defined, the segment and offset are validated as
+//      in based_2d_addressing_model.
+//
 //      Note that the comparison helper functions include several that define the "greater_than"
 //      relationship.  They are included because they are trivial, and make the code for any
 //      synthetic pointer wrapper class comparison operators easier to implement and read.
@@ -63,7 +68,7 @@ class based_2dxl_addressing_model
     bool        less_than(void const* p) const noexcept;
     bool        less_than(based_2dxl_addressing_model const& other) const noexcept;
 
-    void        assign_from(void const* p);
+    void        assign_from(void const* p) RHX_ADDRESS_ONLY_ARG(2);
 
     void        decrement(difference_type dec) noexcept;
     void        increment(difference_type inc) noexcept;
@@ -103,6 +108,7 @@ template<typename SM> inline
 void*
 based_2dxl_addressing_model<SM>::address() const noexcept
 {
+    RHX_CHECK_ADDRESS(if (!addressing_checks::check_location<SM>(m_segment, m_offset)) return nullptr);
     return SM::segment_address(m_segment) + m_offset;
 }
 
@@ -126,7 +132,7 @@ template<typename SM> inline
 bool
 based_2dxl_addressing_model<SM>::equals(std::nullptr_t) const noexcept
 {
-    return address() == nullptr;
+    return m_segment == 0  &&  m_offset == 0;
 }
 
 template<typename SM> inline
@@ -224,6 +230,7 @@ template<typename SM> inline
 void
 based_2dxl_addressing_model<SM>::decrement(difference_type dec) noexcept
 {
+    RHX_CHECK_ADDRESS(addressing_checks::check_step<SM>(m_segment, m_offset, -dec));
     m_offset -= dec;
 }
 
@@ -231,6 +238,7 @@ template<typename SM> inline
 void
 based_2dxl_addressing_model<SM>::increment(difference_type inc) noexcept
 {
+    RHX_CHECK_ADDRESS(addressing_checks::check_step<SM>(m_segment, m_offset, inc));
     m_offset += inc;
 }
 
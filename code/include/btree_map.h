@@ -0,0 +1,1115 @@
+//==================================================================================================
+//  File:
+//      btree_map.h
+//
+//  Summary:
+//      Defines an ordered associative container implemented as a B+ tree with wide nodes, whose
+//      nodes refer to one another by compact references relative to the heap's segments.
+//
+//  Copyright (c) 2017 Bob Steagall, KEWB Computing
+//==================================================================================================
+//
+#ifndef BTREE_MAP_H_DEFINED
+#define BTREE_MAP_H_DEFINED
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "rhx_allocator.h"
+
+#if defined(__SSE2__)  ||  defined(_M_X64)  ||  (defined(_M_IX86_FP)  &&  _M_IX86_FP >= 2)
+    #define RHX_BTREE_SSE2
+    #include <emmintrin.h>
+#endif
+
+#if defined(__SSE4_2__)
+    #define RHX_BTREE_SSE42
+    #include <nmmintrin.h>
+#endif
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      btree_count_less<N>
+//
+//  Summary:
+//      Returns the number of the first N keys of a node that are less than a given key.  The
+//      count is taken over all N keys, with the unused keys at the end of the node holding the
+//      greatest value of the key type, so that there are no branches that depend on the keys.
+//      The compiler is free to vectorize the generic version; the overloads for 32-bit keys
+//      (with SSE2) and 64-bit keys (with SSE4.2) compare four or two keys per instruction.
+//      Unsigned keys are compared as signed keys after flipping their sign bits.
+//--------------------------------------------------------------------------------------------------
+//
+template<std::size_t N, class K> inline
+std::size_t
+btree_count_less(K const* keys, K key) noexcept
+{
+    std::size_t     n = 0;
+
+    for (std::size_t i = 0;  i < N;  ++i)
+    {
+        n += (keys[i] < key) ? 1 : 0;
+    }
+    return n;
+}
+
+#ifdef RHX_BTREE_SSE2
+
+template<std::size_t N> inline
+std::size_t
+btree_count_less_32(void const* keys, std::int32_t key, std::int32_t flip) noexcept
+{
+    __m128i const   vflip = _mm_set1_epi32(flip);
+    __m128i const   vkey  = _mm_set1_epi32(key ^ flip);
+    __m128i         acc   = _mm_setzero_si128();
+    __m128i const*  pk    = static_cast<__m128i const*>(keys);
+
+    for (std::size_t i = 0;  i < N / 4;  ++i)
+    {
+        __m128i     k = _mm_xor_si128(_mm_loadu_si128(pk + i), vflip);
+        acc = _mm_sub_epi32(acc, _mm_cmpgt_epi32(vkey, k));
+    }
+    acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, 0x4E));
+    acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, 0xB1));
+    return (std::size_t) _mm_cvtsi128_si32(acc);
+}
+
+template<std::size_t N> inline
+std::size_t
+btree_count_less(std::int32_t const* keys, std::int32_t key) noexcept
+{
+    return btree_count_less_32<N>(keys, key, 0);
+}
+
+template<std::size_t N> inline
+std::size_t
+btree_count_less(std::uint32_t const* keys, std::uint32_t key) noexcept
+{
+    return btree_count_less_32<N>(keys, (std::int32_t) key, INT32_MIN);
+}
+
+#endif
+
+#ifdef RHX_BTREE_SSE42
+
+template<std::size_t N> inline
+std::size_t
+btree_count_less_64(void const* keys, std::int64_t key, std::int64_t flip) noexcept
+{
+    __m128i const   vflip = _mm_set1_epi64x(flip);
+    __m128i const   vkey  = _mm_set1_epi64x(key ^ flip);
+    __m128i         acc   = _mm_setzero_si128();
+    __m128i const*  pk    = static_cast<__m128i const*>(keys);
+
+    for (std::size_t i = 0;  i < N / 2;  ++i)
+    {
+        __m128i     k = _mm_xor_si128(_mm_loadu_si128(pk + i), vflip);
+        acc = _mm_sub_epi64(acc, _mm_cmpgt_epi64(vkey, k));
+    }
+    acc = _mm_add_epi64(acc, _mm_shuffle_epi32(acc, 0x4E));
+    return (std::size_t) _mm_cvtsi128_si64(acc);
+}
+
+template<std::size_t N> inline
+std::size_t
+btree_count_less(std::int64_t const* keys, std::int64_t key) noexcept
+{
+    return btree_count_less_64<N>(keys, key, 0);
+}
+
+template<std::size_t N> inline
+std::size_t
+btree_count_less(std::uint64_t const* keys, std::uint64_t key) noexcept
+{
+    return btree_count_less_64<N>(keys, (std::int64_t) key, INT64_MIN);
+}
+
+#endif
+
+//--------------------------------------------------------------------------------------------------
+//  Class:
+//      btree_key_search<K, C, N>
+//
+//  Summary:
+//      This class template finds the first of the n keys of a node of capacity N that is not
+//      less than a given key.  Integral keys ordered by std::less are searched by counting,
+//      which requires the unused keys of every node to be padded; other keys are searched by
+//      binary search, and need no padding.
+//--------------------------------------------------------------------------------------------------
+//
+template<class K, class C, std::size_t N,
+         bool = std::is_integral<K>::value  &&  std::is_same<C, std::less<K>>::value>
+struct btree_key_search
+{
+    static constexpr bool   padded = false;
+
+    static std::size_t
+    lower_bound(K const* keys, std::size_t n, K const& key)
+    {
+        return (std::size_t) (std::lower_bound(keys, keys + n, key, C()) - keys);
+    }
+
+    static void
+    pad(K*, std::size_t, std::size_t) noexcept
+    {}
+};
+
+template<class K, class C, std::size_t N>
+struct btree_key_search<K, C, N, true>
+{
+    static constexpr bool   padded = true;
+
+    static std::size_t
+    lower_bound(K const* keys, std::size_t, K const& key) noexcept
+    {
+        return btree_count_less<N>(keys, key);
+    }
+
+    static void
+    pad(K* keys, std::size_t first, std::size_t last) noexcept
+    {
+        std::fill(keys + first, keys + last, (std::numeric_limits<K>::max)());
+    }
+};
+
+//--------------------------------------------------------------------------------------------------
+//  Class:
+//      btree_node_header / btree_leaf<K, V, N> / btree_inner<K, N>
+//
+//  Summary:
+//      These types define the layout of the nodes of a B+ tree.  Leaves hold up to N keys and
+//      their values in separate arrays, so that a search touches only keys, and refer to the
+//      next leaf in key order.  Inner nodes hold up to N separator keys and N+1 child node
+//      references; each separator is the greatest key of the subtree to its left.  Keys and
+//      values are constructed in place, so the arrays are raw storage.  Nodes are aligned on
+//      cache lines.
+//--------------------------------------------------------------------------------------------------
+//
+struct btree_node_header
+{
+    std::uint32_t   m_count;
+    std::uint32_t   m_next;         //- For leaves, the next leaf; zero for the last
+};
+
+template<class K, class V, std::size_t N>
+struct alignas(64) btree_leaf
+{
+    btree_node_header                                           m_hdr;
+    typename std::aligned_storage<sizeof(K), alignof(K)>::type  m_keys[N];
+    typename std::aligned_storage<sizeof(V), alignof(V)>::type  m_values[N];
+
+    K*  keys() noexcept     { return reinterpret_cast<K*>(m_keys); }
+    V*  values() noexcept   { return reinterpret_cast<V*>(m_values); }
+};
+
+template<class K, std::size_t N>
+struct alignas(64) btree_inner
+{
+    btree_node_header                                           m_hdr;
+    typename std::aligned_storage<sizeof(K), alignof(K)>::type  m_keys[N];
+    std::uint32_t                                               m_children[N + 1];
+
+    K*  keys() noexcept     { return reinterpret_cast<K*>(m_keys); }
+};
+
+//- The number of keys that fit in a node of about B bytes, a multiple of four so that the
+//  counting search never needs a partial vector.
+//
+constexpr std::size_t
+btree_capacity(std::size_t bytes, std::size_t per_key)
+{
+    return (bytes / per_key / 4 * 4 < 4) ? 4 : (bytes / per_key / 4 * 4);
+}
+
+//- A node reference holds the index of the node's segment in its top eight bits and the
+//  node's offset within the segment, in cache lines, in the rest.  Since segments are never
+//  larger than 2^30 bytes, the offset fits, and since zero is never a segment index, a valid
+//  reference is never zero.
+//
+template<class SM> inline
+void*
+btree_node_address(std::uint32_t ref) noexcept
+{
+    return SM::segment_address(ref >> 24) + ((std::size_t) (ref & 0xFFFFFF) << 6);
+}
+
+//--------------------------------------------------------------------------------------------------
+//  Class:
+//      btree_iterator<K, V, L, SM>
+//
+//  Summary:
+//      This class template implements a forward iterator over the elements of a B+ tree map,
+//      following the chain of leaves.  Since keys and values are stored separately, it does
+//      not yield references to pairs, but pairs of references.  It holds a native pointer to
+//      its leaf, so it is invalidated by insertion, erasure, and relocation of the heap.
+//--------------------------------------------------------------------------------------------------
+//
+template<class K, class V, class L, class SM>
+class btree_iterator
+{
+  public:
+    using difference_type   = std::ptrdiff_t;
+    using value_type        = std::pair<K const, typename std::remove_const<V>::type>;
+    using reference         = std::pair<K const&, V&>;
+    using iterator_category = std::forward_iterator_tag;
+
+    struct pointer
+    {
+        reference   m_ref;
+        reference const*    operator ->() const noexcept { return &m_ref; }
+    };
+
+  public:
+    btree_iterator() noexcept;
+    btree_iterator(L* leaf, std::size_t index) noexcept;
+
+    template<class U, typename std::enable_if<std::is_convertible<U&, V&>::value, bool>::type = true>
+    btree_iterator(btree_iterator<K, U, L, SM> const& other) noexcept;
+
+    reference   operator  *() const noexcept;
+    pointer     operator ->() const noexcept;
+
+    btree_iterator&     operator ++() noexcept;
+    btree_iterator      operator ++(int) noexcept;
+
+    bool    equals(btree_iterator const& other) const noexcept;
+
+  private:
+    template<class OK, class OV, class OL, class OSM> friend class btree_iterator;
+
+    void    skip_empty() noexcept;
+
+    L*              m_leaf;
+    std::size_t     m_index;
+};
+
+//------
+//
+template<class K, class V, class L, class SM> inline
+btree_iterator<K, V, L, SM>::btree_iterator() noexcept
+:   m_leaf(nullptr)
+,   m_index(0)
+{}
+
+template<class K, class V, class L, class SM> inline
+btree_iterator<K, V, L, SM>::btree_iterator(L* leaf, std::size_t index) noexcept
+:   m_leaf(leaf)
+,   m_index(index)
+{
+    skip_empty();
+}
+
+template<class K, class V, class L, class SM>
+template<class U, typename std::enable_if<std::is_convertible<U&, V&>::value, bool>::type> inline
+btree_iterator<K, V, L, SM>::btree_iterator(btree_iterator<K, U, L, SM> const& other) noexcept
+:   m_leaf(other.m_leaf)
+,   m_index(other.m_index)
+{}
+
+template<class K, class V, class L, class SM> inline
+typename btree_iterator<K, V, L, SM>::reference
+btree_iterator<K, V, L, SM>::operator *() const noexcept
+{
+    return reference(m_leaf->keys()[m_index], m_leaf->values()[m_index]);
+}
+
+template<class K, class V, class L, class SM> inline
+typename btree_iterator<K, V, L, SM>::pointer
+btree_iterator<K, V, L, SM>::operator ->() const noexcept
+{
+    return pointer{**this};
+}
+
+template<class K, class V, class L, class SM> inline
+btree_iterator<K, V, L, SM>&
+btree_iterator<K, V, L, SM>::operator ++() noexcept
+{
+    ++m_index;
+    skip_empty();
+    return *this;
+}
+
+template<class K, class V, class L, class SM> inline
+btree_iterator<K, V, L, SM>
+btree_iterator<K, V, L, SM>::operator ++(int) noexcept
+{
+    btree_iterator  tmp(*this);
+    ++*this;
+    return tmp;
+}
+
+template<class K, class V, class L, class SM> inline
+bool
+btree_iterator<K, V, L, SM>::equals(btree_iterator const& other) const noexcept
+{
+    return m_leaf == other.m_leaf  &&  m_index == other.m_index;
+}
+
+//- Moves past the end of a leaf to the start of the next leaf, skipping leaves left empty by
+//  erasure; the end iterator has no leaf.
+//
+template<class K, class V, class L, class SM> inline
+void
+btree_iterator<K, V, L, SM>::skip_empty() noexcept
+{
+    while (m_leaf != nullptr  &&  m_index >= m_leaf->m_hdr.m_count)
+    {
+        std::uint32_t   next = m_leaf->m_hdr.m_next;
+
+        m_leaf  = (next == 0) ? nullptr : static_cast<L*>(btree_node_address<SM>(next));
+        m_index = 0;
+    }
+}
+
+//------
+//
+template<class K, class V, class U, class L, class SM> inline bool
+operator ==(btree_iterator<K, V, L, SM> const& lhs, btree_iterator<K, U, L, SM> const& rhs)
+{
+    using common = btree_iterator<K, typename std::add_const<V>::type, L, SM>;
+    return common(lhs).equals(common(rhs));
+}
+
+template<class K, class V, class U, class L, class SM> inline bool
+operator !=(btree_iterator<K, V, L, SM> const& lhs, btree_iterator<K, U, L, SM> const& rhs)
+{
+    return !(lhs == rhs);
+}
+
+//--------------------------------------------------------------------------------------------------
+//  Class:
+//      btree_map<K, V, HT, C, B>
+//
+//  Summary:
+//      This class template implements an ordered map as a B+ tree whose nodes, of about B
+//      bytes each, are allocated by rhx_allocator from the allocation strategy HT.  Wide nodes
+//      make the tree shallow and the search within a node cache-friendly, and replace the
+//      per-element nodes and synthetic pointers of std::map with a few bytes of overhead per
+//      element.
+//
+//      A node refers to another by a 32-bit reference made of the index of the heap segment
+//      holding it and its cache-line offset within that segment.  Such a reference is cheaper
+//      to follow than any synthetic pointer, and, like a based pointer, is unaffected by the
+//      relocation of the heap's segments; the map itself holds only references, so it can be
+//      relocated with the heap, or even live outside it.
+//
+//      Erasure removes elements from their leaves but does not merge or rebalance nodes; nodes
+//      emptied by erasure are released by clear() and by destruction.
+//--------------------------------------------------------------------------------------------------
+//
+template<class K, class V, class HT, class C = std::less<K>, std::size_t B = 512>
+class btree_map
+{
+  public:
+    using key_type          = K;
+    using mapped_type       = V;
+    using key_compare       = C;
+    using size_type         = typename HT::size_type;
+    using difference_type   = typename HT::difference_type;
+    using storage_model     = typename HT::storage_model;
+
+    static constexpr std::size_t    leaf_capacity  = btree_capacity(B - sizeof(btree_node_header), sizeof(K) + sizeof(V));
+    static constexpr std::size_t    inner_capacity = btree_capacity(B - sizeof(btree_node_header) - 4, sizeof(K) + 4);
+
+    using leaf_node         = btree_leaf<K, V, leaf_capacity>;
+    using inner_node        = btree_inner<K, inner_capacity>;
+    using iterator          = btree_iterator<K, V, leaf_node, storage_model>;
+    using const_iterator    = btree_iterator<K, V const, leaf_node, storage_model>;
+    using value_type        = typename iterator::value_type;
+    using reference         = typename iterator::reference;
+
+  public:
+    btree_map() noexcept;
+    btree_map(btree_map&& other) noexcept;
+    ~btree_map();
+
+    btree_map(btree_map const&) = delete;
+    btree_map&  operator =(btree_map const&) = delete;
+    btree_map&  operator =(btree_map&& rhs) noexcept;
+
+    iterator        begin() noexcept;
+    iterator        end() noexcept;
+    const_iterator  begin() const noexcept;
+    const_iterator  end() const noexcept;
+    const_iterator  cbegin() const noexcept;
+    const_iterator  cend() const noexcept;
+
+    bool        empty() const noexcept;
+    size_type   size() const noexcept;
+    size_type   height() const noexcept;
+    size_type   node_count() const noexcept;
+    size_type   footprint() const noexcept;
+
+    iterator        find(K const& key);
+    const_iterator  find(K const& key) const;
+    iterator        lower_bound(K const& key);
+    const_iterator  lower_bound(K const& key) const;
+    size_type       count(K const& key) const;
+    V&              at(K const& key);
+    V const&        at(K const& key) const;
+    V&              operator [](K const& key);
+
+    template<class... Args>
+    std::pair<iterator, bool>   try_emplace(K const& key, Args&&... args);
+    template<class... Args>
+    std::pair<iterator, bool>   emplace(K const& key, Args&&... args);
+    std::pair<iterator, bool>   insert(std::pair<K, V> const& value);
+
+    size_type   erase(K const& key);
+    void        clear() noexcept;
+    void        swap(btree_map& other) noexcept;
+
+  private:
+    using node_ref      = std::uint32_t;
+    using leaf_search   = btree_key_search<K, C, leaf_capacity>;
+    using inner_search  = btree_key_search<K, C, inner_capacity>;
+
+    enum : size_type
+    {
+        max_height = 32
+    };
+
+    static node_ref     make_ref(void const* p) noexcept;
+    static void*        node_at(node_ref r) noexcept;
+    static leaf_node*   leaf_at(node_ref r) noexcept;
+    static inner_node*  inner_at(node_ref r) noexcept;
+
+    template<class T>
+    static void     open_slot(T* a, std::size_t i, std::size_t n);
+    template<class T>
+    static void     close_slot(T* a, std::size_t i, std::size_t n);
+    template<class T>
+    static void     move_slots(T* src, T* dst, std::size_t n);
+
+    node_ref    new_leaf();
+    node_ref    new_inner();
+    void        free_subtree(node_ref r, size_type height) noexcept;
+
+    leaf_node*  find_leaf(K const& key) const;
+    node_ref    split_leaf(node_ref lref, std::size_t i, K& sep);
+    void        insert_separator(node_ref* path, std::size_t* slots, size_type level, K const& sep, node_ref child);
+
+    node_ref        m_root;
+    node_ref        m_first;        //- The first leaf
+    std::uint32_t   m_height;       //- The number of levels; leaves are at level one
+    size_type       m_size;
+    size_type       m_leaves;
+    size_type       m_inners;
+};
+
+//------
+//
+template<class K, class V, class HT, class C, std::size_t B> inline
+btree_map<K, V, HT, C, B>::btree_map() noexcept
+:   m_root(0)
+,   m_first(0)
+,   m_height(0)
+,   m_size(0)
+,   m_leaves(0)
+,   m_inners(0)
+{}
+
+template<class K, class V, class HT, class C, std::size_t B> inline
+btree_map<K, V, HT, C, B>::btree_map(btree_map&& other) noexcept
+:   btree_map()
+{
+    swap(other);
+}
+
+template<class K, class V, class HT, class C, std::size_t B> inline
+btree_map<K, V, HT, C, B>::~btree_map()
+{
+    clear();
+}
+
+template<class K, class V, class HT, class C, std::size_t B> inline
+btree_map<K, V, HT, C, B>&
+btree_map<K, V, HT, C, B>::operator =(btree_map&& rhs) noexcept
+{
+    btree_map   tmp(std::move(rhs));
+    swap(tmp);
+    return *this;
+}
+
+//------
+//
+template<class K, class V, class HT, class C, std::size_t B> inline
+typename btree_map<K, V, HT, C, B>::iterator
+btree_map<K, V, HT, C, B>::begin() noexcept
+{
+    return (m_first == 0) ? iterator() : iterator(leaf_at(m_first), 0);
+}
+
+template<class K, class V, class HT, class C, std::size_t B> inline
+typename btree_map<K, V, HT, C, B>::iterator
+btree_map<K, V, HT, C, B>::end() noexcept
+{
+    return iterator();
+}
+
+template<class K, class V, class HT, class C, std::size_t B> inline
+typename btree_map<K, V, HT, C, B>::const_iterator
+btree_map<K, V, HT, C, B>::begin() const noexcept
+{
+    return const_cast<btree_map*>(this)->begin();
+}
+
+template<class K, class V, class HT, class C, std::size_t B> inline
+typename btree_map<K, V, HT, C, B>::const_iterator
+btree_map<K, V, HT, C, B>::end() const noexcept
+{
+    return const_iterator();
+}
+
+template<class K, class V, class HT, class C, std::size_t B> inline
+typename btree_map<K, V, HT, C, B>::const_iterator
+btree_map<K, V, HT, C, B>::cbegin() const noexcept
+{
+    return begin();
+}
+
+template<class K, class V, class HT, class C, std::size_t B> inline
+typename btree_map<K, V, HT, C, B>::const_iterator
+btree_map<K, V, HT, C, B>::cend() const noexcept
+{
+    return end();
+}
+
+//------
+//
+template<class K, class V, class HT, class C, std::size_t B> inline
+bool
+btree_map<K, V, HT, C, B>::empty() const noexcept
+{
+    return m_size == 0;
+}
+
+template<class K, class V, class HT, class C, std::size_t B> inline
+typename btree_map<K, V, HT, C, B>::size_type
+btree_map<K, V, HT, C, B>::size() const noexcept
+{
+    return m_size;
+}
+
+template<class K, class V, class HT, class C, std::size_t B> inline
+typename btree_map<K, V, HT, C, B>::size_type
+btree_map<K, V, HT, C, B>::height() const noexcept
+{
+    return m_height;
+}
+
+template<class K, class V, class HT, class C, std::size_t B> inline
+typename btree_map<K, V, HT, C, B>::size_type
+btree_map<K, V, HT, C, B>::node_count() const noexcept
+{
+    return m_leaves + m_inners;
+}
+
+//- The number of bytes of heap occupied by the nodes.
+//
+template<class K, class V, class HT, class C, std::size_t B> inline
+typename btree_map<K, V, HT, C, B>::size_type
+btree_map<K, V, HT, C, B>::footprint() const noexcept
+{
+    return m_leaves * sizeof(leaf_node) + m_inners * sizeof(inner_node);
+}
+
+//------
+//
+template<class K, class V, class HT, class C, std::size_t B> inline
+typename btree_map<K, V, HT, C, B>::iterator
+btree_map<K, V, HT, C, B>::find(K const& key)
+{
+    leaf_node*  leaf = find_leaf(key);
+
+    if (leaf != nullptr)
+    {
+        std::size_t     i = leaf_search::lower_bound(leaf->keys(), leaf->m_hdr.m_count, key);
+
+        if (i < leaf->m_hdr.m_count  &&  !C()(key, leaf->keys()[i]))
+        {
+            return iterator(leaf, i);
+        }
+    }
+    return end();
+}
+
+template<class K, class V, class HT, class C, std::size_t B> inline
+typename btree_map<K, V, HT, C, B>::const_iterator
+btree_map<K, V, HT, C, B>::find(K const& key) const
+{
+    return const_cast<btree_map*>(this)->find(key);
+}
+
+template<class K, class V, class HT, class C, std::size_t B> inline
+typename btree_map<K, V, HT, C, B>::iterator
+btree_map<K, V, HT, C, B>::lower_bound(K const& key)
+{
+    leaf_node*  leaf = find_leaf(key);
+
+    return (leaf == nullptr) ? end()
+                             : iterator(leaf, leaf_search::lower_bound(leaf->keys(), leaf->m_hdr.m_count, key));
+}
+
+template<class K, class V, class HT, class C, std::size_t B> inline
+typename btree_map<K, V, HT, C, B>::const_iterator
+btree_map<K, V, HT, C, B>::lower_bound(K const& key) const
+{
+    return const_cast<btree_map*>(this)->lower_bound(key);
+}
+
+template<class K, class V, class HT, class C, std::size_t B> inline
+typename btree_map<K, V, HT, C, B>::size_type
+btree_map<K, V, HT, C, B>::count(K const& key) const
+{
+    return (find(key) == end()) ? 0 : 1;
+}
+
+template<class K, class V, class HT, class C, std::size_t B>
+V&
+btree_map<K, V, HT, C, B>::at(K const& key)
+{
+    iterator    it = find(key);
+
+    if (it == end())
+    {
+        throw std::out_of_range("btree_map::at");
+    }
+    return it->second;
+}
+
+template<class K, class V, class HT, class C, std::size_t B> inline
+V const&
+btree_map<K, V, HT, C, B>::at(K const& key) const
+{
+    return const_cast<btree_map*>(this)->at(key);
+}
+
+template<class K, class V, class HT, class C, std::size_t B> inline
+V&
+btree_map<K, V, HT, C, B>::operator [](K const& key)
+{
+    return try_emplace(key).first->second;
+}
+
+//------
+//- Inserts an element into the leaf that should hold its key, splitting the leaf first if it
+//  is full, and adding the separator for the new leaf to the leaf's parent.  The path from the
+//  root is recorded on the way down, so that splits can be propagated upward.
+//
+template<class K, class V, class HT, class C, std::size_t B>
+template<class... Args>
+std::pair<typename btree_map<K, V, HT, C, B>::iterator, bool>
+btree_map<K, V, HT, C, B>::try_emplace(K const& key, Args&&... args)
+{
+    node_ref        path[max_height];
+    std::size_t     slots[max_height];
+
+    if (m_root == 0)
+    {
+        m_root   = m_first = new_leaf();
+        m_height = 1;
+    }
+
+    node_ref    ref = m_root;
+
+    for (size_type level = m_height;  level > 1;  --level)
+    {
+        inner_node*     inner = inner_at(ref);
+        std::size_t     i     = inner_search::lower_bound(inner->keys(), inner->m_hdr.m_count, key);
+
+        path[level]  = ref;
+        slots[level] = i;
+        ref          = inner->m_children[i];
+    }
+
+    leaf_node*      leaf = leaf_at(ref);
+    std::size_t     n    = leaf->m_hdr.m_count;
+    std::size_t     i    = leaf_search::lower_bound(leaf->keys(), n, key);
+
+    if (i < n  &&  !C()(key, leaf->keys()[i]))
+    {
+        return { iterator(leaf, i), false };
+    }
+
+    if (n == leaf_capacity)
+    {
+        K           sep;
+        node_ref    rref = split_leaf(ref, i, sep);
+
+        insert_separator(path, slots, 2, sep, rref);
+
+        if (i >= leaf->m_hdr.m_count)
+        {
+            i   -= leaf->m_hdr.m_count;
+            leaf = leaf_at(rref);
+        }
+        n = leaf->m_hdr.m_count;
+    }
+
+    open_slot(leaf->keys(), i, n);
+    open_slot(leaf->values(), i, n);
+    ::new (static_cast<void*>(leaf->keys() + i)) K(key);
+    ::new (static_cast<void*>(leaf->values() + i)) V(std::forward<Args>(args)...);
+
+    ++leaf->m_hdr.m_count;
+    ++m_size;
+
+    return { iterator(leaf, i), true };
+}
+
+template<class K, class V, class HT, class C, std::size_t B>
+template<class... Args> inline
+std::pair<typename btree_map<K, V, HT, C, B>::iterator, bool>
+btree_map<K, V, HT, C, B>::emplace(K const& key, Args&&... args)
+{
+    return try_emplace(key, std::forward<Args>(args)...);
+}
+
+template<class K, class V, class HT, class C, std::size_t B> inline
+std::pair<typename btree_map<K, V, HT, C, B>::iterator, bool>
+btree_map<K, V, HT, C, B>::insert(std::pair<K, V> const& value)
+{
+    return try_emplace(value.first, value.second);
+}
+
+//------
+//
+template<class K, class V, class HT, class C, std::size_t B>
+typename btree_map<K, V, HT, C, B>::size_type
+btree_map<K, V, HT, C, B>::erase(K const& key)
+{
+    leaf_node*  leaf = find_leaf(key);
+
+    if (leaf == nullptr)
+    {
+        return 0;
+    }
+
+    std::size_t     n = leaf->m_hdr.m_count;
+    std::size_t     i = leaf_search::lower_bound(leaf->keys(), n, key);
+
+    if (i == n  ||  C()(key, leaf->keys()[i]))
+    {
+        return 0;
+    }
+
+    close_slot(leaf->keys(), i, n);
+    close_slot(leaf->values(), i, n);
+    leaf_search::pad(leaf->keys(), n - 1, leaf_capacity);
+
+    --leaf->m_hdr.m_count;
+    --m_size;
+    return 1;
+}
+
+template<class K, class V, class HT, class C, std::size_t B> inline
+void
+btree_map<K, V, HT, C, B>::clear() noexcept
+{
+    if (m_root != 0)
+    {
+        free_subtree(m_root, m_height);
+    }
+
+    m_root   = m_first = 0;
+    m_height = 0;
+    m_size   = 0;
+}
+
+template<class K, class V, class HT, class C, std::size_t B> inline
+void
+btree_map<K, V, HT, C, B>::swap(btree_map& other) noexcept
+{
+    std::swap(m_root, other.m_root);
+    std::swap(m_first, other.m_first);
+    std::swap(m_height, other.m_height);
+    std::swap(m_size, other.m_size);
+    std::swap(m_leaves, other.m_leaves);
+    std::swap(m_inners, other.m_inners);
+}
+
+//------
+//
+template<class K, class V, class HT, class C, std::size_t B> inline
+typename btree_map<K, V, HT, C, B>::node_ref
+btree_map<K, V, HT, C, B>::make_ref(void const* p) noexcept
+{
+    size_type   segment = storage_model::address_segment(p);
+    size_type   offset  = (size_type) (static_cast<char const*>(p) - storage_model::segment_address(segment));
+
+    return (node_ref) ((segment << 24) | (offset >> 6));
+}
+
+template<class K, class V, class HT, class C, std::size_t B> inline
+void*
+btree_map<K, V, HT, C, B>::node_at(node_ref r) noexcept
+{
+    return btree_node_address<storage_model>(r);
+}
+
+template<class K, class V, class HT, class C, std::size_t B> inline
+typename btree_map<K, V, HT, C, B>::leaf_node*
+btree_map<K, V, HT, C, B>::leaf_at(node_ref r) noexcept
+{
+    return static_cast<leaf_node*>(node_at(r));
+}
+
+template<class K, class V, class HT, class C, std::size_t B> inline
+typename btree_map<K, V, HT, C, B>::inner_node*
+btree_map<K, V, HT, C, B>::inner_at(node_ref r) noexcept
+{
+    return static_cast<inner_node*>(node_at(r));
+}
+
+//------
+//- These helpers open a slot at position i of an array of n constructed elements, leaving it
+//  unconstructed; close the slot at position i, leaving the last position unconstructed; and
+//  move n elements into unconstructed storage, destroying the originals.
+//
+template<class K, class V, class HT, class C, std::size_t B>
+template<class T>
+void
+btree_map<K, V, HT, C, B>::open_slot(T* a, std::size_t i, std::size_t n)
+{
+    if (i < n)
+    {
+        ::new (static_cast<void*>(a + n)) T(std::move(a[n - 1]));
+        std::move_backward(a + i, a + n - 1, a + n);
+        a[i].~T();
+    }
+}
+
+template<class K, class V, class HT, class C, std::size_t B>
+template<class T>
+void
+btree_map<K, V, HT, C, B>::close_slot(T* a, std::size_t i, std::size_t n)
+{
+    std::move(a + i + 1, a + n, a + i);
+    a[n - 1].~T();
+}
+
+template<class K, class V, class HT, class C, std::size_t B>
+template<class T>
+void
+btree_map<K, V, HT, C, B>::move_slots(T* src, T* dst, std::size_t n)
+{
+    for (std::size_t i = 0;  i < n;  ++i)
+    {
+        ::new (static_cast<void*>(dst + i)) T(std::move(src[i]));
+        src[i].~T();
+    }
+}
+
+//------
+//
+template<class K, class V, class HT, class C, std::size_t B>
+typename btree_map<K, V, HT, C, B>::node_ref
+btree_map<K, V, HT, C, B>::new_leaf()
+{
+    RHX_TRACE(RHX_TRACE_DEFAULT_SITE("btree_map leaf"));
+
+    leaf_node*  leaf = static_cast<leaf_node*>(rhx_allocator<leaf_node, HT>().allocate(1));
+
+    leaf->m_hdr.m_count = 0;
+    leaf->m_hdr.m_next  = 0;
+    leaf_search::pad(leaf->keys(), 0, leaf_capacity);
+    ++m_leaves;
+
+    return make_ref(leaf);
+}
+
+template<class K, class V, class HT, class C, std::size_t B>
+typename btree_map<K, V, HT, C, B>::node_ref
+btree_map<K, V, HT, C, B>::new_inner()
+{
+    RHX_TRACE(RHX_TRACE_DEFAULT_SITE("btree_map inner"));
+
+    inner_node*     inner = static_cast<inner_node*>(rhx_allocator<inner_node, HT>().allocate(1));
+
+    inner->m_hdr.m_count = 0;
+    inner->m_hdr.m_next  = 0;
+    inner_search::pad(inner->keys(), 0, inner_capacity);
+    ++m_inners;
+
+    return make_ref(inner);
+}
+
+template<class K, class V, class HT, class C, std::size_t B>
+void
+btree_map<K, V, HT, C, B>::free_subtree(node_ref r, size_type height) noexcept
+{
+    if (height > 1)
+    {
+        inner_node*     inner = inner_at(r);
+
+        for (std::size_t i = 0;  i <= inner->m_hdr.m_count;  ++i)
+        {
+            free_subtree(inner->m_children[i], height - 1);
+        }
+        for (std::size_t i = 0;  i < inner->m_hdr.m_count;  ++i)
+        {
+            inner->keys()[i].~K();
+        }
+        rhx_allocator<inner_node, HT>().deallocate(rhx_allocator<inner_node, HT>().address(*inner), 1);
+        --m_inners;
+    }
+    else
+    {
+        leaf_node*  leaf = leaf_at(r);
+
+        for (std::size_t i = 0;  i < leaf->m_hdr.m_count;  ++i)
+        {
+            leaf->keys()[i].~K();
+            leaf->values()[i].~V();
+        }
+        rhx_allocator<leaf_node, HT>().deallocate(rhx_allocator<leaf_node, HT>().address(*leaf), 1);
+        --m_leaves;
+    }
+}
+
+//------
+//
+template<class K, class V, class HT, class C, std::size_t B>
+typename btree_map<K, V, HT, C, B>::leaf_node*
+btree_map<K, V, HT, C, B>::find_leaf(K const& key) const
+{
+    if (m_root == 0)
+    {
+        return nullptr;
+    }
+
+    node_ref    ref = m_root;
+
+    for (size_type level = m_height;  level > 1;  --level)
+    {
+        inner_node*     inner = inner_at(ref);
+
+        ref = inner->m_children[inner_search::lower_bound(inner->keys(), inner->m_hdr.m_count, key)];
+    }
+    return leaf_at(ref);
+}
+
+//- Splits a full leaf in two, returning the new right-hand leaf and setting the separator to
+//  the greatest key left in the original.  The key about to be inserted at position i goes to
+//  the original if i is less than the number of keys kept there, and otherwise to the new
+//  leaf.  Appending to the last leaf moves nothing, so that keys inserted in ascending order
+//  fill their leaves.
+//
+template<class K, class V, class HT, class C, std::size_t B>
+typename btree_map<K, V, HT, C, B>::node_ref
+btree_map<K, V, HT, C, B>::split_leaf(node_ref lref, std::size_t i, K& sep)
+{
+    node_ref        rref  = new_leaf();
+    leaf_node*      left  = leaf_at(lref);
+    leaf_node*      right = leaf_at(rref);
+    bool            last  = left->m_hdr.m_next == 0  &&  i == leaf_capacity;
+    std::size_t     keep  = last ? leaf_capacity : leaf_capacity / 2;
+    std::size_t     nmove = leaf_capacity - keep;
+
+    move_slots(left->keys() + keep, right->keys(), nmove);
+    move_slots(left->values() + keep, right->values(), nmove);
+    leaf_search::pad(left->keys(), keep, leaf_capacity);
+
+    right->m_hdr.m_count = (std::uint32_t) nmove;
+    right->m_hdr.m_next  = left->m_hdr.m_next;
+    left->m_hdr.m_count  = (std::uint32_t) keep;
+    left->m_hdr.m_next   = rref;
+
+    sep = left->keys()[keep - 1];
+    return rref;
+}
+
+//- Inserts a separator and the child to its right into the inner node at the given level of
+//  the recorded path, splitting full inner nodes on the way up, and adding a new root if the
+//  root itself is split.  The separator promoted from a split inner node is its middle key.
+//
+template<class K, class V, class HT, class C, std::size_t B>
+void
+btree_map<K, V, HT, C, B>::insert_separator
+(node_ref* path, std::size_t* slots, size_type level, K const& sep, node_ref child)
+{
+    K           key   = sep;
+    node_ref    right = child;
+
+    for (;;  ++level)
+    {
+        if (level > m_height)
+        {
+            node_ref        rref = new_inner();
+            inner_node*     root = inner_at(rref);
+
+            ::new (static_cast<void*>(root->keys())) K(key);
+            root->m_children[0] = m_root;
+            root->m_children[1] = right;
+            root->m_hdr.m_count = 1;
+
+            m_root = rref;
+            ++m_height;
+            return;
+        }
+
+        inner_node*     inner = inner_at(path[level]);
+        std::size_t     pos   = slots[level];
+        std::size_t     n     = inner->m_hdr.m_count;
+
+        if (n < inner_capacity)
+        {
+            open_slot(inner->keys(), pos, n);
+            ::new (static_cast<void*>(inner->keys() + pos)) K(key);
+            std::copy_backward(inner->m_children + pos + 1, inner->m_children + n + 1, inner->m_children + n + 2);
+            inner->m_children[pos + 1] = right;
+            inner->m_hdr.m_count = (std::uint32_t) (n + 1);
+            return;
+        }
+
+        //- Split the full node around its middle key, which moves up, then insert into the
+        //  half that the separator belongs in.
+        //
+        std::size_t     mid   = inner_capacity / 2;
+        node_ref        sref  = new_inner();
+        inner_node*     sibl  = inner_at(sref);
+        std::size_t     nmove = n - mid - 1;
+        K               up    = std::move(inner->keys()[mid]);
+
+        move_slots(inner->keys() + mid + 1, sibl->keys(), nmove);
+        std::copy(inner->m_children + mid + 1, inner->m_children + n + 1, sibl->m_children);
+        inner->keys()[mid].~K();
+        inner_search::pad(inner->keys(), mid, inner_capacity);
+
+        inner->m_hdr.m_count = (std::uint32_t) mid;
+        sibl->m_hdr.m_count  = (std::uint32_t) nmove;
+
+        inner_node*     dest  = (pos <= mid) ? inner : sibl;
+        std::size_t     dpos  = (pos <= mid) ? pos : pos - mid - 1;
+        std::size_t     dn    = dest->m_hdr.m_count;
+
+        open_slot(dest->keys(), dpos, dn);
+        ::new (static_cast<void*>(dest->keys() + dpos)) K(key);
+        std::copy_backward(dest->m_children + dpos + 1, dest->m_children + dn + 1, dest->m_children + dn + 2);
+        dest->m_children[dpos + 1] = right;
+        dest->m_hdr.m_count = (std::uint32_t) (dn + 1);
+
+        key   = std::move(up);
+        right = sref;
+    }
+}
+
+//------
+//
+template<class K, class V, class HT, class C, std::size_t B> inline
+void
+swap(btree_map<K, V, HT, C, B>& lhs, btree_map<K, V, HT, C, B>& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+
+#endif  //- BTREE_MAP_H_DEFINED
@@ -0,0 +1,1029 @@
+//==================================================================================================
+//  File:
+//      flat_hash_map.h
+//
+//  Summary:
+//      Defines an open-addressing hash map whose elements and control bytes are stored in a
+//      single array allocated from the relocatable heap.
+//
+//  Copyright (c) 2017 Bob Steagall, KEWB Computing
+//==================================================================================================
+//
+#ifndef FLAT_HASH_MAP_H_DEFINED
+#define FLAT_HASH_MAP_H_DEFINED
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "rhx_allocator.h"
+
+#if defined(__SSE2__)  ||  defined(_M_X64)  ||  (defined(_M_IX86_FP)  &&  _M_IX86_FP >= 2)
+    #define RHX_FLAT_HASH_SSE2
+    #include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+    #include <intrin.h>
+#endif
+
+//--------------------------------------------------------------------------------------------------
+//  Class:
+//      flat_hash_group
+//
+//  Summary:
+//      This class represents a group of sixteen consecutive control bytes of a flat hash map,
+//      and answers which of them match a given hash fragment, are empty, or are free (empty or
+//      deleted), as a bit mask with one bit per byte.  With SSE2, each question is answered by
+//      a single comparison of all sixteen bytes; otherwise the bytes are examined one by one.
+//
+//      A control byte is non-negative when its slot is full, and then holds seven bits of the
+//      element's hash; the negative values mark empty and deleted slots.
+//--------------------------------------------------------------------------------------------------
+//
+class flat_hash_group
+{
+  public:
+    using ctrl_type = signed char;
+    using mask_type = std::uint32_t;
+
+    enum : ctrl_type
+    {
+        empty   = -128,
+        deleted = -2
+    };
+
+    static constexpr std::size_t    width = 16;
+
+  public:
+    explicit flat_hash_group(ctrl_type const* pos) noexcept;
+
+    mask_type   match(ctrl_type h2) const noexcept;
+    mask_type   match_empty() const noexcept;
+    mask_type   match_free() const noexcept;
+
+    static unsigned     lowest_bit(mask_type mask) noexcept;
+    static unsigned     leading_zeros(mask_type mask) noexcept;
+
+  private:
+#ifdef RHX_FLAT_HASH_SSE2
+    __m128i         m_ctrl;
+#else
+    ctrl_type       m_ctrl[width];
+#endif
+};
+
+//------
+//
+#ifdef RHX_FLAT_HASH_SSE2
+
+inline
+flat_hash_group::flat_hash_group(ctrl_type const* pos) noexcept
+:   m_ctrl(_mm_loadu_si128(reinterpret_cast<__m128i const*>(pos)))
+{}
+
+inline flat_hash_group::mask_type
+flat_hash_group::match(ctrl_type h2) const noexcept
+{
+    return (mask_type) _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), m_ctrl));
+}
+
+inline flat_hash_group::mask_type
+flat_hash_group::match_empty() const noexcept
+{
+    return (mask_type) _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(empty), m_ctrl));
+}
+
+//- Free slots are exactly those whose control bytes have the sign bit set.
+//
+inline flat_hash_group::mask_type
+flat_hash_group::match_free() const noexcept
+{
+    return (mask_type) _mm_movemask_epi8(m_ctrl);
+}
+
+#else
+
+inline
+flat_hash_group::flat_hash_group(ctrl_type const* pos) noexcept
+{
+    std::memcpy(m_ctrl, pos, width);
+}
+
+inline flat_hash_group::mask_type
+flat_hash_group::match(ctrl_type h2) const noexcept
+{
+    mask_type   mask = 0;
+
+    for (std::size_t i = 0;  i < width;  ++i)
+    {
+        mask |= (mask_type) (m_ctrl[i] == h2) << i;
+    }
+    return mask;
+}
+
+inline flat_hash_group::mask_type
+flat_hash_group::match_empty() const noexcept
+{
+    return match(empty);
+}
+
+inline flat_hash_group::mask_type
+flat_hash_group::match_free() const noexcept
+{
+    mask_type   mask = 0;
+
+    for (std::size_t i = 0;  i < width;  ++i)
+    {
+        mask |= (mask_type) (m_ctrl[i] < 0) << i;
+    }
+    return mask;
+}
+
+#endif
+
+//- The index of the lowest set bit of a non-zero mask, and the number of unset bits above the
+//  highest set bit of a sixteen-bit mask.
+//
+inline unsigned
+flat_hash_group::lowest_bit(mask_type mask) noexcept
+{
+#if defined(_MSC_VER)
+    unsigned long   idx;
+    _BitScanForward(&idx, mask);
+    return (unsigned) idx;
+#else
+    return (unsigned) __builtin_ctz(mask);
+#endif
+}
+
+inline unsigned
+flat_hash_group::leading_zeros(mask_type mask) noexcept
+{
+    unsigned    n = (unsigned) width;
+
+    for (;  mask != 0;  mask >>= 1)
+    {
+        --n;
+    }
+    return n;
+}
+
+//--------------------------------------------------------------------------------------------------
+//  Class:
+//      flat_hash_iterator<T>
+//
+//  Summary:
+//      This class template implements a forward iterator over the full slots of a flat hash
+//      map.  It holds native pointers to a control byte and to the corresponding slot, so it is
+//      invalidated, like the map's references, by rehashing and by relocation of the heap.
+//--------------------------------------------------------------------------------------------------
+//
+template<class T>
+class flat_hash_iterator
+{
+  public:
+    using difference_type   = std::ptrdiff_t;
+    using value_type        = typename std::remove_const<T>::type;
+    using pointer           = T*;
+    using reference         = T&;
+    using iterator_category = std::forward_iterator_tag;
+    using ctrl_type         = flat_hash_group::ctrl_type;
+
+  public:
+    flat_hash_iterator() noexcept;
+    flat_hash_iterator(ctrl_type const* ctrl, ctrl_type const* ctrl_end, T* slot) noexcept;
+
+    template<class U, typename std::enable_if<std::is_convertible<U*, T*>::value, bool>::type = true>
+    flat_hash_iterator(flat_hash_iterator<U> const& other) noexcept;
+
+    reference   operator  *() const noexcept;
+    pointer     operator ->() const noexcept;
+
+    flat_hash_iterator&     operator ++() noexcept;
+    flat_hash_iterator      operator ++(int) noexcept;
+
+    ctrl_type const*    ctrl() const noexcept;
+
+  private:
+    template<class OT> friend class flat_hash_iterator;
+
+    void    skip_free() noexcept;
+
+    ctrl_type const*    m_ctrl;
+    ctrl_type const*    m_end;
+    T*                  m_slot;
+};
+
+//------
+//
+template<class T> inline
+flat_hash_iterator<T>::flat_hash_iterator() noexcept
+:   m_ctrl(nullptr)
+,   m_end(nullptr)
+,   m_slot(nullptr)
+{}
+
+template<class T> inline
+flat_hash_iterator<T>::flat_hash_iterator(ctrl_type const* ctrl, ctrl_type const* ctrl_end, T* slot) noexcept
+:   m_ctrl(ctrl)
+,   m_end(ctrl_end)
+,   m_slot(slot)
+{
+    skip_free();
+}
+
+template<class T>
+template<class U, typename std::enable_if<std::is_convertible<U*, T*>::value, bool>::type> inline
+flat_hash_iterator<T>::flat_hash_iterator(flat_hash_iterator<U> const& other) noexcept
+:   m_ctrl(other.m_ctrl)
+,   m_end(other.m_end)
+,   m_slot(other.m_slot)
+{}
+
+template<class T> inline
+typename flat_hash_iterator<T>::reference
+flat_hash_iterator<T>::operator *() const noexcept
+{
+    return *m_slot;
+}
+
+template<class T> inline
+typename flat_hash_iterator<T>::pointer
+flat_hash_iterator<T>::operator ->() const noexcept
+{
+    return m_slot;
+}
+
+template<class T> inline
+flat_hash_iterator<T>&
+flat_hash_iterator<T>::operator ++() noexcept
+{
+    ++m_ctrl;
+    ++m_slot;
+    skip_free();
+    return *this;
+}
+
+template<class T> inline
+flat_hash_iterator<T>
+flat_hash_iterator<T>::operator ++(int) noexcept
+{
+    flat_hash_iterator  tmp(*this);
+    ++*this;
+    return tmp;
+}
+
+template<class T> inline
+typename flat_hash_iterator<T>::ctrl_type const*
+flat_hash_iterator<T>::ctrl() const noexcept
+{
+    return m_ctrl;
+}
+
+template<class T> inline
+void
+flat_hash_iterator<T>::skip_free() noexcept
+{
+    while (m_ctrl != m_end  &&  *m_ctrl < 0)
+    {
+        ++m_ctrl;
+        ++m_slot;
+    }
+}
+
+//------
+//
+template<class T, class U> inline bool
+operator ==(flat_hash_iterator<T> const& lhs, flat_hash_iterator<U> const& rhs)
+{
+    return lhs.ctrl() == rhs.ctrl();
+}
+
+template<class T, class U> inline bool
+operator !=(flat_hash_iterator<T> const& lhs, flat_hash_iterator<U> const& rhs)
+{
+    return lhs.ctrl() != rhs.ctrl();
+}
+
+//--------------------------------------------------------------------------------------------------
+//  Class:
+//      flat_hash_map<K, V, HT, H, EQ>
+//
+//  Summary:
+//      This class template implements an unordered associative container using open addressing
+//      with SIMD probing of control bytes, after the "Swiss table" design.  The slots and their
+//      control bytes live in one array allocated by rhx_allocator from the allocation strategy
+//      HT: first the slots, then one control byte per slot, then a copy of the first sixteen
+//      control bytes, so that a group can be loaded at any slot without wrapping.  The array
+//      holds no pointers, so it is relocated by copying, and the map itself refers to it by a
+//      single synthetic pointer.
+//
+//      The capacity is a power of two of at least sixteen, and at most seven eighths of the
+//      slots are used before the map grows.  Erasing an element leaves a tombstone unless no
+//      probe sequence can have passed over its slot.  The hasher and key-equality predicate
+//      are default-constructed where they are needed, and so must be stateless.
+//--------------------------------------------------------------------------------------------------
+//
+template<class K, class V, class HT, class H = std::hash<K>, class EQ = std::equal_to<K>>
+class flat_hash_map
+{
+  public:
+    using key_type          = K;
+    using mapped_type       = V;
+    using value_type        = std::pair<K const, V>;
+    using hasher            = H;
+    using key_equal         = EQ;
+    using allocator_type    = rhx_allocator<value_type, HT>;
+    using size_type         = typename HT::size_type;
+    using difference_type   = typename HT::difference_type;
+    using reference         = value_type&;
+    using const_reference   = value_type const&;
+    using pointer           = typename allocator_type::pointer;
+    using iterator          = flat_hash_iterator<value_type>;
+    using const_iterator    = flat_hash_iterator<value_type const>;
+
+  public:
+    flat_hash_map() noexcept;
+    flat_hash_map(flat_hash_map const& other);
+    flat_hash_map(flat_hash_map&& other) noexcept;
+    ~flat_hash_map();
+
+    flat_hash_map&  operator =(flat_hash_map const& rhs);
+    flat_hash_map&  operator =(flat_hash_map&& rhs) noexcept;
+
+    iterator        begin() noexcept;
+    iterator        end() noexcept;
+    const_iterator  begin() const noexcept;
+    const_iterator  end() const noexcept;
+    const_iterator  cbegin() const noexcept;
+    const_iterator  cend() const noexcept;
+
+    bool        empty() const noexcept;
+    size_type   size() const noexcept;
+    size_type   capacity() const noexcept;
+    size_type   tombstones() const noexcept;
+    float       load_factor() const noexcept;
+
+    iterator        find(K const& key) noexcept;
+    const_iterator  find(K const& key) const noexcept;
+    size_type       count(K const& key) const noexcept;
+    V&              at(K const& key);
+    V const&        at(K const& key) const;
+    V&              operator [](K const& key);
+
+    std::pair<iterator, bool>   insert(value_type const& value);
+    template<class... Args>
+    std::pair<iterator, bool>   try_emplace(K const& key, Args&&... args);
+    template<class... Args>
+    std::pair<iterator, bool>   emplace(K const& key, Args&&... args);
+
+    iterator    erase(const_iterator pos) noexcept;
+    size_type   erase(K const& key) noexcept;
+    void        clear() noexcept;
+    void        reserve(size_type n);
+    void        swap(flat_hash_map& other) noexcept;
+
+  private:
+    using ctrl_type  = flat_hash_group::ctrl_type;
+    using group      = flat_hash_group;
+
+    static constexpr size_type  npos = ~size_type(0);
+
+    static std::uint64_t    hash_of(K const& key) noexcept;
+    static ctrl_type        h2_of(std::uint64_t hash) noexcept;
+    static size_type        array_size(size_type cap) noexcept;
+    static size_type        growth_limit(size_type cap) noexcept;
+
+    value_type*     slots() const noexcept;
+    ctrl_type*      ctrl() const noexcept;
+    iterator        iterator_at(size_type i) const noexcept;
+
+    size_type   find_index(K const& key, std::uint64_t hash) const noexcept;
+    size_type   find_free(std::uint64_t hash) const noexcept;
+    size_type   prepare_insert(std::uint64_t hash);
+    void        set_ctrl(size_type i, ctrl_type c) noexcept;
+    void        erase_at(size_type i) noexcept;
+    void        destroy_all() noexcept;
+    void        rehash(size_type new_cap);
+
+    pointer         m_array;        //- Slots, then control bytes
+    size_type       m_capacity;
+    size_type       m_size;
+    size_type       m_growth_left;  //- Empty slots that may still be filled before growing
+};
+
+//------
+//
+template<class K, class V, class HT, class H, class EQ> inline
+flat_hash_map<K, V, HT, H, EQ>::flat_hash_map() noexcept
+:   m_array(nullptr)
+,   m_capacity(0)
+,   m_size(0)
+,   m_growth_left(0)
+{}
+
+//- A copy has the same capacity as its source, so each element can be copied to the slot of
+//  the same index without rehashing.  Tombstones are copied too, since elements placed beyond
+//  them must remain reachable by their probe sequences.
+//
+template<class K, class V, class HT, class H, class EQ>
+flat_hash_map<K, V, HT, H, EQ>::flat_hash_map(flat_hash_map const& other)
+:   flat_hash_map()
+{
+    if (other.m_size == 0)
+    {
+        return;
+    }
+
+    RHX_TRACE(RHX_TRACE_DEFAULT_SITE("flat_hash_map copy"));
+
+    m_array       = allocator_type().allocate(array_size(other.m_capacity));
+    m_capacity    = other.m_capacity;
+    m_growth_left = other.m_growth_left;
+    std::memset(ctrl(), group::empty, m_capacity + group::width);
+
+    try
+    {
+        for (size_type i = 0;  i < m_capacity;  ++i)
+        {
+            if (other.ctrl()[i] >= 0)
+            {
+                ::new (static_cast<void*>(slots() + i)) value_type(other.slots()[i]);
+                set_ctrl(i, other.ctrl()[i]);
+                ++m_size;
+            }
+            else if (other.ctrl()[i] == group::deleted)
+            {
+                set_ctrl(i, group::deleted);
+            }
+        }
+    }
+    catch (...)
+    {
+        destroy_all();
+        throw;
+    }
+}
+
+template<class K, class V, class HT, class H, class EQ> inline
+flat_hash_map<K, V, HT, H, EQ>::flat_hash_map(flat_hash_map&& other) noexcept
+:   m_array(other.m_array)
+,   m_capacity(other.m_capacity)
+,   m_size(other.m_size)
+,   m_growth_left(other.m_growth_left)
+{
+    other.m_array       = nullptr;
+    other.m_capacity    = 0;
+    other.m_size        = 0;
+    other.m_growth_left = 0;
+}
+
+template<class K, class V, class HT, class H, class EQ> inline
+flat_hash_map<K, V, HT, H, EQ>::~flat_hash_map()
+{
+    destroy_all();
+}
+
+template<class K, class V, class HT, class H, class EQ> inline
+flat_hash_map<K, V, HT, H, EQ>&
+flat_hash_map<K, V, HT, H, EQ>::operator =(flat_hash_map const& rhs)
+{
+    if (this != &rhs)
+    {
+        flat_hash_map   tmp(rhs);
+        swap(tmp);
+    }
+    return *this;
+}
+
+template<class K, class V, class HT, class H, class EQ> inline
+flat_hash_map<K, V, HT, H, EQ>&
+flat_hash_map<K, V, HT, H, EQ>::operator =(flat_hash_map&& rhs) noexcept
+{
+    flat_hash_map   tmp(std::move(rhs));
+    swap(tmp);
+    return *this;
+}
+
+//------
+//
+template<class K, class V, class HT, class H, class EQ> inline
+typename flat_hash_map<K, V, HT, H, EQ>::iterator
+flat_hash_map<K, V, HT, H, EQ>::begin() noexcept
+{
+    return iterator_at(0);
+}
+
+template<class K, class V, class HT, class H, class EQ> inline
+typename flat_hash_map<K, V, HT, H, EQ>::iterator
+flat_hash_map<K, V, HT, H, EQ>::end() noexcept
+{
+    return iterator_at(m_capacity);
+}
+
+template<class K, class V, class HT, class H, class EQ> inline
+typename flat_hash_map<K, V, HT, H, EQ>::const_iterator
+flat_hash_map<K, V, HT, H, EQ>::begin() const noexcept
+{
+    return iterator_at(0);
+}
+
+template<class K, class V, class HT, class H, class EQ> inline
+typename flat_hash_map<K, V, HT, H, EQ>::const_iterator
+flat_hash_map<K, V, HT, H, EQ>::end() const noexcept
+{
+    return iterator_at(m_capacity);
+}
+
+template<class K, class V, class HT, class H, class EQ> inline
+typename flat_hash_map<K, V, HT, H, EQ>::const_iterator
+flat_hash_map<K, V, HT, H, EQ>::cbegin() const noexcept
+{
+    return begin();
+}
+
+template<class K, class V, class HT, class H, class EQ> inline
+typename flat_hash_map<K, V, HT, H, EQ>::const_iterator
+flat_hash_map<K, V, HT, H, EQ>::cend() const noexcept
+{
+    return end();
+}
+
+//------
+//
+template<class K, class V, class HT, class H, class EQ> inline
+bool
+flat_hash_map<K, V, HT, H, EQ>::empty() const noexcept
+{
+    return m_size == 0;
+}
+
+template<class K, class V, class HT, class H, class EQ> inline
+typename flat_hash_map<K, V, HT, H, EQ>::size_type
+flat_hash_map<K, V, HT, H, EQ>::size() const noexcept
+{
+    return m_size;
+}
+
+template<class K, class V, class HT, class H, class EQ> inline
+typename flat_hash_map<K, V, HT, H, EQ>::size_type
+flat_hash_map<K, V, HT, H, EQ>::capacity() const noexcept
+{
+    return m_capacity;
+}
+
+template<class K, class V, class HT, class H, class EQ> inline
+typename flat_hash_map<K, V, HT, H, EQ>::size_type
+flat_hash_map<K, V, HT, H, EQ>::tombstones() const noexcept
+{
+    return (m_capacity == 0) ? 0 : (growth_limit(m_capacity) - m_size - m_growth_left);
+}
+
+template<class K, class V, class HT, class H, class EQ> inline
+float
+flat_hash_map<K, V, HT, H, EQ>::load_factor() const noexcept
+{
+    return (m_capacity == 0) ? 0.0f : (float) m_size / (float) m_capacity;
+}
+
+//------
+//
+template<class K, class V, class HT, class H, class EQ> inline
+typename flat_hash_map<K, V, HT, H, EQ>::iterator
+flat_hash_map<K, V, HT, H, EQ>::find(K const& key) noexcept
+{
+    size_type   i = find_index(key, hash_of(key));
+    return (i == npos) ? end() : iterator_at(i);
+}
+
+template<class K, class V, class HT, class H, class EQ> inline
+typename flat_hash_map<K, V, HT, H, EQ>::const_iterator
+flat_hash_map<K, V, HT, H, EQ>::find(K const& key) const noexcept
+{
+    size_type   i = find_index(key, hash_of(key));
+    return (i == npos) ? end() : iterator_at(i);
+}
+
+template<class K, class V, class HT, class H, class EQ> inline
+typename flat_hash_map<K, V, HT, H, EQ>::size_type
+flat_hash_map<K, V, HT, H, EQ>::count(K const& key) const noexcept
+{
+    return (find_index(key, hash_of(key)) == npos) ? 0 : 1;
+}
+
+template<class K, class V, class HT, class H, class EQ>
+V&
+flat_hash_map<K, V, HT, H, EQ>::at(K const& key)
+{
+    size_type   i = find_index(key, hash_of(key));
+
+    if (i == npos)
+    {
+        throw std::out_of_range("flat_hash_map::at");
+    }
+    return slots()[i].second;
+}
+
+template<class K, class V, class HT, class H, class EQ> inline
+V const&
+flat_hash_map<K, V, HT, H, EQ>::at(K const& key) const
+{
+    return const_cast<flat_hash_map*>(this)->at(key);
+}
+
+template<class K, class V, class HT, class H, class EQ> inline
+V&
+flat_hash_map<K, V, HT, H, EQ>::operator [](K const& key)
+{
+    return try_emplace(key).first->second;
+}
+
+//------
+//
+template<class K, class V, class HT, class H, class EQ> inline
+std::pair<typename flat_hash_map<K, V, HT, H, EQ>::iterator, bool>
+flat_hash_map<K, V, HT, H, EQ>::insert(value_type const& value)
+{
+    return try_emplace(value.first, value.second);
+}
+
+//- Constructs an element from the key and the arguments only if the key is not present.  The
+//  slot's control byte is set only once the element is constructed, so a constructor that
+//  throws leaves the map unchanged, apart from possibly having grown.
+//
+template<class K, class V, class HT, class H, class EQ>
+template<class... Args>
+std::pair<typename flat_hash_map<K, V, HT, H, EQ>::iterator, bool>
+flat_hash_map<K, V, HT, H, EQ>::try_emplace(K const& key, Args&&... args)
+{
+    std::uint64_t   hash = hash_of(key);
+    size_type       i    = find_index(key, hash);
+
+    if (i != npos)
+    {
+        return { iterator_at(i), false };
+    }
+
+    i = prepare_insert(hash);
+    ::new (static_cast<void*>(slots() + i)) value_type(std::piecewise_construct,
+                                                       std::forward_as_tuple(key),
+                                                       std::forward_as_tuple(std::forward<Args>(args)...));
+    if (ctrl()[i] == group::empty)
+    {
+        --m_growth_left;
+    }
+    set_ctrl(i, h2_of(hash));
+    ++m_size;
+
+    return { iterator_at(i), true };
+}
+
+template<class K, class V, class HT, class H, class EQ>
+template<class... Args> inline
+std::pair<typename flat_hash_map<K, V, HT, H, EQ>::iterator, bool>
+flat_hash_map<K, V, HT, H, EQ>::emplace(K const& key, Args&&... args)
+{
+    return try_emplace(key, std::forward<Args>(args)...);
+}
+
+//------
+//
+template<class K, class V, class HT, class H, class EQ> inline
+typename flat_hash_map<K, V, HT, H, EQ>::iterator
+flat_hash_map<K, V, HT, H, EQ>::erase(const_iterator pos) noexcept
+{
+    size_type   i = (size_type) (pos.ctrl() - ctrl());
+
+    erase_at(i);
+    return iterator_at(i + 1);
+}
+
+template<class K, class V, class HT, class H, class EQ> inline
+typename flat_hash_map<K, V, HT, H, EQ>::size_type
+flat_hash_map<K, V, HT, H, EQ>::erase(K const& key) noexcept
+{
+    size_type   i = find_index(key, hash_of(key));
+
+    if (i == npos)
+    {
+        return 0;
+    }
+    erase_at(i);
+    return 1;
+}
+
+//- Destroys the elements but keeps the array, whose control bytes are all reset to empty.
+//
+template<class K, class V, class HT, class H, class EQ>
+void
+flat_hash_map<K, V, HT, H, EQ>::clear() noexcept
+{
+    if (m_capacity == 0)
+    {
+        return;
+    }
+
+    if (!std::is_trivially_destructible<value_type>::value)
+    {
+        for (size_type i = 0;  i < m_capacity;  ++i)
+        {
+            if (ctrl()[i] >= 0)
+            {
+                slots()[i].~value_type();
+            }
+        }
+    }
+
+    std::memset(ctrl(), group::empty, m_capacity + group::width);
+    m_size        = 0;
+    m_growth_left = growth_limit(m_capacity);
+}
+
+//- Grows the map, if need be, so that it can hold n elements without rehashing.
+//
+template<class K, class V, class HT, class H, class EQ>
+void
+flat_hash_map<K, V, HT, H, EQ>::reserve(size_type n)
+{
+    size_type   cap = group::width;
+
+    while (growth_limit(cap) < n)
+    {
+        cap *= 2;
+    }
+
+    if (cap > m_capacity)
+    {
+        rehash(cap);
+    }
+}
+
+template<class K, class V, class HT, class H, class EQ> inline
+void
+flat_hash_map<K, V, HT, H, EQ>::swap(flat_hash_map& other) noexcept
+{
+    std::swap(m_array, other.m_array);
+    std::swap(m_capacity, other.m_capacity);
+    std::swap(m_size, other.m_size);
+    std::swap(m_growth_left, other.m_growth_left);
+}
+
+//------
+//- The hasher's result is mixed so that hashers that return the key itself, as std::hash
+//  does for integers with some libraries, still spread keys across the table.  The low seven
+//  bits of the mixed hash are stored in the control byte, and the rest select the first group
+//  to probe.
+//
+template<class K, class V, class HT, class H, class EQ> inline
+std::uint64_t
+flat_hash_map<K, V, HT, H, EQ>::hash_of(K const& key) noexcept
+{
+    std::uint64_t   h = (std::uint64_t) H()(key) * 0x9E3779B97F4A7C15ull;
+    return h ^ (h >> 32);
+}
+
+template<class K, class V, class HT, class H, class EQ> inline
+typename flat_hash_map<K, V, HT, H, EQ>::ctrl_type
+flat_hash_map<K, V, HT, H, EQ>::h2_of(std::uint64_t hash) noexcept
+{
+    return (ctrl_type) (hash & 0x7F);
+}
+
+//- The number of value_type elements the array occupies: the slots, followed by the control
+//  bytes rounded up to a whole number of elements.
+//
+template<class K, class V, class HT, class H, class EQ> inline
+typename flat_hash_map<K, V, HT, H, EQ>::size_type
+flat_hash_map<K, V, HT, H, EQ>::array_size(size_type cap) noexcept
+{
+    return cap + (cap + group::width + sizeof(value_type) - 1) / sizeof(value_type);
+}
+
+template<class K, class V, class HT, class H, class EQ> inline
+typename flat_hash_map<K, V, HT, H, EQ>::size_type
+flat_hash_map<K, V, HT, H, EQ>::growth_limit(size_type cap) noexcept
+{
+    return cap - cap / 8;
+}
+
+//------
+//
+template<class K, class V, class HT, class H, class EQ> inline
+typename flat_hash_map<K, V, HT, H, EQ>::value_type*
+flat_hash_map<K, V, HT, H, EQ>::slots() const noexcept
+{
+    return static_cast<value_type*>(m_array);
+}
+
+template<class K, class V, class HT, class H, class EQ> inline
+typename flat_hash_map<K, V, HT, H, EQ>::ctrl_type*
+flat_hash_map<K, V, HT, H, EQ>::ctrl() const noexcept
+{
+    return reinterpret_cast<ctrl_type*>(slots() + m_capacity);
+}
+
+template<class K, class V, class HT, class H, class EQ> inline
+typename flat_hash_map<K, V, HT, H, EQ>::iterator
+flat_hash_map<K, V, HT, H, EQ>::iterator_at(size_type i) const noexcept
+{
+    if (m_capacity == 0)
+    {
+        return iterator();
+    }
+    return iterator(ctrl() + i, ctrl() + m_capacity, slots() + i);
+}
+
+//------
+//- Probes groups of control bytes, starting with the group at the slot chosen by the hash and
+//  moving on by a growing number of groups each time.  Since the capacity is a power of two
+//  and a multiple of the group width, this quadratic sequence reaches every group, and since
+//  the table is never full, every search ends at a group with an empty slot.
+//
+template<class K, class V, class HT, class H, class EQ>
+typename flat_hash_map<K, V, HT, H, EQ>::size_type
+flat_hash_map<K, V, HT, H, EQ>::find_index(K const& key, std::uint64_t hash) const noexcept
+{
+    if (m_capacity == 0)
+    {
+        return npos;
+    }
+
+    size_type const     mask  = m_capacity - 1;
+    ctrl_type const     h2    = h2_of(hash);
+    ctrl_type const*    pctrl = ctrl();
+    value_type const*   pslot = slots();
+    size_type           pos   = (size_type) (hash >> 7) & mask;
+    size_type           step  = 0;
+
+    for (;;)
+    {
+        group   g(pctrl + pos);
+
+        for (auto m = g.match(h2);  m != 0;  m &= m - 1)
+        {
+            size_type   i = (pos + group::lowest_bit(m)) & mask;
+
+            if (EQ()(pslot[i].first, key))
+            {
+                return i;
+            }
+        }
+
+        if (g.match_empty() != 0)
+        {
+            return npos;
+        }
+
+        step += group::width;
+        pos   = (pos + step) & mask;
+    }
+}
+
+template<class K, class V, class HT, class H, class EQ>
+typename flat_hash_map<K, V, HT, H, EQ>::size_type
+flat_hash_map<K, V, HT, H, EQ>::find_free(std::uint64_t hash) const noexcept
+{
+    size_type const     mask  = m_capacity - 1;
+    size_type           pos   = (size_type) (hash >> 7) & mask;
+    size_type           step  = 0;
+
+    for (;;)
+    {
+        auto    m = group(ctrl() + pos).match_free();
+
+        if (m != 0)
+        {
+            return (pos + group::lowest_bit(m)) & mask;
+        }
+
+        step += group::width;
+        pos   = (pos + step) & mask;
+    }
+}
+
+//- Finds the slot for a new element, first growing the map if the slot found is empty and no
+//  more empty slots may be filled.  If the elements would fill no more than 25/32 of the slots
+//  once the tombstones are dropped, the map is rehashed at the same capacity rather than grown.
+//
+template<class K, class V, class HT, class H, class EQ>
+typename flat_hash_map<K, V, HT, H, EQ>::size_type
+flat_hash_map<K, V, HT, H, EQ>::prepare_insert(std::uint64_t hash)
+{
+    if (m_capacity == 0)
+    {
+        rehash(group::width);
+    }
+
+    size_type   i = find_free(hash);
+
+    if (m_growth_left == 0  &&  ctrl()[i] == group::empty)
+    {
+        rehash((m_size * 32 <= m_capacity * 25) ? m_capacity : m_capacity * 2);
+        i = find_free(hash);
+    }
+    return i;
+}
+
+//- Sets a control byte, and its copy if it is one of the first group.
+//
+template<class K, class V, class HT, class H, class EQ> inline
+void
+flat_hash_map<K, V, HT, H, EQ>::set_ctrl(size_type i, ctrl_type c) noexcept
+{
+    ctrl_type*  pctrl = ctrl();
+
+    pctrl[i] = c;
+    if (i < group::width)
+    {
+        pctrl[m_capacity + i] = c;
+    }
+}
+
+//- A slot can be marked empty rather than deleted if the runs of non-empty slots on either
+//  side of it are together shorter than a group, since then no probe can have found every
+//  slot of a group full and passed over this one.
+//
+template<class K, class V, class HT, class H, class EQ>
+void
+flat_hash_map<K, V, HT, H, EQ>::erase_at(size_type i) noexcept
+{
+    size_type const     mask   = m_capacity - 1;
+    auto                before = group(ctrl() + ((i - group::width) & mask)).match_empty();
+    auto                after  = group(ctrl() + i).match_empty();
+    bool                reuse  = before != 0  &&  after != 0  &&
+                                 group::lowest_bit(after) + group::leading_zeros(before) < group::width;
+
+    slots()[i].~value_type();
+    set_ctrl(i, reuse ? (ctrl_type) group::empty : (ctrl_type) group::deleted);
+    m_growth_left += reuse ? 1 : 0;
+    --m_size;
+}
+
+template<class K, class V, class HT, class H, class EQ>
+void
+flat_hash_map<K, V, HT, H, EQ>::destroy_all() noexcept
+{
+    if (m_capacity != 0)
+    {
+        clear();
+        allocator_type().deallocate(m_array, array_size(m_capacity));
+        m_array       = nullptr;
+        m_capacity    = 0;
+        m_growth_left = 0;
+    }
+}
+
+//- Moves every element into a new array of the given capacity, which drops the tombstones.
+//  The new array is allocated before anything is moved, so a failed allocation leaves the map
+//  unchanged.
+//
+template<class K, class V, class HT, class H, class EQ>
+void
+flat_hash_map<K, V, HT, H, EQ>::rehash(size_type new_cap)
+{
+    RHX_TRACE(RHX_TRACE_DEFAULT_SITE("flat_hash_map rehash"));
+
+    flat_hash_map   tmp;
+
+    tmp.m_array       = allocator_type().allocate(array_size(new_cap));
+    tmp.m_capacity    = new_cap;
+    tmp.m_growth_left = growth_limit(new_cap);
+    std::memset(tmp.ctrl(), group::empty, new_cap + group::width);
+
+    for (size_type i = 0;  i < m_capacity;  ++i)
+    {
+        if (ctrl()[i] >= 0)
+        {
+            value_type&     elem = slots()[i];
+            std::uint64_t   hash = hash_of(elem.first);
+            size_type       j    = tmp.find_free(hash);
+
+            ::new (static_cast<void*>(tmp.slots() + j)) value_type(std::move_if_noexcept(const_cast<K&>(elem.first)),
+                                                                    std::move_if_noexcept(elem.second));
+            tmp.set_ctrl(j, h2_of(hash));
+            --tmp.m_growth_left;
+            ++tmp.m_size;
+        }
+    }
+
+    swap(tmp);
+}
+
+//------
+//
+template<class K, class V, class HT, class H, class EQ> inline
+void
+swap(flat_hash_map<K, V, HT, H, EQ>& lhs, flat_hash_map<K, V, HT, H, EQ>& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+
+#endif  //- FLAT_HASH_MAP_H_DEFINED
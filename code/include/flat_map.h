@@ -0,0 +1,1092 @@
+//==================================================================================================
+//  File:
+//      flat_map.h
+//
+//  Summary:
+//      Defines ordered associative containers that keep their keys, and their mapped values,
+//      in sorted vectors allocated by rhx_allocator, and the search indexes they use.
+//
+//  Copyright (c) 2017 Bob Steagall, KEWB Computing
+//==================================================================================================
+//
+#ifndef FLAT_MAP_H_DEFINED
+#define FLAT_MAP_H_DEFINED
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <numeric>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "rhx_allocator.h"
+
+//- Tag types that select how a flat container searches its keys, and a tag indicating that a
+//  range given to a constructor is already sorted and free of duplicate keys.
+//
+struct flat_binary_search {};
+struct flat_eytzinger_search {};
+
+struct flat_sorted_unique_t {};
+constexpr flat_sorted_unique_t  flat_sorted_unique{};
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      flat_lower_bound
+//
+//  Summary:
+//      Returns the position of the first of n sorted keys that is not less than a given key.
+//      Each step halves the range by selecting one of two bases, rather than by branching, so
+//      the loop's trip count depends only on n and there are no mispredicted branches.
+//--------------------------------------------------------------------------------------------------
+//
+template<class K, class C> inline
+std::size_t
+flat_lower_bound(K const* keys, std::size_t n, K const& key, C const& comp)
+{
+    if (n == 0)
+    {
+        return 0;
+    }
+
+    K const*    base = keys;
+
+    while (n > 1)
+    {
+        std::size_t     half = n / 2;
+
+        base  = comp(base[half], key) ? base + half : base;
+        n    -= half;
+    }
+    return (std::size_t) (base - keys) + (comp(*base, key) ? 1 : 0);
+}
+
+//--------------------------------------------------------------------------------------------------
+//  Class:
+//      flat_search_index<K, C, HT, S>
+//
+//  Summary:
+//      This class template provides the search of a flat container's sorted keys, as selected
+//      by the tag type S.  The container calls rebuild() whenever its keys change.
+//
+//      The binary search index has no state; it searches the sorted keys directly.
+//
+//      The Eytzinger index keeps a copy of the keys in the order of a breadth-first traversal
+//      of the implicit binary search tree over them, starting at position one, along with the
+//      sorted position of each.  The first levels of the tree share a few cache lines, and the
+//      descendants of a node a few levels down are adjacent, so they can be prefetched.  It
+//      costs a rebuild in linear time for every change, and is meant for containers that are
+//      built once and then searched many times.
+//--------------------------------------------------------------------------------------------------
+//
+template<class K, class C, class HT, class S>
+class flat_search_index;
+
+template<class K, class C, class HT>
+class flat_search_index<K, C, HT, flat_binary_search>
+{
+  public:
+    using size_type = typename HT::size_type;
+
+    void        rebuild(K const*, std::size_t) {}
+    void        clear() noexcept {}
+    size_type   footprint() const noexcept  { return 0; }
+
+    std::size_t lower_bound(K const* keys, std::size_t n, K const& key) const
+                {
+                    return flat_lower_bound(keys, n, key, C());
+                }
+};
+
+template<class K, class C, class HT>
+class flat_search_index<K, C, HT, flat_eytzinger_search>
+{
+  public:
+    using size_type = typename HT::size_type;
+
+    void        rebuild(K const* keys, std::size_t n);
+    void        clear() noexcept;
+    size_type   footprint() const noexcept;
+    std::size_t lower_bound(K const* keys, std::size_t n, K const& key) const;
+
+  private:
+    using key_vector  = std::vector<K, rhx_allocator<K, HT>>;
+    using rank_vector = std::vector<std::uint32_t, rhx_allocator<std::uint32_t, HT>>;
+
+    static constexpr std::size_t    prefetch_stride = (sizeof(K) < 64) ? (64 / sizeof(K)) : 1;
+
+    std::size_t     fill(K const* keys, std::size_t i, std::size_t k);
+
+    key_vector      m_keys;
+    rank_vector     m_ranks;
+};
+
+//------
+//
+template<class K, class C, class HT>
+void
+flat_search_index<K, C, HT, flat_eytzinger_search>::rebuild(K const* keys, std::size_t n)
+{
+    key_vector      new_keys;
+    rank_vector     new_ranks;
+
+    if (n != 0)
+    {
+        new_keys.resize(n + 1, keys[0]);
+        new_ranks.resize(n + 1);
+    }
+    m_keys.swap(new_keys);
+    m_ranks.swap(new_ranks);
+    fill(keys, 0, 1);
+}
+
+template<class K, class C, class HT> inline
+void
+flat_search_index<K, C, HT, flat_eytzinger_search>::clear() noexcept
+{
+    m_keys.clear();
+    m_ranks.clear();
+}
+
+template<class K, class C, class HT> inline
+typename flat_search_index<K, C, HT, flat_eytzinger_search>::size_type
+flat_search_index<K, C, HT, flat_eytzinger_search>::footprint() const noexcept
+{
+    return (size_type) (m_keys.capacity() * sizeof(K) + m_ranks.capacity() * sizeof(std::uint32_t));
+}
+
+//- Descends from the root, moving to the right child when the node's key is less than the
+//  given key.  The path ends below a leaf; the last node at which the descent went left, found
+//  by discarding the trailing right turns and the final left turn, holds the lower bound.
+//
+template<class K, class C, class HT>
+std::size_t
+flat_search_index<K, C, HT, flat_eytzinger_search>::lower_bound
+(K const*, std::size_t n, K const& key) const
+{
+    K const*        tree = m_keys.data();
+    std::size_t     k    = 1;
+    C               comp;
+
+    while (k <= n)
+    {
+#if defined(__GNUC__)
+        __builtin_prefetch(tree + k * prefetch_stride);
+#endif
+        k = 2 * k + (comp(tree[k], key) ? 1 : 0);
+    }
+    while (k & 1)
+    {
+        k >>= 1;
+    }
+    k >>= 1;
+
+    return (k == 0) ? n : m_ranks.data()[k];
+}
+
+//- Fills the subtree rooted at node k by an in-order traversal, taking the sorted keys in turn
+//  starting at position i, and returns the position of the next key.
+//
+template<class K, class C, class HT>
+std::size_t
+flat_search_index<K, C, HT, flat_eytzinger_search>::fill(K const* keys, std::size_t i, std::size_t k)
+{
+    if (k < m_keys.size())
+    {
+        i = fill(keys, i, 2 * k);
+        m_keys[k]  = keys[i];
+        m_ranks[k] = (std::uint32_t) i;
+        i = fill(keys, i + 1, 2 * k + 1);
+    }
+    return i;
+}
+
+//--------------------------------------------------------------------------------------------------
+//  Class:
+//      flat_set<K, HT, C, S>
+//
+//  Summary:
+//      This class template implements an ordered set as a sorted vector of keys, allocated by
+//      rhx_allocator from the allocation strategy HT, and searched by the index selected by
+//      the tag type S.  Construction from a range sorts the keys in place in the heap, so
+//      building a large set costs a single sort; inserting or erasing a single key moves the
+//      keys after it.  Its iterators are those of the vector, and are invalidated by any
+//      change to the set.
+//
+//      The set refers to its keys only by way of its vectors' synthetic pointers, so it can
+//      be relocated with the heap whenever they can.
+//--------------------------------------------------------------------------------------------------
+//
+template<class K, class HT, class C = std::less<K>, class S = flat_binary_search>
+class flat_set
+{
+  public:
+    using key_type          = K;
+    using value_type        = K;
+    using key_compare       = C;
+    using size_type         = typename HT::size_type;
+    using difference_type   = typename HT::difference_type;
+    using container_type    = std::vector<K, rhx_allocator<K, HT>>;
+    using iterator          = typename container_type::const_iterator;
+    using const_iterator    = typename container_type::const_iterator;
+
+  public:
+    flat_set();
+    explicit flat_set(container_type keys);
+    template<class InputIt>
+    flat_set(InputIt first, InputIt last);
+    template<class InputIt>
+    flat_set(flat_sorted_unique_t, InputIt first, InputIt last);
+
+    const_iterator  begin() const noexcept;
+    const_iterator  end() const noexcept;
+    const_iterator  cbegin() const noexcept;
+    const_iterator  cend() const noexcept;
+
+    bool        empty() const noexcept;
+    size_type   size() const noexcept;
+    size_type   footprint() const noexcept;
+
+    const_iterator  find(K const& key) const;
+    const_iterator  lower_bound(K const& key) const;
+    size_type       count(K const& key) const;
+
+    std::pair<iterator, bool>   insert(K const& key);
+    template<class InputIt>
+    void                        insert(InputIt first, InputIt last);
+
+    size_type   erase(K const& key);
+    void        clear() noexcept;
+    void        reserve(size_type n);
+    void        swap(flat_set& other) noexcept;
+
+    container_type const&   keys() const noexcept;
+
+  private:
+    using index_type = flat_search_index<K, C, HT, S>;
+
+    void            sort_unique();
+    std::size_t     position(K const& key) const;
+
+    container_type  m_keys;
+    index_type      m_index;
+};
+
+//------
+//
+template<class K, class HT, class C, class S> inline
+flat_set<K, HT, C, S>::flat_set()
+:   m_keys()
+,   m_index()
+{}
+
+template<class K, class HT, class C, class S>
+flat_set<K, HT, C, S>::flat_set(container_type keys)
+:   m_keys(std::move(keys))
+,   m_index()
+{
+    sort_unique();
+}
+
+template<class K, class HT, class C, class S>
+template<class InputIt>
+flat_set<K, HT, C, S>::flat_set(InputIt first, InputIt last)
+:   m_keys(first, last)
+,   m_index()
+{
+    sort_unique();
+}
+
+template<class K, class HT, class C, class S>
+template<class InputIt>
+flat_set<K, HT, C, S>::flat_set(flat_sorted_unique_t, InputIt first, InputIt last)
+:   m_keys(first, last)
+,   m_index()
+{
+    m_index.rebuild(m_keys.data(), m_keys.size());
+}
+
+//------
+//
+template<class K, class HT, class C, class S> inline
+typename flat_set<K, HT, C, S>::const_iterator
+flat_set<K, HT, C, S>::begin() const noexcept
+{
+    return m_keys.cbegin();
+}
+
+template<class K, class HT, class C, class S> inline
+typename flat_set<K, HT, C, S>::const_iterator
+flat_set<K, HT, C, S>::end() const noexcept
+{
+    return m_keys.cend();
+}
+
+template<class K, class HT, class C, class S> inline
+typename flat_set<K, HT, C, S>::const_iterator
+flat_set<K, HT, C, S>::cbegin() const noexcept
+{
+    return m_keys.cbegin();
+}
+
+template<class K, class HT, class C, class S> inline
+typename flat_set<K, HT, C, S>::const_iterator
+flat_set<K, HT, C, S>::cend() const noexcept
+{
+    return m_keys.cend();
+}
+
+//------
+//
+template<class K, class HT, class C, class S> inline
+bool
+flat_set<K, HT, C, S>::empty() const noexcept
+{
+    return m_keys.empty();
+}
+
+template<class K, class HT, class C, class S> inline
+typename flat_set<K, HT, C, S>::size_type
+flat_set<K, HT, C, S>::size() const noexcept
+{
+    return (size_type) m_keys.size();
+}
+
+//- The number of bytes of heap occupied by the keys and the index.
+//
+template<class K, class HT, class C, class S> inline
+typename flat_set<K, HT, C, S>::size_type
+flat_set<K, HT, C, S>::footprint() const noexcept
+{
+    return (size_type) (m_keys.capacity() * sizeof(K)) + m_index.footprint();
+}
+
+//------
+//
+template<class K, class HT, class C, class S> inline
+typename flat_set<K, HT, C, S>::const_iterator
+flat_set<K, HT, C, S>::find(K const& key) const
+{
+    std::size_t     i = position(key);
+
+    return (i == m_keys.size()  ||  C()(key, m_keys[i])) ? end() : begin() + i;
+}
+
+template<class K, class HT, class C, class S> inline
+typename flat_set<K, HT, C, S>::const_iterator
+flat_set<K, HT, C, S>::lower_bound(K const& key) const
+{
+    return begin() + position(key);
+}
+
+template<class K, class HT, class C, class S> inline
+typename flat_set<K, HT, C, S>::size_type
+flat_set<K, HT, C, S>::count(K const& key) const
+{
+    return (find(key) == end()) ? 0 : 1;
+}
+
+//------
+//
+template<class K, class HT, class C, class S>
+std::pair<typename flat_set<K, HT, C, S>::iterator, bool>
+flat_set<K, HT, C, S>::insert(K const& key)
+{
+    std::size_t     i = position(key);
+
+    if (i < m_keys.size()  &&  !C()(key, m_keys[i]))
+    {
+        return { begin() + i, false };
+    }
+
+    m_keys.insert(m_keys.begin() + i, key);
+    m_index.rebuild(m_keys.data(), m_keys.size());
+    return { begin() + i, true };
+}
+
+//- Appends the new keys and sorts the whole vector again; keys already present are kept.
+//
+template<class K, class HT, class C, class S>
+template<class InputIt>
+void
+flat_set<K, HT, C, S>::insert(InputIt first, InputIt last)
+{
+    m_keys.insert(m_keys.end(), first, last);
+    sort_unique();
+}
+
+template<class K, class HT, class C, class S>
+typename flat_set<K, HT, C, S>::size_type
+flat_set<K, HT, C, S>::erase(K const& key)
+{
+    std::size_t     i = position(key);
+
+    if (i == m_keys.size()  ||  C()(key, m_keys[i]))
+    {
+        return 0;
+    }
+
+    m_keys.erase(m_keys.begin() + i);
+    m_index.rebuild(m_keys.data(), m_keys.size());
+    return 1;
+}
+
+template<class K, class HT, class C, class S> inline
+void
+flat_set<K, HT, C, S>::clear() noexcept
+{
+    m_keys.clear();
+    m_index.clear();
+}
+
+template<class K, class HT, class C, class S> inline
+void
+flat_set<K, HT, C, S>::reserve(size_type n)
+{
+    m_keys.reserve(n);
+}
+
+template<class K, class HT, class C, class S> inline
+void
+flat_set<K, HT, C, S>::swap(flat_set& other) noexcept
+{
+    m_keys.swap(other.m_keys);
+    std::swap(m_index, other.m_index);
+}
+
+template<class K, class HT, class C, class S> inline
+typename flat_set<K, HT, C, S>::container_type const&
+flat_set<K, HT, C, S>::keys() const noexcept
+{
+    return m_keys;
+}
+
+//------
+//- Sorts the keys through the vector's iterators, which step by synthetic pointer, and
+//  removes all but the first of each run of equivalent keys.
+//
+template<class K, class HT, class C, class S>
+void
+flat_set<K, HT, C, S>::sort_unique()
+{
+    C   comp;
+
+    std::stable_sort(m_keys.begin(), m_keys.end(), comp);
+    m_keys.erase(std::unique(m_keys.begin(), m_keys.end(),
+                             [&comp](K const& a, K const& b) { return !comp(a, b); }),
+                 m_keys.end());
+    m_index.rebuild(m_keys.data(), m_keys.size());
+}
+
+template<class K, class HT, class C, class S> inline
+std::size_t
+flat_set<K, HT, C, S>::position(K const& key) const
+{
+    return m_index.lower_bound(m_keys.data(), m_keys.size(), key);
+}
+
+//--------------------------------------------------------------------------------------------------
+//  Class:
+//      flat_map_iterator<K, V>
+//
+//  Summary:
+//      This class template implements a bidirectional iterator over the elements of a flat
+//      map.  Since keys and values are stored in separate vectors, it does not yield references
+//      to pairs, but pairs of references.  It holds native pointers to a key and its value, so
+//      it is invalidated by any change to the map, and by relocation of the heap.
+//--------------------------------------------------------------------------------------------------
+//
+template<class K, class V>
+class flat_map_iterator
+{
+  public:
+    using difference_type   = std::ptrdiff_t;
+    using value_type        = std::pair<K const, typename std::remove_const<V>::type>;
+    using reference         = std::pair<K const&, V&>;
+    using iterator_category = std::bidirectional_iterator_tag;
+
+    struct pointer
+    {
+        reference   m_ref;
+        reference const*    operator ->() const noexcept { return &m_ref; }
+    };
+
+  public:
+    flat_map_iterator() noexcept;
+    flat_map_iterator(K const* key, V* value) noexcept;
+
+    template<class U, typename std::enable_if<std::is_convertible<U*, V*>::value, bool>::type = true>
+    flat_map_iterator(flat_map_iterator<K, U> const& other) noexcept;
+
+    reference   operator  *() const noexcept;
+    pointer     operator ->() const noexcept;
+
+    flat_map_iterator&  operator ++() noexcept;
+    flat_map_iterator   operator ++(int) noexcept;
+    flat_map_iterator&  operator --() noexcept;
+    flat_map_iterator   operator --(int) noexcept;
+
+    bool    equals(flat_map_iterator const& other) const noexcept;
+
+  private:
+    template<class OK, class OV> friend class flat_map_iterator;
+
+    K const*    m_key;
+    V*          m_value;
+};
+
+//------
+//
+template<class K, class V> inline
+flat_map_iterator<K, V>::flat_map_iterator() noexcept
+:   m_key(nullptr)
+,   m_value(nullptr)
+{}
+
+template<class K, class V> inline
+flat_map_iterator<K, V>::flat_map_iterator(K const* key, V* value) noexcept
+:   m_key(key)
+,   m_value(value)
+{}
+
+template<class K, class V>
+template<class U, typename std::enable_if<std::is_convertible<U*, V*>::value, bool>::type> inline
+flat_map_iterator<K, V>::flat_map_iterator(flat_map_iterator<K, U> const& other) noexcept
+:   m_key(other.m_key)
+,   m_value(other.m_value)
+{}
+
+template<class K, class V> inline
+typename flat_map_iterator<K, V>::reference
+flat_map_iterator<K, V>::operator *() const noexcept
+{
+    return reference(*m_key, *m_value);
+}
+
+template<class K, class V> inline
+typename flat_map_iterator<K, V>::pointer
+flat_map_iterator<K, V>::operator ->() const noexcept
+{
+    return pointer{**this};
+}
+
+template<class K, class V> inline
+flat_map_iterator<K, V>&
+flat_map_iterator<K, V>::operator ++() noexcept
+{
+    ++m_key;
+    ++m_value;
+    return *this;
+}
+
+template<class K, class V> inline
+flat_map_iterator<K, V>
+flat_map_iterator<K, V>::operator ++(int) noexcept
+{
+    flat_map_iterator   tmp(*this);
+    ++*this;
+    return tmp;
+}
+
+template<class K, class V> inline
+flat_map_iterator<K, V>&
+flat_map_iterator<K, V>::operator --() noexcept
+{
+    --m_key;
+    --m_value;
+    return *this;
+}
+
+template<class K, class V> inline
+flat_map_iterator<K, V>
+flat_map_iterator<K, V>::operator --(int) noexcept
+{
+    flat_map_iterator   tmp(*this);
+    --*this;
+    return tmp;
+}
+
+template<class K, class V> inline
+bool
+flat_map_iterator<K, V>::equals(flat_map_iterator const& other) const noexcept
+{
+    return m_key == other.m_key;
+}
+
+//------
+//
+template<class K, class V, class U> inline bool
+operator ==(flat_map_iterator<K, V> const& lhs, flat_map_iterator<K, U> const& rhs)
+{
+    using common = flat_map_iterator<K, typename std::add_const<V>::type>;
+    return common(lhs).equals(common(rhs));
+}
+
+template<class K, class V, class U> inline bool
+operator !=(flat_map_iterator<K, V> const& lhs, flat_map_iterator<K, U> const& rhs)
+{
+    return !(lhs == rhs);
+}
+
+//--------------------------------------------------------------------------------------------------
+//  Class:
+//      flat_map<K, V, HT, C, S>
+//
+//  Summary:
+//      This class template implements an ordered map as a sorted vector of keys and a
+//      parallel vector of mapped values, both allocated by rhx_allocator from the allocation
+//      strategy HT, with the keys searched by the index selected by the tag type S.  Keeping
+//      the keys apart from the values means that a search touches nothing but keys.
+//
+//      Construction from a range, or from a vector of keys and a vector of values, sorts a
+//      permutation of the elements in the heap and then gathers the keys and values in order;
+//      of several elements with equivalent keys, the first is kept, as std::map would.  Like
+//      flat_set, it is best suited to maps that are built once and then searched many times,
+//      and it can be relocated with the heap whenever its vectors can.
+//--------------------------------------------------------------------------------------------------
+//
+template<class K, class V, class HT, class C = std::less<K>, class S = flat_binary_search>
+class flat_map
+{
+  public:
+    using key_type              = K;
+    using mapped_type           = V;
+    using key_compare           = C;
+    using size_type             = typename HT::size_type;
+    using difference_type       = typename HT::difference_type;
+    using key_container_type    = std::vector<K, rhx_allocator<K, HT>>;
+    using mapped_container_type = std::vector<V, rhx_allocator<V, HT>>;
+    using iterator              = flat_map_iterator<K, V>;
+    using const_iterator        = flat_map_iterator<K, V const>;
+    using value_type            = typename iterator::value_type;
+    using reference             = typename iterator::reference;
+
+  public:
+    flat_map();
+    flat_map(key_container_type keys, mapped_container_type values);
+    template<class InputIt>
+    flat_map(InputIt first, InputIt last);
+    template<class InputIt>
+    flat_map(flat_sorted_unique_t, InputIt first, InputIt last);
+
+    iterator        begin() noexcept;
+    iterator        end() noexcept;
+    const_iterator  begin() const noexcept;
+    const_iterator  end() const noexcept;
+    const_iterator  cbegin() const noexcept;
+    const_iterator  cend() const noexcept;
+
+    bool        empty() const noexcept;
+    size_type   size() const noexcept;
+    size_type   footprint() const noexcept;
+
+    iterator        find(K const& key);
+    const_iterator  find(K const& key) const;
+    iterator        lower_bound(K const& key);
+    const_iterator  lower_bound(K const& key) const;
+    size_type       count(K const& key) const;
+    V&              at(K const& key);
+    V const&        at(K const& key) const;
+    V&              operator [](K const& key);
+
+    template<class... Args>
+    std::pair<iterator, bool>   try_emplace(K const& key, Args&&... args);
+    template<class... Args>
+    std::pair<iterator, bool>   emplace(K const& key, Args&&... args);
+    std::pair<iterator, bool>   insert(std::pair<K, V> const& value);
+    template<class InputIt>
+    void                        insert(InputIt first, InputIt last);
+
+    size_type   erase(K const& key);
+    void        clear() noexcept;
+    void        reserve(size_type n);
+    void        swap(flat_map& other) noexcept;
+
+    key_container_type const&       keys() const noexcept;
+    mapped_container_type const&    values() const noexcept;
+
+  private:
+    using index_type = flat_search_index<K, C, HT, S>;
+    using perm_type  = std::vector<size_type, rhx_allocator<size_type, HT>>;
+
+    void            sort_unique();
+    std::size_t     position(K const& key) const;
+    iterator        at_position(std::size_t i);
+
+    key_container_type      m_keys;
+    mapped_container_type   m_values;
+    index_type              m_index;
+};
+
+//------
+//
+template<class K, class V, class HT, class C, class S> inline
+flat_map<K, V, HT, C, S>::flat_map()
+:   m_keys()
+,   m_values()
+,   m_index()
+{}
+
+template<class K, class V, class HT, class C, class S>
+flat_map<K, V, HT, C, S>::flat_map(key_container_type keys, mapped_container_type values)
+:   m_keys(std::move(keys))
+,   m_values(std::move(values))
+,   m_index()
+{
+    if (m_keys.size() != m_values.size())
+    {
+        throw std::invalid_argument("flat_map: key and value counts differ");
+    }
+    sort_unique();
+}
+
+template<class K, class V, class HT, class C, class S>
+template<class InputIt>
+flat_map<K, V, HT, C, S>::flat_map(InputIt first, InputIt last)
+:   m_keys()
+,   m_values()
+,   m_index()
+{
+    insert(first, last);
+}
+
+template<class K, class V, class HT, class C, class S>
+template<class InputIt>
+flat_map<K, V, HT, C, S>::flat_map(flat_sorted_unique_t, InputIt first, InputIt last)
+:   m_keys()
+,   m_values()
+,   m_index()
+{
+    for (;  first != last;  ++first)
+    {
+        m_keys.push_back(first->first);
+        m_values.push_back(first->second);
+    }
+    m_index.rebuild(m_keys.data(), m_keys.size());
+}
+
+//------
+//
+template<class K, class V, class HT, class C, class S> inline
+typename flat_map<K, V, HT, C, S>::iterator
+flat_map<K, V, HT, C, S>::begin() noexcept
+{
+    return iterator(m_keys.data(), m_values.data());
+}
+
+template<class K, class V, class HT, class C, class S> inline
+typename flat_map<K, V, HT, C, S>::iterator
+flat_map<K, V, HT, C, S>::end() noexcept
+{
+    return iterator(m_keys.data() + m_keys.size(), m_values.data() + m_values.size());
+}
+
+template<class K, class V, class HT, class C, class S> inline
+typename flat_map<K, V, HT, C, S>::const_iterator
+flat_map<K, V, HT, C, S>::begin() const noexcept
+{
+    return const_cast<flat_map*>(this)->begin();
+}
+
+template<class K, class V, class HT, class C, class S> inline
+typename flat_map<K, V, HT, C, S>::const_iterator
+flat_map<K, V, HT, C, S>::end() const noexcept
+{
+    return const_cast<flat_map*>(this)->end();
+}
+
+template<class K, class V, class HT, class C, class S> inline
+typename flat_map<K, V, HT, C, S>::const_iterator
+flat_map<K, V, HT, C, S>::cbegin() const noexcept
+{
+    return begin();
+}
+
+template<class K, class V, class HT, class C, class S> inline
+typename flat_map<K, V, HT, C, S>::const_iterator
+flat_map<K, V, HT, C, S>::cend() const noexcept
+{
+    return end();
+}
+
+//------
+//
+template<class K, class V, class HT, class C, class S> inline
+bool
+flat_map<K, V, HT, C, S>::empty() const noexcept
+{
+    return m_keys.empty();
+}
+
+template<class K, class V, class HT, class C, class S> inline
+typename flat_map<K, V, HT, C, S>::size_type
+flat_map<K, V, HT, C, S>::size() const noexcept
+{
+    return (size_type) m_keys.size();
+}
+
+//- The number of bytes of heap occupied by the keys, the values, and the index.
+//
+template<class K, class V, class HT, class C, class S> inline
+typename flat_map<K, V, HT, C, S>::size_type
+flat_map<K, V, HT, C, S>::footprint() const noexcept
+{
+    return (size_type) (m_keys.capacity() * sizeof(K) + m_values.capacity() * sizeof(V))
+         + m_index.footprint();
+}
+
+//------
+//
+template<class K, class V, class HT, class C, class S> inline
+typename flat_map<K, V, HT, C, S>::iterator
+flat_map<K, V, HT, C, S>::find(K const& key)
+{
+    std::size_t     i = position(key);
+
+    return (i == m_keys.size()  ||  C()(key, m_keys[i])) ? end() : at_position(i);
+}
+
+template<class K, class V, class HT, class C, class S> inline
+typename flat_map<K, V, HT, C, S>::const_iterator
+flat_map<K, V, HT, C, S>::find(K const& key) const
+{
+    return const_cast<flat_map*>(this)->find(key);
+}
+
+template<class K, class V, class HT, class C, class S> inline
+typename flat_map<K, V, HT, C, S>::iterator
+flat_map<K, V, HT, C, S>::lower_bound(K const& key)
+{
+    return at_position(position(key));
+}
+
+template<class K, class V, class HT, class C, class S> inline
+typename flat_map<K, V, HT, C, S>::const_iterator
+flat_map<K, V, HT, C, S>::lower_bound(K const& key) const
+{
+    return const_cast<flat_map*>(this)->lower_bound(key);
+}
+
+template<class K, class V, class HT, class C, class S> inline
+typename flat_map<K, V, HT, C, S>::size_type
+flat_map<K, V, HT, C, S>::count(K const& key) const
+{
+    return (find(key) == end()) ? 0 : 1;
+}
+
+template<class K, class V, class HT, class C, class S>
+V&
+flat_map<K, V, HT, C, S>::at(K const& key)
+{
+    iterator    it = find(key);
+
+    if (it == end())
+    {
+        throw std::out_of_range("flat_map::at");
+    }
+    return it->second;
+}
+
+template<class K, class V, class HT, class C, class S> inline
+V const&
+flat_map<K, V, HT, C, S>::at(K const& key) const
+{
+    return const_cast<flat_map*>(this)->at(key);
+}
+
+template<class K, class V, class HT, class C, class S> inline
+V&
+flat_map<K, V, HT, C, S>::operator [](K const& key)
+{
+    return try_emplace(key).first->second;
+}
+
+//------
+//
+template<class K, class V, class HT, class C, class S>
+template<class... Args>
+std::pair<typename flat_map<K, V, HT, C, S>::iterator, bool>
+flat_map<K, V, HT, C, S>::try_emplace(K const& key, Args&&... args)
+{
+    std::size_t     i = position(key);
+
+    if (i < m_keys.size()  &&  !C()(key, m_keys[i]))
+    {
+        return { at_position(i), false };
+    }
+
+    m_values.emplace(m_values.begin() + i, std::forward<Args>(args)...);
+    try
+    {
+        m_keys.insert(m_keys.begin() + i, key);
+    }
+    catch (...)
+    {
+        m_values.erase(m_values.begin() + i);
+        throw;
+    }
+    m_index.rebuild(m_keys.data(), m_keys.size());
+
+    return { at_position(i), true };
+}
+
+template<class K, class V, class HT, class C, class S>
+template<class... Args> inline
+std::pair<typename flat_map<K, V, HT, C, S>::iterator, bool>
+flat_map<K, V, HT, C, S>::emplace(K const& key, Args&&... args)
+{
+    return try_emplace(key, std::forward<Args>(args)...);
+}
+
+template<class K, class V, class HT, class C, class S> inline
+std::pair<typename flat_map<K, V, HT, C, S>::iterator, bool>
+flat_map<K, V, HT, C, S>::insert(std::pair<K, V> const& value)
+{
+    return try_emplace(value.first, value.second);
+}
+
+//- Appends the new elements and sorts the whole map again; elements already present are kept.
+//
+template<class K, class V, class HT, class C, class S>
+template<class InputIt>
+void
+flat_map<K, V, HT, C, S>::insert(InputIt first, InputIt last)
+{
+    for (;  first != last;  ++first)
+    {
+        m_keys.push_back(first->first);
+        m_values.push_back(first->second);
+    }
+    sort_unique();
+}
+
+template<class K, class V, class HT, class C, class S>
+typename flat_map<K, V, HT, C, S>::size_type
+flat_map<K, V, HT, C, S>::erase(K const& key)
+{
+    std::size_t     i = position(key);
+
+    if (i == m_keys.size()  ||  C()(key, m_keys[i]))
+    {
+        return 0;
+    }
+
+    m_keys.erase(m_keys.begin() + i);
+    m_values.erase(m_values.begin() + i);
+    m_index.rebuild(m_keys.data(), m_keys.size());
+    return 1;
+}
+
+template<class K, class V, class HT, class C, class S> inline
+void
+flat_map<K, V, HT, C, S>::clear() noexcept
+{
+    m_keys.clear();
+    m_values.clear();
+    m_index.clear();
+}
+
+template<class K, class V, class HT, class C, class S> inline
+void
+flat_map<K, V, HT, C, S>::reserve(size_type n)
+{
+    m_keys.reserve(n);
+    m_values.reserve(n);
+}
+
+template<class K, class V, class HT, class C, class S> inline
+void
+flat_map<K, V, HT, C, S>::swap(flat_map& other) noexcept
+{
+    m_keys.swap(other.m_keys);
+    m_values.swap(other.m_values);
+    std::swap(m_index, other.m_index);
+}
+
+template<class K, class V, class HT, class C, class S> inline
+typename flat_map<K, V, HT, C, S>::key_container_type const&
+flat_map<K, V, HT, C, S>::keys() const noexcept
+{
+    return m_keys;
+}
+
+template<class K, class V, class HT, class C, class S> inline
+typename flat_map<K, V, HT, C, S>::mapped_container_type const&
+flat_map<K, V, HT, C, S>::values() const noexcept
+{
+    return m_values;
+}
+
+//------
+//- Sorts a permutation of the element positions, stored in the heap and stepped through by
+//  synthetic pointer, by the keys at those positions.  The sort is stable, so the first of
+//  each run of equivalent keys is the earliest inserted, and it alone is gathered into the
+//  new vectors.
+//
+template<class K, class V, class HT, class C, class S>
+void
+flat_map<K, V, HT, C, S>::sort_unique()
+{
+    C                       comp;
+    K*                      pkeys   = m_keys.data();
+    V*                      pvalues = m_values.data();
+    perm_type               perm(m_keys.size());
+    key_container_type      keys;
+    mapped_container_type   values;
+
+    std::iota(perm.begin(), perm.end(), (size_type) 0);
+    std::stable_sort(perm.begin(), perm.end(),
+                     [&comp, pkeys](size_type a, size_type b) { return comp(pkeys[a], pkeys[b]); });
+
+    keys.reserve(m_keys.size());
+    values.reserve(m_values.size());
+
+    for (size_type i : perm)
+    {
+        if (keys.empty()  ||  comp(keys.back(), pkeys[i]))
+        {
+            keys.push_back(std::move(pkeys[i]));
+            values.push_back(std::move(pvalues[i]));
+        }
+    }
+
+    m_keys.swap(keys);
+    m_values.swap(values);
+    m_index.rebuild(m_keys.data(), m_keys.size());
+}
+
+template<class K, class V, class HT, class C, class S> inline
+std::size_t
+flat_map<K, V, HT, C, S>::position(K const& key) const
+{
+    return m_index.lower_bound(m_keys.data(), m_keys.size(), key);
+}
+
+template<class K, class V, class HT, class C, class S> inline
+typename flat_map<K, V, HT, C, S>::iterator
+flat_map<K, V, HT, C, S>::at_position(std::size_t i)
+{
+    return iterator(m_keys.data() + i, m_values.data() + i);
+}
+
+//------
+//
+template<class K, class HT, class C, class S> inline
+void
+swap(flat_set<K, HT, C, S>& lhs, flat_set<K, HT, C, S>& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+
+template<class K, class V, class HT, class C, class S> inline
+void
+swap(flat_map<K, V, HT, C, S>& lhs, flat_map<K, V, HT, C, S>& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+
+#endif  //- FLAT_MAP_H_DEFINED
@@ -0,0 +1,576 @@
+//==================================================================================================
+//  File:
+//      heap_verifier.h
+//
+//  Summary:
+//      Defines a verifier for the segments of a storage model, which scans them in parallel for
+//      native addresses that would not survive relocation, and checks that the synthetic
+//      pointers reachable from a set of roots refer to allocated memory.
+//
+//  Copyright (c) 2017 Bob Steagall, KEWB Computing
+//==================================================================================================
+//
+#ifndef HEAP_VERIFIER_H_DEFINED
+#define HEAP_VERIFIER_H_DEFINED
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include "rhx_trace.h"
+#include "leaky_allocation_strategy.h"
+#include "slab_allocation_strategy.h"
+
+//--------------------------------------------------------------------------------------------------
+//  Struct:
+//      heap_issue
+//
+//  Summary:
+//      This struct describes a single problem found by heap_verifier<SM>.  Its location is the
+//      segment and offset of the offending word or pointer; the segment is zero for a pointer
+//      that lies outside the segments, such as a root on the stack.
+//--------------------------------------------------------------------------------------------------
+//
+struct heap_issue
+{
+    enum kind_type : int
+    {
+        raw_address,    //- A word in the heap holding the native address of heap memory
+        wild_pointer,   //- A synthetic pointer to memory outside the allocated part of the heap
+        freed_pointer   //- A synthetic pointer into a free block of the slab strategy
+    };
+
+    kind_type       m_kind;
+    std::size_t     m_segment;
+    std::size_t     m_offset;
+    void const*     m_value;        //- The address found, or the pointer's target
+};
+
+//--------------------------------------------------------------------------------------------------
+//  Struct:
+//      heap_report
+//
+//  Summary:
+//      This struct reports the results of a verification pass.  Every issue is counted, but
+//      only the first max_issues of them, in order of location, are recorded.
+//--------------------------------------------------------------------------------------------------
+//
+struct heap_report
+{
+    std::size_t                 m_bytes_scanned;
+    std::size_t                 m_pointers_checked;
+    std::size_t                 m_issue_count;
+    std::vector<heap_issue>     m_issues;
+
+    bool    ok() const noexcept     { return m_issue_count == 0; }
+};
+
+//--------------------------------------------------------------------------------------------------
+//  Class:
+//      heap_verifier<SM>
+//
+//  Summary:
+//      This class template verifies the contents of the segments of storage model SM, as they
+//      have been allocated by leaky_allocation_strategy<SM> and slab_allocation_strategy<SM>.
+//      It is meant to catch, before the buffers are swapped, the mistakes that corrupt the heap
+//      only afterward: native pointers stored in the heap, and synthetic pointers that have
+//      been copied as bytes where their representation depends on their location, as those of
+//      the offset addressing model do.
+//
+//      The raw address scan reads every aligned word of the allocated part of each segment, and
+//      reports those whose values lie within a segment.  Synthetic pointers of the relocatable
+//      addressing models never have such values, so the scan is meaningless for the wrapper
+//      model, whose pointers are native.  The segments are split into chunks that are scanned
+//      by a number of threads at once.
+//
+//      The pointer check needs to know where the synthetic pointers are, so, like
+//      slab_compactor<SM>, it traces everything reachable from a set of registered roots
+//      through the rhx_trace<T> registrations of their types.  Each pointer visited must refer
+//      to the allocated part of a segment, and not to a free block of the slab strategy; the
+//      targets of pointers that fail these checks are not traced further.
+//--------------------------------------------------------------------------------------------------
+//
+template<class SM>
+class heap_verifier
+{
+  public:
+    using addressing_model  = typename SM::addressing_model;
+    using size_type         = typename SM::size_type;
+
+    template<class T>
+    using pointer = syn_ptr<T, addressing_model>;
+
+    enum : size_type
+    {
+        chunk_size = 1u << 20,      //- Bytes scanned by a thread at a time
+        max_issues = 1000           //- Issues recorded in a report
+    };
+
+  public:
+    template<class T>
+    void    add_root(pointer<T>& root);
+    template<class T>
+    void    add_root(T& object);
+
+    template<class T>
+    void    operator ()(pointer<T>& ptr);
+
+    heap_report     scan_raw_addresses(unsigned thread_count = 0) const;
+    heap_report     check_pointers();
+    heap_report     verify(unsigned thread_count = 0);
+
+  private:
+    using bump_strategy = leaky_allocation_strategy<SM>;
+    using slab_strategy = slab_allocation_strategy<SM>;
+    using trace_fn      = void (*)(void* object, heap_verifier& visit);
+
+    struct work_item
+    {
+        void*       m_object;
+        trace_fn    m_trace;
+    };
+
+    struct scan_chunk
+    {
+        char const*     m_begin;
+        char const*     m_end;
+        size_type       m_segment;
+    };
+
+    struct address_range
+    {
+        std::uintptr_t  m_begin;
+        std::uintptr_t  m_end;
+    };
+
+    struct slab_span
+    {
+        char const*         m_base;
+        size_type           m_block_size;
+        std::vector<bool>   m_free;
+    };
+
+    std::vector<work_item>          m_roots;
+    std::vector<work_item>          m_work;
+    std::unordered_set<void*>       m_visited;
+    std::vector<slab_span>          m_slabs;
+    heap_report*                    mp_report = nullptr;
+
+    template<class T>
+    static  void    trace_thunk(void* object, heap_verifier& visit);
+    template<class T>
+    static  void    root_thunk(void* root, heap_verifier& visit);
+
+    static  void    scan(scan_chunk const& chunk, std::vector<address_range> const& ranges,
+                         std::vector<heap_issue>& issues, std::size_t& count);
+    static  void    record(heap_report& report, heap_issue const& issue);
+    static  void    finish(heap_report& report);
+
+    void        build_slab_table();
+    bool        check_target(void const* p, heap_issue::kind_type& kind);
+    slab_span*  find_slab(char const* p);
+};
+
+//------
+//- Registers a root pointer.
+//
+template<class SM>
+template<class T> inline
+void
+heap_verifier<SM>::add_root(pointer<T>& root)
+{
+    m_roots.push_back(work_item{std::addressof(root), &root_thunk<T>});
+}
+
+//- Registers an object, such as a container on the stack, whose pointers are checked.
+//
+template<class SM>
+template<class T> inline
+void
+heap_verifier<SM>::add_root(T& object)
+{
+    m_roots.push_back(work_item{std::addressof(object), &trace_thunk<T>});
+}
+
+//- Checks a synthetic pointer visited while tracing, and schedules its target to be traced if
+//  it refers to allocated memory.
+//
+template<class SM>
+template<class T>
+void
+heap_verifier<SM>::operator ()(pointer<T>& ptr)
+{
+    T*  target = static_cast<T*>(ptr);
+
+    if (target == nullptr)
+    {
+        return;
+    }
+
+    ++mp_report->m_pointers_checked;
+
+    heap_issue::kind_type   kind;
+
+    if (!check_target(target, kind))
+    {
+        heap_issue  issue{kind, 0, 0, target};
+
+        slab_strategy::locate(std::addressof(ptr), issue.m_segment, issue.m_offset);
+        record(*mp_report, issue);
+    }
+    else if (m_visited.insert(target).second)
+    {
+        m_work.push_back(work_item{target, &trace_thunk<T>});
+    }
+}
+
+//------
+//- Splits the allocated part of each segment into chunks and scans them with the given number
+//  of threads, or with one per hardware thread if it is zero.  The calling thread is one of
+//  them.
+//
+template<class SM>
+heap_report
+heap_verifier<SM>::scan_raw_addresses(unsigned thread_count) const
+{
+    heap_report                 report{0, 0, 0, {}};
+    std::vector<scan_chunk>     chunks;
+    std::vector<address_range>  ranges;
+    auto                        mark = bump_strategy::mark();
+
+    for (size_type i = SM::first_segment_index();  i <= SM::last_segment_index();  ++i)
+    {
+        char const*     base = SM::segment_address(i);
+
+        if (base == nullptr)
+        {
+            continue;
+        }
+
+        ranges.push_back(address_range{reinterpret_cast<std::uintptr_t>(base),
+                                       reinterpret_cast<std::uintptr_t>(base + SM::segment_size(i))});
+
+        if (i <= mark.m_segment)
+        {
+            char const*     end = base + ((i == mark.m_segment) ? mark.m_offset : SM::segment_size(i));
+
+            for (char const* p = base + 64;  p < end;  p += chunk_size)
+            {
+                chunks.push_back(scan_chunk{p, std::min(p + chunk_size, end), i});
+                report.m_bytes_scanned += chunks.back().m_end - p;
+            }
+        }
+    }
+
+    if (thread_count == 0)
+    {
+        thread_count = std::max(1u, std::thread::hardware_concurrency());
+    }
+    thread_count = (unsigned) std::max<std::size_t>(1, std::min<std::size_t>(thread_count, chunks.size()));
+
+    std::atomic<std::size_t>    next_chunk(0);
+    std::mutex                  report_mutex;
+    std::vector<std::thread>    threads;
+
+    auto    worker = [&]()
+    {
+        std::vector<heap_issue>     issues;
+        std::size_t                 count = 0;
+
+        for (std::size_t i;  (i = next_chunk.fetch_add(1)) < chunks.size();  )
+        {
+            scan(chunks[i], ranges, issues, count);
+        }
+
+        std::lock_guard<std::mutex>     lock(report_mutex);
+
+        report.m_issue_count += count;
+        report.m_issues.insert(report.m_issues.end(), issues.begin(), issues.end());
+    };
+
+    for (unsigned i = 1;  i < thread_count;  ++i)
+    {
+        threads.emplace_back(worker);
+    }
+    worker();
+
+    for (std::thread& t : threads)
+    {
+        t.join();
+    }
+
+    finish(report);
+    return report;
+}
+
+//- Traces everything reachable from the roots, checking each synthetic pointer on the way.
+//
+template<class SM>
+heap_report
+heap_verifier<SM>::check_pointers()
+{
+    heap_report     report{0, 0, 0, {}};
+
+    mp_report = &report;
+    build_slab_table();
+
+    for (work_item const& root : m_roots)
+    {
+        if (m_visited.insert(root.m_object).second)
+        {
+            m_work.push_back(root);
+        }
+    }
+
+    while (!m_work.empty())
+    {
+        work_item   item = m_work.back();
+
+        m_work.pop_back();
+        item.m_trace(item.m_object, *this);
+    }
+
+    m_visited.clear();
+    m_slabs.clear();
+    mp_report = nullptr;
+
+    finish(report);
+    return report;
+}
+
+//- Performs both checks, and combines their reports.
+//
+template<class SM>
+heap_report
+heap_verifier<SM>::verify(unsigned thread_count)
+{
+    heap_report     report = check_pointers();
+    heap_report     scanned = scan_raw_addresses(thread_count);
+
+    report.m_bytes_scanned = scanned.m_bytes_scanned;
+    report.m_issue_count  += scanned.m_issue_count;
+    report.m_issues.insert(report.m_issues.end(), scanned.m_issues.begin(), scanned.m_issues.end());
+
+    finish(report);
+    return report;
+}
+
+//------
+//
+template<class SM>
+template<class T>
+void
+heap_verifier<SM>::trace_thunk(void* object, heap_verifier& visit)
+{
+    rhx_trace<T>::trace(*static_cast<T*>(object), visit);
+}
+
+template<class SM>
+template<class T>
+void
+heap_verifier<SM>::root_thunk(void* root, heap_verifier& visit)
+{
+    visit(*static_cast<pointer<T>*>(root));
+}
+
+//- Scans the aligned words of a chunk for values within any of the given address ranges.  The
+//  ranges are first tested as a whole, since nearly every word lies outside all of them.
+//
+template<class SM>
+void
+heap_verifier<SM>::scan(scan_chunk const& chunk, std::vector<address_range> const& ranges,
+                        std::vector<heap_issue>& issues, std::size_t& count)
+{
+    std::uintptr_t  lo = ~std::uintptr_t(0);
+    std::uintptr_t  hi = 0;
+
+    for (address_range const& r : ranges)
+    {
+        lo = std::min(lo, r.m_begin);
+        hi = std::max(hi, r.m_end);
+    }
+
+    char const*     base = SM::segment_address(chunk.m_segment);
+
+    for (char const* p = chunk.m_begin;  p + sizeof(std::uintptr_t) <= chunk.m_end;  p += sizeof(std::uintptr_t))
+    {
+        std::uintptr_t  word;
+
+        std::memcpy(&word, p, sizeof(word));
+
+        if (word - lo >= hi - lo)
+        {
+            continue;
+        }
+
+        for (address_range const& r : ranges)
+        {
+            if (r.m_begin <= word  &&  word < r.m_end)
+            {
+                if (issues.size() < max_issues)
+                {
+                    issues.push_back(heap_issue{heap_issue::raw_address, chunk.m_segment,
+                                                (std::size_t)(p - base), reinterpret_cast<void const*>(word)});
+                }
+                ++count;
+                break;
+            }
+        }
+    }
+}
+
+template<class SM> inline
+void
+heap_verifier<SM>::record(heap_report& report, heap_issue const& issue)
+{
+    if (report.m_issues.size() < max_issues)
+    {
+        report.m_issues.push_back(issue);
+    }
+    ++report.m_issue_count;
+}
+
+//- Orders the recorded issues by location, and keeps the first max_issues of them.
+//
+template<class SM>
+void
+heap_verifier<SM>::finish(heap_report& report)
+{
+    std::sort(report.m_issues.begin(), report.m_issues.end(),
+              [](heap_issue const& a, heap_issue const& b)
+              {
+                  return (a.m_segment != b.m_segment) ? (a.m_segment < b.m_segment) : (a.m_offset < b.m_offset);
+              });
+
+    if (report.m_issues.size() > max_issues)
+    {
+        report.m_issues.resize(max_issues);
+    }
+}
+
+//------
+//- Builds a table of the slabs of the slab strategy, sorted by address, marking the blocks on
+//  the free lists and in the uncarved remainder of each bin's current slab as free, and the
+//  spare slabs as wholly free.  The table is empty if the strategy's slabs have been released.
+//
+template<class SM>
+void
+heap_verifier<SM>::build_slab_table()
+{
+    if (slab_strategy::sm_epoch != bump_strategy::epoch())
+    {
+        return;
+    }
+
+    for (size_type bin = 0;  bin < slab_strategy::bin_count;  ++bin)
+    {
+        size_type   block_size = slab_strategy::block_size(bin);
+
+        for (auto const& ref : slab_strategy::sm_slabs[bin])
+        {
+            m_slabs.push_back(slab_span{SM::segment_address(ref.m_segment) + ref.m_offset, block_size,
+                                        std::vector<bool>(slab_strategy::slab_size / block_size, false)});
+        }
+    }
+
+    for (auto const& ref : slab_strategy::sm_spare_slabs)
+    {
+        m_slabs.push_back(slab_span{SM::segment_address(ref.m_segment) + ref.m_offset,
+                                    slab_strategy::slab_size, std::vector<bool>(1, true)});
+    }
+
+    std::sort(m_slabs.begin(), m_slabs.end(),
+              [](slab_span const& a, slab_span const& b) { return a.m_base < b.m_base; });
+
+    auto    set_free = [this](char const* p)
+    {
+        if (slab_span* slab = find_slab(p))
+        {
+            slab->m_free[(p - slab->m_base) / slab->m_block_size] = true;
+        }
+    };
+
+    for (size_type bin = 0;  bin < slab_strategy::bin_count;  ++bin)
+    {
+        size_type       block_size = slab_strategy::block_size(bin);
+        char const*     next = static_cast<char*>(slab_strategy::sm_slab_next[bin]);
+
+        if (next != nullptr)
+        {
+            for (size_type left = slab_strategy::sm_slab_left[bin];  left >= block_size;  left -= block_size)
+            {
+                set_free(next);
+                next += block_size;
+            }
+        }
+
+        for (void* p = slab_strategy::sm_free_list[bin];  p != nullptr;
+             p = *static_cast<typename slab_strategy::void_pointer*>(p))
+        {
+            set_free(static_cast<char const*>(p));
+        }
+    }
+}
+
+//- Determines whether the target of a pointer is allocated memory, and the kind of issue if it
+//  is not.  A target must lie in a segment, past its unused header and below the bump
+//  strategy's cursor, and not in a free slab block.
+//
+template<class SM>
+bool
+heap_verifier<SM>::check_target(void const* p, heap_issue::kind_type& kind)
+{
+    size_type   segment, offset;
+    auto        mark = bump_strategy::mark();
+
+    slab_strategy::locate(p, segment, offset);
+
+    if (segment == 0  ||  segment > mark.m_segment  ||  offset < 64  ||
+        (segment == mark.m_segment  &&  offset >= mark.m_offset))
+    {
+        kind = heap_issue::wild_pointer;
+        return false;
+    }
+
+    char const*     pc = static_cast<char const*>(p);
+
+    if (slab_span* slab = find_slab(pc))
+    {
+        if (slab->m_free[(pc - slab->m_base) / slab->m_block_size])
+        {
+            kind = heap_issue::freed_pointer;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+//- Finds the slab containing an address, if any.
+//
+template<class SM>
+typename heap_verifier<SM>::slab_span*
+heap_verifier<SM>::find_slab(char const* p)
+{
+    auto    it = std::upper_bound(m_slabs.begin(), m_slabs.end(), p,
+                    [](char const* a, slab_span const& s) { return a < s.m_base; });
+
+    if (it == m_slabs.begin())
+    {
+        return nullptr;
+    }
+    --it;
+
+    size_type   index = (p - it->m_base) / it->m_block_size;
+
+    return (p < it->m_base + slab_strategy::slab_size  &&  index < it->m_free.size()) ? &*it : nullptr;
+}
+
+#endif  //- HEAP_VERIFIER_H_DEFINED
@@ -13,8 +13,12 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
 
 #include "synthetic_pointer.h"
+#include "allocation_stats.h"
 
 //--------------------------------------------------------------------------------------------------
 //  Class:
@@ -23,6 +27,9 @@
 //  Summary:
 //      This class implements a simple leaky allocation strategy for testing purposes.  It relies
 //      on the interface provided by storage_model_base and its derived types.
+//
+//      When built with RHX_ALLOCATION_STATS defined, it keeps allocation statistics for each
+//      storage model, which can be queried with stats() or dumped with dump_allocation_stats().
 //--------------------------------------------------------------------------------------------------
 //
 template<class SM>
@@ -39,20 +46,45 @@ class leaky_allocation_strategy
     template<class T>
     using rebind_pointer        = syn_ptr<T, addressing_model>;
 
+    //- A position in the buffers, used to roll back allocations in a single step.
+    //
+    struct marker
+    {
+        size_type   m_segment;
+        size_type   m_offset;
+    };
+
+    class scope;
+
+    enum : size_type
+    {
+        min_alignment = 16          //- Every chunk is aligned to at least this boundary
+    };
+
   public:
     size_type       max_size() const;
 
-    void_pointer    allocate(size_type n);
-    void            deallocate(void_pointer p);
+    void_pointer    allocate(size_type n, size_type alignment = min_alignment);
+    void            deallocate(void_pointer p, size_type n, size_type alignment = min_alignment);
+    bool            try_expand(void_pointer p, size_type old_n, size_type new_n);
+
+    static  marker      mark();
+    static  void        rollback(marker const& m);
+    static  size_type   epoch();
+
+    static  allocation_stats&   stats();
 
     static  void    reset_buffers();
     static  void    swap_buffers();
 
   private:
+    static  void                initialize();
     static  difference_type     round_up(difference_type x, difference_type r);
+    static  size_type           position(size_type segment, size_type offset);
 
     static  size_type   sm_curr_segment;
     static  size_type   sm_curr_offset;
+    static  size_type   sm_epoch;
     static  bool        sm_initialized;
 };
 
@@ -64,54 +96,170 @@ template<class SM>  typename leaky_allocation_strategy<SM>::size_type
 template<class SM>  typename leaky_allocation_strategy<SM>::size_type
 leaky_allocation_strategy<SM>::sm_curr_offset = 0;
 
+template<class SM>  typename leaky_allocation_strategy<SM>::size_type
+leaky_allocation_strategy<SM>::sm_epoch = 0;
+
 template<class SM>  bool
 leaky_allocation_strategy<SM>::sm_initialized = false;
 
 //------
+//- Chunks never span segments, and the first 64 bytes of each segment are unused, so this is
+//  the largest chunk that can be allocated.
 //
 template<class SM> inline
 typename leaky_allocation_strategy<SM>::size_type
 leaky_allocation_strategy<SM>::max_size() const
 {
-    return storage_model::max_segment_size();
+    return storage_model::max_segment_size() - 64;
 }
 
 //------
+//- Segments are aligned to the storage model's segment_alignment, so aligning a chunk's offset
+//  aligns its address.  Alignments larger than that, or not a power of two, cannot be honored.
+//  Nor can requests larger than a segment, or any request once the last segment is full.  The
+//  next segment is created when allocation first moves into it.
 //
 template<class SM>
 typename leaky_allocation_strategy<SM>::void_pointer
-leaky_allocation_strategy<SM>::allocate(size_type n)
+leaky_allocation_strategy<SM>::allocate(size_type n, size_type alignment)
 {
     if (!sm_initialized)
     {
-        storage_model::init_segments();
-        sm_curr_segment = storage_model::first_segment_index();
-        sm_curr_offset  = 64;
-        sm_initialized  = true;
+        initialize();
+    }
+
+    if (alignment < min_alignment)
+    {
+        alignment = min_alignment;
+    }
+    else if (alignment > storage_model::segment_alignment  ||  (alignment & (alignment - 1)) != 0)
+    {
+        throw std::bad_alloc();
+    }
+
+    if (n > max_size()  ||  (size_type) (round_up(64, alignment) + round_up(n, 16u)) > storage_model::max_segment_size())
+    {
+        throw std::bad_alloc();
     }
 
     size_type   chunk_size   = round_up(n, 16u);
-    size_type   chunk_offset = sm_curr_offset;
+    size_type   chunk_start  = sm_curr_offset;
+    size_type   chunk_offset = round_up(chunk_start, alignment);
 
     if ((chunk_offset + chunk_size) > storage_model::max_segment_size())
     {
+        if (!storage_model::ensure_segment(sm_curr_segment + 1))
+        {
+            throw std::bad_alloc();
+        }
+
+        RHX_STATS(stats().record_rollover(storage_model::max_segment_size() - sm_curr_offset + 64));
         ++sm_curr_segment;
-        chunk_offset   = 64;
-        sm_curr_offset = chunk_offset + chunk_size;
-    }
-    else
-    {
-        sm_curr_offset += chunk_size;
+        chunk_start  = 64;
+        chunk_offset = round_up(64, alignment);
     }
 
+    sm_curr_offset = chunk_offset + chunk_size;
+
+    RHX_STATS(stats().record_allocate(n, chunk_size, chunk_offset - chunk_start));
+    RHX_STATS(stats().record_fill(sm_curr_segment, sm_curr_offset));
+
     return storage_model::segment_pointer(sm_curr_segment, chunk_offset);
 }
 
 template<class SM> inline
 void
-leaky_allocation_strategy<SM>::deallocate(void_pointer)
+leaky_allocation_strategy<SM>::deallocate(void_pointer, size_type, size_type)
 {}
 
+//------
+//- Attempts to resize an existing chunk in place.  Only the most recently allocated chunk can
+//  be resized, since it is the only one that borders the unallocated remainder of the current
+//  segment; resizing it is simply a matter of moving the current offset.
+//
+template<class SM>
+bool
+leaky_allocation_strategy<SM>::try_expand(void_pointer p, size_type old_n, size_type new_n)
+{
+    if (!sm_initialized  ||  p == nullptr)
+    {
+        return false;
+    }
+
+    char*       pchunk   = static_cast<char*>(static_cast<void*>(p));
+    char*       pbase    = storage_model::segment_address(sm_curr_segment);
+    size_type   old_size = round_up(old_n, 16u);
+    size_type   new_size = round_up(new_n, 16u);
+
+    if (pbase == nullptr  ||  (pchunk + old_size) != (pbase + sm_curr_offset))
+    {
+        return false;
+    }
+
+    size_type   chunk_offset = pchunk - pbase;
+
+    if ((chunk_offset + new_size) > storage_model::max_segment_size())
+    {
+        return false;
+    }
+
+    sm_curr_offset = chunk_offset + new_size;
+
+    RHX_STATS(stats().record_expand(old_size, new_size));
+    RHX_STATS(stats().record_fill(sm_curr_segment, sm_curr_offset));
+    return true;
+}
+
+//------
+//- Markers capture the current position in the buffers.  Rolling back to a marker releases
+//  everything allocated since it was taken; markers must be rolled back in LIFO order.
+//
+template<class SM> inline
+typename leaky_allocation_strategy<SM>::marker
+leaky_allocation_strategy<SM>::mark()
+{
+    if (!sm_initialized)
+    {
+        initialize();
+    }
+
+    return marker{sm_curr_segment, sm_curr_offset};
+}
+
+template<class SM> inline
+void
+leaky_allocation_strategy<SM>::rollback(marker const& m)
+{
+    RHX_STATS(stats().record_release(position(sm_curr_segment, sm_curr_offset) -
+                                     position(m.m_segment, m.m_offset)));
+    sm_curr_segment = m.m_segment;
+    sm_curr_offset  = m.m_offset;
+    ++sm_epoch;
+}
+
+//------
+//- The epoch changes whenever previously allocated memory is released in bulk, by rolling back
+//  or resetting the buffers.  Strategies layered over this one use it to discard any state
+//  that refers to released memory.
+//
+template<class SM> inline
+typename leaky_allocation_strategy<SM>::size_type
+leaky_allocation_strategy<SM>::epoch()
+{
+    return sm_epoch;
+}
+
+//------
+//- The statistics are kept per storage model, since every storage model has its own cursor.
+//
+template<class SM>
+allocation_stats&
+leaky_allocation_strategy<SM>::stats()
+{
+    static allocation_stats     s("leaky", storage_model::model_name());
+    return s;
+}
+
 //------
 //
 template<class SM> inline
@@ -121,6 +269,8 @@ leaky_allocation_strategy<SM>::reset_buffers()
     storage_model::reset_segments();
     sm_curr_segment = storage_model::first_segment_index();
     sm_curr_offset  = 64;
+    ++sm_epoch;
+    RHX_STATS(stats().record_reset());
 }
 
 template<class SM> inline
@@ -132,6 +282,17 @@ leaky_allocation_strategy<SM>::swap_buffers()
 
 //------
 //
+template<class SM>
+void
+leaky_allocation_strategy<SM>::initialize()
+{
+    storage_model::init_segments();
+    sm_curr_segment = storage_model::first_segment_index();
+    sm_curr_offset  = 64;
+    sm_initialized  = true;
+    RHX_STATS(stats().record_reset());
+}
+
 template<class SM> inline
 typename leaky_allocation_strategy<SM>::difference_type
 leaky_allocation_strategy<SM>::round_up(difference_type x, difference_type r)
@@ -139,4 +300,135 @@ leaky_allocation_strategy<SM>::round_up(difference_type x, difference_type r)
     return (x % r) ? (x + r - (x % r)) : x;
 }
 
+//- Returns the number of bytes consumed from the segments up to the given position, counting
+//  each segment as full once allocation has moved past it.
+//
+template<class SM> inline
+typename leaky_allocation_strategy<SM>::size_type
+leaky_allocation_strategy<SM>::position(size_type segment, size_type offset)
+{
+    return (segment - storage_model::first_segment_index()) * storage_model::max_segment_size() + offset;
+}
+
+//--------------------------------------------------------------------------------------------------
+//  Class:
+//      leaky_allocation_strategy<SM>::scope
+//
+//  Summary:
+//      This class implements an RAII arena scope.  It marks the strategy's current position on
+//      construction and rolls back to it on destruction, so that everything allocated during
+//      the scope's lifetime is released with a single store and no clearing of memory.  Scopes
+//      may be nested, provided that they are destroyed in the reverse order of construction.
+//
+//      Objects made by create() are destroyed, in reverse order of creation, before the scope
+//      rolls back.  Objects of trivially-destructible type are not recorded for destruction,
+//      so creating them costs no more than the underlying allocation.  Objects allocated by
+//      other means (e.g., by containers using rhx_allocator) are simply abandoned.
+//--------------------------------------------------------------------------------------------------
+//
+template<class SM>
+class leaky_allocation_strategy<SM>::scope
+{
+  public:
+    scope();
+    ~scope();
+
+    scope(scope const&) = delete;
+    scope&  operator =(scope const&) = delete;
+
+    template<class T, class... Args>
+    rebind_pointer<T>   create(Args&&... args);
+
+    void    release();
+
+  private:
+    struct cleanup_record
+    {
+        void_pointer    m_next;
+        void_pointer    m_object;
+        void          (*m_destroy)(void*);
+    };
+
+    template<class T>
+    static  void    destroy_object(void* p);
+
+    marker          m_mark;
+    void_pointer    m_cleanup;
+};
+
+//------
+//
+template<class SM> inline
+leaky_allocation_strategy<SM>::scope::scope()
+:   m_mark(leaky_allocation_strategy::mark())
+,   m_cleanup(nullptr)
+{}
+
+template<class SM> inline
+leaky_allocation_strategy<SM>::scope::~scope()
+{
+    release();
+}
+
+//------
+//
+template<class SM>
+template<class T, class... Args>
+typename leaky_allocation_strategy<SM>::template rebind_pointer<T>
+leaky_allocation_strategy<SM>::scope::create(Args&&... args)
+{
+    leaky_allocation_strategy   heap;
+    void_pointer                pobj = heap.allocate(sizeof(T), alignof(T));
+    void_pointer                prec = nullptr;
+
+    //- The cleanup record is allocated before the object is constructed, so that running out
+    //  of memory for it cannot leave a constructed object that is never destroyed.
+    //
+    if (!std::is_trivially_destructible<T>::value)
+    {
+        prec = heap.allocate(sizeof(cleanup_record));
+    }
+
+    ::new (static_cast<void*>(pobj)) T(std::forward<Args>(args)...);
+
+    if (prec != nullptr)
+    {
+        cleanup_record*     prc = ::new (static_cast<void*>(prec)) cleanup_record;
+
+        prc->m_next    = m_cleanup;
+        prc->m_object  = pobj;
+        prc->m_destroy = &destroy_object<T>;
+        m_cleanup      = prec;
+    }
+
+    return static_cast<rebind_pointer<T>>(pobj);
+}
+
+//------
+//- Destroys the recorded objects and rolls back to the scope's marker.  The scope remains
+//  usable afterwards, and can be released again.
+//
+template<class SM>
+void
+leaky_allocation_strategy<SM>::scope::release()
+{
+    while (m_cleanup != nullptr)
+    {
+        cleanup_record*     prc = static_cast<cleanup_record*>(static_cast<void*>(m_cleanup));
+
+        prc->m_destroy(static_cast<void*>(prc->m_object));
+        m_cleanup = prc->m_next;
+    }
+
+    leaky_allocation_strategy::rollback(m_mark);
+}
+
+template<class SM>
+template<class T>
+void
+leaky_allocation_strategy<SM>::scope::destroy_object(void* p)
+{
+    static_cast<T*>(p)->~T();
+}
+
 #endif  //- SEGMENTED_LEAKY_ALLOCATION_STRATEGY_H_DEFINED
@@ -0,0 +1,255 @@
+//==================================================================================================
+//  File:
+//      numa_allocation_strategy.h
+//
+//  Summary:
+//      Defines a NUMA node-local allocation strategy class for testing rhx_allocator.
+//
+//  Copyright (c) 2017 Bob Steagall, KEWB Computing
+//==================================================================================================
+//
+#ifndef SEGMENTED_NUMA_ALLOCATION_STRATEGY_H_DEFINED
+#define SEGMENTED_NUMA_ALLOCATION_STRATEGY_H_DEFINED
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+#include "synthetic_pointer.h"
+#include "allocation_stats.h"
+
+//--------------------------------------------------------------------------------------------------
+//  Class:
+//      numa_allocation_strategy<SM>
+//
+//  Summary:
+//      This class implements a leaky allocation strategy that allocates from the segments
+//      assigned to the calling thread's NUMA node.  Each node has its own cursor, which moves
+//      only through that node's segments; a request that cannot be satisfied from the caller's
+//      node throws std::bad_alloc rather than silently placing memory on a remote node.
+//
+//      Like leaky_allocation_strategy<SM>, memory is only released in bulk by reset_buffers().
+//      The two strategies do not coordinate, so only one of them should be used with a given
+//      set of segments between resets.  The based 1D storage model is limited to its first
+//      segment, so with that model only the first segment's node can allocate; requests made
+//      from any other node throw std::bad_alloc.
+//--------------------------------------------------------------------------------------------------
+//
+template<class SM>
+class numa_allocation_strategy
+{
+  public:
+    using storage_model         = SM;
+    using addressing_model      = typename SM::addressing_model;
+    using difference_type       = typename SM::difference_type;
+    using size_type             = typename SM::size_type;
+    using void_pointer          = syn_ptr<void, addressing_model>;
+    using const_void_pointer    = syn_ptr<void const, addressing_model>;
+
+    template<class T>
+    using rebind_pointer        = syn_ptr<T, addressing_model>;
+
+    enum : size_type
+    {
+        min_alignment = 16,                     //- Every chunk is aligned to at least this boundary
+        max_nodes     = SM::max_segments        //- Each node needs at least one segment
+    };
+
+  public:
+    size_type       max_size() const;
+
+    void_pointer    allocate(size_type n, size_type alignment = min_alignment);
+    void            deallocate(void_pointer p, size_type n, size_type alignment = min_alignment);
+
+    static  int     node_of(const_void_pointer p);
+
+    static  allocation_stats&   stats();
+
+    static  void    reset_buffers();
+    static  void    swap_buffers();
+
+  private:
+    static  void                initialize();
+    static  size_type           next_node_segment(int node, size_type segment);
+    static  difference_type     round_up(difference_type x, difference_type r);
+
+    static  size_type   sm_curr_segment[max_nodes];
+    static  size_type   sm_curr_offset[max_nodes];
+    static  bool        sm_initialized;
+};
+
+//------
+//
+template<class SM>  typename numa_allocation_strategy<SM>::size_type
+numa_allocation_strategy<SM>::sm_curr_segment[max_nodes];
+
+template<class SM>  typename numa_allocation_strategy<SM>::size_type
+numa_allocation_strategy<SM>::sm_curr_offset[max_nodes];
+
+template<class SM>  bool
+numa_allocation_strategy<SM>::sm_initialized = false;
+
+//------
+//
+template<class SM> inline
+typename numa_allocation_strategy<SM>::size_type
+numa_allocation_strategy<SM>::max_size() const
+{
+    return storage_model::max_segment_size() - 64;
+}
+
+//------
+//- There are only as many cursors as segments, so on machines with more nodes than that, the
+//  higher-numbered nodes share the cursors (and segments) of the lower-numbered ones.
+//
+template<class SM>
+typename numa_allocation_strategy<SM>::void_pointer
+numa_allocation_strategy<SM>::allocate(size_type n, size_type alignment)
+{
+    if (!sm_initialized)
+    {
+        initialize();
+    }
+
+    if (alignment < min_alignment)
+    {
+        alignment = min_alignment;
+    }
+    else if (alignment > storage_model::segment_alignment  ||  (alignment & (alignment - 1)) != 0)
+    {
+        throw std::bad_alloc();
+    }
+
+    int         node         = storage_model::current_node() % (int) max_nodes;
+    size_type   chunk_size   = round_up(n, 16u);
+
+    if (sm_curr_segment[node] == 0)
+    {
+        throw std::bad_alloc();
+    }
+
+    size_type   chunk_start  = sm_curr_offset[node];
+    size_type   chunk_offset = round_up(chunk_start, alignment);
+
+    if ((chunk_offset + chunk_size) > storage_model::max_segment_size())
+    {
+        size_type   next = next_node_segment(node, sm_curr_segment[node]);
+
+        if (next == 0  ||  (round_up(64, alignment) + chunk_size) > storage_model::max_segment_size()  ||
+            !storage_model::ensure_segment(next))
+        {
+            throw std::bad_alloc();
+        }
+
+        RHX_STATS(stats().record_rollover(storage_model::max_segment_size() - chunk_start + 64));
+        sm_curr_segment[node] = next;
+        chunk_start           = 64;
+        chunk_offset          = round_up(64, alignment);
+    }
+
+    sm_curr_offset[node] = chunk_offset + chunk_size;
+
+    RHX_STATS(stats().record_allocate(n, chunk_size, chunk_offset - chunk_start));
+    RHX_STATS(stats().record_fill(sm_curr_segment[node], sm_curr_offset[node]));
+
+    return storage_model::segment_pointer(sm_curr_segment[node], chunk_offset);
+}
+
+template<class SM> inline
+void
+numa_allocation_strategy<SM>::deallocate(void_pointer, size_type, size_type)
+{}
+
+//------
+//- Returns the node on which the memory addressed by a pointer was placed, or -1 if it does
+//  not point into a segment.
+//
+template<class SM> inline
+int
+numa_allocation_strategy<SM>::node_of(const_void_pointer p)
+{
+    return storage_model::address_node(static_cast<void const*>(p));
+}
+
+//------
+//- The statistics cover all of the nodes together; the fill levels of the segments show how
+//  the memory was spread across them.
+//
+template<class SM>
+allocation_stats&
+numa_allocation_strategy<SM>::stats()
+{
+    static allocation_stats     s("numa", storage_model::model_name());
+    return s;
+}
+
+//------
+//
+template<class SM> inline
+void
+numa_allocation_strategy<SM>::reset_buffers()
+{
+    storage_model::reset_segments();
+    initialize();
+}
+
+template<class SM> inline
+void
+numa_allocation_strategy<SM>::swap_buffers()
+{
+    storage_model::swap_buffers();
+}
+
+//------
+//- Every node's cursor starts at the first segment assigned to it, which is created here if
+//  need be; nodes that do not exist have no segments, and their cursors are left empty.
+//
+template<class SM>
+void
+numa_allocation_strategy<SM>::initialize()
+{
+    storage_model::init_segments();
+
+    for (int node = 0;  node < (int) max_nodes;  ++node)
+    {
+        sm_curr_segment[node] = next_node_segment(node, 0);
+        sm_curr_offset[node]  = 64;
+
+        if (sm_curr_segment[node] != 0)
+        {
+            storage_model::ensure_segment(sm_curr_segment[node]);
+        }
+    }
+    sm_initialized = true;
+    RHX_STATS(stats().record_reset());
+}
+
+//------
+//- Returns the index of the next segment after the given one that is assigned to the given
+//  node, or zero if there is none.
+//
+template<class SM>
+typename numa_allocation_strategy<SM>::size_type
+numa_allocation_strategy<SM>::next_node_segment(int node, size_type segment)
+{
+    size_type   i = (segment < storage_model::first_segment_index())
+                    ? storage_model::first_segment_index() : (segment + 1);
+
+    for (;  i <= storage_model::last_segment_index();  ++i)
+    {
+        if (storage_model::segment_node(i) == node)
+        {
+            return i;
+        }
+    }
+    return 0;
+}
+
+template<class SM> inline
+typename numa_allocation_strategy<SM>::difference_type
+numa_allocation_strategy<SM>::round_up(difference_type x, difference_type r)
+{
+    return (x % r) ? (x + r - (x % r)) : x;
+}
+
+#endif  //- SEGMENTED_NUMA_ALLOCATION_STRATEGY_H_DEFINED
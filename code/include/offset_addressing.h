@@ -14,6 +14,8 @@
 #include <cstddef>
 #include <cstdint>
 
+#include "addressing_checks.h"
+
 //--------------------------------------------------------------------------------------------------
 //  Class:
 //      offset_addressing_model
@@ -23,6 +25,9 @@
 //      The offset is stored as a 64-bit integer, and the address represented by a pointer object
 //      is computed by adding the offset to the address of the pointer object itself.
 //
+//      The offset records no segment, so when built with RHX_CHECKED_ADDRESSING defined, only
+//      arithmetic is checked: a pointer into a segment must not be moved out of it.
+//
 //      Note that the comparison helper functions include several that define the "greater_than"
 //      relationship.  They are included because they are trivial, and make the code for any
 //      synthetic pointer wrapper class comparison operators easier to implement and read.
@@ -159,10 +164,23 @@ offset_addressing_model::operator =(void const* rhs) noexcept
 
 //------
 //
+//- The address is formed from the address of this object, and so GCC's alias analysis takes it
+//  to point into this object.  When this object is a temporary, such as an iterator copied by
+//  std::move(), stores through the address are then eliminated as dead.  The empty asm statement
+//  hides the address's origin from the optimizer.
+//
 inline void*
 offset_addressing_model::address() const noexcept
 {
-    return (m_offset == null_offset) ? nullptr : reinterpret_cast<void*>(reinterpret_cast<uintptr_t>(this) + m_offset);
+    if (m_offset == null_offset)
+    {
+        return nullptr;
+    }
+    uintptr_t   addr = reinterpret_cast<uintptr_t>(this) + m_offset;
+#if defined(__GNUC__)
+    asm("" : "+r"(addr));
+#endif
+    return reinterpret_cast<void*>(addr);
 }
 
 //------
@@ -238,12 +256,14 @@ offset_addressing_model::assign_from(void const* p)
 inline void
 offset_addressing_model::decrement(difference_type dec) noexcept
 {
+    RHX_CHECK_ADDRESS(if (m_offset != null_offset) addressing_checks::check_native_step(address(), -dec));
     m_offset -= dec;
 }
 
 inline void
 offset_addressing_model::increment(difference_type inc) noexcept
 {
+    RHX_CHECK_ADDRESS(if (m_offset != null_offset) addressing_checks::check_native_step(address(), inc));
     m_offset += inc;
 }
 
@@ -30,6 +30,7 @@ class offset_storage_model : public storage_model_base
     using addressing_model = offset_addressing_model;
 
     static  addressing_model    segment_pointer(size_type, size_type offset);
+    static  char const*         model_name() noexcept;
 };
 
 //------
@@ -40,4 +41,10 @@ offset_storage_model::segment_pointer(size_type segment, size_type offset)
     return addressing_model{segment_address(segment) + offset};
 }
 
+inline char const*
+offset_storage_model::model_name() noexcept
+{
+    return "offset";
+}
+
 #endif  //- OFFSET_STORAGE_H_DEFINED
@@ -0,0 +1,496 @@
+//==================================================================================================
+//  File:
+//      policy_storage.h
+//
+//  Summary:
+//      Defines a storage model class template that is composed from a segment provider policy
+//      and an addressing model, along with the segment providers themselves.
+//
+//  Copyright (c) 2017 Bob Steagall, KEWB Computing
+//==================================================================================================
+//
+#ifndef POLICY_STORAGE_H_DEFINED
+#define POLICY_STORAGE_H_DEFINED
+
+#include <cstring>
+#include <new>
+#include <string>
+#include <utility>
+#include <type_traits>
+
+#include "storage_base.h"
+#include "based_1d_addressing.h"
+#include "based_2d_addressing.h"
+#include "based_2dxl_addressing.h"
+#include "offset_addressing.h"
+#include "wrapper_addressing.h"
+
+//--------------------------------------------------------------------------------------------------
+//  Classes:
+//      heap_segment_provider
+//      mmap_segment_provider
+//      shm_segment_provider
+//      file_segment_provider
+//
+//  Summary:
+//      These classes are the segment provider policies for policy_storage_model.  A provider
+//      supplies zero-filled buffers aligned to storage_model_base::segment_alignment, returns
+//      them, and clears them back to zero, failing to allocate by throwing std::bad_alloc.
+//
+//      The heap provider takes buffers from the process heap, and must clear them by writing
+//      every byte.  The other providers map their buffers, so their pages are not touched until
+//      they are used, and are discarded rather than written when cleared.  The mmap provider
+//      maps private anonymous memory.  The shm provider maps a POSIX shared memory object,
+//      which is inherited by child processes.  The file provider maps a temporary file, which
+//      is unlinked as soon as it has been mapped; its pages are written back to the file rather
+//      than to swap.  On platforms other than Linux, the mapping providers use the heap.
+//--------------------------------------------------------------------------------------------------
+//
+struct heap_segment_provider
+{
+    using size_type = std::size_t;
+
+    static  char*       allocate(size_type size);
+    static  void        deallocate(char* pbuf, size_type size) noexcept;
+    static  void        clear(char* pbuf, size_type size) noexcept;
+    static  char const* name() noexcept;
+};
+
+struct mmap_segment_provider
+{
+    using size_type = std::size_t;
+
+    static  char*       allocate(size_type size);
+    static  void        deallocate(char* pbuf, size_type size) noexcept;
+    static  void        clear(char* pbuf, size_type size) noexcept;
+    static  char const* name() noexcept;
+};
+
+struct shm_segment_provider
+{
+    using size_type = std::size_t;
+
+    static  char*       allocate(size_type size);
+    static  void        deallocate(char* pbuf, size_type size) noexcept;
+    static  void        clear(char* pbuf, size_type size) noexcept;
+    static  char const* name() noexcept;
+};
+
+struct file_segment_provider
+{
+    using size_type = std::size_t;
+
+    static  char*       allocate(size_type size);
+    static  void        deallocate(char* pbuf, size_type size) noexcept;
+    static  void        clear(char* pbuf, size_type size) noexcept;
+    static  char const* name() noexcept;
+};
+
+//- The offset and wrapper addressing models do not depend on a storage model, so these adapt
+//  them to the form of addressing model template that policy_storage_model expects.
+//
+template<class SM>  using offset_addressing_policy  = offset_addressing_model;
+template<class SM>  using wrapper_addressing_policy = wrapper_addressing_model;
+
+//--------------------------------------------------------------------------------------------------
+//  Class:
+//      policy_storage_model<SP, AM, Tag>
+//
+//  Summary:
+//      This class template implements a segmented storage model like that of storage_model_base,
+//      with its segments obtained from the segment provider SP and addressed by the model AM,
+//      which is instantiated with the storage model itself.  For example,
+//
+//          policy_storage_model<mmap_segment_provider, based_2d_addressing_model>
+//
+//      is a based 2D storage model whose segments are mapped memory.
+//
+//      Each specialization has its own segment table, so that several of them are independent
+//      heaps: each can be reset, swapped, and cleared without affecting the others, and their
+//      strategies keep separate cursors.  Since the addressing models find their segments
+//      through static member functions, a heap is identified by its type, and the Tag argument
+//      exists to tell apart heaps that would otherwise have the same provider and addressing
+//      model.
+//
+//      An addressing model constructed from an offset from the first segment, such as based
+//      1D, reaches other segments only by their distance from the first, which swap_buffers()
+//      does not preserve.  A model using one is therefore limited to its first segment: it
+//      reports a single segment and refuses to create others, so that a strategy filling the
+//      segment fails with std::bad_alloc rather than making pointers that a swap leaves dangling.
+//
+//      These models do not request huge pages or bind their segments to NUMA nodes, and since
+//      the offset and wrapper models do not record segments, pointers of those models are not
+//      bounds checked when they refer to the segments of a policy model.
+//--------------------------------------------------------------------------------------------------
+//
+template<class SP, template<class> class AM, class Tag = void>
+class policy_storage_model
+{
+  public:
+    using difference_type  = std::ptrdiff_t;
+    using size_type        = std::size_t;
+    using segment_provider = SP;
+    using addressing_model = AM<policy_storage_model>;
+
+    enum : size_type
+    {
+        max_segments      = storage_model_base::max_segments,
+        max_size          = storage_model_base::max_size,
+        segment_alignment = storage_model_base::segment_alignment
+    };
+
+  public:
+    static  void        allocate_segment(size_type segment, size_type size = max_size);
+    static  void        clear_segments();
+    static  void        deallocate_segment(size_type segment);
+    static  bool        ensure_segment(size_type segment);
+    static  void        init_segments();
+    static  void        reset_segments();
+    static  void        swap_buffers();
+
+    static  char*       segment_address(size_type segment) noexcept;
+    static  size_type   segment_size(size_type segment) noexcept;
+    static  size_type   address_segment(void const* p) noexcept;
+
+    static  char*       first_segment_address() noexcept;
+    static  size_type   first_segment_size() noexcept;
+
+    static  addressing_model    segment_pointer(size_type segment, size_type offset);
+    static  char const*         model_name();
+
+    static  constexpr   size_type   first_segment_index();
+    static  constexpr   size_type   last_segment_index();
+    static  constexpr   size_type   max_segment_count();
+    static  constexpr   size_type   max_segment_size();
+
+  private:
+    //- The ways in which the addressing models are constructed from a location.
+    //
+    using by_segment = std::integral_constant<int, 0>;     //- From a segment and offset
+    using by_address = std::integral_constant<int, 1>;     //- From a native address
+    using by_offset  = std::integral_constant<int, 2>;     //- From an offset from the first segment
+
+    static  addressing_model    make_pointer(size_type segment, size_type offset, by_segment);
+    static  addressing_model    make_pointer(size_type segment, size_type offset, by_address);
+    static  addressing_model    make_pointer(size_type segment, size_type offset, by_offset);
+
+    static  constexpr   int     pointer_form();
+
+    static  char const* addressing_name(based_1d_addressing_model<policy_storage_model> const*);
+    static  char const* addressing_name(based_2d_addressing_model<policy_storage_model> const*);
+    static  char const* addressing_name(based_2dxl_addressing_model<policy_storage_model> const*);
+    static  char const* addressing_name(offset_addressing_model const*);
+    static  char const* addressing_name(wrapper_addressing_model const*);
+    static  char const* addressing_name(void const*);
+
+    static  char*       sm_segment_ptrs[max_segments + 2];
+    static  size_type   sm_segment_size[max_segments + 2];
+    static  char*       sm_shadow_ptrs[max_segments + 2];
+    static  bool        sm_ready;
+};
+
+template<class SP, template<class> class AM, class Tag>
+char*   policy_storage_model<SP, AM, Tag>::sm_segment_ptrs[max_segments + 2] = {};
+
+template<class SP, template<class> class AM, class Tag>
+typename policy_storage_model<SP, AM, Tag>::size_type
+policy_storage_model<SP, AM, Tag>::sm_segment_size[max_segments + 2] = {};
+
+template<class SP, template<class> class AM, class Tag>
+char*   policy_storage_model<SP, AM, Tag>::sm_shadow_ptrs[max_segments + 2] = {};
+
+template<class SP, template<class> class AM, class Tag>
+bool    policy_storage_model<SP, AM, Tag>::sm_ready = false;
+
+//------
+//- The shadow buffer is obtained first, so that it can be returned if the segment itself
+//  cannot be obtained.
+//
+template<class SP, template<class> class AM, class Tag>
+void
+policy_storage_model<SP, AM, Tag>::allocate_segment(size_type segment, size_type size)
+{
+    if (segment >= first_segment_index()  &&  segment <= last_segment_index()  &&
+        size <= max_size  &&  sm_segment_ptrs[segment] == nullptr)
+    {
+        char*   pshadow = SP::allocate(size);
+
+        try
+        {
+            sm_segment_ptrs[segment] = SP::allocate(size);
+        }
+        catch (...)
+        {
+            SP::deallocate(pshadow, size);
+            throw;
+        }
+        sm_shadow_ptrs[segment]  = pshadow;
+        sm_segment_size[segment] = size;
+    }
+}
+
+template<class SP, template<class> class AM, class Tag>
+void
+policy_storage_model<SP, AM, Tag>::clear_segments()
+{
+    sm_ready = false;
+
+    for (size_type i = first_segment_index();  i <= last_segment_index();  ++i)
+    {
+        deallocate_segment(i);
+    }
+}
+
+template<class SP, template<class> class AM, class Tag>
+void
+policy_storage_model<SP, AM, Tag>::deallocate_segment(size_type segment)
+{
+    if (sm_segment_ptrs[segment] != nullptr)
+    {
+        SP::deallocate(sm_segment_ptrs[segment], sm_segment_size[segment]);
+        SP::deallocate(sm_shadow_ptrs[segment], sm_segment_size[segment]);
+        sm_segment_ptrs[segment] = nullptr;
+        sm_shadow_ptrs[segment]  = nullptr;
+        sm_segment_size[segment] = 0;
+    }
+}
+
+//- Creates a segment if it does not yet exist.  Returns false if the index is out of range.
+//
+template<class SP, template<class> class AM, class Tag>
+bool
+policy_storage_model<SP, AM, Tag>::ensure_segment(size_type segment)
+{
+    if (segment < first_segment_index()  ||  segment > last_segment_index())
+    {
+        return false;
+    }
+    if (sm_segment_ptrs[segment] == nullptr)
+    {
+        allocate_segment(segment);
+    }
+    return sm_segment_ptrs[segment] != nullptr;
+}
+
+template<class SP, template<class> class AM, class Tag>
+void
+policy_storage_model<SP, AM, Tag>::init_segments()
+{
+    if (!sm_ready)
+    {
+        allocate_segment(first_segment_index());
+        sm_ready = true;
+    }
+}
+
+template<class SP, template<class> class AM, class Tag>
+void
+policy_storage_model<SP, AM, Tag>::reset_segments()
+{
+    for (size_type i = first_segment_index();  i <= last_segment_index();  ++i)
+    {
+        if (sm_segment_ptrs[i] != nullptr)
+        {
+            SP::clear(sm_segment_ptrs[i], sm_segment_size[i]);
+            SP::clear(sm_shadow_ptrs[i], sm_segment_size[i]);
+        }
+    }
+}
+
+template<class SP, template<class> class AM, class Tag>
+void
+policy_storage_model<SP, AM, Tag>::swap_buffers()
+{
+    for (size_type i = first_segment_index();  i <= last_segment_index();  ++i)
+    {
+        if (sm_segment_ptrs[i] != nullptr)
+        {
+            memcpy(sm_shadow_ptrs[i], sm_segment_ptrs[i], sm_segment_size[i]);
+            std::swap(sm_shadow_ptrs[i], sm_segment_ptrs[i]);
+        }
+    }
+}
+
+//------
+//
+template<class SP, template<class> class AM, class Tag> inline
+char*
+policy_storage_model<SP, AM, Tag>::segment_address(size_type segment) noexcept
+{
+    return sm_segment_ptrs[segment];
+}
+
+template<class SP, template<class> class AM, class Tag> inline
+typename policy_storage_model<SP, AM, Tag>::size_type
+policy_storage_model<SP, AM, Tag>::segment_size(size_type segment) noexcept
+{
+    return sm_segment_size[segment];
+}
+
+//- Returns the index of the segment containing an address, or zero if there is none.
+//
+template<class SP, template<class> class AM, class Tag>
+typename policy_storage_model<SP, AM, Tag>::size_type
+policy_storage_model<SP, AM, Tag>::address_segment(void const* p) noexcept
+{
+    char const*     pc = static_cast<char const*>(p);
+
+    for (size_type i = first_segment_index();  i <= last_segment_index();  ++i)
+    {
+        if (sm_segment_ptrs[i] != nullptr  &&
+            pc >= sm_segment_ptrs[i]  &&  pc < sm_segment_ptrs[i] + sm_segment_size[i])
+        {
+            return i;
+        }
+    }
+    return 0;
+}
+
+//------
+//
+template<class SP, template<class> class AM, class Tag> inline
+char*
+policy_storage_model<SP, AM, Tag>::first_segment_address() noexcept
+{
+    return sm_segment_ptrs[first_segment_index()];
+}
+
+template<class SP, template<class> class AM, class Tag> inline
+typename policy_storage_model<SP, AM, Tag>::size_type
+policy_storage_model<SP, AM, Tag>::first_segment_size() noexcept
+{
+    return sm_segment_size[first_segment_index()];
+}
+
+//------
+//- The form of construction is chosen from the constructors the addressing model provides.
+//
+template<class SP, template<class> class AM, class Tag> inline
+typename policy_storage_model<SP, AM, Tag>::addressing_model
+policy_storage_model<SP, AM, Tag>::segment_pointer(size_type segment, size_type offset)
+{
+    return make_pointer(segment, offset, std::integral_constant<int, pointer_form()>());
+}
+
+//- The name joins those of the addressing model and the segment provider, as in "based_2d:mmap".
+//
+template<class SP, template<class> class AM, class Tag>
+char const*
+policy_storage_model<SP, AM, Tag>::model_name()
+{
+    static std::string const    name = std::string(addressing_name(static_cast<addressing_model const*>(nullptr)))
+                                       + ":" + SP::name();
+    return name.c_str();
+}
+
+//------
+//
+template<class SP, template<class> class AM, class Tag>
+constexpr inline typename policy_storage_model<SP, AM, Tag>::size_type
+policy_storage_model<SP, AM, Tag>::first_segment_index()
+{
+    return storage_model_base::first_segment_index();
+}
+
+template<class SP, template<class> class AM, class Tag>
+constexpr inline typename policy_storage_model<SP, AM, Tag>::size_type
+policy_storage_model<SP, AM, Tag>::last_segment_index()
+{
+    return (pointer_form() == by_offset::value) ? first_segment_index()
+                                                : storage_model_base::last_segment_index();
+}
+
+template<class SP, template<class> class AM, class Tag>
+constexpr inline typename policy_storage_model<SP, AM, Tag>::size_type
+policy_storage_model<SP, AM, Tag>::max_segment_count()
+{
+    return last_segment_index() - first_segment_index() + 1;
+}
+
+template<class SP, template<class> class AM, class Tag>
+constexpr inline typename policy_storage_model<SP, AM, Tag>::size_type
+policy_storage_model<SP, AM, Tag>::max_segment_size()
+{
+    return max_size;
+}
+
+//------
+//- Returns the form of construction the addressing model provides, as one of by_segment,
+//  by_address, or by_offset.
+//
+template<class SP, template<class> class AM, class Tag>
+constexpr inline int
+policy_storage_model<SP, AM, Tag>::pointer_form()
+{
+    return std::is_constructible<addressing_model, size_type, size_type>::value ? by_segment::value :
+           std::is_constructible<addressing_model, char*>::value ? by_address::value : by_offset::value;
+}
+
+//------
+//
+template<class SP, template<class> class AM, class Tag> inline
+typename policy_storage_model<SP, AM, Tag>::addressing_model
+policy_storage_model<SP, AM, Tag>::make_pointer(size_type segment, size_type offset, by_segment)
+{
+    return addressing_model{segment, offset};
+}
+
+template<class SP, template<class> class AM, class Tag> inline
+typename policy_storage_model<SP, AM, Tag>::addressing_model
+policy_storage_model<SP, AM, Tag>::make_pointer(size_type segment, size_type offset, by_address)
+{
+    return addressing_model{segment_address(segment) + offset};
+}
+
+template<class SP, template<class> class AM, class Tag> inline
+typename policy_storage_model<SP, AM, Tag>::addressing_model
+policy_storage_model<SP, AM, Tag>::make_pointer(size_type segment, size_type offset, by_offset)
+{
+    return addressing_model{static_cast<size_type>(segment_address(segment) + offset - first_segment_address())};
+}
+
+//------
+//
+template<class SP, template<class> class AM, class Tag> inline
+char const*
+policy_storage_model<SP, AM, Tag>::addressing_name(based_1d_addressing_model<policy_storage_model> const*)
+{
+    return "based_1d";
+}
+
+template<class SP, template<class> class AM, class Tag> inline
+char const*
+policy_storage_model<SP, AM, Tag>::addressing_name(based_2d_addressing_model<policy_storage_model> const*)
+{
+    return "based_2d";
+}
+
+template<class SP, template<class> class AM, class Tag> inline
+char const*
+policy_storage_model<SP, AM, Tag>::addressing_name(based_2dxl_addressing_model<policy_storage_model> const*)
+{
+    return "based_2dxl";
+}
+
+template<class SP, template<class> class AM, class Tag> inline
+char const*
+policy_storage_model<SP, AM, Tag>::addressing_name(offset_addressing_model const*)
+{
+    return "offset";
+}
+
+template<class SP, template<class> class AM, class Tag> inline
+char const*
+policy_storage_model<SP, AM, Tag>::addressing_name(wrapper_addressing_model const*)
+{
+    return "wrapper";
+}
+
+template<class SP, template<class> class AM, class Tag> inline
+char const*
+policy_storage_model<SP, AM, Tag>::addressing_name(void const*)
+{
+    return "custom";
+}
+
+#endif  //- POLICY_STORAGE_H_DEFINED
@@ -14,6 +14,23 @@
 #include <type_traits>
 #include <memory>
 
+#include "allocation_trace.h"
+
+//--------------------------------------------------------------------------------------------------
+//  Struct Template:
+//      rhx_type_tag<T>
+//
+//  Summary:
+//      This empty struct template names the type for which rhx_allocator<T> requests memory.
+//      A strategy that keeps separate pools for different types provides allocate() and
+//      deallocate() overloads taking the tag as their last argument, and rhx_allocator<T>
+//      calls those in preference to the untagged ones.
+//--------------------------------------------------------------------------------------------------
+//
+template<class T>
+struct rhx_type_tag
+{};
+
 //--------------------------------------------------------------------------------------------------
 //  Class Template:
 //      rhx_allocator<T,HT>
@@ -22,6 +39,13 @@
 //      This class template implements a standard-conforming allocator that uses the pointer
 //      interface and allocation strategy expressed by its second template parameter to allocate
 //      memory for representing objects of type T.
+//
+//      Requests are made with an rhx_type_tag<T> when the strategy accepts one, so that a
+//      strategy can keep the objects of each type together.  Since containers rebind their
+//      allocators, T is then the container's node type.
+//
+//      When built with RHX_ALLOCATION_TRACE defined, every allocation, deallocation, and
+//      successful in-place expansion is recorded in the active allocation trace, if any.
 //--------------------------------------------------------------------------------------------------
 //
 template<class T, class HT>
@@ -65,6 +89,7 @@ class rhx_allocator
     pointer     allocate(size_type n);
     pointer     allocate(size_type n, const_void_pointer p);
     void        deallocate(pointer p, size_type n);
+    bool        try_expand(pointer p, size_type old_n, size_type new_n);
 
     template<class U, class... Args>
     void        construct(U* p, Args&&... args);
@@ -75,6 +100,20 @@ class rhx_allocator
   private:
     template<class OT, class OHT> friend class rhx_allocator;
 
+    template<class H>
+    static auto heap_allocate(H& heap, size_type n, int)
+        -> decltype(heap.allocate(n, alignof(T), rhx_type_tag<T>()));
+    template<class H>
+    static auto heap_allocate(H& heap, size_type n, long)
+        -> decltype(heap.allocate(n, alignof(T)));
+
+    template<class H>
+    static auto heap_deallocate(H& heap, pointer p, size_type n, int)
+        -> decltype(heap.deallocate(p, n, alignof(T), rhx_type_tag<T>()));
+    template<class H>
+    static auto heap_deallocate(H& heap, pointer p, size_type n, long)
+        -> decltype(heap.deallocate(p, n, alignof(T)));
+
     HT          m_heap;
 };
 
@@ -167,23 +206,79 @@ template<class T, class HT> inline
 typename rhx_allocator<T, HT>::pointer
 rhx_allocator<T, HT>::allocate(size_type n)
 {
-    return static_cast<pointer>(m_heap.allocate(n * sizeof(T)));
+    pointer     p = static_cast<pointer>(heap_allocate(m_heap, n * sizeof(T), 0));
+
+    RHX_TRACE(trace_allocation<T>(trace_record::allocate_op, static_cast<T const*>(p), n * sizeof(T)));
+    return p;
 }
 
 template<class T, class HT> inline
 typename rhx_allocator<T, HT>::pointer
 rhx_allocator<T, HT>::allocate(size_type n, const_void_pointer)
 {
-    return static_cast<pointer>(m_heap.allocate(n * sizeof(T)));
+    return allocate(n);
 }
 
 template<class T, class HT> inline
 void
-rhx_allocator<T, HT>::deallocate(pointer p, size_type)
+rhx_allocator<T, HT>::deallocate(pointer p, size_type n)
+{
+    RHX_TRACE(trace_allocation<T>(trace_record::deallocate_op, static_cast<T const*>(p), n * sizeof(T)));
+    heap_deallocate(m_heap, p, n * sizeof(T), 0);
+}
+
+template<class T, class HT> inline
+bool
+rhx_allocator<T, HT>::try_expand(pointer p, size_type old_n, size_type new_n)
 {
-    m_heap.deallocate(p);
+    bool    expanded = m_heap.try_expand(p, old_n * sizeof(T), new_n * sizeof(T));
+
+    RHX_TRACE(if (expanded) trace_allocation<T>(trace_record::expand_op, static_cast<T const*>(p), new_n * sizeof(T)));
+    return expanded;
+}
+
+//------
+//- The strategy is called with the type tag if it accepts one; the int argument makes that
+//  overload the better match, and the long overload the fallback.
+//
+template<class T, class HT>
+template<class H> inline
+auto
+rhx_allocator<T, HT>::heap_allocate(H& heap, size_type n, int)
+    -> decltype(heap.allocate(n, alignof(T), rhx_type_tag<T>()))
+{
+    return heap.allocate(n, alignof(T), rhx_type_tag<T>());
+}
+
+template<class T, class HT>
+template<class H> inline
+auto
+rhx_allocator<T, HT>::heap_allocate(H& heap, size_type n, long)
+    -> decltype(heap.allocate(n, alignof(T)))
+{
+    return heap.allocate(n, alignof(T));
+}
+
+template<class T, class HT>
+template<class H> inline
+auto
+rhx_allocator<T, HT>::heap_deallocate(H& heap, pointer p, size_type n, int)
+    -> decltype(heap.deallocate(p, n, alignof(T), rhx_type_tag<T>()))
+{
+    heap.deallocate(p, n, alignof(T), rhx_type_tag<T>());
 }
 
+template<class T, class HT>
+template<class H> inline
+auto
+rhx_allocator<T, HT>::heap_deallocate(H& heap, pointer p, size_type n, long)
+    -> decltype(heap.deallocate(p, n, alignof(T)))
+{
+    heap.deallocate(p, n, alignof(T));
+}
+
+//------
+//
 template<class T, class HT>
 template<class U, class... Args> inline
 void
@@ -241,6 +336,63 @@ allocate(Args&&... args)
     return pobj;
 }
 
+//--------------------------------------------------------------------------------------------------
+//  Facility:   rhx_allocator<T> Buffer Reallocation
+//
+//  Resizes a buffer of old_n elements, the first n_used of which are constructed, so that it
+//  can hold new_n elements.  The strategy is first asked to resize the buffer in place; only if
+//  that fails is a new buffer allocated and the constructed elements moved into it.
+//--------------------------------------------------------------------------------------------------
+//
+template<class T, class HT>
+typename rhx_allocator<T, HT>::pointer
+reallocate(rhx_allocator<T, HT>& alloc, typename rhx_allocator<T, HT>::pointer p,
+           typename rhx_allocator<T, HT>::size_type n_used,
+           typename rhx_allocator<T, HT>::size_type old_n,
+           typename rhx_allocator<T, HT>::size_type new_n)
+{
+    using size_type = typename rhx_allocator<T, HT>::size_type;
+
+    if (p != nullptr  &&  alloc.try_expand(p, old_n, new_n))
+    {
+        return p;
+    }
+
+    auto        pnew = alloc.allocate(new_n);
+    T*          psrc = static_cast<T*>(p);
+    T*          pdst = static_cast<T*>(pnew);
+    size_type   i    = 0;
+
+    try
+    {
+        for (;  i < n_used;  ++i)
+        {
+            alloc.construct(pdst + i, std::move_if_noexcept(psrc[i]));
+        }
+    }
+    catch (...)
+    {
+        while (i-- > 0)
+        {
+            alloc.destroy(pdst + i);
+        }
+        alloc.deallocate(pnew, new_n);
+        throw;
+    }
+
+    for (i = 0;  i < n_used;  ++i)
+    {
+        alloc.destroy(psrc + i);
+    }
+
+    if (p != nullptr)
+    {
+        alloc.deallocate(p, old_n);
+    }
+
+    return pnew;
+}
+
 template<class T, class Alloc, class... Args>
 typename Alloc::pointer
 allocate_object(Args&&... args)
@@ -253,7 +405,7 @@ allocate_object(Args&&... args)
     }
     catch (...)
     {
-        Alloc().deallocate(pobj);
+        Alloc().deallocate(pobj, 1);
         throw;
     }
 
@@ -0,0 +1,892 @@
+//==================================================================================================
+//  File:
+//      rhx_string.h
+//
+//  Summary:
+//      Defines a string class template for relocatable heaps, whose short strings are stored
+//      inline without any pointer into the string object itself.
+//
+//  Copyright (c) 2017 Bob Steagall, KEWB Computing
+//==================================================================================================
+//
+#ifndef RHX_STRING_H_DEFINED
+#define RHX_STRING_H_DEFINED
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <new>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "rhx_allocator.h"
+
+//--------------------------------------------------------------------------------------------------
+//  Class:
+//      basic_rhx_string<CharT, HT, Traits>
+//
+//  Summary:
+//      This class template implements a string whose characters are allocated by rhx_allocator
+//      from the allocation strategy HT, with a small-string optimization that does not depend
+//      on the standard library's string.
+//
+//      A long string holds a synthetic pointer to its characters and its capacity; a short
+//      string holds its characters in the same bytes.  Which of the two is in use is recorded
+//      in the low bit of the size word, rather than by pointing into the object as libstdc++
+//      does, so a short string has no address of its own to fix up: moving, copying, or
+//      relocating it is a plain copy of its bytes, and a long string is relocatable whenever
+//      its synthetic pointer is.  With 64-bit pointers, strings of up to 15 characters are
+//      short.
+//
+//      Its interface is a subset of std::basic_string's.  Its iterators are native pointers.
+//--------------------------------------------------------------------------------------------------
+//
+template<class CharT, class HT, class Traits = std::char_traits<CharT>>
+class basic_rhx_string
+{
+  public:
+    using traits_type       = Traits;
+    using value_type        = CharT;
+    using allocator_type    = rhx_allocator<CharT, HT>;
+    using size_type         = typename HT::size_type;
+    using difference_type   = typename HT::difference_type;
+    using reference         = CharT&;
+    using const_reference   = CharT const&;
+    using pointer           = CharT*;
+    using const_pointer     = CharT const*;
+    using iterator          = CharT*;
+    using const_iterator    = CharT const*;
+
+    static constexpr size_type  npos = static_cast<size_type>(-1);
+
+  public:
+    basic_rhx_string() noexcept;
+    basic_rhx_string(basic_rhx_string const& other);
+    basic_rhx_string(basic_rhx_string&& other) noexcept;
+    basic_rhx_string(CharT const* s);
+    basic_rhx_string(CharT const* s, size_type n);
+    basic_rhx_string(size_type n, CharT ch);
+    template<class A>
+    explicit basic_rhx_string(std::basic_string<CharT, Traits, A> const& s);
+    ~basic_rhx_string();
+
+    basic_rhx_string&   operator =(basic_rhx_string const& rhs);
+    basic_rhx_string&   operator =(basic_rhx_string&& rhs) noexcept;
+    basic_rhx_string&   operator =(CharT const* s);
+
+    basic_rhx_string&   assign(CharT const* s, size_type n);
+    basic_rhx_string&   assign(CharT const* s);
+
+    iterator        begin() noexcept;
+    iterator        end() noexcept;
+    const_iterator  begin() const noexcept;
+    const_iterator  end() const noexcept;
+    const_iterator  cbegin() const noexcept;
+    const_iterator  cend() const noexcept;
+
+    CharT*          data() noexcept;
+    CharT const*    data() const noexcept;
+    CharT const*    c_str() const noexcept;
+
+    bool        empty() const noexcept;
+    size_type   size() const noexcept;
+    size_type   length() const noexcept;
+    size_type   capacity() const noexcept;
+    size_type   max_size() const noexcept;
+
+    reference       operator [](size_type i) noexcept;
+    const_reference operator [](size_type i) const noexcept;
+    reference       at(size_type i);
+    const_reference at(size_type i) const;
+    reference       front() noexcept;
+    const_reference front() const noexcept;
+    reference       back() noexcept;
+    const_reference back() const noexcept;
+
+    void    reserve(size_type n);
+    void    shrink_to_fit();
+    void    clear() noexcept;
+    void    resize(size_type n, CharT ch = CharT());
+    void    push_back(CharT ch);
+    void    pop_back() noexcept;
+
+    basic_rhx_string&   append(CharT const* s, size_type n);
+    basic_rhx_string&   append(CharT const* s);
+    basic_rhx_string&   append(basic_rhx_string const& str);
+    basic_rhx_string&   operator +=(basic_rhx_string const& str);
+    basic_rhx_string&   operator +=(CharT const* s);
+    basic_rhx_string&   operator +=(CharT ch);
+
+    int         compare(CharT const* s, size_type n) const noexcept;
+    int         compare(basic_rhx_string const& str) const noexcept;
+    size_type   find(CharT const* s, size_type pos, size_type n) const noexcept;
+    size_type   find(basic_rhx_string const& str, size_type pos = 0) const noexcept;
+    size_type   find(CharT ch, size_type pos = 0) const noexcept;
+
+    basic_rhx_string    substr(size_type pos = 0, size_type n = npos) const;
+    allocator_type      get_allocator() const noexcept;
+    void                swap(basic_rhx_string& other) noexcept;
+
+  private:
+    using heap_pointer = typename allocator_type::pointer;
+
+    struct long_rep
+    {
+        heap_pointer    m_ptr;
+        size_type       m_cap;
+    };
+
+    enum : size_type
+    {
+        local_capacity = sizeof(long_rep) / sizeof(CharT) - 1,
+        long_flag      = 1
+    };
+
+    //- A rep starts out in the short form, holding an empty string, so that its bytes are
+    //  defined before the string's constructors choose a form.
+    //
+    union rep
+    {
+        long_rep    m_long;
+        CharT       m_local[local_capacity + 1];
+
+        rep() noexcept : m_local() {}
+        ~rep() {}
+    };
+
+    rep         m_rep;
+    size_type   m_meta;         //- The size, shifted left one bit, plus long_flag if long
+
+    bool    is_long() const noexcept;
+    void    set_size(size_type n) noexcept;
+    void    init(CharT const* s, size_type n);
+    void    steal(basic_rhx_string& other) noexcept;
+    void    release() noexcept;
+    void    replace_buffer(size_type cap, size_type keep, CharT const* s, size_type n);
+    void    check_length(size_type n) const;
+};
+
+//------
+//
+template<class CharT, class HT, class Traits> inline
+basic_rhx_string<CharT, HT, Traits>::basic_rhx_string() noexcept
+:   m_meta(0)
+{}
+
+template<class CharT, class HT, class Traits> inline
+basic_rhx_string<CharT, HT, Traits>::basic_rhx_string(basic_rhx_string const& other)
+:   m_meta(0)
+{
+    init(other.data(), other.size());
+}
+
+template<class CharT, class HT, class Traits> inline
+basic_rhx_string<CharT, HT, Traits>::basic_rhx_string(basic_rhx_string&& other) noexcept
+:   m_meta(0)
+{
+    steal(other);
+}
+
+template<class CharT, class HT, class Traits> inline
+basic_rhx_string<CharT, HT, Traits>::basic_rhx_string(CharT const* s)
+:   m_meta(0)
+{
+    init(s, (size_type) Traits::length(s));
+}
+
+template<class CharT, class HT, class Traits> inline
+basic_rhx_string<CharT, HT, Traits>::basic_rhx_string(CharT const* s, size_type n)
+:   m_meta(0)
+{
+    init(s, n);
+}
+
+template<class CharT, class HT, class Traits>
+basic_rhx_string<CharT, HT, Traits>::basic_rhx_string(size_type n, CharT ch)
+:   m_meta(0)
+{
+    init(nullptr, 0);
+    resize(n, ch);
+}
+
+template<class CharT, class HT, class Traits>
+template<class A> inline
+basic_rhx_string<CharT, HT, Traits>::basic_rhx_string(std::basic_string<CharT, Traits, A> const& s)
+:   m_meta(0)
+{
+    init(s.data(), (size_type) s.size());
+}
+
+template<class CharT, class HT, class Traits> inline
+basic_rhx_string<CharT, HT, Traits>::~basic_rhx_string()
+{
+    release();
+}
+
+//------
+//
+template<class CharT, class HT, class Traits> inline
+basic_rhx_string<CharT, HT, Traits>&
+basic_rhx_string<CharT, HT, Traits>::operator =(basic_rhx_string const& rhs)
+{
+    return (&rhs == this) ? *this : assign(rhs.data(), rhs.size());
+}
+
+template<class CharT, class HT, class Traits> inline
+basic_rhx_string<CharT, HT, Traits>&
+basic_rhx_string<CharT, HT, Traits>::operator =(basic_rhx_string&& rhs) noexcept
+{
+    if (&rhs != this)
+    {
+        release();
+        steal(rhs);
+    }
+    return *this;
+}
+
+template<class CharT, class HT, class Traits> inline
+basic_rhx_string<CharT, HT, Traits>&
+basic_rhx_string<CharT, HT, Traits>::operator =(CharT const* s)
+{
+    return assign(s);
+}
+
+//- Assignment reuses the current buffer whenever it is large enough.  The source may lie
+//  within the string itself.
+//
+template<class CharT, class HT, class Traits>
+basic_rhx_string<CharT, HT, Traits>&
+basic_rhx_string<CharT, HT, Traits>::assign(CharT const* s, size_type n)
+{
+    if (n <= capacity())
+    {
+        Traits::move(data(), s, n);
+        set_size(n);
+    }
+    else
+    {
+        replace_buffer(n, 0, s, n);
+    }
+    return *this;
+}
+
+template<class CharT, class HT, class Traits> inline
+basic_rhx_string<CharT, HT, Traits>&
+basic_rhx_string<CharT, HT, Traits>::assign(CharT const* s)
+{
+    return assign(s, (size_type) Traits::length(s));
+}
+
+//------
+//
+template<class CharT, class HT, class Traits> inline
+typename basic_rhx_string<CharT, HT, Traits>::iterator
+basic_rhx_string<CharT, HT, Traits>::begin() noexcept
+{
+    return data();
+}
+
+template<class CharT, class HT, class Traits> inline
+typename basic_rhx_string<CharT, HT, Traits>::iterator
+basic_rhx_string<CharT, HT, Traits>::end() noexcept
+{
+    return data() + size();
+}
+
+template<class CharT, class HT, class Traits> inline
+typename basic_rhx_string<CharT, HT, Traits>::const_iterator
+basic_rhx_string<CharT, HT, Traits>::begin() const noexcept
+{
+    return data();
+}
+
+template<class CharT, class HT, class Traits> inline
+typename basic_rhx_string<CharT, HT, Traits>::const_iterator
+basic_rhx_string<CharT, HT, Traits>::end() const noexcept
+{
+    return data() + size();
+}
+
+template<class CharT, class HT, class Traits> inline
+typename basic_rhx_string<CharT, HT, Traits>::const_iterator
+basic_rhx_string<CharT, HT, Traits>::cbegin() const noexcept
+{
+    return data();
+}
+
+template<class CharT, class HT, class Traits> inline
+typename basic_rhx_string<CharT, HT, Traits>::const_iterator
+basic_rhx_string<CharT, HT, Traits>::cend() const noexcept
+{
+    return data() + size();
+}
+
+//------
+//
+template<class CharT, class HT, class Traits> inline
+CharT*
+basic_rhx_string<CharT, HT, Traits>::data() noexcept
+{
+    return is_long() ? static_cast<CharT*>(m_rep.m_long.m_ptr) : m_rep.m_local;
+}
+
+template<class CharT, class HT, class Traits> inline
+CharT const*
+basic_rhx_string<CharT, HT, Traits>::data() const noexcept
+{
+    return is_long() ? static_cast<CharT const*>(m_rep.m_long.m_ptr) : m_rep.m_local;
+}
+
+template<class CharT, class HT, class Traits> inline
+CharT const*
+basic_rhx_string<CharT, HT, Traits>::c_str() const noexcept
+{
+    return data();
+}
+
+//------
+//
+template<class CharT, class HT, class Traits> inline
+bool
+basic_rhx_string<CharT, HT, Traits>::empty() const noexcept
+{
+    return size() == 0;
+}
+
+template<class CharT, class HT, class Traits> inline
+typename basic_rhx_string<CharT, HT, Traits>::size_type
+basic_rhx_string<CharT, HT, Traits>::size() const noexcept
+{
+    return m_meta >> 1;
+}
+
+template<class CharT, class HT, class Traits> inline
+typename basic_rhx_string<CharT, HT, Traits>::size_type
+basic_rhx_string<CharT, HT, Traits>::length() const noexcept
+{
+    return size();
+}
+
+template<class CharT, class HT, class Traits> inline
+typename basic_rhx_string<CharT, HT, Traits>::size_type
+basic_rhx_string<CharT, HT, Traits>::capacity() const noexcept
+{
+    return is_long() ? m_rep.m_long.m_cap : (size_type) local_capacity;
+}
+
+template<class CharT, class HT, class Traits> inline
+typename basic_rhx_string<CharT, HT, Traits>::size_type
+basic_rhx_string<CharT, HT, Traits>::max_size() const noexcept
+{
+    return std::min<size_type>(allocator_type().max_size() - 1, npos >> 1);
+}
+
+//------
+//
+template<class CharT, class HT, class Traits> inline
+typename basic_rhx_string<CharT, HT, Traits>::reference
+basic_rhx_string<CharT, HT, Traits>::operator [](size_type i) noexcept
+{
+    return data()[i];
+}
+
+template<class CharT, class HT, class Traits> inline
+typename basic_rhx_string<CharT, HT, Traits>::const_reference
+basic_rhx_string<CharT, HT, Traits>::operator [](size_type i) const noexcept
+{
+    return data()[i];
+}
+
+template<class CharT, class HT, class Traits> inline
+typename basic_rhx_string<CharT, HT, Traits>::reference
+basic_rhx_string<CharT, HT, Traits>::at(size_type i)
+{
+    if (i >= size())
+    {
+        throw std::out_of_range("basic_rhx_string::at");
+    }
+    return data()[i];
+}
+
+template<class CharT, class HT, class Traits> inline
+typename basic_rhx_string<CharT, HT, Traits>::const_reference
+basic_rhx_string<CharT, HT, Traits>::at(size_type i) const
+{
+    return const_cast<basic_rhx_string*>(this)->at(i);
+}
+
+template<class CharT, class HT, class Traits> inline
+typename basic_rhx_string<CharT, HT, Traits>::reference
+basic_rhx_string<CharT, HT, Traits>::front() noexcept
+{
+    return data()[0];
+}
+
+template<class CharT, class HT, class Traits> inline
+typename basic_rhx_string<CharT, HT, Traits>::const_reference
+basic_rhx_string<CharT, HT, Traits>::front() const noexcept
+{
+    return data()[0];
+}
+
+template<class CharT, class HT, class Traits> inline
+typename basic_rhx_string<CharT, HT, Traits>::reference
+basic_rhx_string<CharT, HT, Traits>::back() noexcept
+{
+    return data()[size() - 1];
+}
+
+template<class CharT, class HT, class Traits> inline
+typename basic_rhx_string<CharT, HT, Traits>::const_reference
+basic_rhx_string<CharT, HT, Traits>::back() const noexcept
+{
+    return data()[size() - 1];
+}
+
+//------
+//
+template<class CharT, class HT, class Traits> inline
+void
+basic_rhx_string<CharT, HT, Traits>::reserve(size_type n)
+{
+    if (n > capacity())
+    {
+        replace_buffer(n, size(), nullptr, 0);
+    }
+}
+
+//- Moves a long string that has become short back into the object; otherwise trims the buffer
+//  to the size of the string.
+//
+template<class CharT, class HT, class Traits>
+void
+basic_rhx_string<CharT, HT, Traits>::shrink_to_fit()
+{
+    if (!is_long())
+    {
+        return;
+    }
+
+    size_type   n = size();
+
+    if (n <= local_capacity)
+    {
+        CharT   tmp[local_capacity + 1];
+
+        Traits::copy(tmp, data(), n);
+        release();
+        Traits::copy(m_rep.m_local, tmp, n);
+        m_meta = 0;
+        set_size(n);
+    }
+    else if (n < capacity())
+    {
+        replace_buffer(n, n, nullptr, 0);
+    }
+}
+
+template<class CharT, class HT, class Traits> inline
+void
+basic_rhx_string<CharT, HT, Traits>::clear() noexcept
+{
+    set_size(0);
+}
+
+template<class CharT, class HT, class Traits>
+void
+basic_rhx_string<CharT, HT, Traits>::resize(size_type n, CharT ch)
+{
+    size_type   old = size();
+
+    if (n > old)
+    {
+        reserve(std::max(n, (old > local_capacity) ? 2 * old : old));
+        Traits::assign(data() + old, n - old, ch);
+    }
+    set_size(n);
+}
+
+template<class CharT, class HT, class Traits> inline
+void
+basic_rhx_string<CharT, HT, Traits>::push_back(CharT ch)
+{
+    append(&ch, 1);
+}
+
+template<class CharT, class HT, class Traits> inline
+void
+basic_rhx_string<CharT, HT, Traits>::pop_back() noexcept
+{
+    set_size(size() - 1);
+}
+
+//------
+//- Appending grows the buffer geometrically.  The source may lie within the string itself,
+//  which is why a new buffer is filled before the old one is released.
+//
+template<class CharT, class HT, class Traits>
+basic_rhx_string<CharT, HT, Traits>&
+basic_rhx_string<CharT, HT, Traits>::append(CharT const* s, size_type n)
+{
+    size_type   old = size();
+
+    if (n <= capacity() - old)
+    {
+        Traits::move(data() + old, s, n);
+        set_size(old + n);
+    }
+    else
+    {
+        check_length(old + n);
+        replace_buffer(std::max(old + n, 2 * capacity()), old, s, n);
+    }
+    return *this;
+}
+
+template<class CharT, class HT, class Traits> inline
+basic_rhx_string<CharT, HT, Traits>&
+basic_rhx_string<CharT, HT, Traits>::append(CharT const* s)
+{
+    return append(s, (size_type) Traits::length(s));
+}
+
+template<class CharT, class HT, class Traits> inline
+basic_rhx_string<CharT, HT, Traits>&
+basic_rhx_string<CharT, HT, Traits>::append(basic_rhx_string const& str)
+{
+    return append(str.data(), str.size());
+}
+
+template<class CharT, class HT, class Traits> inline
+basic_rhx_string<CharT, HT, Traits>&
+basic_rhx_string<CharT, HT, Traits>::operator +=(basic_rhx_string const& str)
+{
+    return append(str.data(), str.size());
+}
+
+template<class CharT, class HT, class Traits> inline
+basic_rhx_string<CharT, HT, Traits>&
+basic_rhx_string<CharT, HT, Traits>::operator +=(CharT const* s)
+{
+    return append(s);
+}
+
+template<class CharT, class HT, class Traits> inline
+basic_rhx_string<CharT, HT, Traits>&
+basic_rhx_string<CharT, HT, Traits>::operator +=(CharT ch)
+{
+    return append(&ch, 1);
+}
+
+//------
+//
+template<class CharT, class HT, class Traits> inline
+int
+basic_rhx_string<CharT, HT, Traits>::compare(CharT const* s, size_type n) const noexcept
+{
+    size_type   len = size();
+    int         cmp = Traits::compare(data(), s, std::min(len, n));
+
+    return (cmp != 0) ? cmp : (len < n) ? -1 : (len > n) ? 1 : 0;
+}
+
+template<class CharT, class HT, class Traits> inline
+int
+basic_rhx_string<CharT, HT, Traits>::compare(basic_rhx_string const& str) const noexcept
+{
+    return compare(str.data(), str.size());
+}
+
+template<class CharT, class HT, class Traits>
+typename basic_rhx_string<CharT, HT, Traits>::size_type
+basic_rhx_string<CharT, HT, Traits>::find(CharT const* s, size_type pos, size_type n) const noexcept
+{
+    size_type       len = size();
+    CharT const*    p   = data();
+
+    for (;  pos <= len  &&  n <= len - pos;  ++pos)
+    {
+        if (Traits::compare(p + pos, s, n) == 0)
+        {
+            return pos;
+        }
+    }
+    return npos;
+}
+
+template<class CharT, class HT, class Traits> inline
+typename basic_rhx_string<CharT, HT, Traits>::size_type
+basic_rhx_string<CharT, HT, Traits>::find(basic_rhx_string const& str, size_type pos) const noexcept
+{
+    return find(str.data(), pos, str.size());
+}
+
+template<class CharT, class HT, class Traits> inline
+typename basic_rhx_string<CharT, HT, Traits>::size_type
+basic_rhx_string<CharT, HT, Traits>::find(CharT ch, size_type pos) const noexcept
+{
+    return find(&ch, pos, 1);
+}
+
+template<class CharT, class HT, class Traits>
+basic_rhx_string<CharT, HT, Traits>
+basic_rhx_string<CharT, HT, Traits>::substr(size_type pos, size_type n) const
+{
+    if (pos > size())
+    {
+        throw std::out_of_range("basic_rhx_string::substr");
+    }
+    return basic_rhx_string(data() + pos, std::min(n, size() - pos));
+}
+
+template<class CharT, class HT, class Traits> inline
+typename basic_rhx_string<CharT, HT, Traits>::allocator_type
+basic_rhx_string<CharT, HT, Traits>::get_allocator() const noexcept
+{
+    return allocator_type();
+}
+
+template<class CharT, class HT, class Traits> inline
+void
+basic_rhx_string<CharT, HT, Traits>::swap(basic_rhx_string& other) noexcept
+{
+    basic_rhx_string    tmp(std::move(other));
+
+    other = std::move(*this);
+    *this = std::move(tmp);
+}
+
+//------
+//
+template<class CharT, class HT, class Traits> inline
+bool
+basic_rhx_string<CharT, HT, Traits>::is_long() const noexcept
+{
+    return (m_meta & long_flag) != 0;
+}
+
+//- Sets the size, keeping the long flag, and writes the terminating null character.
+//
+template<class CharT, class HT, class Traits> inline
+void
+basic_rhx_string<CharT, HT, Traits>::set_size(size_type n) noexcept
+{
+    m_meta = (n << 1) | (m_meta & long_flag);
+    Traits::assign(data()[n], CharT());
+}
+
+//- Initializes an object holding nothing, as from a constructor.
+//
+template<class CharT, class HT, class Traits>
+void
+basic_rhx_string<CharT, HT, Traits>::init(CharT const* s, size_type n)
+{
+    if (n <= local_capacity)
+    {
+        Traits::copy(m_rep.m_local, s, n);
+        set_size(n);
+    }
+    else
+    {
+        replace_buffer(n, 0, s, n);
+    }
+}
+
+//- Takes the representation of another string, which is left empty.  A short string's
+//  characters are simply copied; a long string's synthetic pointer is copy-constructed in
+//  place, so that models whose pointers depend on their own address see the new location.
+//
+template<class CharT, class HT, class Traits>
+void
+basic_rhx_string<CharT, HT, Traits>::steal(basic_rhx_string& other) noexcept
+{
+    if (other.is_long())
+    {
+        ::new (static_cast<void*>(&m_rep.m_long)) long_rep(other.m_rep.m_long);
+        m_meta = other.m_meta;
+
+        other.m_rep.m_long.~long_rep();
+        other.m_meta = 0;
+        other.set_size(0);
+    }
+    else
+    {
+        Traits::copy(m_rep.m_local, other.m_rep.m_local, local_capacity + 1);
+        m_meta = other.m_meta;
+        other.set_size(0);
+    }
+}
+
+//- Releases the buffer of a long string, leaving the object holding nothing.
+//
+template<class CharT, class HT, class Traits>
+void
+basic_rhx_string<CharT, HT, Traits>::release() noexcept
+{
+    if (is_long())
+    {
+        allocator_type().deallocate(m_rep.m_long.m_ptr, m_rep.m_long.m_cap + 1);
+        m_rep.m_long.~long_rep();
+        m_meta = 0;
+    }
+}
+
+//- Moves the string into a new long buffer of capacity cap, keeping its first keep characters
+//  and appending the n characters at s.
+//
+template<class CharT, class HT, class Traits>
+void
+basic_rhx_string<CharT, HT, Traits>::replace_buffer(size_type cap, size_type keep, CharT const* s, size_type n)
+{
+    check_length(cap);
+
+    RHX_TRACE(RHX_TRACE_DEFAULT_SITE("rhx_string buffer"));
+
+    heap_pointer    buf = allocator_type().allocate(cap + 1);
+    CharT*          p   = static_cast<CharT*>(buf);
+
+    Traits::copy(p, data(), keep);
+    Traits::copy(p + keep, s, n);
+    release();
+
+    ::new (static_cast<void*>(&m_rep.m_long)) long_rep{buf, cap};
+    m_meta = long_flag;
+    set_size(keep + n);
+}
+
+template<class CharT, class HT, class Traits> inline
+void
+basic_rhx_string<CharT, HT, Traits>::check_length(size_type n) const
+{
+    if (n > max_size())
+    {
+        throw std::length_error("basic_rhx_string");
+    }
+}
+
+//------
+//
+template<class CharT, class HT, class Traits> inline bool
+operator ==(basic_rhx_string<CharT, HT, Traits> const& lhs, basic_rhx_string<CharT, HT, Traits> const& rhs) noexcept
+{
+    return lhs.size() == rhs.size()  &&  lhs.compare(rhs) == 0;
+}
+
+template<class CharT, class HT, class Traits> inline bool
+operator !=(basic_rhx_string<CharT, HT, Traits> const& lhs, basic_rhx_string<CharT, HT, Traits> const& rhs) noexcept
+{
+    return !(lhs == rhs);
+}
+
+template<class CharT, class HT, class Traits> inline bool
+operator <(basic_rhx_string<CharT, HT, Traits> const& lhs, basic_rhx_string<CharT, HT, Traits> const& rhs) noexcept
+{
+    return lhs.compare(rhs) < 0;
+}
+
+template<class CharT, class HT, class Traits> inline bool
+operator >(basic_rhx_string<CharT, HT, Traits> const& lhs, basic_rhx_string<CharT, HT, Traits> const& rhs) noexcept
+{
+    return rhs < lhs;
+}
+
+template<class CharT, class HT, class Traits> inline bool
+operator <=(basic_rhx_string<CharT, HT, Traits> const& lhs, basic_rhx_string<CharT, HT, Traits> const& rhs) noexcept
+{
+    return !(rhs < lhs);
+}
+
+template<class CharT, class HT, class Traits> inline bool
+operator >=(basic_rhx_string<CharT, HT, Traits> const& lhs, basic_rhx_string<CharT, HT, Traits> const& rhs) noexcept
+{
+    return !(lhs < rhs);
+}
+
+template<class CharT, class HT, class Traits> inline bool
+operator ==(basic_rhx_string<CharT, HT, Traits> const& lhs, CharT const* rhs) noexcept
+{
+    return lhs.compare(rhs, Traits::length(rhs)) == 0;
+}
+
+template<class CharT, class HT, class Traits> inline bool
+operator ==(CharT const* lhs, basic_rhx_string<CharT, HT, Traits> const& rhs) noexcept
+{
+    return rhs == lhs;
+}
+
+template<class CharT, class HT, class Traits, class A> inline bool
+operator ==(std::basic_string<CharT, Traits, A> const& lhs, basic_rhx_string<CharT, HT, Traits> const& rhs) noexcept
+{
+    return lhs.size() == rhs.size()  &&  rhs.compare(lhs.data(), rhs.size()) == 0;
+}
+
+template<class CharT, class HT, class Traits, class A> inline bool
+operator ==(basic_rhx_string<CharT, HT, Traits> const& lhs, std::basic_string<CharT, Traits, A> const& rhs) noexcept
+{
+    return rhs == lhs;
+}
+
+template<class CharT, class HT, class Traits, class A> inline bool
+operator !=(std::basic_string<CharT, Traits, A> const& lhs, basic_rhx_string<CharT, HT, Traits> const& rhs) noexcept
+{
+    return !(lhs == rhs);
+}
+
+template<class CharT, class HT, class Traits, class A> inline bool
+operator !=(basic_rhx_string<CharT, HT, Traits> const& lhs, std::basic_string<CharT, Traits, A> const& rhs) noexcept
+{
+    return !(rhs == lhs);
+}
+
+template<class CharT, class HT, class Traits> inline
+std::basic_ostream<CharT, Traits>&
+operator <<(std::basic_ostream<CharT, Traits>& os, basic_rhx_string<CharT, HT, Traits> const& str)
+{
+    return os.write(str.data(), (std::streamsize) str.size());
+}
+
+template<class CharT, class HT, class Traits> inline
+void
+swap(basic_rhx_string<CharT, HT, Traits>& lhs, basic_rhx_string<CharT, HT, Traits>& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+
+template<class HT>
+using rhx_string = basic_rhx_string<char, HT>;
+
+//- Hashes a sequence of bytes with 64-bit FNV-1a.
+//
+inline std::size_t
+rhx_hash_bytes(void const* data, std::size_t n) noexcept
+{
+    unsigned char const*    p = static_cast<unsigned char const*>(data);
+    std::uint64_t           h = 0xCBF29CE484222325ull;
+
+    for (std::size_t i = 0;  i < n;  ++i)
+    {
+        h = (h ^ p[i]) * 0x100000001B3ull;
+    }
+    return (std::size_t) h;
+}
+
+//- Hashes the characters, so that strings may be the keys of unordered containers.
+//
+namespace std
+{
+    template<class CharT, class HT, class Traits>
+    struct hash<basic_rhx_string<CharT, HT, Traits>>
+    {
+        size_t
+        operator ()(basic_rhx_string<CharT, HT, Traits> const& str) const noexcept
+        {
+            return rhx_hash_bytes(str.data(), str.size() * sizeof(CharT));
+        }
+    };
+}
+
+#endif  //- RHX_STRING_H_DEFINED
@@ -0,0 +1,45 @@
+//==================================================================================================
+//  File:
+//      rhx_trace.h
+//
+//  Summary:
+//      Defines the traits class template by which the types of objects in the heap register the
+//      synthetic pointers they hold, for use by the heap's tracing tools.
+//
+//  Copyright (c) 2017 Bob Steagall, KEWB Computing
+//==================================================================================================
+//
+#ifndef RHX_TRACE_H_DEFINED
+#define RHX_TRACE_H_DEFINED
+
+//--------------------------------------------------------------------------------------------------
+//  Class:
+//      rhx_trace<T>
+//
+//  Summary:
+//      This traits class template registers the synthetic pointers held by objects of type T.
+//      Its trace() member is called with an object and a visitor, and must call the visitor
+//      on every synthetic pointer member of the object that may refer to heap memory.  The
+//      primary template describes a type holding no pointers; types holding pointers must
+//      specialize it, as in:
+//
+//          template<class AM>
+//          struct rhx_trace<my_node<AM>>
+//          {
+//              template<class V>
+//              static void trace(my_node<AM>& node, V& visit)
+//              {
+//                  visit(node.m_left);
+//                  visit(node.m_right);
+//              }
+//          };
+//--------------------------------------------------------------------------------------------------
+//
+template<class T>
+struct rhx_trace
+{
+    template<class V>
+    static void     trace(T&, V&) {}
+};
+
+#endif  //- RHX_TRACE_H_DEFINED
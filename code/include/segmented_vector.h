@@ -0,0 +1,776 @@
+//==================================================================================================
+//  File:
+//      segmented_vector.h
+//
+//  Summary:
+//      Defines a vector-like container whose elements are stored in fixed-size chunks, so that it
+//      can grow beyond a single segment of the relocatable heap, and its segmented iterator.
+//
+//  Copyright (c) 2017 Bob Steagall, KEWB Computing
+//==================================================================================================
+//
+#ifndef SEGMENTED_VECTOR_H_DEFINED
+#define SEGMENTED_VECTOR_H_DEFINED
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "rhx_allocator.h"
+
+//--------------------------------------------------------------------------------------------------
+//  Class:
+//      segmented_iterator<T, CP>
+//
+//  Summary:
+//      This class template implements a random-access iterator over the chunks of a segmented
+//      vector.  It refers to its chunk by way of the vector's chunk table, whose entries are
+//      synthetic pointers of type CP, and to the element and the chunk's first element by
+//      native pointers, so that stepping within a chunk costs no more than stepping a native
+//      pointer; the chunk's synthetic pointer is only converted when the iterator moves to
+//      another chunk.
+//
+//      The chunk table ends with a null entry, so that the end iterator of a vector whose last
+//      chunk is full has a chunk to refer to.  An iterator's chunk is always the one holding its
+//      position, whichever way it was reached, so iterators to the same position compare equal.
+//
+//      local() and local_end() give the iterator's position and the end of its chunk as native
+//      pointers; for_each_segment() uses them to present a range one chunk at a time.
+//--------------------------------------------------------------------------------------------------
+//
+template<class T, class CP>
+class segmented_iterator
+{
+  public:
+    using difference_type   = std::ptrdiff_t;
+    using value_type        = typename std::remove_const<T>::type;
+    using pointer           = T*;
+    using reference         = T&;
+    using iterator_category = std::random_access_iterator_tag;
+    using chunk_pointer     = CP const*;
+
+  public:
+    segmented_iterator() noexcept;
+    segmented_iterator(chunk_pointer chunk, difference_type offset, difference_type chunk_cap) noexcept;
+
+    template<class U, typename std::enable_if<std::is_convertible<U*, T*>::value, bool>::type = true>
+    segmented_iterator(segmented_iterator<U, CP> const& other) noexcept;
+
+    reference   operator  *() const noexcept;
+    pointer     operator ->() const noexcept;
+    reference   operator [](difference_type n) const noexcept;
+
+    segmented_iterator&     operator ++() noexcept;
+    segmented_iterator      operator ++(int) noexcept;
+    segmented_iterator&     operator --() noexcept;
+    segmented_iterator      operator --(int) noexcept;
+    segmented_iterator&     operator +=(difference_type n) noexcept;
+    segmented_iterator&     operator -=(difference_type n) noexcept;
+
+    segmented_iterator      operator +(difference_type n) const noexcept;
+    segmented_iterator      operator -(difference_type n) const noexcept;
+    difference_type         operator -(segmented_iterator const& other) const noexcept;
+
+    bool    equals(segmented_iterator const& other) const noexcept;
+    bool    less_than(segmented_iterator const& other) const noexcept;
+
+    chunk_pointer   chunk() const noexcept;
+    pointer         local() const noexcept;
+    pointer         local_end() const noexcept;
+
+  private:
+    template<class OT, class OCP> friend class segmented_iterator;
+
+    void    set_chunk(chunk_pointer chunk) noexcept;
+
+    chunk_pointer   m_chunk;
+    pointer         m_cur;
+    pointer         m_first;
+    difference_type m_cap;
+};
+
+//------
+//
+template<class T, class CP> inline
+segmented_iterator<T, CP>::segmented_iterator() noexcept
+:   m_chunk(nullptr)
+,   m_cur(nullptr)
+,   m_first(nullptr)
+,   m_cap(0)
+{}
+
+template<class T, class CP> inline
+segmented_iterator<T, CP>::segmented_iterator
+(chunk_pointer chunk, difference_type offset, difference_type chunk_cap) noexcept
+:   m_cap(chunk_cap)
+{
+    set_chunk(chunk);
+    m_cur = m_first + offset;
+}
+
+template<class T, class CP>
+template<class U, typename std::enable_if<std::is_convertible<U*, T*>::value, bool>::type> inline
+segmented_iterator<T, CP>::segmented_iterator(segmented_iterator<U, CP> const& other) noexcept
+:   m_chunk(other.m_chunk)
+,   m_cur(other.m_cur)
+,   m_first(other.m_first)
+,   m_cap(other.m_cap)
+{}
+
+//------
+//
+template<class T, class CP> inline
+typename segmented_iterator<T, CP>::reference
+segmented_iterator<T, CP>::operator *() const noexcept
+{
+    return *m_cur;
+}
+
+template<class T, class CP> inline
+typename segmented_iterator<T, CP>::pointer
+segmented_iterator<T, CP>::operator ->() const noexcept
+{
+    return m_cur;
+}
+
+template<class T, class CP> inline
+typename segmented_iterator<T, CP>::reference
+segmented_iterator<T, CP>::operator [](difference_type n) const noexcept
+{
+    return *(*this + n);
+}
+
+//------
+//
+template<class T, class CP> inline
+segmented_iterator<T, CP>&
+segmented_iterator<T, CP>::operator ++() noexcept
+{
+    if (++m_cur - m_first == m_cap)
+    {
+        set_chunk(m_chunk + 1);
+        m_cur = m_first;
+    }
+    return *this;
+}
+
+template<class T, class CP> inline
+segmented_iterator<T, CP>
+segmented_iterator<T, CP>::operator ++(int) noexcept
+{
+    segmented_iterator  tmp(*this);
+    ++*this;
+    return tmp;
+}
+
+template<class T, class CP> inline
+segmented_iterator<T, CP>&
+segmented_iterator<T, CP>::operator --() noexcept
+{
+    if (m_cur == m_first)
+    {
+        set_chunk(m_chunk - 1);
+        m_cur = m_first + m_cap;
+    }
+    --m_cur;
+    return *this;
+}
+
+template<class T, class CP> inline
+segmented_iterator<T, CP>
+segmented_iterator<T, CP>::operator --(int) noexcept
+{
+    segmented_iterator  tmp(*this);
+    --*this;
+    return tmp;
+}
+
+//- Moves the iterator within its chunk if it can, and otherwise to the chunk holding the new
+//  position, rounding the chunk offset toward minus infinity when moving backward.
+//
+template<class T, class CP>
+segmented_iterator<T, CP>&
+segmented_iterator<T, CP>::operator +=(difference_type n) noexcept
+{
+    difference_type     offset = n + (m_cur - m_first);
+
+    if (n == 0)
+    {
+        return *this;
+    }
+
+    if (offset >= 0  &&  offset < m_cap)
+    {
+        m_cur += n;
+    }
+    else
+    {
+        difference_type     chunk_offset = (offset > 0) ? (offset / m_cap)
+                                                        : -((-offset - 1) / m_cap) - 1;
+        set_chunk(m_chunk + chunk_offset);
+        m_cur = m_first + (offset - chunk_offset * m_cap);
+    }
+    return *this;
+}
+
+template<class T, class CP> inline
+segmented_iterator<T, CP>&
+segmented_iterator<T, CP>::operator -=(difference_type n) noexcept
+{
+    return *this += -n;
+}
+
+template<class T, class CP> inline
+segmented_iterator<T, CP>
+segmented_iterator<T, CP>::operator +(difference_type n) const noexcept
+{
+    segmented_iterator  tmp(*this);
+    return tmp += n;
+}
+
+template<class T, class CP> inline
+segmented_iterator<T, CP>
+segmented_iterator<T, CP>::operator -(difference_type n) const noexcept
+{
+    segmented_iterator  tmp(*this);
+    return tmp += -n;
+}
+
+template<class T, class CP> inline
+typename segmented_iterator<T, CP>::difference_type
+segmented_iterator<T, CP>::operator -(segmented_iterator const& other) const noexcept
+{
+    return (m_chunk - other.m_chunk) * m_cap + (m_cur - m_first) - (other.m_cur - other.m_first);
+}
+
+//------
+//
+template<class T, class CP> inline
+bool
+segmented_iterator<T, CP>::equals(segmented_iterator const& other) const noexcept
+{
+    return m_cur == other.m_cur  &&  m_chunk == other.m_chunk;
+}
+
+template<class T, class CP> inline
+bool
+segmented_iterator<T, CP>::less_than(segmented_iterator const& other) const noexcept
+{
+    return (m_chunk == other.m_chunk) ? (m_cur < other.m_cur) : (m_chunk < other.m_chunk);
+}
+
+//------
+//
+template<class T, class CP> inline
+typename segmented_iterator<T, CP>::chunk_pointer
+segmented_iterator<T, CP>::chunk() const noexcept
+{
+    return m_chunk;
+}
+
+template<class T, class CP> inline
+typename segmented_iterator<T, CP>::pointer
+segmented_iterator<T, CP>::local() const noexcept
+{
+    return m_cur;
+}
+
+template<class T, class CP> inline
+typename segmented_iterator<T, CP>::pointer
+segmented_iterator<T, CP>::local_end() const noexcept
+{
+    return m_first + m_cap;
+}
+
+//------
+//
+template<class T, class CP> inline
+void
+segmented_iterator<T, CP>::set_chunk(chunk_pointer chunk) noexcept
+{
+    m_chunk = chunk;
+    m_first = (chunk != nullptr) ? static_cast<pointer>(*chunk) : nullptr;
+}
+
+//--------------------------------------------------------------------------------------------------
+//  Facility:   segmented_iterator<T, CP> Operators
+//--------------------------------------------------------------------------------------------------
+//
+template<class T, class U, class CP> inline bool
+operator ==(segmented_iterator<T, CP> const& lhs, segmented_iterator<U, CP> const& rhs)
+{
+    using common = segmented_iterator<typename std::add_const<T>::type, CP>;
+    return common(lhs).equals(common(rhs));
+}
+
+template<class T, class U, class CP> inline bool
+operator !=(segmented_iterator<T, CP> const& lhs, segmented_iterator<U, CP> const& rhs)
+{
+    return !(lhs == rhs);
+}
+
+template<class T, class U, class CP> inline bool
+operator <(segmented_iterator<T, CP> const& lhs, segmented_iterator<U, CP> const& rhs)
+{
+    using common = segmented_iterator<typename std::add_const<T>::type, CP>;
+    return common(lhs).less_than(common(rhs));
+}
+
+template<class T, class U, class CP> inline bool
+operator >(segmented_iterator<T, CP> const& lhs, segmented_iterator<U, CP> const& rhs)
+{
+    return rhs < lhs;
+}
+
+template<class T, class U, class CP> inline bool
+operator <=(segmented_iterator<T, CP> const& lhs, segmented_iterator<U, CP> const& rhs)
+{
+    return !(rhs < lhs);
+}
+
+template<class T, class U, class CP> inline bool
+operator >=(segmented_iterator<T, CP> const& lhs, segmented_iterator<U, CP> const& rhs)
+{
+    return !(lhs < rhs);
+}
+
+template<class T, class CP> inline
+segmented_iterator<T, CP>
+operator +(typename segmented_iterator<T, CP>::difference_type n, segmented_iterator<T, CP> const& it)
+{
+    return it + n;
+}
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      for_each_segment
+//
+//  Summary:
+//      Calls f(first, last) with native pointers delimiting each chunk-local part of the range
+//      [first, last), in order, and returns f.  Each part lies wholly within one chunk, so an
+//      algorithm applied to the parts runs at native speed, with no segment arithmetic in its
+//      inner loop.
+//--------------------------------------------------------------------------------------------------
+//
+template<class T, class CP, class F>
+F
+for_each_segment(segmented_iterator<T, CP> first, segmented_iterator<T, CP> last, F f)
+{
+    while (first.chunk() != last.chunk())
+    {
+        T*  pend = first.local_end();
+
+        f(first.local(), pend);
+        first += pend - first.local();
+    }
+
+    if (first.local() != last.local())
+    {
+        f(first.local(), last.local());
+    }
+    return f;
+}
+
+//--------------------------------------------------------------------------------------------------
+//  Class:
+//      segmented_vector<T, HT>
+//
+//  Summary:
+//      This class template implements a sequence container with vector-like growth at the end,
+//      whose elements are stored in fixed-size chunks allocated by rhx_allocator from the
+//      allocation strategy HT.  By default a chunk is as large as the strategy can allocate,
+//      which is a whole segment, so a vector can span as many segments as the heap has, and
+//      each chunk is local to one segment.  Element references are never invalidated by growth.
+//
+//      The capacity of a vector is therefore bounded by the heap: at most max_segment_count()
+//      segments of 128 MB each, less the space used by the chunk table and anything else in the
+//      heap.  By default that is 1 GB in all; the segment count can be raised when building with
+//      RHX_MAX_SEGMENTS.  The based 1D model addresses only its first segment, so a vector using
+//      it holds only the chunks that fit there, and growth beyond them throws std::bad_alloc.
+//
+//      The chunk table is itself a vector using rhx_allocator, so a segmented vector placed in
+//      the heap is relocatable along with its elements.  Chunks emptied by pop_back() or clear()
+//      are kept for reuse until shrink_to_fit() is called.
+//--------------------------------------------------------------------------------------------------
+//
+template<class T, class HT>
+class segmented_vector
+{
+  public:
+    using allocator_type    = rhx_allocator<T, HT>;
+    using storage_model     = typename HT::storage_model;
+    using value_type        = T;
+    using size_type         = typename HT::size_type;
+    using difference_type   = typename HT::difference_type;
+    using reference         = T&;
+    using const_reference   = T const&;
+    using pointer           = typename allocator_type::pointer;
+    using iterator          = segmented_iterator<T, pointer>;
+    using const_iterator    = segmented_iterator<T const, pointer>;
+
+  public:
+    segmented_vector();
+    explicit segmented_vector(size_type chunk_cap);
+    segmented_vector(segmented_vector&& other) noexcept;
+    ~segmented_vector();
+
+    segmented_vector(segmented_vector const&) = delete;
+    segmented_vector&   operator =(segmented_vector const&) = delete;
+    segmented_vector&   operator =(segmented_vector&& rhs) noexcept;
+
+    iterator        begin() noexcept;
+    iterator        end() noexcept;
+    const_iterator  begin() const noexcept;
+    const_iterator  end() const noexcept;
+    const_iterator  cbegin() const noexcept;
+    const_iterator  cend() const noexcept;
+
+    reference       operator [](size_type i) noexcept;
+    const_reference operator [](size_type i) const noexcept;
+    reference       front() noexcept;
+    reference       back() noexcept;
+
+    bool        empty() const noexcept;
+    size_type   size() const noexcept;
+    size_type   capacity() const noexcept;
+    size_type   chunk_capacity() const noexcept;
+    size_type   chunk_count() const noexcept;
+    T*          chunk_data(size_type i) const noexcept;
+    size_type   chunk_segment(size_type i) const noexcept;
+
+    void        push_back(T const& value);
+    void        push_back(T&& value);
+    template<class... Args>
+    reference   emplace_back(Args&&... args);
+    void        pop_back() noexcept;
+    void        resize(size_type n);
+    void        clear() noexcept;
+    void        shrink_to_fit() noexcept;
+    void        swap(segmented_vector& other) noexcept;
+
+  private:
+    using chunk_table = std::vector<pointer, rhx_allocator<pointer, HT>>;
+
+    T*          slot(size_type i) const noexcept;
+    void        add_chunk();
+
+    chunk_table     m_chunks;       //- Allocated chunks, followed by a null entry
+    size_type       m_size;
+    size_type       m_chunk_cap;
+};
+
+//------
+//
+template<class T, class HT> inline
+segmented_vector<T, HT>::segmented_vector()
+:   m_chunks()
+,   m_size(0)
+,   m_chunk_cap(allocator_type().max_size())
+{}
+
+template<class T, class HT> inline
+segmented_vector<T, HT>::segmented_vector(size_type chunk_cap)
+:   m_chunks()
+,   m_size(0)
+,   m_chunk_cap((chunk_cap == 0) ? 1 : chunk_cap)
+{}
+
+template<class T, class HT> inline
+segmented_vector<T, HT>::segmented_vector(segmented_vector&& other) noexcept
+:   m_chunks(std::move(other.m_chunks))
+,   m_size(other.m_size)
+,   m_chunk_cap(other.m_chunk_cap)
+{
+    other.m_chunks.clear();
+    other.m_size = 0;
+}
+
+template<class T, class HT>
+segmented_vector<T, HT>::~segmented_vector()
+{
+    clear();
+    shrink_to_fit();
+}
+
+template<class T, class HT> inline
+segmented_vector<T, HT>&
+segmented_vector<T, HT>::operator =(segmented_vector&& rhs) noexcept
+{
+    segmented_vector    tmp(std::move(rhs));
+    swap(tmp);
+    return *this;
+}
+
+//------
+//- A vector that has never allocated a chunk has an empty chunk table, and its iterators are
+//  all null.
+//
+template<class T, class HT> inline
+typename segmented_vector<T, HT>::iterator
+segmented_vector<T, HT>::begin() noexcept
+{
+    return m_chunks.empty() ? iterator() : iterator(m_chunks.data(), 0, m_chunk_cap);
+}
+
+template<class T, class HT> inline
+typename segmented_vector<T, HT>::iterator
+segmented_vector<T, HT>::end() noexcept
+{
+    return m_chunks.empty() ? iterator()
+                            : iterator(m_chunks.data() + m_size / m_chunk_cap, m_size % m_chunk_cap, m_chunk_cap);
+}
+
+template<class T, class HT> inline
+typename segmented_vector<T, HT>::const_iterator
+segmented_vector<T, HT>::begin() const noexcept
+{
+    return const_cast<segmented_vector*>(this)->begin();
+}
+
+template<class T, class HT> inline
+typename segmented_vector<T, HT>::const_iterator
+segmented_vector<T, HT>::end() const noexcept
+{
+    return const_cast<segmented_vector*>(this)->end();
+}
+
+template<class T, class HT> inline
+typename segmented_vector<T, HT>::const_iterator
+segmented_vector<T, HT>::cbegin() const noexcept
+{
+    return begin();
+}
+
+template<class T, class HT> inline
+typename segmented_vector<T, HT>::const_iterator
+segmented_vector<T, HT>::cend() const noexcept
+{
+    return end();
+}
+
+//------
+//
+template<class T, class HT> inline
+typename segmented_vector<T, HT>::reference
+segmented_vector<T, HT>::operator [](size_type i) noexcept
+{
+    return *slot(i);
+}
+
+template<class T, class HT> inline
+typename segmented_vector<T, HT>::const_reference
+segmented_vector<T, HT>::operator [](size_type i) const noexcept
+{
+    return *slot(i);
+}
+
+template<class T, class HT> inline
+typename segmented_vector<T, HT>::reference
+segmented_vector<T, HT>::front() noexcept
+{
+    return *slot(0);
+}
+
+template<class T, class HT> inline
+typename segmented_vector<T, HT>::reference
+segmented_vector<T, HT>::back() noexcept
+{
+    return *slot(m_size - 1);
+}
+
+//------
+//
+template<class T, class HT> inline
+bool
+segmented_vector<T, HT>::empty() const noexcept
+{
+    return m_size == 0;
+}
+
+template<class T, class HT> inline
+typename segmented_vector<T, HT>::size_type
+segmented_vector<T, HT>::size() const noexcept
+{
+    return m_size;
+}
+
+template<class T, class HT> inline
+typename segmented_vector<T, HT>::size_type
+segmented_vector<T, HT>::capacity() const noexcept
+{
+    return chunk_count() * m_chunk_cap;
+}
+
+template<class T, class HT> inline
+typename segmented_vector<T, HT>::size_type
+segmented_vector<T, HT>::chunk_capacity() const noexcept
+{
+    return m_chunk_cap;
+}
+
+template<class T, class HT> inline
+typename segmented_vector<T, HT>::size_type
+segmented_vector<T, HT>::chunk_count() const noexcept
+{
+    return m_chunks.empty() ? 0 : (m_chunks.size() - 1);
+}
+
+template<class T, class HT> inline
+T*
+segmented_vector<T, HT>::chunk_data(size_type i) const noexcept
+{
+    return static_cast<T*>(m_chunks[i]);
+}
+
+//- Returns the index of the heap segment holding a chunk.  With the default chunk capacity,
+//  no two chunks share a segment.
+//
+template<class T, class HT> inline
+typename segmented_vector<T, HT>::size_type
+segmented_vector<T, HT>::chunk_segment(size_type i) const noexcept
+{
+    return storage_model::address_segment(chunk_data(i));
+}
+
+//------
+//
+template<class T, class HT> inline
+void
+segmented_vector<T, HT>::push_back(T const& value)
+{
+    emplace_back(value);
+}
+
+template<class T, class HT> inline
+void
+segmented_vector<T, HT>::push_back(T&& value)
+{
+    emplace_back(std::move(value));
+}
+
+template<class T, class HT>
+template<class... Args>
+typename segmented_vector<T, HT>::reference
+segmented_vector<T, HT>::emplace_back(Args&&... args)
+{
+    if (m_size == capacity())
+    {
+        add_chunk();
+    }
+
+    T*  p = ::new (static_cast<void*>(slot(m_size))) T(std::forward<Args>(args)...);
+
+    ++m_size;
+    return *p;
+}
+
+template<class T, class HT> inline
+void
+segmented_vector<T, HT>::pop_back() noexcept
+{
+    slot(--m_size)->~T();
+}
+
+template<class T, class HT>
+void
+segmented_vector<T, HT>::resize(size_type n)
+{
+    while (m_size > n)
+    {
+        pop_back();
+    }
+    while (m_size < n)
+    {
+        emplace_back();
+    }
+}
+
+template<class T, class HT>
+void
+segmented_vector<T, HT>::clear() noexcept
+{
+    if (!std::is_trivially_destructible<T>::value)
+    {
+        for_each_segment(begin(), end(), [](T* first, T* last)
+        {
+            for (;  first != last;  ++first)
+            {
+                first->~T();
+            }
+        });
+    }
+    m_size = 0;
+}
+
+//- Releases the chunks beyond those holding elements.
+//
+template<class T, class HT>
+void
+segmented_vector<T, HT>::shrink_to_fit() noexcept
+{
+    allocator_type  alloc;
+    size_type       used = (m_size + m_chunk_cap - 1) / m_chunk_cap;
+
+    while (chunk_count() > used)
+    {
+        m_chunks.pop_back();
+        alloc.deallocate(m_chunks.back(), m_chunk_cap);
+        m_chunks.back() = nullptr;
+    }
+
+    if (used == 0)
+    {
+        m_chunks.clear();
+        m_chunks.shrink_to_fit();
+    }
+}
+
+template<class T, class HT> inline
+void
+segmented_vector<T, HT>::swap(segmented_vector& other) noexcept
+{
+    m_chunks.swap(other.m_chunks);
+    std::swap(m_size, other.m_size);
+    std::swap(m_chunk_cap, other.m_chunk_cap);
+}
+
+//------
+//
+template<class T, class HT> inline
+T*
+segmented_vector<T, HT>::slot(size_type i) const noexcept
+{
+    return static_cast<T*>(m_chunks[i / m_chunk_cap]) + (i % m_chunk_cap);
+}
+
+//- The table entry for the new chunk is made before the chunk is allocated, so that nothing
+//  is leaked if either allocation fails.
+//
+template<class T, class HT>
+void
+segmented_vector<T, HT>::add_chunk()
+{
+    RHX_TRACE(RHX_TRACE_DEFAULT_SITE("segmented_vector chunk"));
+
+    if (m_chunks.empty())
+    {
+        m_chunks.push_back(nullptr);
+    }
+    m_chunks.push_back(nullptr);
+
+    try
+    {
+        m_chunks[m_chunks.size() - 2] = allocator_type().allocate(m_chunk_cap);
+    }
+    catch (...)
+    {
+        m_chunks.pop_back();
+        throw;
+    }
+}
+
+#endif  //- SEGMENTED_VECTOR_H_DEFINED
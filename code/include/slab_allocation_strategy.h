@@ -0,0 +1,489 @@
+//==================================================================================================
+//  File:
+//      slab_allocation_strategy.h
+//
+//  Summary:
+//      Defines a size-class slab allocation strategy class for testing rhx_allocator.
+//
+//  Copyright (c) 2017 Bob Steagall, KEWB Computing
+//==================================================================================================
+//
+#ifndef SEGMENTED_SLAB_ALLOCATION_STRATEGY_H_DEFINED
+#define SEGMENTED_SLAB_ALLOCATION_STRATEGY_H_DEFINED
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <vector>
+
+#include "rhx_allocator.h"
+#include "synthetic_pointer.h"
+#include "leaky_allocation_strategy.h"
+
+//--------------------------------------------------------------------------------------------------
+//  Class:
+//      slab_allocation_strategy<SM>
+//
+//  Summary:
+//      This class implements a size-class slab allocation strategy, intended for the fixed-size
+//      nodes allocated by list, forward_list, map, and unordered_map.  Small requests are rounded
+//      up to one of a small number of size classes.  The blocks are kept in pools, each with
+//      its own set of size classes, and each size class of a pool carves its blocks from its
+//      own slabs.
+//
+//      Requests made through rhx_allocator<T> carry an rhx_type_tag<T>, and the first types to
+//      make them are each given a pool of their own.  Since node-based containers rebind their
+//      allocators to their node types, the nodes of a container are packed together, apart
+//      from those of other containers whose nodes are of similar size.  Untagged requests, and
+//      those of types beyond the first pool_count - 1, share pool 0.  A size class of a pool
+//      is called a bin.
+//
+//      Freed blocks are kept on per-bin intrusive free lists, whose links are synthetic
+//      pointers stored in the freed blocks themselves, and are reused in LIFO order.  Slabs,
+//      large requests, and over-aligned requests are obtained from leaky_allocation_strategy<SM>,
+//      so the two strategies can safely share the same storage model.
+//
+//      The statistics of this strategy describe the blocks it hands out from its size classes;
+//      the slabs themselves, and large requests, are counted by the leaky strategy.
+//
+//      The strategy records the segment and offset of every slab it carves, by bin, so that
+//      slab_compactor<SM> can find the blocks of each bin.  Slabs emptied by compaction are
+//      kept as spares, and are reused by any bin before new slabs are requested.
+//--------------------------------------------------------------------------------------------------
+//
+template<class SM> class slab_compactor;
+template<class SM> class heap_verifier;
+
+template<class SM>
+class slab_allocation_strategy
+{
+  public:
+    using storage_model         = SM;
+    using addressing_model      = typename SM::addressing_model;
+    using difference_type       = typename SM::difference_type;
+    using size_type             = typename SM::size_type;
+    using void_pointer          = syn_ptr<void, addressing_model>;
+    using const_void_pointer    = syn_ptr<void const, addressing_model>;
+
+    template<class T>
+    using rebind_pointer        = syn_ptr<T, addressing_model>;
+
+    enum : size_type
+    {
+        min_alignment     = 16,                             //- Alignment of every block
+        class_granularity = 16,                             //- Size class spacing
+        class_count       = 16,                             //- Classes of 16 to 256 bytes
+        max_class_size    = class_granularity * class_count,
+        pool_count        = 8,                              //- Pool 0 and seven type pools
+        bin_count         = pool_count * class_count,
+        slab_size         = 1u << 16                        //- 64 KB slabs
+    };
+
+  public:
+    size_type       max_size() const;
+
+    void_pointer    allocate(size_type n, size_type alignment = min_alignment);
+    template<class T>
+    void_pointer    allocate(size_type n, size_type alignment, rhx_type_tag<T>);
+    void            deallocate(void_pointer p, size_type n, size_type alignment = min_alignment);
+    template<class T>
+    void            deallocate(void_pointer p, size_type n, size_type alignment, rhx_type_tag<T>);
+    bool            try_expand(void_pointer p, size_type old_n, size_type new_n);
+
+    static  void    reset_buffers();
+    static  void    swap_buffers();
+
+    template<class T>
+    static  size_type           type_pool();
+    static  allocation_stats&   stats();
+
+  private:
+    friend class slab_compactor<SM>;
+    friend class heap_verifier<SM>;
+
+    using bump_strategy = leaky_allocation_strategy<SM>;
+    using char_pointer  = syn_ptr<char, addressing_model>;
+
+    struct slab_ref
+    {
+        size_type   m_segment;
+        size_type   m_offset;
+    };
+
+    using slab_list = std::vector<slab_ref>;
+
+    template<class T>
+    static  size_type       type_base(rhx_type_tag<T>);
+    static  size_type       type_base(rhx_type_tag<void>);
+    template<class T>
+    static  size_type       assign_pool();
+    static  size_type       size_class(size_type n);
+    static  size_type       block_size(size_type bin);
+    template<class T>
+    static  void_pointer    allocate_from(size_type n, size_type alignment);
+    template<class T>
+    static  void            deallocate_to(void_pointer p, size_type n, size_type alignment);
+    static  void_pointer    carve(size_type bin);
+    static  void            refresh();
+    static  void            locate(void const* p, size_type& segment, size_type& offset);
+
+    static  void_pointer    sm_free_list[bin_count];
+    static  char_pointer    sm_slab_next[bin_count];
+    static  size_type       sm_slab_left[bin_count];
+    static  size_type       sm_epoch;
+    static  size_type       sm_pool_next;
+    template<class T>
+    static  size_type       sm_type_base;       //- First bin of T's pool, bin_count until given
+    static  slab_list       sm_slabs[bin_count];
+    static  slab_list       sm_spare_slabs;
+};
+
+//------
+//
+template<class SM>  typename slab_allocation_strategy<SM>::void_pointer
+slab_allocation_strategy<SM>::sm_free_list[bin_count];
+
+template<class SM>  typename slab_allocation_strategy<SM>::char_pointer
+slab_allocation_strategy<SM>::sm_slab_next[bin_count];
+
+template<class SM>  typename slab_allocation_strategy<SM>::size_type
+slab_allocation_strategy<SM>::sm_slab_left[bin_count];
+
+template<class SM>  typename slab_allocation_strategy<SM>::size_type
+slab_allocation_strategy<SM>::sm_epoch = ~size_type(0);
+
+template<class SM>  typename slab_allocation_strategy<SM>::size_type
+slab_allocation_strategy<SM>::sm_pool_next = 1;
+
+template<class SM>
+template<class T>   typename slab_allocation_strategy<SM>::size_type
+slab_allocation_strategy<SM>::sm_type_base = bin_count;
+
+template<class SM>  typename slab_allocation_strategy<SM>::slab_list
+slab_allocation_strategy<SM>::sm_slabs[bin_count];
+
+template<class SM>  typename slab_allocation_strategy<SM>::slab_list
+slab_allocation_strategy<SM>::sm_spare_slabs;
+
+//------
+//
+template<class SM> inline
+typename slab_allocation_strategy<SM>::size_type
+slab_allocation_strategy<SM>::max_size() const
+{
+    return bump_strategy().max_size();
+}
+
+//------
+//
+template<class SM> inline
+typename slab_allocation_strategy<SM>::void_pointer
+slab_allocation_strategy<SM>::allocate(size_type n, size_type alignment)
+{
+    return allocate_from<void>(n, alignment);
+}
+
+template<class SM>
+template<class T> inline
+typename slab_allocation_strategy<SM>::void_pointer
+slab_allocation_strategy<SM>::allocate(size_type n, size_type alignment, rhx_type_tag<T>)
+{
+    return allocate_from<T>(n, alignment);
+}
+
+//------
+//- A block must be returned to the pool it was allocated from, and so with the same tag, if
+//  any, with which it was allocated.
+//
+template<class SM> inline
+void
+slab_allocation_strategy<SM>::deallocate(void_pointer p, size_type n, size_type alignment)
+{
+    deallocate_to<void>(p, n, alignment);
+}
+
+template<class SM>
+template<class T> inline
+void
+slab_allocation_strategy<SM>::deallocate(void_pointer p, size_type n, size_type alignment, rhx_type_tag<T>)
+{
+    deallocate_to<T>(p, n, alignment);
+}
+
+//------
+//- A small block can be resized in place as long as it stays within its size class; a large
+//  block can be resized if the bump strategy is able to do so.
+//
+template<class SM>
+bool
+slab_allocation_strategy<SM>::try_expand(void_pointer p, size_type old_n, size_type new_n)
+{
+    if (old_n <= max_class_size)
+    {
+        return new_n <= max_class_size  &&  size_class(old_n) == size_class(new_n);
+    }
+    else if (new_n > max_class_size)
+    {
+        return bump_strategy().try_expand(p, old_n, new_n);
+    }
+    else
+    {
+        return false;
+    }
+}
+
+//------
+//
+template<class SM> inline
+void
+slab_allocation_strategy<SM>::reset_buffers()
+{
+    bump_strategy::reset_buffers();
+    refresh();
+}
+
+//------
+//
+template<class SM>
+allocation_stats&
+slab_allocation_strategy<SM>::stats()
+{
+    static allocation_stats     s("slab", storage_model::model_name());
+    return s;
+}
+
+//------
+//- The free list heads and slab cursors live outside the segments, so they are re-created from
+//  their segment:offset positions after the buffers have been swapped.  This matters for the
+//  offset addressing model, whose pointers are relative to their own location.
+//
+template<class SM>
+void
+slab_allocation_strategy<SM>::swap_buffers()
+{
+    size_type   free_seg[bin_count], free_off[bin_count];
+    size_type   slab_seg[bin_count], slab_off[bin_count];
+
+    for (size_type i = 0;  i < bin_count;  ++i)
+    {
+        locate(static_cast<void*>(sm_free_list[i]), free_seg[i], free_off[i]);
+        locate(static_cast<char*>(sm_slab_next[i]), slab_seg[i], slab_off[i]);
+    }
+
+    bump_strategy::swap_buffers();
+
+    for (size_type i = 0;  i < bin_count;  ++i)
+    {
+        if (free_seg[i] != 0)
+        {
+            sm_free_list[i] = void_pointer(storage_model::segment_pointer(free_seg[i], free_off[i]));
+        }
+        if (slab_seg[i] != 0)
+        {
+            sm_slab_next[i] = char_pointer(storage_model::segment_pointer(slab_seg[i], slab_off[i]));
+        }
+    }
+}
+
+//------
+//- Reports the pool given to a type, which is zero if the type pools were all given out before
+//  the type made its first request.
+//
+template<class SM>
+template<class T> inline
+typename slab_allocation_strategy<SM>::size_type
+slab_allocation_strategy<SM>::type_pool()
+{
+    return type_base(rhx_type_tag<T>()) / class_count;
+}
+
+//------
+//- Returns the index of the first bin of a tagged type's pool.  The index is kept in a variable
+//  rather than a function-local static, so that the allocation path tests it without a guard;
+//  untagged requests use pool 0.
+//
+template<class SM>
+template<class T> inline
+typename slab_allocation_strategy<SM>::size_type
+slab_allocation_strategy<SM>::type_base(rhx_type_tag<T>)
+{
+    size_type   base = sm_type_base<T>;
+    return (base != bin_count) ? base : assign_pool<T>();
+}
+
+template<class SM> inline
+typename slab_allocation_strategy<SM>::size_type
+slab_allocation_strategy<SM>::type_base(rhx_type_tag<void>)
+{
+    return 0;
+}
+
+//------
+//- Gives a tagged type its pool the first time it is used.  Once the type pools have all been
+//  given out, later types share pool 0.  The assignment lasts for the life of the program.
+//
+template<class SM>
+template<class T>
+typename slab_allocation_strategy<SM>::size_type
+slab_allocation_strategy<SM>::assign_pool()
+{
+    sm_type_base<T> = (sm_pool_next < pool_count) ? (sm_pool_next++ * class_count) : 0;
+    return sm_type_base<T>;
+}
+
+//------
+//- Maps a request size to its size class.  Every request of the same rounded size falls into
+//  the same class, whatever the type being allocated; the pool is chosen by type.
+//
+template<class SM> inline
+typename slab_allocation_strategy<SM>::size_type
+slab_allocation_strategy<SM>::size_class(size_type n)
+{
+    return (n == 0) ? 0 : ((n - 1) / class_granularity);
+}
+
+template<class SM> inline
+typename slab_allocation_strategy<SM>::size_type
+slab_allocation_strategy<SM>::block_size(size_type bin)
+{
+    return (bin % class_count + 1) * class_granularity;
+}
+
+//------
+//- The pool is looked up only after the buffers have been checked, so that the common path
+//  does not hold the pool's index across the call to refresh().
+//
+template<class SM>
+template<class T> inline
+typename slab_allocation_strategy<SM>::void_pointer
+slab_allocation_strategy<SM>::allocate_from(size_type n, size_type alignment)
+{
+    if (n > max_class_size  ||  alignment > min_alignment)
+    {
+        return bump_strategy().allocate(n, alignment);
+    }
+
+    if (sm_epoch != bump_strategy::epoch())
+    {
+        refresh();
+    }
+
+    size_type       bin = type_base(rhx_type_tag<T>()) + size_class(n);
+    void_pointer    p   = sm_free_list[bin];
+
+    RHX_STATS(stats().record_allocate(n, block_size(bin), 0));
+
+    if (p == nullptr)
+    {
+        return carve(bin);
+    }
+
+    sm_free_list[bin] = *static_cast<void_pointer*>(static_cast<void*>(p));
+    return p;
+}
+
+//------
+//- Pushes a block onto the free list for its bin.  Blocks handed out before the bump strategy
+//  last released its memory no longer exist, and are ignored.
+//
+template<class SM>
+template<class T> inline
+void
+slab_allocation_strategy<SM>::deallocate_to(void_pointer p, size_type n, size_type alignment)
+{
+    if (p == nullptr)
+    {
+        return;
+    }
+
+    if (n > max_class_size  ||  alignment > min_alignment)
+    {
+        bump_strategy().deallocate(p, n, alignment);
+    }
+    else if (sm_epoch == bump_strategy::epoch())
+    {
+        size_type   bin = type_base(rhx_type_tag<T>()) + size_class(n);
+
+        RHX_STATS(stats().record_deallocate(n, block_size(bin)));
+        ::new (static_cast<void*>(p)) void_pointer(sm_free_list[bin]);
+        sm_free_list[bin] = p;
+    }
+}
+
+//------
+//
+template<class SM>
+typename slab_allocation_strategy<SM>::void_pointer
+slab_allocation_strategy<SM>::carve(size_type bin)
+{
+    size_type   bsize = block_size(bin);
+
+    if (sm_slab_left[bin] < bsize)
+    {
+        slab_ref    slab;
+
+        if (sm_spare_slabs.empty())
+        {
+            sm_slab_next[bin] = static_cast<char_pointer>(bump_strategy().allocate(slab_size));
+            locate(static_cast<char*>(sm_slab_next[bin]), slab.m_segment, slab.m_offset);
+        }
+        else
+        {
+            slab = sm_spare_slabs.back();
+            sm_spare_slabs.pop_back();
+            sm_slab_next[bin] = char_pointer(storage_model::segment_address(slab.m_segment) + slab.m_offset);
+        }
+        sm_slabs[bin].push_back(slab);
+        sm_slab_left[bin] = slab_size;
+    }
+
+    void_pointer    p = sm_slab_next[bin];
+
+    sm_slab_next[bin] += bsize;
+    sm_slab_left[bin] -= bsize;
+
+    return p;
+}
+
+template<class SM>
+void
+slab_allocation_strategy<SM>::refresh()
+{
+    for (size_type i = 0;  i < bin_count;  ++i)
+    {
+        sm_free_list[i] = nullptr;
+        sm_slab_next[i] = nullptr;
+        sm_slab_left[i] = 0;
+        sm_slabs[i].clear();
+    }
+
+    sm_spare_slabs.clear();
+    sm_epoch = bump_strategy::epoch();
+    RHX_STATS(stats().record_reset());
+}
+
+//------
+//- Finds the segment containing a given address; the segment index is zero if there is none.
+//
+template<class SM>
+void
+slab_allocation_strategy<SM>::locate(void const* p, size_type& segment, size_type& offset)
+{
+    char const*     pdata = static_cast<char const*>(p);
+
+    segment = offset = 0;
+
+    for (size_type i = storage_model::first_segment_index();  i <= storage_model::last_segment_index();  ++i)
+    {
+        char const*     pbottom = storage_model::segment_address(i);
+
+        if (pbottom != nullptr  &&  pbottom <= pdata  &&  pdata < (pbottom + storage_model::segment_size(i)))
+        {
+            segment = i;
+            offset  = pdata - pbottom;
+            return;
+        }
+    }
+}
+
+#endif  //- SEGMENTED_SLAB_ALLOCATION_STRATEGY_H_DEFINED
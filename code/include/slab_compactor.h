@@ -0,0 +1,500 @@
+//==================================================================================================
+//  File:
+//      slab_compactor.h
+//
+//  Summary:
+//      Defines a compactor for the bins of the slab allocation strategy, which moves
+//      live blocks into the holes left by freed ones and rewrites the synthetic pointers that
+//      refer to them.
+//
+//  Copyright (c) 2017 Bob Steagall, KEWB Computing
+//==================================================================================================
+//
+#ifndef SLAB_COMPACTOR_H_DEFINED
+#define SLAB_COMPACTOR_H_DEFINED
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <memory>
+#include <unordered_set>
+#include <vector>
+
+#include "rhx_trace.h"
+#include "slab_allocation_strategy.h"
+
+//--------------------------------------------------------------------------------------------------
+//  Struct:
+//      compaction_stats
+//
+//  Summary:
+//      This struct reports what a compaction pass found and did, in blocks of the slab size
+//      classes and in slabs.
+//--------------------------------------------------------------------------------------------------
+//
+struct compaction_stats
+{
+    std::size_t     m_live_blocks;      //- Blocks reachable from the roots
+    std::size_t     m_pinned_blocks;    //- Allocated blocks not reachable, left in place
+    std::size_t     m_moved_blocks;     //- Live blocks moved into lower holes
+    std::size_t     m_fixed_pointers;   //- Synthetic pointers rewritten
+    std::size_t     m_released_slabs;   //- Slabs left empty, and returned as spares
+};
+
+//--------------------------------------------------------------------------------------------------
+//  Class:
+//      slab_compactor<SM>
+//
+//  Summary:
+//      This class template compacts the bins of slab_allocation_strategy<SM>, each of which is
+//      one size class of one pool.  After a long run of allocation and deallocation, the blocks
+//      of a bin are scattered over many partly-empty slabs.  Compaction slides them together:
+//      within each bin, the live block at the highest address is moved into the free block at
+//      the lowest address, until the two meet, and the slabs left without any block in use are
+//      handed back to the strategy as spares, which any bin reuses before requesting new memory.
+//
+//      Since the strategy records nothing about the types of the blocks it hands out, moving
+//      them requires the caller to describe where the pointers to them are.  The caller
+//      registers roots, either synthetic pointers or objects holding them, and the
+//      compactor traces everything reachable from them through the rhx_trace<T> registrations
+//      of their types.  Every synthetic pointer visited along the way is recorded, and once
+//      the live blocks have been moved, each is rewritten in its new location to refer to its
+//      target's new location, according to a forwarding table of the moves.  Rewriting every
+//      visited pointer, rather than only those whose targets moved, keeps self-relative
+//      pointers correct when the blocks holding them move.
+//
+//      The blocks found in use but not reached from the roots are pinned: they are neither
+//      moved nor freed.  Any pointer into a block that moves must be reachable from the roots,
+//      and any native pointer or reference into such a block is invalidated by compaction.
+//      A block is assumed to hold a single object, as the nodes of linked structures do.
+//--------------------------------------------------------------------------------------------------
+//
+template<class SM>
+class slab_compactor
+{
+  public:
+    using strategy          = slab_allocation_strategy<SM>;
+    using addressing_model  = typename SM::addressing_model;
+    using size_type         = typename SM::size_type;
+
+    template<class T>
+    using pointer = syn_ptr<T, addressing_model>;
+
+  public:
+    template<class T>
+    void    add_root(pointer<T>& root);
+    template<class T>
+    void    add_root(T& object);
+
+    template<class T>
+    void    operator ()(pointer<T>& ptr);
+
+    compaction_stats    compact();
+
+  private:
+    using trace_fn  = void (*)(void* object, slab_compactor& visit);
+    using assign_fn = void (*)(void* slot, void* target);
+
+    struct work_item
+    {
+        void*       m_object;
+        trace_fn    m_trace;
+    };
+
+    struct slot_record
+    {
+        void*       m_slot;
+        void*       m_target;
+        assign_fn   m_assign;
+    };
+
+    enum block_state : std::uint8_t
+    {
+        block_free,
+        block_pinned,
+        block_live
+    };
+
+    struct slab_info
+    {
+        char*                       m_base;
+        size_type                   m_bin;
+        size_type                   m_block_size;
+        std::vector<block_state>    m_blocks;
+    };
+
+    struct forward_record
+    {
+        char*       m_from;
+        char*       m_to;
+        size_type   m_size;
+    };
+
+    std::vector<work_item>          m_work;
+    std::vector<void*>              m_objects;
+    std::vector<slot_record>        m_slots;
+    std::unordered_set<void*>       m_visited;
+    std::vector<slab_info>          m_slabs;
+    std::vector<forward_record>     m_forward;
+
+    template<class T>
+    static  void    trace_thunk(void* object, slab_compactor& visit);
+    template<class T>
+    static  void    assign_thunk(void* slot, void* target);
+
+    void        push(void* object, trace_fn trace);
+    void        build_slab_table();
+    slab_info*  find_slab(void const* p);
+    void        plan_bin(size_type bin, compaction_stats& stats);
+    void        rebuild_bin(size_type bin, compaction_stats& stats);
+    void*       forward(void* p) const;
+};
+
+//------
+//- Registers a root pointer, which is itself rewritten if its target moves.
+//
+template<class SM>
+template<class T> inline
+void
+slab_compactor<SM>::add_root(pointer<T>& root)
+{
+    (*this)(root);
+}
+
+//- Registers an object, such as a container on the stack, whose pointers are traced but which
+//  is not itself moved, even if it lies in a slab.
+//
+template<class SM>
+template<class T> inline
+void
+slab_compactor<SM>::add_root(T& object)
+{
+    m_objects.push_back(std::addressof(object));
+    push(std::addressof(object), &trace_thunk<T>);
+}
+
+//- Records a synthetic pointer visited while tracing, and schedules its target to be traced.
+//
+template<class SM>
+template<class T> inline
+void
+slab_compactor<SM>::operator ()(pointer<T>& ptr)
+{
+    T*  target = static_cast<T*>(ptr);
+
+    if (target != nullptr)
+    {
+        m_slots.push_back(slot_record{std::addressof(ptr), target, &assign_thunk<T>});
+        push(target, &trace_thunk<T>);
+    }
+}
+
+//------
+//
+template<class SM>
+compaction_stats
+slab_compactor<SM>::compact()
+{
+    compaction_stats    stats = {0, 0, 0, 0, 0};
+
+    if (strategy::sm_epoch != strategy::bump_strategy::epoch())
+    {
+        return stats;
+    }
+
+    //- Mark: trace everything reachable from the roots.
+    //
+    while (!m_work.empty())
+    {
+        work_item   item = m_work.back();
+
+        m_work.pop_back();
+        item.m_trace(item.m_object, *this);
+    }
+
+    //- Plan: classify every block of every slab, and pair the live blocks to be moved with the
+    //  holes they will fill.
+    //
+    build_slab_table();
+
+    for (size_type bin = 0;  bin < strategy::bin_count;  ++bin)
+    {
+        plan_bin(bin, stats);
+    }
+
+    std::sort(m_forward.begin(), m_forward.end(),
+              [](forward_record const& a, forward_record const& b) { return a.m_from < b.m_from; });
+
+    //- Move the blocks, then rewrite every visited pointer at its new location.  A moved block
+    //  never lands on another block being moved, since only free blocks are filled.
+    //
+    for (forward_record const& fr : m_forward)
+    {
+        std::memcpy(fr.m_to, fr.m_from, fr.m_size);
+    }
+
+    for (slot_record const& sr : m_slots)
+    {
+        sr.m_assign(forward(sr.m_slot), forward(sr.m_target));
+    }
+    stats.m_fixed_pointers = m_slots.size();
+    stats.m_moved_blocks   = m_forward.size();
+
+    //- Rebuild the strategy's free lists and slab lists from the new block states.
+    //
+    for (size_type bin = 0;  bin < strategy::bin_count;  ++bin)
+    {
+        rebuild_bin(bin, stats);
+    }
+
+    m_objects.clear();
+    m_slots.clear();
+    m_visited.clear();
+    m_slabs.clear();
+    m_forward.clear();
+
+    return stats;
+}
+
+//------
+//
+template<class SM>
+template<class T>
+void
+slab_compactor<SM>::trace_thunk(void* object, slab_compactor& visit)
+{
+    rhx_trace<T>::trace(*static_cast<T*>(object), visit);
+}
+
+template<class SM>
+template<class T>
+void
+slab_compactor<SM>::assign_thunk(void* slot, void* target)
+{
+    *static_cast<pointer<T>*>(slot) = static_cast<T*>(target);
+}
+
+template<class SM> inline
+void
+slab_compactor<SM>::push(void* object, trace_fn trace)
+{
+    if (m_visited.insert(object).second)
+    {
+        m_work.push_back(work_item{object, trace});
+    }
+}
+
+//- Builds a table of the slabs of every bin, sorted by address, in which each block is
+//  initially in use; then frees the uncarved remainder of each bin's current slab and the
+//  blocks on each bin's free list, marks the blocks reached from the roots as live, and pins
+//  the blocks holding root objects.
+//
+template<class SM>
+void
+slab_compactor<SM>::build_slab_table()
+{
+    for (size_type bin = 0;  bin < strategy::bin_count;  ++bin)
+    {
+        size_type   block_size = strategy::block_size(bin);
+
+        for (auto const& ref : strategy::sm_slabs[bin])
+        {
+            char*   base = SM::segment_address(ref.m_segment) + ref.m_offset;
+
+            m_slabs.push_back(slab_info{base, bin, block_size,
+                              std::vector<block_state>(strategy::slab_size / block_size, block_pinned)});
+        }
+    }
+
+    std::sort(m_slabs.begin(), m_slabs.end(),
+              [](slab_info const& a, slab_info const& b) { return a.m_base < b.m_base; });
+
+    for (size_type bin = 0;  bin < strategy::bin_count;  ++bin)
+    {
+        char*   next = static_cast<char*>(strategy::sm_slab_next[bin]);
+
+        if (next != nullptr  &&  strategy::sm_slab_left[bin] > 0)
+        {
+            if (slab_info* slab = find_slab(next))
+            {
+                size_type   first = (next - slab->m_base) / slab->m_block_size;
+
+                std::fill(slab->m_blocks.begin() + first, slab->m_blocks.end(), block_free);
+            }
+        }
+
+        for (void* p = strategy::sm_free_list[bin];  p != nullptr;
+             p = *static_cast<typename strategy::void_pointer*>(p))
+        {
+            if (slab_info* slab = find_slab(p))
+            {
+                slab->m_blocks[(static_cast<char*>(p) - slab->m_base) / slab->m_block_size] = block_free;
+            }
+        }
+    }
+
+    for (void* p : m_visited)
+    {
+        if (slab_info* slab = find_slab(p))
+        {
+            block_state&    state = slab->m_blocks[(static_cast<char*>(p) - slab->m_base) / slab->m_block_size];
+
+            if (state == block_pinned)
+            {
+                state = block_live;
+            }
+        }
+    }
+
+    for (void* p : m_objects)
+    {
+        if (slab_info* slab = find_slab(p))
+        {
+            slab->m_blocks[(static_cast<char*>(p) - slab->m_base) / slab->m_block_size] = block_pinned;
+        }
+    }
+}
+
+//- Finds the slab containing an address, if any.
+//
+template<class SM>
+typename slab_compactor<SM>::slab_info*
+slab_compactor<SM>::find_slab(void const* p)
+{
+    char const*     pc = static_cast<char const*>(p);
+    auto            it = std::upper_bound(m_slabs.begin(), m_slabs.end(), pc,
+                            [](char const* a, slab_info const& s) { return a < s.m_base; });
+
+    if (it == m_slabs.begin())
+    {
+        return nullptr;
+    }
+    --it;
+
+    size_type   index = (pc - it->m_base) / it->m_block_size;
+
+    return (pc < it->m_base + strategy::slab_size  &&  index < it->m_blocks.size()) ? &*it : nullptr;
+}
+
+//- Pairs the live blocks of a bin, from the highest address down, with its free blocks, from
+//  the lowest address up, until the two meet.
+//
+template<class SM>
+void
+slab_compactor<SM>::plan_bin(size_type bin, compaction_stats& stats)
+{
+    using block_ref = std::pair<slab_info*, size_type>;
+
+    std::vector<block_ref>  holes;
+    std::vector<block_ref>  lives;
+
+    for (slab_info& slab : m_slabs)
+    {
+        if (slab.m_bin != bin)
+        {
+            continue;
+        }
+        for (size_type i = 0;  i < slab.m_blocks.size();  ++i)
+        {
+            switch (slab.m_blocks[i])
+            {
+              case block_free:      holes.emplace_back(&slab, i);   break;
+              case block_live:      lives.emplace_back(&slab, i);   ++stats.m_live_blocks;  break;
+              case block_pinned:    ++stats.m_pinned_blocks;        break;
+            }
+        }
+    }
+
+    auto    addr = [](block_ref const& b) { return b.first->m_base + b.second * b.first->m_block_size; };
+    auto    hole = holes.begin();
+    auto    live = lives.rbegin();
+
+    for (;  hole != holes.end()  &&  live != lives.rend()  &&  addr(*hole) < addr(*live);  ++hole, ++live)
+    {
+        m_forward.push_back(forward_record{addr(*live), addr(*hole), live->first->m_block_size});
+        hole->first->m_blocks[hole->second] = block_live;
+        live->first->m_blocks[live->second] = block_free;
+    }
+}
+
+//- Returns the slabs of a bin left without blocks in use to the strategy as spares, and
+//  rebuilds the bin's free list from the free blocks of the remaining slabs, lowest address
+//  first.  The free list then covers the uncarved remainder of the current slab as well, so the
+//  bin starts a new slab only once it is exhausted.
+//
+template<class SM>
+void
+slab_compactor<SM>::rebuild_bin(size_type bin, compaction_stats& stats)
+{
+    using void_pointer = typename strategy::void_pointer;
+
+    typename strategy::slab_list    kept;
+    void_pointer                    head = nullptr;
+
+    for (auto it = m_slabs.rbegin();  it != m_slabs.rend();  ++it)
+    {
+        slab_info&  slab = *it;
+
+        if (slab.m_bin != bin)
+        {
+            continue;
+        }
+
+        typename strategy::slab_ref     ref;
+
+        strategy::locate(slab.m_base, ref.m_segment, ref.m_offset);
+
+        if (std::all_of(slab.m_blocks.begin(), slab.m_blocks.end(),
+                        [](block_state s) { return s == block_free; }))
+        {
+            strategy::sm_spare_slabs.push_back(ref);
+            ++stats.m_released_slabs;
+            continue;
+        }
+
+        kept.push_back(ref);
+
+        for (size_type i = slab.m_blocks.size();  i-- > 0;  )
+        {
+            if (slab.m_blocks[i] == block_free)
+            {
+                void*   p = slab.m_base + i * slab.m_block_size;
+
+                ::new (p) void_pointer(head);
+                head = void_pointer(p);
+            }
+        }
+    }
+
+    std::reverse(kept.begin(), kept.end());
+    strategy::sm_slabs[bin].swap(kept);
+    strategy::sm_free_list[bin] = head;
+    strategy::sm_slab_next[bin] = nullptr;
+    strategy::sm_slab_left[bin] = 0;
+}
+
+//- Maps an address within a moved block to the same position in the block's new location;
+//  other addresses are unchanged.
+//
+template<class SM>
+void*
+slab_compactor<SM>::forward(void* p) const
+{
+    char*   pc = static_cast<char*>(p);
+    auto    it = std::upper_bound(m_forward.begin(), m_forward.end(), pc,
+                    [](char* a, forward_record const& fr) { return a < fr.m_from; });
+
+    if (it != m_forward.begin())
+    {
+        --it;
+
+        if (pc < it->m_from + it->m_size)
+        {
+            return it->m_to + (pc - it->m_from);
+        }
+    }
+    return p;
+}
+
+#endif  //- SLAB_COMPACTOR_H_DEFINED
@@ -24,8 +24,29 @@
 //      from the process's own heap (i.e., its private address space).  It is intended to be used
 //      by derived classes to implement a small number of alternative storage models - wrapper,
 //      based 1D, based 2D, and offset.
+//
+//      On Linux, segments can optionally be backed by huge pages to reduce TLB pressure.  The
+//      requested page mode applies to segments allocated after it is set; if it cannot be
+//      honored, allocation falls back through the smaller page sizes to normal pages, and the
+//      mode actually obtained for each segment can be queried.
+//
+//      Segments are also assigned to NUMA nodes round-robin when they are allocated, and on
+//      multi-node Linux machines their memory is bound to the assigned node with mbind().  To
+//      exercise node-aware code on single-node machines, a number of nodes can be simulated;
+//      segments are then assigned to simulated nodes without binding, and the calling thread's
+//      node is whatever it last set.  Node assignments are made at allocation time, so the
+//      segments must be re-created after the simulated node count is changed.
 //--------------------------------------------------------------------------------------------------
 //
+//- The number of segments in the heap may be set when building, for example with the CMake
+//  cache variable of the same name.  Segments are created only as they are needed, so a larger
+//  count costs only the segment tables until the memory is used.  btree_map keeps segment
+//  indexes in eight bits, so the count may be at most 254.
+//
+#ifndef RHX_MAX_SEGMENTS
+    #define RHX_MAX_SEGMENTS    8
+#endif
+
 class storage_model_base
 {
   public:
@@ -34,14 +55,24 @@ class storage_model_base
 
     enum : size_type
     {
-        max_segments = 2,           //- Don't need many for testing
-        max_size     = 1u << 27     //- 128 MB segments
+        max_segments      = RHX_MAX_SEGMENTS,   //- 1 GB in all by default, created as needed
+        max_size          = 1u << 27,           //- 128 MB segments
+        segment_alignment = 1u << 12            //- Segments begin on a 4 KB boundary
+    };
+
+    enum class page_mode : int
+    {
+        normal,         //- Normal pages from the process heap
+        transparent,    //- Transparent huge pages, requested via madvise()
+        huge_2mb,       //- Explicit 2 MB huge pages (MAP_HUGETLB)
+        huge_1gb        //- Explicit 1 GB huge pages (MAP_HUGETLB)
     };
 
   public:
     static  void        allocate_segment(size_type segment, size_type size = max_size);
     static  void        clear_segments();
     static  void        deallocate_segment(size_type segment);
+    static  bool        ensure_segment(size_type segment);
     static  void        init_segments();
     static  void        reset_segments();
     static  void        swap_buffers();
@@ -52,6 +83,20 @@ class storage_model_base
     static  char*       first_segment_address() noexcept;
     static  size_type   first_segment_size() noexcept;
 
+    static  void        set_page_mode(page_mode mode) noexcept;
+    static  page_mode   requested_page_mode() noexcept;
+    static  page_mode   segment_page_mode(size_type segment) noexcept;
+    static  char const* page_mode_name(page_mode mode) noexcept;
+
+    static  void        simulate_nodes(int count) noexcept;
+    static  bool        nodes_simulated() noexcept;
+    static  int         node_count() noexcept;
+    static  int         current_node() noexcept;
+    static  void        set_current_node(int node) noexcept;
+    static  int         segment_node(size_type segment) noexcept;
+    static  int         address_node(void const* p) noexcept;
+    static  size_type   address_segment(void const* p) noexcept;
+
     static  constexpr   size_type   first_segment_index();
     static  constexpr   size_type   last_segment_index();
     static  constexpr   size_type   max_segment_count();
@@ -61,11 +106,21 @@ class storage_model_base
     static  char*       sm_segment_ptrs[max_segments + 2];
     static  size_type   sm_segment_size[max_segments + 2];
     static  char*       sm_shadow_ptrs[max_segments + 2];
+    static  page_mode   sm_segment_mode[max_segments + 2];
+    static  page_mode   sm_shadow_mode[max_segments + 2];
+    static  int         sm_segment_node[max_segments + 2];
     static  char*&      sm_1d_base;
     static  size_type&  sm_1d_size;
+    static  page_mode   sm_page_mode;
+    static  int         sm_simulated_nodes;
     static  bool        sm_ready;
+
+    static  thread_local    int     st_simulated_node;
 };
 
+static_assert(storage_model_base::max_segments >= 1  &&  storage_model_base::max_segments <= 254,
+              "RHX_MAX_SEGMENTS must be between 1 and 254");
+
 //------
 //
 inline char*
@@ -94,6 +149,55 @@ storage_model_base::first_segment_size() noexcept
     return sm_1d_size;
 }
 
+//------
+//
+inline void
+storage_model_base::set_page_mode(page_mode mode) noexcept
+{
+    sm_page_mode = mode;
+}
+
+inline storage_model_base::page_mode
+storage_model_base::requested_page_mode() noexcept
+{
+    return sm_page_mode;
+}
+
+inline storage_model_base::page_mode
+storage_model_base::segment_page_mode(size_type segment) noexcept
+{
+    return sm_segment_mode[segment];
+}
+
+//------
+//
+inline void
+storage_model_base::simulate_nodes(int count) noexcept
+{
+    sm_simulated_nodes = (count > 0) ? count : 0;
+}
+
+inline bool
+storage_model_base::nodes_simulated() noexcept
+{
+    return sm_simulated_nodes != 0;
+}
+
+inline void
+storage_model_base::set_current_node(int node) noexcept
+{
+    st_simulated_node = node;
+}
+
+//- A segment that has not been created yet reports the node it will be assigned when it is.
+//
+inline int
+storage_model_base::segment_node(size_type segment) noexcept
+{
+    return (sm_segment_ptrs[segment] != nullptr) ? sm_segment_node[segment]
+                                                 : (int)((segment - first_segment_index()) % node_count());
+}
+
 //------
 //
 constexpr inline storage_model_base::size_type
@@ -0,0 +1,600 @@
+//==================================================================================================
+//  File:
+//      string_pool.h
+//
+//  Summary:
+//      Defines a pool of interned strings, stored in the relocatable heap and referred to by
+//      compact integer handles.
+//
+//  Copyright (c) 2017 Bob Steagall, KEWB Computing
+//==================================================================================================
+//
+#ifndef STRING_POOL_H_DEFINED
+#define STRING_POOL_H_DEFINED
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "rhx_allocator.h"
+#include "rhx_string.h"
+
+//--------------------------------------------------------------------------------------------------
+//  Class:
+//      string_handle
+//
+//  Summary:
+//      This class represents an interned string as its 32-bit index in the pool that interned
+//      it.  Two handles from the same pool are equal exactly when their strings are, so they
+//      are compared, ordered, and hashed as integers, without reference to the pool; note that
+//      this order is the order of interning, not the lexicographic order of the strings.  Being
+//      an integer, a handle is unaffected by relocation of the heap.
+//
+//      A default-constructed handle refers to the empty string, which every pool holds.
+//--------------------------------------------------------------------------------------------------
+//
+class string_handle
+{
+  public:
+    using id_type = std::uint32_t;
+
+  public:
+    constexpr string_handle() noexcept;
+    constexpr explicit string_handle(id_type id) noexcept;
+
+    constexpr id_type   id() const noexcept;
+    constexpr bool      valid() const noexcept;
+
+    static constexpr string_handle  none() noexcept;
+
+  private:
+    id_type     m_id;
+};
+
+//------
+//
+inline constexpr
+string_handle::string_handle() noexcept
+:   m_id(0)
+{}
+
+inline constexpr
+string_handle::string_handle(id_type id) noexcept
+:   m_id(id)
+{}
+
+inline constexpr string_handle::id_type
+string_handle::id() const noexcept
+{
+    return m_id;
+}
+
+inline constexpr bool
+string_handle::valid() const noexcept
+{
+    return m_id != none().m_id;
+}
+
+//- The handle returned when a string is looked up but not found.
+//
+inline constexpr string_handle
+string_handle::none() noexcept
+{
+    return string_handle(static_cast<id_type>(-1));
+}
+
+inline constexpr bool
+operator ==(string_handle lhs, string_handle rhs) noexcept
+{
+    return lhs.id() == rhs.id();
+}
+
+inline constexpr bool
+operator !=(string_handle lhs, string_handle rhs) noexcept
+{
+    return lhs.id() != rhs.id();
+}
+
+inline constexpr bool
+operator <(string_handle lhs, string_handle rhs) noexcept
+{
+    return lhs.id() < rhs.id();
+}
+
+namespace std
+{
+    template<>
+    struct hash<string_handle>
+    {
+        size_t
+        operator ()(string_handle h) const noexcept
+        {
+            return hash<string_handle::id_type>()(h.id());
+        }
+    };
+}
+
+//--------------------------------------------------------------------------------------------------
+//  Class:
+//      basic_string_pool<CharT, HT, Traits>
+//
+//  Summary:
+//      This class template implements a pool of interned strings.  Interning a string returns
+//      the handle of the pool's single copy of it, adding the copy if it is not yet present, so
+//      a symbol that recurs throughout a data structure is stored once and represented
+//      everywhere else by four bytes.
+//
+//      The characters of the strings are packed, null-terminated, into chunks allocated from
+//      the heap, and are never moved or freed individually; a string longer than a quarter of a
+//      chunk is given an allocation of its own.  For each string the pool records a synthetic
+//      pointer to its characters, its length, and its hash, in a vector indexed by handle.  The
+//      index is an open-addressing table of handles with linear probing, whose size is a power
+//      of two kept at least a third larger than the number of strings; the recorded hashes make
+//      probing and rehashing cheap.
+//
+//      All of the pool's state is held in vectors using rhx_allocator and in synthetic
+//      pointers, so a pool placed in the heap is relocated with it, and its handles remain
+//      valid.  The native pointers returned by c_str() remain valid until the pool is cleared
+//      or destroyed, or the heap relocated.
+//--------------------------------------------------------------------------------------------------
+//
+template<class CharT, class HT, class Traits = std::char_traits<CharT>>
+class basic_string_pool
+{
+  public:
+    using traits_type   = Traits;
+    using value_type    = CharT;
+    using handle_type   = string_handle;
+    using size_type     = typename HT::size_type;
+
+    static constexpr size_type  chunk_size = 16384;
+
+  public:
+    basic_string_pool();
+    basic_string_pool(basic_string_pool const& other);
+    basic_string_pool(basic_string_pool&& other) noexcept;
+    ~basic_string_pool();
+
+    basic_string_pool&  operator =(basic_string_pool const& rhs);
+    basic_string_pool&  operator =(basic_string_pool&& rhs) noexcept;
+
+    handle_type     intern(CharT const* s, size_type n);
+    handle_type     intern(CharT const* s);
+    template<class A>
+    handle_type     intern(std::basic_string<CharT, Traits, A> const& str);
+    template<class SHT>
+    handle_type     intern(basic_rhx_string<CharT, SHT, Traits> const& str);
+
+    handle_type     find(CharT const* s, size_type n) const noexcept;
+    handle_type     find(CharT const* s) const noexcept;
+    template<class A>
+    handle_type     find(std::basic_string<CharT, Traits, A> const& str) const noexcept;
+
+    CharT const*    c_str(handle_type h) const noexcept;
+    size_type       length(handle_type h) const noexcept;
+    int             compare(handle_type lhs, handle_type rhs) const noexcept;
+
+    size_type   size() const noexcept;
+    size_type   footprint() const noexcept;
+    void        reserve(size_type n);
+    void        clear();
+    void        swap(basic_string_pool& other) noexcept;
+
+  private:
+    using char_allocator = rhx_allocator<CharT, HT>;
+    using char_pointer   = typename char_allocator::pointer;
+    using id_type        = typename handle_type::id_type;
+
+    struct entry
+    {
+        char_pointer    m_chars;
+        std::uint32_t   m_size;
+        std::uint32_t   m_hash;
+    };
+
+    struct chunk
+    {
+        char_pointer    m_chars;
+        size_type       m_size;
+    };
+
+    using entry_vector = std::vector<entry, rhx_allocator<entry, HT>>;
+    using chunk_vector = std::vector<chunk, rhx_allocator<chunk, HT>>;
+    using slot_vector  = std::vector<id_type, rhx_allocator<id_type, HT>>;
+
+    entry_vector    m_entries;
+    slot_vector     m_slots;        //- Each slot holds a handle's id plus one, or zero if empty
+    chunk_vector    m_chunks;
+    size_type       m_bump;         //- The index of the chunk being filled, or m_chunks.size()
+    size_type       m_bump_used;    //- The number of characters used in that chunk
+
+    static std::uint32_t    hash_of(CharT const* s, size_type n) noexcept;
+
+    size_type       probe(CharT const* s, size_type n, std::uint32_t hash) const noexcept;
+    CharT*          store(CharT const* s, size_type n);
+    void            rehash(size_type nslots);
+    void            release() noexcept;
+};
+
+//------
+//
+template<class CharT, class HT, class Traits>
+basic_string_pool<CharT, HT, Traits>::basic_string_pool()
+:   m_entries()
+,   m_slots()
+,   m_chunks()
+,   m_bump(0)
+,   m_bump_used(0)
+{
+    intern(nullptr, 0);
+}
+
+//- A copy holds the same strings with the same handles, since interning them in order assigns
+//  the same ids.
+//
+template<class CharT, class HT, class Traits>
+basic_string_pool<CharT, HT, Traits>::basic_string_pool(basic_string_pool const& other)
+:   basic_string_pool()
+{
+    reserve(other.size());
+
+    for (size_type i = 1;  i < other.size();  ++i)
+    {
+        handle_type     h((id_type) i);
+
+        intern(other.c_str(h), other.length(h));
+    }
+}
+
+//- A moved-from pool holds no strings, not even the empty string, and may only be destroyed or
+//  assigned.
+//
+template<class CharT, class HT, class Traits> inline
+basic_string_pool<CharT, HT, Traits>::basic_string_pool(basic_string_pool&& other) noexcept
+:   m_entries()
+,   m_slots()
+,   m_chunks()
+,   m_bump(0)
+,   m_bump_used(0)
+{
+    swap(other);
+}
+
+template<class CharT, class HT, class Traits> inline
+basic_string_pool<CharT, HT, Traits>::~basic_string_pool()
+{
+    release();
+}
+
+template<class CharT, class HT, class Traits> inline
+basic_string_pool<CharT, HT, Traits>&
+basic_string_pool<CharT, HT, Traits>::operator =(basic_string_pool const& rhs)
+{
+    if (&rhs != this)
+    {
+        basic_string_pool   tmp(rhs);
+        swap(tmp);
+    }
+    return *this;
+}
+
+template<class CharT, class HT, class Traits> inline
+basic_string_pool<CharT, HT, Traits>&
+basic_string_pool<CharT, HT, Traits>::operator =(basic_string_pool&& rhs) noexcept
+{
+    swap(rhs);
+    return *this;
+}
+
+//------
+//
+template<class CharT, class HT, class Traits>
+typename basic_string_pool<CharT, HT, Traits>::handle_type
+basic_string_pool<CharT, HT, Traits>::intern(CharT const* s, size_type n)
+{
+    std::uint32_t   hash = hash_of(s, n);
+
+    if (!m_slots.empty())
+    {
+        size_type   slot = probe(s, n, hash);
+
+        if (m_slots[slot] != 0)
+        {
+            return handle_type(m_slots[slot] - 1);
+        }
+    }
+
+    if (m_entries.size() >= static_cast<size_type>(handle_type::none().id())  ||  n > UINT32_MAX)
+    {
+        throw std::length_error("basic_string_pool");
+    }
+
+    //- Keep the table no more than three-quarters full.
+    //
+    if (4 * (m_entries.size() + 1) > 3 * m_slots.size())
+    {
+        rehash(std::max<size_type>(16, 2 * m_slots.size()));
+    }
+
+    CharT*      p  = store(s, n);
+    id_type     id = (id_type) m_entries.size();
+
+    m_entries.push_back(entry{char_pointer(p), (std::uint32_t) n, hash});
+    m_slots[probe(s, n, hash)] = id + 1;
+
+    return handle_type(id);
+}
+
+template<class CharT, class HT, class Traits> inline
+typename basic_string_pool<CharT, HT, Traits>::handle_type
+basic_string_pool<CharT, HT, Traits>::intern(CharT const* s)
+{
+    return intern(s, (size_type) Traits::length(s));
+}
+
+template<class CharT, class HT, class Traits>
+template<class A> inline
+typename basic_string_pool<CharT, HT, Traits>::handle_type
+basic_string_pool<CharT, HT, Traits>::intern(std::basic_string<CharT, Traits, A> const& str)
+{
+    return intern(str.data(), (size_type) str.size());
+}
+
+template<class CharT, class HT, class Traits>
+template<class SHT> inline
+typename basic_string_pool<CharT, HT, Traits>::handle_type
+basic_string_pool<CharT, HT, Traits>::intern(basic_rhx_string<CharT, SHT, Traits> const& str)
+{
+    return intern(str.data(), (size_type) str.size());
+}
+
+//------
+//
+template<class CharT, class HT, class Traits> inline
+typename basic_string_pool<CharT, HT, Traits>::handle_type
+basic_string_pool<CharT, HT, Traits>::find(CharT const* s, size_type n) const noexcept
+{
+    if (m_slots.empty())
+    {
+        return handle_type::none();
+    }
+
+    id_type     id = m_slots[probe(s, n, hash_of(s, n))];
+
+    return (id != 0) ? handle_type(id - 1) : handle_type::none();
+}
+
+template<class CharT, class HT, class Traits> inline
+typename basic_string_pool<CharT, HT, Traits>::handle_type
+basic_string_pool<CharT, HT, Traits>::find(CharT const* s) const noexcept
+{
+    return find(s, (size_type) Traits::length(s));
+}
+
+template<class CharT, class HT, class Traits>
+template<class A> inline
+typename basic_string_pool<CharT, HT, Traits>::handle_type
+basic_string_pool<CharT, HT, Traits>::find(std::basic_string<CharT, Traits, A> const& str) const noexcept
+{
+    return find(str.data(), (size_type) str.size());
+}
+
+template<class CharT, class HT, class Traits> inline
+CharT const*
+basic_string_pool<CharT, HT, Traits>::c_str(handle_type h) const noexcept
+{
+    return static_cast<CharT const*>(m_entries[h.id()].m_chars);
+}
+
+template<class CharT, class HT, class Traits> inline
+typename basic_string_pool<CharT, HT, Traits>::size_type
+basic_string_pool<CharT, HT, Traits>::length(handle_type h) const noexcept
+{
+    return m_entries[h.id()].m_size;
+}
+
+//- Compares two strings lexicographically; equal handles need no look at the characters.
+//
+template<class CharT, class HT, class Traits>
+int
+basic_string_pool<CharT, HT, Traits>::compare(handle_type lhs, handle_type rhs) const noexcept
+{
+    if (lhs == rhs)
+    {
+        return 0;
+    }
+
+    size_type   n1  = length(lhs);
+    size_type   n2  = length(rhs);
+    int         cmp = Traits::compare(c_str(lhs), c_str(rhs), std::min(n1, n2));
+
+    return (cmp != 0) ? cmp : (n1 < n2) ? -1 : 1;
+}
+
+//------
+//
+template<class CharT, class HT, class Traits> inline
+typename basic_string_pool<CharT, HT, Traits>::size_type
+basic_string_pool<CharT, HT, Traits>::size() const noexcept
+{
+    return m_entries.size();
+}
+
+//- Reports the number of bytes allocated from the heap by the pool.
+//
+template<class CharT, class HT, class Traits>
+typename basic_string_pool<CharT, HT, Traits>::size_type
+basic_string_pool<CharT, HT, Traits>::footprint() const noexcept
+{
+    size_type   bytes = m_entries.capacity() * sizeof(entry)
+                      + m_slots.capacity() * sizeof(id_type)
+                      + m_chunks.capacity() * sizeof(chunk);
+
+    for (chunk const& c : m_chunks)
+    {
+        bytes += c.m_size * sizeof(CharT);
+    }
+    return bytes;
+}
+
+template<class CharT, class HT, class Traits>
+void
+basic_string_pool<CharT, HT, Traits>::reserve(size_type n)
+{
+    size_type   nslots = std::max<size_type>(16, m_slots.size());
+
+    while (4 * n > 3 * nslots)
+    {
+        nslots *= 2;
+    }
+    if (nslots > m_slots.size())
+    {
+        rehash(nslots);
+    }
+    m_entries.reserve(n);
+}
+
+//- Discards every string except the empty string, whose handle remains valid.
+//
+template<class CharT, class HT, class Traits> inline
+void
+basic_string_pool<CharT, HT, Traits>::clear()
+{
+    basic_string_pool   tmp;
+    swap(tmp);
+}
+
+template<class CharT, class HT, class Traits> inline
+void
+basic_string_pool<CharT, HT, Traits>::swap(basic_string_pool& other) noexcept
+{
+    m_entries.swap(other.m_entries);
+    m_slots.swap(other.m_slots);
+    m_chunks.swap(other.m_chunks);
+    std::swap(m_bump, other.m_bump);
+    std::swap(m_bump_used, other.m_bump_used);
+}
+
+//------
+//- The low 32 bits of the FNV-1a hash suffice to index the table, and are stored with the entry.
+//
+template<class CharT, class HT, class Traits> inline
+std::uint32_t
+basic_string_pool<CharT, HT, Traits>::hash_of(CharT const* s, size_type n) noexcept
+{
+    return (std::uint32_t) rhx_hash_bytes(s, n * sizeof(CharT));
+}
+
+//- Returns the slot holding the given string, or else the empty slot at which probing stopped.
+//  The table is never full, so some slot is always empty.
+//
+template<class CharT, class HT, class Traits>
+typename basic_string_pool<CharT, HT, Traits>::size_type
+basic_string_pool<CharT, HT, Traits>::probe(CharT const* s, size_type n, std::uint32_t hash) const noexcept
+{
+    size_type   mask = m_slots.size() - 1;
+    size_type   slot = hash & mask;
+
+    for (;  m_slots[slot] != 0;  slot = (slot + 1) & mask)
+    {
+        entry const&    e = m_entries[m_slots[slot] - 1];
+
+        if (e.m_hash == hash  &&  e.m_size == n  &&
+            Traits::compare(static_cast<CharT const*>(e.m_chars), s, n) == 0)
+        {
+            break;
+        }
+    }
+    return slot;
+}
+
+//- Copies a string and its terminating null character into the chunk being filled, starting a
+//  new chunk if it does not fit.  A string too long to share a chunk gets an allocation of its
+//  own, and the chunk being filled is left as it was.
+//
+template<class CharT, class HT, class Traits>
+CharT*
+basic_string_pool<CharT, HT, Traits>::store(CharT const* s, size_type n)
+{
+    RHX_TRACE(RHX_TRACE_DEFAULT_SITE("string_pool chunk"));
+
+    CharT*      p;
+
+    m_chunks.reserve(m_chunks.size() + 1);
+
+    if (n + 1 > chunk_size / 4)
+    {
+        m_chunks.push_back(chunk{char_allocator().allocate(n + 1), n + 1});
+        p = static_cast<CharT*>(m_chunks.back().m_chars);
+
+        if (m_bump == m_chunks.size() - 1)
+        {
+            m_bump = m_chunks.size();
+        }
+    }
+    else
+    {
+        if (m_bump == m_chunks.size()  ||  m_bump_used + n + 1 > chunk_size)
+        {
+            m_chunks.push_back(chunk{char_allocator().allocate(chunk_size), chunk_size});
+            m_bump      = m_chunks.size() - 1;
+            m_bump_used = 0;
+        }
+        p = static_cast<CharT*>(m_chunks[m_bump].m_chars) + m_bump_used;
+        m_bump_used += n + 1;
+    }
+
+    Traits::copy(p, s, n);
+    Traits::assign(p[n], CharT());
+    return p;
+}
+
+template<class CharT, class HT, class Traits>
+void
+basic_string_pool<CharT, HT, Traits>::rehash(size_type nslots)
+{
+    slot_vector     slots(nslots, 0);
+    size_type       mask = nslots - 1;
+
+    for (size_type i = 0;  i < m_entries.size();  ++i)
+    {
+        size_type   slot = m_entries[i].m_hash & mask;
+
+        while (slots[slot] != 0)
+        {
+            slot = (slot + 1) & mask;
+        }
+        slots[slot] = (id_type) i + 1;
+    }
+    m_slots.swap(slots);
+}
+
+template<class CharT, class HT, class Traits>
+void
+basic_string_pool<CharT, HT, Traits>::release() noexcept
+{
+    for (chunk& c : m_chunks)
+    {
+        char_allocator().deallocate(c.m_chars, c.m_size);
+    }
+    m_chunks.clear();
+    m_bump      = 0;
+    m_bump_used = 0;
+}
+
+template<class CharT, class HT, class Traits> inline
+void
+swap(basic_string_pool<CharT, HT, Traits>& lhs, basic_string_pool<CharT, HT, Traits>& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+
+template<class HT>
+using string_pool = basic_string_pool<char, HT>;
+
+#endif  //- STRING_POOL_H_DEFINED
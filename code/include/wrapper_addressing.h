@@ -14,6 +14,8 @@
 #include <cstddef>
 #include <cstdint>
 
+#include "addressing_checks.h"
+
 //--------------------------------------------------------------------------------------------------
 //  Class:
 //      wrapper_addressing_model
@@ -22,6 +24,9 @@
 //      This class implements what is probably the simplest possible synthetic addressing model,
 //      one that wraps a native void pointer.  
 //
+//      When built with RHX_CHECKED_ADDRESSING defined, arithmetic on a pointer into one of the
+//      segments is checked to stay within that segment.
+//
 //      Note that the comparison helper functions include several that define the "greater_than"
 //      relationship.  They are included because they are trivial, and make the code for any
 //      synthetic pointer wrapper class comparison operators easier to implement and read.
@@ -180,12 +185,14 @@ wrapper_addressing_model::assign_from(void const* p) noexcept
 inline void
 wrapper_addressing_model::decrement(difference_type dec) noexcept
 {
+    RHX_CHECK_ADDRESS(addressing_checks::check_native_step(m_addr, -dec));
     m_addr = static_cast<char*>(m_addr) - dec;
 }
 
 inline void
 wrapper_addressing_model::increment(difference_type inc) noexcept
 {
+    RHX_CHECK_ADDRESS(addressing_checks::check_native_step(m_addr, inc));
     m_addr = static_cast<char*>(m_addr) + inc;
 }
 
@@ -30,6 +30,7 @@ class wrapper_storage_model : public storage_model_base
     using addressing_model = wrapper_addressing_model;
 
     static  addressing_model    segment_pointer(size_type segment, size_type offset=0);
+    static  char const*         model_name() noexcept;
 
 };
 
@@ -41,4 +42,10 @@ wrapper_storage_model::segment_pointer(size_type segment, size_type offset)
     return addressing_model{segment_address(segment) + offset};
 }
 
+inline char const*
+wrapper_storage_model::model_name() noexcept
+{
+    return "wrapper";
+}
+
 #endif  //- WRAPPER_STORAGE_H_DEFINED
@@ -0,0 +1,60 @@
+//==================================================================================================
+//  File:
+//      addressing_checks.cpp
+//
+//  Summary:
+//      Implements the addressing model checks that do not depend on a storage model, and the
+//      reporting of failed checks.
+//
+//  Copyright (c) 2017 Bob Steagall, KEWB Computing
+//==================================================================================================
+//
+#include <cstdio>
+#include <cstdlib>
+
+#include "addressing_checks.h"
+
+addressing_checks::handler_type     addressing_checks::sm_handler = &addressing_checks::default_handler;
+
+//- Installs a fault handler, or the default handler if it is null, and returns the previous one.
+//
+addressing_checks::handler_type
+addressing_checks::set_handler(handler_type handler) noexcept
+{
+    handler_type    prev = sm_handler;
+
+    sm_handler = (handler != nullptr) ? handler : &default_handler;
+    return prev;
+}
+
+//- Checks that moving a native pointer by the given distance keeps it within the segment that
+//  contains it, if any.  This serves the models whose representations do not record segments.
+//
+void
+addressing_checks::check_native_step(void const* p, difference_type delta) noexcept
+{
+    size_type   segment = storage_model_base::address_segment(p);
+
+    if (segment != 0)
+    {
+        check_step<storage_model_base>(segment,
+            static_cast<char const*>(p) - storage_model_base::segment_address(segment), delta);
+    }
+}
+
+void
+addressing_checks::report(addressing_fault::kind_type kind, size_type segment, size_type offset,
+                          difference_type delta) noexcept
+{
+    sm_handler(addressing_fault{kind, segment, offset, delta});
+}
+
+void
+addressing_checks::default_handler(addressing_fault const& fault)
+{
+    static char const* const    names[] = {"missing segment", "offset overflow", "segment crossing"};
+
+    fprintf(stderr, "addressing fault: %s at segment %zu, offset %zu, moving by %td\n",
+            names[fault.m_kind], fault.m_segment, fault.m_offset, fault.m_delta);
+    std::abort();
+}
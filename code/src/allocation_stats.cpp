@@ -0,0 +1,171 @@
+//==================================================================================================
+//  File:
+//      allocation_stats.cpp
+//
+//  Summary:
+//      Implements the allocation statistics and their reporting.
+//
+//  Copyright (c) 2017 Bob Steagall, KEWB Computing
+//==================================================================================================
+//
+#include <cstdlib>
+#include <cstring>
+
+#include "allocation_stats.h"
+
+allocation_stats*   allocation_stats::sm_first = nullptr;
+
+allocation_stats::allocation_stats(char const* strategy, char const* model)
+:   m_strategy(strategy)
+,   m_model(model)
+,   m_next(sm_first)
+{
+    clear();
+    sm_first = this;
+}
+
+void
+allocation_stats::clear()
+{
+    m_allocations     = 0;
+    m_deallocations   = 0;
+    m_expansions      = 0;
+    m_rollovers       = 0;
+    m_resets          = 0;
+    m_bytes_requested = 0;
+    m_bytes_rounding  = 0;
+    m_bytes_padding   = 0;
+    m_bytes_abandoned = 0;
+    m_bytes_freed     = 0;
+    m_bytes_in_use    = 0;
+    m_high_water      = 0;
+
+    memset(m_class_allocs, 0, sizeof(m_class_allocs));
+    memset(m_class_frees, 0, sizeof(m_class_frees));
+    memset(m_histogram, 0, sizeof(m_histogram));
+    memset(m_segment_peak, 0, sizeof(m_segment_peak));
+}
+
+bool
+allocation_stats::empty() const
+{
+    return m_allocations == 0  &&  m_expansions == 0;
+}
+
+//- Returns the greatest fraction of a segment that has been in use, including its reserved
+//  start, or zero for a segment that has not been allocated.
+//
+double
+allocation_stats::fill_level(size_type segment) const
+{
+    if (segment >= segment_slots  ||  storage_model_base::segment_size(segment) == 0)
+    {
+        return 0.0;
+    }
+    return (double) m_segment_peak[segment] / (double) storage_model_base::segment_size(segment);
+}
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      allocation_stats::print
+//
+//  Summary:
+//      Prints the statistics in a readable form.  Size classes and histogram bins that were
+//      never used, and segments that were never filled, are left out.
+//--------------------------------------------------------------------------------------------------
+//
+void
+allocation_stats::print(FILE* fp) const
+{
+    double const    requested = (m_bytes_requested != 0) ? (double) m_bytes_requested : 1.0;
+
+    fprintf(fp, "allocation stats: %s strategy, %s storage model\n", m_strategy, m_model);
+    fprintf(fp, "  allocations      %12llu   deallocations  %12llu\n",
+            (unsigned long long) m_allocations, (unsigned long long) m_deallocations);
+    fprintf(fp, "  expansions       %12llu   rollovers      %12llu   resets  %llu\n",
+            (unsigned long long) m_expansions, (unsigned long long) m_rollovers,
+            (unsigned long long) m_resets);
+    fprintf(fp, "  bytes requested  %12llu\n", (unsigned long long) m_bytes_requested);
+    fprintf(fp, "  rounding waste   %12llu   (%.2f%% of requested)\n",
+            (unsigned long long) m_bytes_rounding, 100.0 * m_bytes_rounding / requested);
+    fprintf(fp, "  alignment waste  %12llu   (%.2f%% of requested)\n",
+            (unsigned long long) m_bytes_padding, 100.0 * m_bytes_padding / requested);
+    fprintf(fp, "  abandoned        %12llu   (%.2f%% of requested)\n",
+            (unsigned long long) m_bytes_abandoned, 100.0 * m_bytes_abandoned / requested);
+    fprintf(fp, "  bytes freed      %12llu\n", (unsigned long long) m_bytes_freed);
+    fprintf(fp, "  bytes in use     %12llu   high water     %12llu\n",
+            (unsigned long long) m_bytes_in_use, (unsigned long long) m_high_water);
+
+    for (size_type i = 0;  i < segment_slots;  ++i)
+    {
+        if (m_segment_peak[i] != 0)
+        {
+            fprintf(fp, "  segment %2zu peak  %12llu   (%.2f%% full)\n",
+                    i, (unsigned long long) m_segment_peak[i], 100.0 * fill_level(i));
+        }
+    }
+
+    fprintf(fp, "  size class            allocs          frees\n");
+    for (size_type i = 0;  i < class_count;  ++i)
+    {
+        if (m_class_allocs[i] != 0  ||  m_class_frees[i] != 0)
+        {
+            if (i == class_count - 1)
+                fprintf(fp, "      > %4zu", (size_type) ((class_count - 1) * class_granularity));
+            else
+                fprintf(fp, "     <= %4zu", (size_type) ((i + 1) * class_granularity));
+
+            fprintf(fp, "  %14llu %14llu\n",
+                    (unsigned long long) m_class_allocs[i], (unsigned long long) m_class_frees[i]);
+        }
+    }
+
+    fprintf(fp, "  request size          count\n");
+    for (size_type i = 0;  i < histogram_bins;  ++i)
+    {
+        if (m_histogram[i] != 0)
+        {
+            fprintf(fp, "     < 2^%-2zu   %14llu\n", i + 1, (unsigned long long) m_histogram[i]);
+        }
+    }
+    fprintf(fp, "\n");
+}
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      dump_allocation_stats
+//
+//  Summary:
+//      Prints the statistics of every strategy and storage model combination that has made an
+//      allocation.  Does nothing unless statistics were compiled in.
+//--------------------------------------------------------------------------------------------------
+//
+void
+dump_allocation_stats(FILE* fp)
+{
+#ifdef RHX_ALLOCATION_STATS
+    for (allocation_stats const* ps = allocation_stats::first();  ps != nullptr;  ps = ps->next())
+    {
+        if (!ps->empty())
+        {
+            ps->print(fp);
+        }
+    }
+#else
+    fprintf(fp, "allocation stats: not compiled in; define RHX_ALLOCATION_STATS to collect them\n");
+#endif
+}
+
+//- Arranges for the statistics to be dumped to stdout when the program exits.
+//
+void
+dump_allocation_stats_at_exit()
+{
+    static bool     registered = false;
+
+    if (!registered)
+    {
+        atexit([]() { dump_allocation_stats(stdout); });
+        registered = true;
+    }
+}
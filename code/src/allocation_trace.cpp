@@ -0,0 +1,266 @@
+//==================================================================================================
+//  File:
+//      allocation_trace.cpp
+//
+//  Summary:
+//      Implements the allocation trace writer and reader.
+//
+//  Copyright (c) 2017 Bob Steagall, KEWB Computing
+//==================================================================================================
+//
+#include <chrono>
+#include <cstring>
+
+#include "allocation_trace.h"
+
+//- A trace file begins with a header identifying it and giving the size of a record, so that
+//  traces written by a different build are rejected rather than misread.  It ends with a trailer
+//  giving the number of records and the position of the type and site tables.
+//
+namespace
+{
+    char const          trace_magic[8] = { 'R', 'H', 'X', 'T', 'R', 'A', 'C', 'E' };
+    std::size_t const   trace_block    = 4096;      //- Records buffered before writing
+
+    struct trace_header
+    {
+        char        m_magic[8];
+        uint32_t    m_version;
+        uint32_t    m_record_size;
+    };
+
+    struct trace_trailer
+    {
+        uint64_t    m_count;
+        uint64_t    m_tables;
+    };
+
+    using trace_clock = std::chrono::steady_clock;
+
+    trace_clock::time_point     trace_start;
+
+    void
+    write_string(FILE* fp, std::string const& s)
+    {
+        uint32_t    len = (uint32_t) s.size();
+
+        fwrite(&len, sizeof(len), 1, fp);
+        fwrite(s.data(), 1, len, fp);
+    }
+
+    bool
+    read_string(FILE* fp, std::string& s)
+    {
+        uint32_t    len;
+
+        if (fread(&len, sizeof(len), 1, fp) != 1)
+        {
+            return false;
+        }
+        s.resize(len);
+        return len == 0  ||  fread(&s[0], 1, len, fp) == len;
+    }
+}
+
+FILE*                           allocation_trace::sm_file  = nullptr;
+uint64_t                        allocation_trace::sm_count = 0;
+uint16_t                        allocation_trace::sm_site  = 0;
+std::vector<trace_record>       allocation_trace::sm_buffer;
+std::vector<trace_type_info>    allocation_trace::sm_types;
+std::vector<std::string>        allocation_trace::sm_sites(1, "unknown");
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      allocation_trace::start / stop
+//
+//  Summary:
+//      Opens a new trace file and writes its header, or finishes the active trace and closes
+//      its file.  Starting a trace while another is active finishes the first one.
+//--------------------------------------------------------------------------------------------------
+//
+bool
+allocation_trace::start(char const* file_name)
+{
+    stop();
+
+    if ((sm_file = fopen(file_name, "wb")) == nullptr)
+    {
+        return false;
+    }
+
+    trace_header    hdr;
+
+    memcpy(hdr.m_magic, trace_magic, sizeof(trace_magic));
+    hdr.m_version     = 1;
+    hdr.m_record_size = sizeof(trace_record);
+    fwrite(&hdr, sizeof(hdr), 1, sm_file);
+
+    sm_count    = 0;
+    trace_start = trace_clock::now();
+    sm_buffer.reserve(trace_block);
+
+    return true;
+}
+
+void
+allocation_trace::stop()
+{
+    if (sm_file == nullptr)
+    {
+        return;
+    }
+
+    flush();
+
+    trace_trailer   trl;
+    uint32_t        count;
+
+    trl.m_count  = sm_count;
+    trl.m_tables = (uint64_t) ftell(sm_file);
+
+    count = (uint32_t) sm_types.size();
+    fwrite(&count, sizeof(count), 1, sm_file);
+    for (auto const& t : sm_types)
+    {
+        fwrite(&t.m_size, sizeof(t.m_size), 1, sm_file);
+        fwrite(&t.m_align, sizeof(t.m_align), 1, sm_file);
+        write_string(sm_file, t.m_name);
+    }
+
+    count = (uint32_t) sm_sites.size();
+    fwrite(&count, sizeof(count), 1, sm_file);
+    for (auto const& s : sm_sites)
+    {
+        write_string(sm_file, s);
+    }
+
+    fwrite(&trl, sizeof(trl), 1, sm_file);
+    fclose(sm_file);
+    sm_file = nullptr;
+}
+
+//------
+//
+uint16_t
+allocation_trace::register_type(char const* name, std::size_t size, std::size_t align)
+{
+    sm_types.push_back(trace_type_info{name, (uint32_t) size, (uint32_t) align});
+    return (uint16_t) (sm_types.size() - 1);
+}
+
+//- A name that is already registered keeps its id, so that a site in a template shares one id
+//  across its instantiations.  Sites beyond the number that fit in a record are all recorded
+//  as "unknown".
+//
+uint16_t
+allocation_trace::register_site(char const* name)
+{
+    for (std::size_t i = 0;  i < sm_sites.size();  ++i)
+    {
+        if (sm_sites[i] == name)
+        {
+            return (uint16_t) i;
+        }
+    }
+    if (sm_sites.size() > trace_record::site_mask)
+    {
+        return 0;
+    }
+    sm_sites.push_back(name);
+    return (uint16_t) (sm_sites.size() - 1);
+}
+
+//------
+//
+void
+allocation_trace::record(uint16_t op, void const* p, std::size_t size, uint16_t type)
+{
+    trace_record    rec;
+
+    rec.m_time    = (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(trace_clock::now() - trace_start).count();
+    rec.m_address = (uint64_t) reinterpret_cast<uintptr_t>(p);
+    rec.m_size    = (size > UINT32_MAX) ? UINT32_MAX : (uint32_t) size;
+    rec.m_type    = type;
+    rec.m_site_op = (uint16_t) ((op << trace_record::op_shift) | sm_site);
+
+    sm_buffer.push_back(rec);
+
+    if (sm_buffer.size() >= trace_block)
+    {
+        flush();
+    }
+}
+
+void
+allocation_trace::flush()
+{
+    if (!sm_buffer.empty())
+    {
+        fwrite(sm_buffer.data(), sizeof(trace_record), sm_buffer.size(), sm_file);
+        sm_count += sm_buffer.size();
+        sm_buffer.clear();
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      trace_file::read
+//
+//  Summary:
+//      Reads a trace written by allocation_trace.  Returns false if the file cannot be opened,
+//      was not written with the same record layout, or is incomplete.
+//--------------------------------------------------------------------------------------------------
+//
+bool
+trace_file::read(char const* file_name)
+{
+    FILE*           fp = fopen(file_name, "rb");
+    trace_header    hdr;
+    trace_trailer   trl;
+    uint32_t        count;
+    bool            ok = false;
+
+    m_records.clear();
+    m_types.clear();
+    m_sites.clear();
+
+    if (fp == nullptr)
+    {
+        return false;
+    }
+
+    if (fread(&hdr, sizeof(hdr), 1, fp) == 1  &&
+        memcmp(hdr.m_magic, trace_magic, sizeof(trace_magic)) == 0  &&
+        hdr.m_record_size == sizeof(trace_record)  &&
+        fseek(fp, -(long) sizeof(trl), SEEK_END) == 0  &&
+        fread(&trl, sizeof(trl), 1, fp) == 1  &&
+        fseek(fp, (long) sizeof(hdr), SEEK_SET) == 0)
+    {
+        m_records.resize((std::size_t) trl.m_count);
+        ok = m_records.empty()  ||  fread(m_records.data(), sizeof(trace_record), m_records.size(), fp) == m_records.size();
+        ok = ok  &&  fseek(fp, (long) trl.m_tables, SEEK_SET) == 0;
+
+        ok = ok  &&  fread(&count, sizeof(count), 1, fp) == 1;
+        for (uint32_t i = 0;  ok  &&  i < count;  ++i)
+        {
+            trace_type_info     t;
+
+            ok = fread(&t.m_size, sizeof(t.m_size), 1, fp) == 1  &&
+                 fread(&t.m_align, sizeof(t.m_align), 1, fp) == 1  &&
+                 read_string(fp, t.m_name);
+            m_types.push_back(t);
+        }
+
+        ok = ok  &&  fread(&count, sizeof(count), 1, fp) == 1;
+        for (uint32_t i = 0;  ok  &&  i < count;  ++i)
+        {
+            std::string     s;
+
+            ok = read_string(fp, s);
+            m_sites.push_back(s);
+        }
+    }
+
+    fclose(fp);
+    return ok;
+}
@@ -0,0 +1,264 @@
+//==================================================================================================
+//  File:
+//      policy_storage.cpp
+//
+//  Summary:
+//      Implements the segment providers used by the policy-based storage models.
+//
+//  Copyright (c) 2017 Bob Steagall, KEWB Computing
+//==================================================================================================
+//
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "policy_storage.h"
+
+#ifdef __linux__
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+using size_type = std::size_t;
+
+template class based_2d_addressing_model<policy_storage_model<heap_segment_provider, based_2d_addressing_model>>;
+
+//------
+//- As with the segments of storage_model_base, the address returned by new[] is stashed just
+//  below the aligned buffer so that it can be deleted later.
+//
+char*
+heap_segment_provider::allocate(size_type size)
+{
+    char*       praw = new char[size + storage_model_base::segment_alignment];
+    uintptr_t   addr = reinterpret_cast<uintptr_t>(praw) + storage_model_base::segment_alignment;
+    char*       pbuf = reinterpret_cast<char*>(addr & ~(uintptr_t(storage_model_base::segment_alignment) - 1));
+
+    reinterpret_cast<char**>(pbuf)[-1] = praw;
+    memset(pbuf, 0, size);
+    return pbuf;
+}
+
+void
+heap_segment_provider::deallocate(char* pbuf, size_type) noexcept
+{
+    delete [] reinterpret_cast<char**>(pbuf)[-1];
+}
+
+void
+heap_segment_provider::clear(char* pbuf, size_type size) noexcept
+{
+    memset(pbuf, 0, size);
+}
+
+char const*
+heap_segment_provider::name() noexcept
+{
+    return "heap";
+}
+
+#ifdef __linux__
+//------
+//- Mappings are a whole number of pages long; the segment alignment is a multiple of the page
+//  size, so mapped buffers are always suitably aligned.
+//
+static size_type
+mapped_length(size_type size)
+{
+    return (size + storage_model_base::segment_alignment - 1) & ~(size_type(storage_model_base::segment_alignment) - 1);
+}
+
+//- Maps a file that has been opened for a provider, closing it afterward, since the mapping
+//  keeps the underlying object alive.
+//
+static char*
+map_shared_file(int fd, size_type size)
+{
+    void*   pbuf = MAP_FAILED;
+
+    if (fd >= 0)
+    {
+        if (ftruncate(fd, mapped_length(size)) == 0)
+        {
+            pbuf = mmap(nullptr, mapped_length(size), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        }
+        close(fd);
+    }
+    if (pbuf == MAP_FAILED)
+    {
+        throw std::bad_alloc();
+    }
+    return static_cast<char*>(pbuf);
+}
+
+//- Discards the pages of a shared mapping, which then read as zero.  Not every file system
+//  supports this, in which case the pages are zeroed in place.
+//
+static void
+clear_shared_file(char* pbuf, size_type size)
+{
+    if (madvise(pbuf, mapped_length(size), MADV_REMOVE) != 0)
+    {
+        memset(pbuf, 0, size);
+    }
+}
+#endif
+
+//------
+//
+char*
+mmap_segment_provider::allocate(size_type size)
+{
+#ifdef __linux__
+    void*   pbuf = mmap(nullptr, mapped_length(size), PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+    if (pbuf == MAP_FAILED)
+    {
+        throw std::bad_alloc();
+    }
+    return static_cast<char*>(pbuf);
+#else
+    return heap_segment_provider::allocate(size);
+#endif
+}
+
+void
+mmap_segment_provider::deallocate(char* pbuf, size_type size) noexcept
+{
+#ifdef __linux__
+    munmap(pbuf, mapped_length(size));
+#else
+    heap_segment_provider::deallocate(pbuf, size);
+#endif
+}
+
+//- Discarding the pages of a private anonymous mapping returns it to its freshly-mapped state.
+//
+void
+mmap_segment_provider::clear(char* pbuf, size_type size) noexcept
+{
+#ifdef __linux__
+    if (madvise(pbuf, mapped_length(size), MADV_DONTNEED) != 0)
+    {
+        memset(pbuf, 0, size);
+    }
+#else
+    heap_segment_provider::clear(pbuf, size);
+#endif
+}
+
+char const*
+mmap_segment_provider::name() noexcept
+{
+    return "mmap";
+}
+
+//------
+//- Each shared memory object is given a name unique to the process, and the name is removed
+//  as soon as the object is mapped; the object lives on until the last mapping of it is gone.
+//
+char*
+shm_segment_provider::allocate(size_type size)
+{
+#ifdef __linux__
+    static std::atomic<unsigned>    serial{0};
+
+    char    name[64];
+    int     fd;
+
+    snprintf(name, sizeof(name), "/rhx_segment.%d.%u", (int) getpid(), serial++);
+    fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+    if (fd >= 0)
+    {
+        shm_unlink(name);
+    }
+    return map_shared_file(fd, size);
+#else
+    return heap_segment_provider::allocate(size);
+#endif
+}
+
+void
+shm_segment_provider::deallocate(char* pbuf, size_type size) noexcept
+{
+#ifdef __linux__
+    munmap(pbuf, mapped_length(size));
+#else
+    heap_segment_provider::deallocate(pbuf, size);
+#endif
+}
+
+void
+shm_segment_provider::clear(char* pbuf, size_type size) noexcept
+{
+#ifdef __linux__
+    clear_shared_file(pbuf, size);
+#else
+    heap_segment_provider::clear(pbuf, size);
+#endif
+}
+
+char const*
+shm_segment_provider::name() noexcept
+{
+    return "shm";
+}
+
+//------
+//- The backing files are created in the directory named by TMPDIR, or in /tmp.
+//
+char*
+file_segment_provider::allocate(size_type size)
+{
+#ifdef __linux__
+    char const*     dir = getenv("TMPDIR");
+    char            path[4096];
+    int             fd;
+
+    if (dir == nullptr  ||  *dir == '\0')
+    {
+        dir = "/tmp";
+    }
+    if (snprintf(path, sizeof(path), "%s/rhx_segment.XXXXXX", dir) >= (int) sizeof(path))
+    {
+        throw std::bad_alloc();
+    }
+    fd = mkstemp(path);
+    if (fd >= 0)
+    {
+        unlink(path);
+    }
+    return map_shared_file(fd, size);
+#else
+    return heap_segment_provider::allocate(size);
+#endif
+}
+
+void
+file_segment_provider::deallocate(char* pbuf, size_type size) noexcept
+{
+#ifdef __linux__
+    munmap(pbuf, mapped_length(size));
+#else
+    heap_segment_provider::deallocate(pbuf, size);
+#endif
+}
+
+void
+file_segment_provider::clear(char* pbuf, size_type size) noexcept
+{
+#ifdef __linux__
+    clear_shared_file(pbuf, size);
+#else
+    heap_segment_provider::clear(pbuf, size);
+#endif
+}
+
+char const*
+file_segment_provider::name() noexcept
+{
+    return "file";
+}
@@ -0,0 +1,22 @@
+//==================================================================================================
+//  File:
+//      slab_allocation_strategy.cpp
+//
+//  Summary:
+//      Explicitly instantiates the slab allocation strategy for each of the storage models.
+//
+//  Copyright (c) 2017 Bob Steagall, KEWB Computing
+//==================================================================================================
+//
+#include "based_1d_storage.h"
+#include "based_2d_storage.h"
+#include "based_2dxl_storage.h"
+#include "offset_storage.h"
+#include "wrapper_storage.h"
+#include "slab_allocation_strategy.h"
+
+template class slab_allocation_strategy<based_1d_storage_model>;
+template class slab_allocation_strategy<based_2d_storage_model>;
+template class slab_allocation_strategy<based_2dxl_storage_model>;
+template class slab_allocation_strategy<offset_storage_model>;
+template class slab_allocation_strategy<wrapper_storage_model>;
@@ -9,18 +9,244 @@
 //  Copyright (c) 2017 Bob Steagall, KEWB Computing
 //==================================================================================================
 //
+#include <cstdio>
 #include <cstring>
 #include <utility>
 #include "storage_base.h"
 
+#ifdef __linux__
+    #include <sys/mman.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+
+    #ifndef MPOL_BIND
+        #define MPOL_BIND       2
+    #endif
+    #ifndef MPOL_MF_MOVE
+        #define MPOL_MF_MOVE    (1 << 1)
+    #endif
+
+    #ifndef MAP_HUGE_SHIFT
+        #define MAP_HUGE_SHIFT  26
+    #endif
+    #ifndef MAP_HUGE_2MB
+        #define MAP_HUGE_2MB    (21 << MAP_HUGE_SHIFT)
+    #endif
+    #ifndef MAP_HUGE_1GB
+        #define MAP_HUGE_1GB    (30 << MAP_HUGE_SHIFT)
+    #endif
+#endif
+
 using size_type = storage_model_base::size_type;
+using page_mode = storage_model_base::page_mode;
 
 char*       storage_model_base::sm_segment_ptrs[max_segments + 2];
 size_type   storage_model_base::sm_segment_size[max_segments + 2];
 char*       storage_model_base::sm_shadow_ptrs[max_segments + 2];
-char*&      storage_model_base::sm_1d_base = storage_model_base::sm_segment_ptrs[2];
-size_type&  storage_model_base::sm_1d_size = storage_model_base::sm_segment_size[2];
-bool        storage_model_base::sm_ready   = false;
+page_mode   storage_model_base::sm_segment_mode[max_segments + 2];
+page_mode   storage_model_base::sm_shadow_mode[max_segments + 2];
+int         storage_model_base::sm_segment_node[max_segments + 2];
+char*&      storage_model_base::sm_1d_base   = storage_model_base::sm_segment_ptrs[2];
+size_type&  storage_model_base::sm_1d_size   = storage_model_base::sm_segment_size[2];
+page_mode   storage_model_base::sm_page_mode = page_mode::normal;
+int         storage_model_base::sm_simulated_nodes = 0;
+bool        storage_model_base::sm_ready     = false;
+
+thread_local    int     storage_model_base::st_simulated_node = 0;
+
+//------
+//- Segment buffers are aligned to segment_alignment, so that the alignment of an offset within
+//  a segment is the alignment of the corresponding address.  The address returned by new[] is
+//  stashed just below the aligned buffer so that it can be deleted later.
+//
+static char*
+allocate_heap_buffer(size_type size)
+{
+    char*       praw  = new char[size + storage_model_base::segment_alignment];
+    uintptr_t   addr  = reinterpret_cast<uintptr_t>(praw) + storage_model_base::segment_alignment;
+    char*       pbuf  = reinterpret_cast<char*>(addr & ~(uintptr_t(storage_model_base::segment_alignment) - 1));
+
+    reinterpret_cast<char**>(pbuf)[-1] = praw;
+    return pbuf;
+}
+
+static void
+deallocate_heap_buffer(char* pbuf)
+{
+    delete [] reinterpret_cast<char**>(pbuf)[-1];
+}
+
+#ifdef __linux__
+//------
+//- Huge page mappings must be a whole number of pages long, so a segment's mapping may be
+//  longer than the segment itself.
+//
+static size_type
+mapped_length(size_type size, page_mode mode)
+{
+    size_type   page = (mode == page_mode::huge_1gb) ? (1u << 30) : (1u << 21);
+    return (size + page - 1) & ~(page - 1);
+}
+
+static char*
+map_hugetlb_buffer(size_type size, page_mode mode)
+{
+    int     flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB;
+    void*   pbuf;
+
+    flags |= (mode == page_mode::huge_1gb) ? MAP_HUGE_1GB : MAP_HUGE_2MB;
+    pbuf   = mmap(nullptr, mapped_length(size, mode), PROT_READ | PROT_WRITE, flags, -1, 0);
+
+    return (pbuf == MAP_FAILED) ? nullptr : static_cast<char*>(pbuf);
+}
+
+//------
+//- Transparent huge pages can only back 2 MB-aligned ranges, so the mapping is made oversized
+//  and then trimmed to a 2 MB boundary before asking the kernel for huge pages.
+//
+static char*
+map_transparent_buffer(size_type size)
+{
+    size_type   length = mapped_length(size, page_mode::transparent);
+    size_type   extra  = 1u << 21;
+    void*       praw   = mmap(nullptr, length + extra, PROT_READ | PROT_WRITE,
+                              MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+    if (praw == MAP_FAILED)
+    {
+        return nullptr;
+    }
+
+    uintptr_t   raw_addr = reinterpret_cast<uintptr_t>(praw);
+    uintptr_t   buf_addr = (raw_addr + extra - 1) & ~(uintptr_t(extra) - 1);
+    size_type   head     = buf_addr - raw_addr;
+    char*       pbuf     = reinterpret_cast<char*>(buf_addr);
+
+    if (head != 0)
+    {
+        munmap(praw, head);
+    }
+    if (extra - head != 0)
+    {
+        munmap(pbuf + length, extra - head);
+    }
+
+    if (madvise(pbuf, length, MADV_HUGEPAGE) != 0)
+    {
+        munmap(pbuf, length);
+        return nullptr;
+    }
+
+    return pbuf;
+}
+#endif
+
+//------
+//- Returns the number of NUMA nodes configured on this machine, as one more than the highest
+//  node number listed in sysfs.
+//
+static int
+system_node_count()
+{
+    static int  count = 0;
+
+    if (count == 0)
+    {
+        count = 1;
+#ifdef __linux__
+        if (FILE* fp = fopen("/sys/devices/system/node/possible", "r"))
+        {
+            int     lo, hi;
+            char    sep;
+
+            while (fscanf(fp, "%d", &lo) == 1)
+            {
+                hi = lo;
+                if (fscanf(fp, "%c", &sep) == 1  &&  sep == '-')
+                {
+                    if (fscanf(fp, "%d", &hi) != 1) break;
+                    if (fscanf(fp, "%c", &sep) != 1) sep = '\n';
+                }
+                count = (hi + 1 > count) ? (hi + 1) : count;
+                if (sep != ',') break;
+            }
+            fclose(fp);
+        }
+#endif
+    }
+    return count;
+}
+
+//------
+//- Binds the pages of a buffer to a NUMA node.  This must be done before the buffer is first
+//  touched; pages that have already been faulted in are migrated where possible.  Failure is
+//  harmless, and simply leaves the buffer under the default first-touch policy.
+//
+static void
+bind_buffer(char* pbuf, size_type size, int node)
+{
+#ifdef __linux__
+    unsigned long   mask[4] = {};
+    unsigned long   bits    = 8 * sizeof(unsigned long);
+
+    if (node >= 0  &&  node < (int)(bits * 4))
+    {
+        mask[node / bits] = 1ul << (node % bits);
+        syscall(SYS_mbind, pbuf, size, MPOL_BIND, mask, bits * 4 + 1, MPOL_MF_MOVE);
+    }
+#else
+    (void) pbuf;
+    (void) size;
+    (void) node;
+#endif
+}
+
+//------
+//- Allocates a segment buffer using the requested page mode, falling back to successively
+//  smaller pages when the request cannot be honored.  The mode obtained is returned in 'mode'.
+//
+static char*
+allocate_buffer(size_type size, page_mode& mode)
+{
+#ifdef __linux__
+    char*   pbuf = nullptr;
+
+    if (mode == page_mode::huge_1gb)
+    {
+        if ((pbuf = map_hugetlb_buffer(size, mode)) != nullptr) return pbuf;
+        mode = page_mode::huge_2mb;
+    }
+    if (mode == page_mode::huge_2mb)
+    {
+        if ((pbuf = map_hugetlb_buffer(size, mode)) != nullptr) return pbuf;
+        mode = page_mode::transparent;
+    }
+    if (mode == page_mode::transparent)
+    {
+        if ((pbuf = map_transparent_buffer(size)) != nullptr) return pbuf;
+    }
+#endif
+
+    mode = page_mode::normal;
+    return allocate_heap_buffer(size);
+}
+
+static void
+deallocate_buffer(char* pbuf, size_type size, page_mode mode)
+{
+#ifdef __linux__
+    if (mode != page_mode::normal)
+    {
+        munmap(pbuf, mapped_length(size, mode));
+        return;
+    }
+#else
+    (void) size;
+    (void) mode;
+#endif
+
+    deallocate_heap_buffer(pbuf);
+}
 
 void
 storage_model_base::allocate_segment(size_type segment, size_type size)
@@ -28,13 +254,21 @@ storage_model_base::allocate_segment(size_type segment, size_type size)
     if (segment >= first_segment_index()  &&  segment <= last_segment_index()  &&  
         size <= max_size  &&  sm_segment_ptrs[segment] == nullptr)
     {
-        sm_shadow_ptrs[segment] = new char[size];
+        int     node = (int)((segment - first_segment_index()) % node_count());
+        bool    bind = !nodes_simulated()  &&  node_count() > 1;
+
+        sm_shadow_mode[segment] = sm_page_mode;
+        sm_shadow_ptrs[segment] = allocate_buffer(size, sm_shadow_mode[segment]);
+        if (bind) bind_buffer(sm_shadow_ptrs[segment], size, node);
         memset(sm_shadow_ptrs[segment], 0, size);
 
-        sm_segment_ptrs[segment] = new char[size];
+        sm_segment_mode[segment] = sm_page_mode;
+        sm_segment_ptrs[segment] = allocate_buffer(size, sm_segment_mode[segment]);
+        if (bind) bind_buffer(sm_segment_ptrs[segment], size, node);
         memset(sm_segment_ptrs[segment], 0, size);
 
         sm_segment_size[segment] = size;
+        sm_segment_node[segment] = node;
     }
 }
 
@@ -54,12 +288,33 @@ storage_model_base::deallocate_segment(size_type segment)
 {
     if (sm_segment_ptrs[segment] != nullptr)
     {
-        delete [] sm_segment_ptrs[segment];
-        delete [] sm_shadow_ptrs[segment];
+        deallocate_buffer(sm_segment_ptrs[segment], sm_segment_size[segment], sm_segment_mode[segment]);
+        deallocate_buffer(sm_shadow_ptrs[segment], sm_segment_size[segment], sm_shadow_mode[segment]);
         sm_segment_ptrs[segment] = nullptr;
         sm_segment_size[segment] = 0;
         sm_shadow_ptrs[segment]  = nullptr;
+        sm_segment_mode[segment] = page_mode::normal;
+        sm_shadow_mode[segment]  = page_mode::normal;
+        sm_segment_node[segment] = 0;
+    }
+}
+
+//------
+//- Creates a segment if it does not yet exist.  Returns false if the index is out of range;
+//  failure to obtain the memory is reported by throwing std::bad_alloc.
+//
+bool
+storage_model_base::ensure_segment(size_type segment)
+{
+    if (segment < first_segment_index()  ||  segment > last_segment_index())
+    {
+        return false;
+    }
+    if (sm_segment_ptrs[segment] == nullptr)
+    {
+        allocate_segment(segment);
     }
+    return sm_segment_ptrs[segment] != nullptr;
 }
 
 void
@@ -67,11 +322,7 @@ storage_model_base::init_segments()
 {
     if (!sm_ready)
     {
-        for (size_type i = first_segment_index();  i <= last_segment_index();  ++i)
-        {
-            allocate_segment(i);
-        }
-
+        allocate_segment(first_segment_index());
         sm_ready = true;
     }
 }
@@ -94,7 +345,77 @@ storage_model_base::swap_buffers()
 {
     for (size_type i = first_segment_index();  i <= last_segment_index();  ++i)
     {
+        if (sm_segment_ptrs[i] == nullptr)
+        {
+            continue;
+        }
         memcpy(sm_shadow_ptrs[i], sm_segment_ptrs[i], sm_segment_size[i]);
         std::swap(sm_shadow_ptrs[i], sm_segment_ptrs[i]);
+        std::swap(sm_shadow_mode[i], sm_segment_mode[i]);
+    }
+}
+
+char const*
+storage_model_base::page_mode_name(page_mode mode) noexcept
+{
+    switch (mode)
+    {
+        case page_mode::transparent:    return "transparent";
+        case page_mode::huge_2mb:       return "huge_2mb";
+        case page_mode::huge_1gb:       return "huge_1gb";
+        default:                        return "normal";
+    }
+}
+
+//------
+//
+int
+storage_model_base::node_count() noexcept
+{
+    return nodes_simulated() ? sm_simulated_nodes : system_node_count();
+}
+
+int
+storage_model_base::current_node() noexcept
+{
+    if (nodes_simulated())
+    {
+        return st_simulated_node % sm_simulated_nodes;
+    }
+
+#ifdef __linux__
+    unsigned    cpu, node;
+
+    if (syscall(SYS_getcpu, &cpu, &node, nullptr) == 0)
+    {
+        return (int) node;
+    }
+#endif
+    return 0;
+}
+
+int
+storage_model_base::address_node(void const* p) noexcept
+{
+    size_type   segment = address_segment(p);
+
+    return (segment != 0) ? sm_segment_node[segment] : -1;
+}
+
+//- Returns the index of the segment containing an address, or zero if there is none.
+//
+size_type
+storage_model_base::address_segment(void const* p) noexcept
+{
+    char const*     pc = static_cast<char const*>(p);
+
+    for (size_type i = first_segment_index();  i <= last_segment_index();  ++i)
+    {
+        if (sm_segment_ptrs[i] != nullptr  &&
+            pc >= sm_segment_ptrs[i]  &&  pc < sm_segment_ptrs[i] + sm_segment_size[i])
+        {
+            return i;
+        }
     }
+    return 0;
 }
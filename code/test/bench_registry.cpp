@@ -0,0 +1,228 @@
+//==================================================================================================
+//  File:
+//      bench_registry.cpp
+//
+//  Summary:
+//      Implements the benchmark registry and the benchmark driver, run with "alloc -b".
+//
+//  Copyright (c) 2017 Bob Steagall, KEWB Computing
+//==================================================================================================
+//
+#include <cstring>
+
+#include "bench_registry.h"
+#include "bench_report.h"
+#include "pointer_tests.h"
+
+namespace
+{
+    vector<bench_entry>&
+    bench_table()
+    {
+        static vector<bench_entry>  table;
+        return table;
+    }
+
+    //- A strategy may be named in full, or without its "_strategy" suffix.
+    //
+    bool
+    name_matches(char const* registered, string const& wanted)
+    {
+        size_t const    len = strlen(registered);
+        size_t const    sfx = sizeof("_strategy") - 1;
+
+        if (wanted == registered)
+        {
+            return true;
+        }
+        return len > sfx  &&  strcmp(registered + len - sfx, "_strategy") == 0  &&
+               wanted.size() == len - sfx  &&  wanted.compare(0, wanted.size(), registered, len - sfx) == 0;
+    }
+
+    bool
+    selected(vector<string> const& names, char const* registered)
+    {
+        if (names.empty())
+        {
+            return true;
+        }
+        for (string const& name : names)
+        {
+            if (name_matches(registered, name))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool
+    known(string const& name, char const* bench_entry::* field)
+    {
+        for (bench_entry const& entry : bench_table())
+        {
+            if (name_matches(entry.*field, name))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+}
+
+//------
+//
+void
+register_bench(char const* op, char const* stype, char const* dtype, bench_function run)
+{
+    bench_table().push_back(bench_entry{op, stype, dtype, run});
+}
+
+vector<bench_entry> const&
+registered_benches()
+{
+    return bench_table();
+}
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      parse_name_list / parse_count_list
+//
+//  Summary:
+//      Split a comma-separated command-line argument into names, or into positive element
+//      counts.  Return false if the list contains an empty item or, for counts, an item that is
+//      not a positive number.
+//--------------------------------------------------------------------------------------------------
+//
+bool
+parse_name_list(char const* list, vector<string>& names)
+{
+    char const*     item = list;
+
+    for (char const* p = list;  ;  ++p)
+    {
+        if (*p == ','  ||  *p == '\0')
+        {
+            if (p == item)
+            {
+                return false;
+            }
+            names.emplace_back(item, p);
+            item = p + 1;
+
+            if (*p == '\0')
+            {
+                return true;
+            }
+        }
+    }
+}
+
+bool
+parse_count_list(char const* list, vector<size_t>& counts)
+{
+    vector<string>  items;
+
+    if (!parse_name_list(list, items))
+    {
+        return false;
+    }
+
+    for (string const& item : items)
+    {
+        char*               end;
+        unsigned long long  n = strtoull(item.c_str(), &end, 10);
+
+        if (*end != '\0'  ||  n == 0  ||  item[0] == '-')
+        {
+            return false;
+        }
+        counts.push_back((size_t) n);
+    }
+    return true;
+}
+
+//------
+//
+void
+list_benches()
+{
+    for (bench_entry const& entry : bench_table())
+    {
+        printf("%-12s %-26s %s\n", entry.m_op, entry.m_stype, entry.m_dtype);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      run_benches
+//
+//  Summary:
+//      Runs every registered benchmark that matches the selection, for each selected element
+//      count, in registration order.  A count whose arrays do not fit in the heap is reported
+//      as n/a instead of being timed.  Returns the number of benchmarks run, or zero if the
+//      selection names an operation, strategy, or type that is not registered.
+//--------------------------------------------------------------------------------------------------
+//
+size_t
+run_benches(bench_selection const& sel)
+{
+    vector<size_t>  counts(sel.m_counts);
+    size_t          nrun = 0;
+
+    for (string const& name : sel.m_ops)
+    {
+        if (!known(name, &bench_entry::m_op))
+        {
+            printf("benchmark driver: no operation named '%s'\n", name.c_str());
+            return 0;
+        }
+    }
+    for (string const& name : sel.m_stypes)
+    {
+        if (!known(name, &bench_entry::m_stype))
+        {
+            printf("benchmark driver: no strategy named '%s'\n", name.c_str());
+            return 0;
+        }
+    }
+    for (string const& name : sel.m_dtypes)
+    {
+        if (!known(name, &bench_entry::m_dtype))
+        {
+            printf("benchmark driver: no data type named '%s'\n", name.c_str());
+            return 0;
+        }
+    }
+
+    if (counts.empty())
+    {
+        counts.assign(elem_counts, elem_counts + max_element_index());
+    }
+
+    for (bench_entry const& entry : bench_table())
+    {
+        if (!selected(sel.m_ops, entry.m_op)  ||
+            !selected(sel.m_stypes, entry.m_stype)  ||
+            !selected(sel.m_dtypes, entry.m_dtype))
+        {
+            continue;
+        }
+
+        for (size_t nelem : counts)
+        {
+            try
+            {
+                entry.m_run(entry.m_stype, entry.m_dtype, nelem);
+            }
+            catch (std::bad_alloc&)
+            {
+                print_unavailable(entry.m_op, entry.m_stype, entry.m_dtype, nelem);
+            }
+        }
+        cout << endl;
+        ++nrun;
+    }
+
+    return nrun;
+}
@@ -0,0 +1,55 @@
+//==================================================================================================
+//  File:
+//      bench_registry.h
+//
+//  Summary:
+//      Declares a registry of the synthetic pointer benchmarks, so that the operations, strategies,
+//      data types, and element counts to be timed can be chosen at run time.
+//
+//  Copyright (c) 2017 Bob Steagall, KEWB Computing
+//==================================================================================================
+//
+#ifndef BENCH_REGISTRY_H_DEFINED
+#define BENCH_REGISTRY_H_DEFINED
+
+#include "common.h"
+
+//- A benchmark is one instantiation of a run_pointer_*_test<AS,DT>() function template, erased
+//  to a plain function pointer that times it for a given element count.
+//
+using bench_function = void (*)(char const* stype, char const* dtype, size_t nelem);
+
+struct bench_entry
+{
+    char const*     m_op;
+    char const*     m_stype;
+    char const*     m_dtype;
+    bench_function  m_run;
+};
+
+//- The benchmarks chosen on the command line.  An empty list selects everything registered in
+//  that dimension; the element counts default to those of the -p option.
+//
+struct bench_selection
+{
+    vector<string>  m_ops;
+    vector<string>  m_stypes;
+    vector<string>  m_dtypes;
+    vector<size_t>  m_counts;
+};
+
+void                        register_bench(char const* op, char const* stype, char const* dtype,
+                                           bench_function run);
+vector<bench_entry> const&  registered_benches();
+
+bool    parse_name_list(char const* list, vector<string>& names);
+bool    parse_count_list(char const* list, vector<size_t>& counts);
+
+void    list_benches();
+size_t  run_benches(bench_selection const& sel);
+
+//- Registers the instantiation of run_pointer_<op>_test<ST,DT>() for the named strategy and type.
+//
+#define REGISTER_BENCH(OP, ST, DT)  register_bench(#OP, #ST, #DT, &run_pointer_##OP##_test<ST,DT>)
+
+#endif  //- BENCH_REGISTRY_H_DEFINED
@@ -0,0 +1,450 @@
+//==================================================================================================
+//  File:
+//      bench_report.cpp
+//
+//  Summary:
+//      Implements facilities for summarizing benchmark timings and writing the results in text
+//      and machine-readable form.
+//
+//  Copyright (c) 2017 Bob Steagall, KEWB Computing
+//==================================================================================================
+//
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "bench_report.h"
+
+#ifndef BENCH_CXX_FLAGS
+    #define BENCH_CXX_FLAGS     "unknown"
+#endif
+
+namespace
+{
+    report_format   fmt       = report_format::text;
+    std::string     file_name;
+    std::ofstream   report;
+
+    //- Describes the compiler that built the harness.
+    //
+    std::string
+    compiler_name()
+    {
+#if defined(COMPILER_GCC)
+        return std::string("gcc ") + __VERSION__;
+#elif defined(COMPILER_CLANG)
+        return std::string("clang ") + __clang_version__;
+#elif defined(COMPILER_MS)
+        return "msvc " + std::to_string(_MSC_FULL_VER);
+#else
+        return "unknown";
+#endif
+    }
+
+    //- Describes the CPU the harness is running on.
+    //
+    std::string
+    cpu_model()
+    {
+        std::ifstream   cpuinfo("/proc/cpuinfo");
+        std::string     line;
+
+        while (std::getline(cpuinfo, line))
+        {
+            if (line.compare(0, 10, "model name") == 0)
+            {
+                auto    pos = line.find(':');
+
+                if (pos != std::string::npos  &&  pos + 2 <= line.size())
+                {
+                    return line.substr(pos + 2);
+                }
+            }
+        }
+        return "unknown";
+    }
+
+    //- Returns the two-sided 95% critical value of Student's t distribution.
+    //
+    double
+    t_critical_95(size_t dof)
+    {
+        static double const     table[] = { 12.706, 4.303, 3.182, 2.776, 2.571,
+                                            2.447, 2.365, 2.306, 2.262, 2.228,
+                                            2.201, 2.179, 2.160, 2.145, 2.131,
+                                            2.120, 2.110, 2.101, 2.093, 2.086,
+                                            2.080, 2.074, 2.069, 2.064, 2.060,
+                                            2.056, 2.052, 2.048, 2.045, 2.042 };
+
+        return (dof == 0) ? 0.0 : (dof <= array_size(table)) ? table[dof - 1] : 1.960;
+    }
+
+    //- Returns the median of a sequence, which is partially reordered.
+    //
+    template<typename T>
+    double
+    median_of(std::vector<T>& v)
+    {
+        size_t  n   = v.size();
+        auto    mid = v.begin() + n / 2;
+
+        std::nth_element(v.begin(), mid, v.end());
+
+        if (n % 2 != 0)
+        {
+            return (double) *mid;
+        }
+        return ((double) *mid + (double) *std::max_element(v.begin(), mid)) / 2.0;
+    }
+
+    //- Quotes a string for CSV or JSON output.
+    //
+    std::string
+    quoted(std::string const& str)
+    {
+        std::string     out(1, '"');
+
+        for (char c : str)
+        {
+            if (c == '"')
+            {
+                out += (fmt == report_format::csv) ? "\"\"" : "\\\"";
+            }
+            else if (c == '\\'  &&  fmt == report_format::json)
+            {
+                out += "\\\\";
+            }
+            else
+            {
+                out += c;
+            }
+        }
+        return out + '"';
+    }
+
+    //- Opens the report file on first use, writing the CSV header if needed.
+    //
+    bool
+    open_report()
+    {
+        if (!report.is_open())
+        {
+            if (file_name.empty())
+            {
+                file_name = (fmt == report_format::csv) ? "alloc-timings.csv" : "alloc-timings.json";
+            }
+
+            report.open(file_name, std::ios::out | std::ios::trunc);
+
+            if (report.is_open()  &&  fmt == report_format::csv)
+            {
+                report << "op,stype,dtype,nelem,nreps,sample,el_nat,el_syn,sample_ratio,"
+                       << "el_nat_total,el_syn_total,el_nat_median,el_syn_median,ratio,ratio_mad,"
+                       << "ci_low,ci_high,compiler,flags,cpu";
+
+                for (size_t c = 0;  c < counter_values::counter_count;  ++c)
+                {
+                    report << ",nat_" << counter_values::name(c) << ",syn_" << counter_values::name(c);
+                }
+                report << ",multiplexed" << std::endl;
+            }
+        }
+        return report.is_open();
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      summarize_timings
+//
+//  Summary:
+//      Computes the summary statistics for a set of timing samples.
+//--------------------------------------------------------------------------------------------------
+//
+timing_summary
+summarize_timings(timing_vector const& samples)
+{
+    timing_summary          sum{samples.size(), 0, 0, 0, 0, 0, 0.0, 0.0, 0.0, 0.0, {}, {}};
+    std::vector<int64_t>    nat, syn;
+    std::vector<double>     ratios, devs;
+
+    if (samples.empty())
+    {
+        return sum;
+    }
+
+    for (auto const& s : samples)
+    {
+        sum.m_el_nat_total += s.m_el_nat;
+        sum.m_el_syn_total += s.m_el_syn;
+        nat.push_back(s.m_el_nat);
+        syn.push_back(s.m_el_syn);
+        ratios.push_back((double) s.m_el_syn / (double) s.m_el_nat);
+    }
+
+    sum.m_el_nat_median = (int64_t) median_of(nat);
+    sum.m_el_syn_median = (int64_t) median_of(syn);
+    sum.m_ratio         = median_of(ratios);
+
+    for (double r : ratios)
+    {
+        devs.push_back(std::fabs(r - sum.m_ratio));
+    }
+    sum.m_ratio_mad = median_of(devs);
+
+    //- Compute the interval over the samples that are not outliers; 1.4826 scales the MAD to
+    //  estimate the standard deviation of normally-distributed data.  When the MAD is zero and
+    //  the median lies between two samples, every sample would be rejected, so then all of them
+    //  are used.
+    //
+    double  limit = 3.0 * 1.4826 * sum.m_ratio_mad;
+    double  total = 0.0;
+    double  total2 = 0.0;
+    size_t  n     = 0;
+
+    auto    is_inlier = [&](double r) { return std::fabs(r - sum.m_ratio) <= limit; };
+
+    if (std::none_of(ratios.begin(), ratios.end(), is_inlier))
+    {
+        limit = std::numeric_limits<double>::infinity();
+    }
+
+    for (double r : ratios)
+    {
+        if (is_inlier(r))
+        {
+            total  += r;
+            total2 += r * r;
+            ++n;
+        }
+    }
+
+    double  mean = total / n;
+    double  var  = (n > 1) ? ((total2 - n * mean * mean) / (n - 1)) : 0.0;
+    double  half = t_critical_95(n - 1) * std::sqrt((var > 0.0) ? (var / n) : 0.0);
+
+    sum.m_outliers = samples.size() - n;
+    sum.m_ci_low   = mean - half;
+    sum.m_ci_high  = mean + half;
+
+    for (size_t c = 0;  c < counter_values::counter_count;  ++c)
+    {
+        std::vector<uint64_t>   pc_nat, pc_syn;
+
+        for (auto const& s : samples)
+        {
+            pc_nat.push_back(s.m_pc_nat.m_values[c]);
+            pc_syn.push_back(s.m_pc_syn.m_values[c]);
+        }
+        sum.m_pc_nat_median.m_values[c] = (uint64_t) median_of(pc_nat);
+        sum.m_pc_syn_median.m_values[c] = (uint64_t) median_of(pc_syn);
+    }
+
+    for (auto const& s : samples)
+    {
+        sum.m_pc_nat_median.m_multiplexed |= s.m_pc_nat.m_multiplexed;
+        sum.m_pc_syn_median.m_multiplexed |= s.m_pc_syn.m_multiplexed;
+    }
+
+    return sum;
+}
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      set_report_format
+//
+//  Summary:
+//      Selects the report format by name - "text", "csv", or "json".  Returns false if the name
+//      is not recognized.
+//--------------------------------------------------------------------------------------------------
+//
+bool
+set_report_format(char const* fmt_name)
+{
+    std::string     name(fmt_name);
+
+    if (name == "text")
+        fmt = report_format::text;
+    else if (name == "csv")
+        fmt = report_format::csv;
+    else if (name == "json")
+        fmt = report_format::json;
+    else
+        return false;
+
+    return true;
+}
+
+void
+set_report_file(char const* name)
+{
+    file_name = name;
+}
+
+report_format
+current_report_format()
+{
+    return fmt;
+}
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      print_timings
+//
+//  Summary:
+//      Prints the text summary: the median ratio and element count as before, followed by the
+//      ratio's MAD, the relative half-width of its confidence interval, and the sample count.
+//--------------------------------------------------------------------------------------------------
+//
+void
+print_timings(char const* op, char const* stype, char const* dtype, size_t nelem,
+              timing_summary const& summary)
+{
+    std::ios    old_state(nullptr);
+    old_state.copyfmt(std::cout);
+
+    double  ratio = summary.m_ratio;
+
+    std::cout << op << ", " << stype << ", " << dtype << ", " << std::showpoint << std::setw(7)
+              << std::setprecision((ratio >= 1.0) ? 5 : 4) << ratio << ", ";
+    std::cout.copyfmt(old_state);
+    std::cout << nelem << ", " << std::fixed << std::setprecision(4) << summary.m_ratio_mad
+              << ", " << summary.precision() << ", " << summary.m_samples << std::endl;
+    std::cout.copyfmt(old_state);
+
+    if (bench_counters().available())
+    {
+        std::cout << "perf, " << op << ", " << stype << ", " << dtype << ", " << nelem;
+
+        for (size_t c = 0;  c < counter_values::counter_count;  ++c)
+        {
+            if (bench_counters().available(c))
+            {
+                std::cout << ", " << counter_values::name(c) << ", "
+                          << summary.m_pc_nat_median.m_values[c] << ", "
+                          << summary.m_pc_syn_median.m_values[c];
+            }
+        }
+        if (summary.m_pc_nat_median.m_multiplexed  ||  summary.m_pc_syn_median.m_multiplexed)
+        {
+            std::cout << ", multiplexed";
+        }
+        std::cout << std::endl;
+    }
+}
+
+//------
+//
+void
+print_unavailable(char const* op, char const* stype, char const* dtype, size_t nelem)
+{
+    std::cout << op << ", " << stype << ", " << dtype << ", " << std::setw(7) << "n/a" << ", "
+              << nelem << std::endl;
+}
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      report_timings
+//
+//  Summary:
+//      Writes a benchmark record in the current format.  CSV output has one row per sample,
+//      with the summary columns repeated on each row; JSON output has one object per line,
+//      holding the samples as an array of [native, synthetic] nanosecond pairs.  Hardware event
+//      counts are included per sample in the same way; unavailable counters are left empty in
+//      CSV and omitted from JSON.  Each sample is also flagged if its counts were multiplexed.
+//--------------------------------------------------------------------------------------------------
+//
+void
+report_timings(char const* op, char const* stype, char const* dtype, size_t nelem, size_t nreps,
+               timing_vector const& samples, timing_summary const& summary)
+{
+    if (fmt == report_format::text  ||  !open_report())
+    {
+        return;
+    }
+
+    static std::string const    compiler = compiler_name();
+    static std::string const    flags    = BENCH_CXX_FLAGS;
+    static std::string const    cpu      = cpu_model();
+
+    report.precision(6);
+
+    if (fmt == report_format::csv)
+    {
+        for (size_t i = 0;  i < samples.size();  ++i)
+        {
+            report << op << ',' << stype << ',' << dtype << ',' << nelem << ',' << nreps << ','
+                   << i << ',' << samples[i].m_el_nat << ',' << samples[i].m_el_syn << ','
+                   << (double) samples[i].m_el_syn / (double) samples[i].m_el_nat << ','
+                   << summary.m_el_nat_total << ',' << summary.m_el_syn_total << ','
+                   << summary.m_el_nat_median << ',' << summary.m_el_syn_median << ','
+                   << summary.m_ratio << ',' << summary.m_ratio_mad << ','
+                   << summary.m_ci_low << ',' << summary.m_ci_high << ',' << quoted(compiler) << ','
+                   << quoted(flags) << ',' << quoted(cpu);
+
+            for (size_t c = 0;  c < counter_values::counter_count;  ++c)
+            {
+                if (bench_counters().available(c))
+                {
+                    report << ',' << samples[i].m_pc_nat.m_values[c]
+                           << ',' << samples[i].m_pc_syn.m_values[c];
+                }
+                else
+                {
+                    report << ",,";
+                }
+            }
+            report << ',' << (samples[i].m_pc_nat.m_multiplexed  ||  samples[i].m_pc_syn.m_multiplexed)
+                   << '\n';
+        }
+    }
+    else
+    {
+        report << "{\"op\": " << quoted(op) << ", \"stype\": " << quoted(stype)
+               << ", \"dtype\": " << quoted(dtype) << ", \"nelem\": " << nelem
+               << ", \"nreps\": " << nreps << ", \"el_nat_total\": " << summary.m_el_nat_total
+               << ", \"el_syn_total\": " << summary.m_el_syn_total
+               << ", \"el_nat_median\": " << summary.m_el_nat_median
+               << ", \"el_syn_median\": " << summary.m_el_syn_median
+               << ", \"ratio\": " << summary.m_ratio << ", \"ratio_mad\": " << summary.m_ratio_mad
+               << ", \"ci_low\": " << summary.m_ci_low << ", \"ci_high\": " << summary.m_ci_high
+               << ", \"compiler\": " << quoted(compiler) << ", \"flags\": " << quoted(flags)
+               << ", \"cpu\": " << quoted(cpu) << ", \"samples\": [";
+
+        for (size_t i = 0;  i < samples.size();  ++i)
+        {
+            report << ((i == 0) ? "[" : ", [") << samples[i].m_el_nat << ", "
+                   << samples[i].m_el_syn << "]";
+        }
+        report << "], \"counters\": {";
+
+        for (size_t c = 0, n = 0;  c < counter_values::counter_count;  ++c)
+        {
+            if (!bench_counters().available(c)) continue;
+
+            report << ((n++ == 0) ? "\"" : ", \"") << counter_values::name(c) << "\": [";
+
+            for (size_t i = 0;  i < samples.size();  ++i)
+            {
+                report << ((i == 0) ? "[" : ", [") << samples[i].m_pc_nat.m_values[c] << ", "
+                       << samples[i].m_pc_syn.m_values[c] << "]";
+            }
+            report << "]";
+        }
+        report << "}, \"multiplexed\": [";
+
+        for (size_t i = 0;  i < samples.size();  ++i)
+        {
+            bool    multiplexed = samples[i].m_pc_nat.m_multiplexed  ||  samples[i].m_pc_syn.m_multiplexed;
+
+            report << ((i == 0) ? "" : ", ") << (multiplexed ? "true" : "false");
+        }
+        report << "]}\n";
+    }
+    report.flush();
+}
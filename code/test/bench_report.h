@@ -0,0 +1,90 @@
+//==================================================================================================
+//  File:
+//      bench_report.h
+//
+//  Summary:
+//      Declares facilities for summarizing benchmark timings and writing the results in text
+//      and machine-readable form.
+//
+//  Copyright (c) 2017 Bob Steagall, KEWB Computing
+//==================================================================================================
+//
+#ifndef BENCH_REPORT_H_DEFINED
+#define BENCH_REPORT_H_DEFINED
+
+#include <cstddef>
+#include <cstdint>
+
+#include "common.h"
+
+//- The available report formats.  Text is the traditional one-line summary written to stdout
+//  by the timing tests themselves; CSV and JSON records are written to the report file, and
+//  carry every sample along with a description of the build and the machine.
+//
+enum class report_format
+{
+    text,
+    csv,
+    json
+};
+
+//- Summary statistics for a set of native/synthetic timing samples.  The ratio is the median of
+//  the per-sample synthetic-to-native ratios, and its dispersion is given by the median absolute
+//  deviation (MAD).  The confidence interval is a 95% interval on the mean ratio, computed after
+//  discarding samples more than three scaled MADs from the median.  The counter values are the
+//  medians of the native and synthetic hardware event counts, when counters are available, and
+//  are flagged as multiplexed if the counts of any sample were.
+//
+struct timing_summary
+{
+    size_t      m_samples;
+    size_t      m_outliers;
+    int64_t     m_el_nat_total;
+    int64_t     m_el_syn_total;
+    int64_t     m_el_nat_median;
+    int64_t     m_el_syn_median;
+    double      m_ratio;
+    double      m_ratio_mad;
+    double      m_ci_low;
+    double      m_ci_high;
+
+    counter_values  m_pc_nat_median;
+    counter_values  m_pc_syn_median;
+
+    double      precision() const;
+};
+
+//- Returns the half-width of the confidence interval relative to the ratio.
+//
+inline double
+timing_summary::precision() const
+{
+    return (m_ci_high - m_ci_low) / (2.0 * m_ratio);
+}
+
+timing_summary  summarize_timings(timing_vector const& samples);
+
+bool            set_report_format(char const* fmt_name);
+void            set_report_file(char const* file_name);
+report_format   current_report_format();
+
+//- Prints the traditional one-line text summary for a benchmark at one element count, followed
+//  by a line of native and synthetic hardware event counts if any counters are available.  The
+//  counts line ends with "multiplexed" when the counts are scaled estimates.
+//
+void    print_timings(char const* op, char const* stype, char const* dtype, size_t nelem,
+                      timing_summary const& summary);
+
+//- Prints the one-line text summary for a benchmark that could not be run at one element count,
+//  with n/a in place of the ratio.
+//
+void    print_unavailable(char const* op, char const* stype, char const* dtype, size_t nelem);
+
+//- Writes one record for a single benchmark at a single element count.  The samples are the raw
+//  native/synthetic timing pairs in the order they were measured.  Does nothing when the format
+//  is text.
+//
+void    report_timings(char const* op, char const* stype, char const* dtype, size_t nelem,
+                       size_t nreps, timing_vector const& samples, timing_summary const& summary);
+
+#endif  //- BENCH_REPORT_H_DEFINED
@@ -0,0 +1,199 @@
+//==================================================================================================
+//  File:
+//      bench_runner.h
+//
+//  Summary:
+//      Defines an adaptive benchmark runner, which repeats a timing test until the synthetic-to-
+//      native ratio is known with the desired precision.
+//
+//  Copyright (c) 2017 Bob Steagall, KEWB Computing
+//==================================================================================================
+//
+#ifndef BENCH_RUNNER_H_DEFINED
+#define BENCH_RUNNER_H_DEFINED
+
+#include "bench_report.h"
+
+#ifdef __linux__
+    #include <sched.h>
+#endif
+
+#if defined(_MSC_VER)
+    #include <intrin.h>
+#elif defined(__x86_64__)  ||  defined(__i386__)
+    #include <x86intrin.h>
+#endif
+
+//- Parameters of the adaptive runner.
+//
+enum : size_t
+{
+    bench_warmup_runs  = 2,         //- Untimed runs to warm caches, TLBs, and branch predictors
+    bench_min_samples  = 10,        //- Samples always taken
+    bench_max_samples  = 200        //- Samples never exceeded, even if still imprecise
+};
+
+double const    bench_target_precision = 0.01;  //- Desired CI half-width, relative to the ratio
+
+//- The number of samples to take regardless of precision, or zero to let the runner decide.
+//  The benchmark driver sets this from its command line.
+//
+inline size_t&
+bench_fixed_samples()
+{
+    static size_t   nsamples = 0;
+    return nsamples;
+}
+
+//- Pins the calling thread to the CPU it is currently running on, so that the samples are not
+//  disturbed by migrations.  This is done once; later calls do nothing.
+//
+inline void
+pin_bench_thread()
+{
+#ifdef __linux__
+    static bool     pinned = false;
+
+    if (!pinned)
+    {
+        int     cpu = sched_getcpu();
+
+        if (cpu >= 0)
+        {
+            cpu_set_t   cpus;
+
+            CPU_ZERO(&cpus);
+            CPU_SET(cpu, &cpus);
+            sched_setaffinity(0, sizeof(cpus), &cpus);
+        }
+        pinned = true;
+    }
+#endif
+}
+
+//- Forces a value to be computed and kept, without generating any code to use it, so that the
+//  work producing it cannot be optimized away.  This is the same trick used by the DoNotOptimize()
+//  function of Google Benchmark.
+//
+template<typename T>
+inline void
+do_not_optimize(T const& value)
+{
+#if defined(__GNUC__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static  char const volatile* volatile   sink;
+
+    sink = reinterpret_cast<char const volatile*>(&value);
+    _ReadWriteBarrier();
+#endif
+}
+
+//- Like do_not_optimize(), but requires the value to be in a register, so that a value read
+//  through a pointer must actually be loaded.  do_not_optimize() accepts a memory operand, which
+//  lets the compiler hand over the location the value was read from and skip the load.
+//
+template<typename T>
+inline void
+do_not_optimize_load(T value)
+{
+#if defined(__GNUC__)
+    asm volatile("" : : "r"(value) : "memory");
+#else
+    do_not_optimize(value);
+#endif
+}
+
+//- Prevents the compiler from moving or eliding memory reads and writes across the call.
+//
+inline void
+clobber_memory()
+{
+#if defined(__GNUC__)
+    asm volatile("" : : : "memory");
+#else
+    _ReadWriteBarrier();
+#endif
+}
+
+//- Returns the number of time-stamp counter ticks per nanosecond, measured once against the
+//  stopwatch, or zero if the platform has no time-stamp counter.  The TSC runs at a constant rate
+//  on current x86 processors, so this converts wall time to (nominal) cycles when the hardware
+//  cycle counter is not available.
+//
+inline double
+tsc_ticks_per_nsec()
+{
+#if defined(_MSC_VER)  ||  defined(__x86_64__)  ||  defined(__i386__)
+    static double   ticks_per_nsec = 0.0;
+
+    if (ticks_per_nsec == 0.0)
+    {
+        stopwatch   sw;
+        uint64_t    t0;
+
+        sw.start();
+        t0 = __rdtsc();
+        do
+        {
+            sw.stop();
+        }
+        while (sw.elapsed_msec() < 20);
+
+        ticks_per_nsec = (double)(__rdtsc() - t0) / (double) sw.elapsed_nsec();
+    }
+    return ticks_per_nsec;
+#else
+    return 0.0;
+#endif
+}
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      collect_timings<TF>
+//
+//  Summary:
+//      This function template calls a timing test, which returns a timing_pair, repeatedly: first
+//      a few times to warm up, and then until the confidence interval on the ratio is narrower
+//      than the target precision or the maximum number of samples has been taken.  If a fixed
+//      number of samples has been requested, exactly that many are taken.  It returns the
+//      samples in the order they were measured.
+//--------------------------------------------------------------------------------------------------
+//
+template<typename TimingTest>
+timing_vector
+collect_timings(TimingTest&& test)
+{
+    timing_vector   samples;
+
+    pin_bench_thread();
+
+    for (size_t i = 0;  i < bench_warmup_runs;  ++i)
+    {
+        test();
+    }
+
+    if (bench_fixed_samples() != 0)
+    {
+        while (samples.size() < bench_fixed_samples())
+        {
+            samples.push_back(test());
+        }
+        return samples;
+    }
+
+    while (samples.size() < bench_max_samples)
+    {
+        samples.push_back(test());
+
+        if (samples.size() >= bench_min_samples  &&
+            summarize_timings(samples).precision() <= bench_target_precision)
+        {
+            break;
+        }
+    }
+
+    return samples;
+}
+
+#endif  //- BENCH_RUNNER_H_DEFINED
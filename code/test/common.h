@@ -29,19 +29,32 @@
 #include <list>
 #include <map>
 #include <numeric>
+#include <set>
 #include <string>
 #include <typeinfo>
 #include <unordered_map>
 #include <vector>
 
 #include "stopwatch.h"
+#include "perf_counters.h"
 #include "based_1d_storage.h"
 #include "based_2d_storage.h"
 #include "based_2dxl_storage.h"
 #include "offset_storage.h"
 #include "wrapper_storage.h"
+#include "policy_storage.h"
 #include "leaky_allocation_strategy.h"
+#include "slab_allocation_strategy.h"
+#include "slab_compactor.h"
+#include "heap_verifier.h"
+#include "numa_allocation_strategy.h"
 #include "rhx_allocator.h"
+#include "segmented_vector.h"
+#include "flat_hash_map.h"
+#include "btree_map.h"
+#include "flat_map.h"
+#include "rhx_string.h"
+#include "string_pool.h"
 #include "poc_allocator.h"
 
 #undef max
@@ -85,6 +98,18 @@ using based_2dxl_strategy = leaky_allocation_strategy<based_2dxl_storage_model>;
 using based_1d_strategy   = leaky_allocation_strategy<based_1d_storage_model>;
 using offset_strategy     = leaky_allocation_strategy<offset_storage_model>;
 
+using wrapper_slab_strategy    = slab_allocation_strategy<wrapper_storage_model>;
+using based_2d_slab_strategy   = slab_allocation_strategy<based_2d_storage_model>;
+using based_2dxl_slab_strategy = slab_allocation_strategy<based_2dxl_storage_model>;
+using based_1d_slab_strategy   = slab_allocation_strategy<based_1d_storage_model>;
+using offset_slab_strategy     = slab_allocation_strategy<offset_storage_model>;
+
+using wrapper_numa_strategy    = numa_allocation_strategy<wrapper_storage_model>;
+using based_2d_numa_strategy   = numa_allocation_strategy<based_2d_storage_model>;
+using based_2dxl_numa_strategy = numa_allocation_strategy<based_2dxl_storage_model>;
+using based_1d_numa_strategy   = numa_allocation_strategy<based_1d_storage_model>;
+using offset_numa_strategy     = numa_allocation_strategy<offset_storage_model>;
+
 bool    verbose_output();
 size_t  max_ptr_op_count_index();
 
@@ -99,8 +124,8 @@ struct test_struct
     uint64_t    m2;
     char        m3[48];
 
-    test_struct() { memset(this, 0, sizeof(test_struct)); m1 = m2 = 999; }
-    test_struct(test_struct const& other) { memcpy(this, &other, sizeof(test_struct)); m1 = other.m1; }
+    test_struct() : m1(999), m2(999), m3() {}
+    test_struct(test_struct const&) = default;
 };
 
 inline bool
@@ -138,8 +163,10 @@ operator <<(std::ostream& os, std::pair<T,U> const& p)
 
 struct timing_pair
 {
-    int64_t     m_el_nat;
-    int64_t     m_el_syn;
+    int64_t         m_el_nat;
+    int64_t         m_el_syn;
+    counter_values  m_pc_nat;
+    counter_values  m_pc_syn;
 
     int64_t     diff() const;
 };
@@ -0,0 +1,20 @@
+//==================================================================================================
+//  File:
+//      container_btree_tests.cpp
+//
+//  Copyright (c) 2017 Bob Steagall, KEWB Computing
+//==================================================================================================
+//
+#include "container_btree_tests.h"
+
+#define RUN_BTREE_TESTS(ST)     run_btree_tests<ST>(#ST)
+
+void
+run_container_btree_tests()
+{
+    RUN_BTREE_TESTS(wrapper_strategy);
+    RUN_BTREE_TESTS(based_2d_strategy);
+    RUN_BTREE_TESTS(based_2dxl_strategy);
+    RUN_BTREE_TESTS(offset_strategy);
+    RUN_BTREE_TESTS(based_2d_slab_strategy);
+}
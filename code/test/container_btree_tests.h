@@ -0,0 +1,277 @@
+//==================================================================================================
+//  File:
+//      container_btree_tests.h
+//
+//  Copyright (c) 2017 Bob Steagall, KEWB Computing
+//==================================================================================================
+//
+#ifndef CONTAINER_BTREE_TESTS_H_DEFINED
+#define CONTAINER_BTREE_TESTS_H_DEFINED
+
+#include "container_tests.h"
+
+//- This function template compares the contents of a map with those of a B+ tree map, element
+//  by element in key order.
+//
+template<typename K1, typename V1, typename C1, typename A1,
+         typename K2, typename V2, typename HT, typename C2, size_t B>
+bool
+contents_match(map<K1,V1,C1,A1> const& c1, btree_map<K2,V2,HT,C2,B> const& c2)
+{
+    if (!lengths_match(c1, c2)  ||  c1.size() != c2.size())
+    {
+        return false;
+    }
+
+    auto    it2 = c2.cbegin();
+
+    for (auto const& kvp : c1)
+    {
+        if (!(kvp.first == it2->first)  ||  !(kvp.second == it2->second)) return false;
+        ++it2;
+    }
+
+    return true;
+}
+
+//- Converts the generated test data to keys of other integral types, so that signed keys
+//  include negative values.
+//
+template<typename K>
+vector<K>
+generate_btree_keys(size_t nelem)
+{
+    vector<K>   keys;
+
+    for (uint64_t v : generate_test_data<uint64_t>(nelem))
+    {
+        keys.push_back(static_cast<K>(v));
+    }
+    return keys;
+}
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      do_normal_btree_tests<AllocStrategy, KeyType>
+//
+//  Summary:
+//      This function template compares a B+ tree map against a native map through random and
+//      ascending insertion, lookup, lower-bound searches, erasure, and move operations.
+//--------------------------------------------------------------------------------------------------
+//
+template<typename AllocStrategy, typename KeyType>
+void
+do_normal_btree_tests(size_t nelem)
+{
+    //- Various type aliases to aid readability.
+    //
+    using strategy     = AllocStrategy;
+    using nat_map_type = map<KeyType, uint64_t>;
+    using syn_map_type = btree_map<KeyType, uint64_t, strategy>;
+
+    vector<KeyType>     keys(generate_btree_keys<KeyType>(nelem));
+    nat_map_type        nat_map;
+    syn_map_type        syn_map;
+
+    CHECK(syn_map.begin() == syn_map.end());
+    CHECK(syn_map.find(keys[0]) == syn_map.end());
+    CHECK(syn_map.erase(keys[0]) == 0u);
+
+    //- Random insertion and lookup.
+    //
+    for (KeyType key : keys)
+    {
+        CHECK(syn_map.try_emplace(key, (uint64_t) key * 3).second == nat_map.emplace(key, (uint64_t) key * 3).second);
+    }
+
+    CHECK(contents_match(nat_map, syn_map));
+    CHECK(syn_map.height() > 1u);
+    CHECK(syn_map.footprint() < nat_map.size() * 4 * (sizeof(KeyType) + sizeof(uint64_t)));
+
+    for (KeyType key : keys)
+    {
+        CHECK(syn_map.count(key) == 1u);
+        CHECK(syn_map.at(key) == nat_map.at(key));
+    }
+
+    for (size_t i = 0;  i < keys.size();  i += 17)
+    {
+        KeyType     probe = keys[i] + 1;
+        auto        nat_it = nat_map.lower_bound(probe);
+        auto        syn_it = syn_map.lower_bound(probe);
+
+        CHECK((nat_it == nat_map.end()) == (syn_it == syn_map.end()));
+        CHECK(nat_it == nat_map.end()  ||  nat_it->first == syn_it->first);
+        CHECK(syn_map.count(probe) == nat_map.count(probe));
+    }
+
+    syn_map[keys[0]] = 17;
+    nat_map[keys[0]] = 17;
+    CHECK(syn_map.at(keys[0]) == 17u);
+
+    //- Erasing leaves nodes in place, but the map remains usable.
+    //
+    for (size_t i = 0;  i < keys.size();  i += 2)
+    {
+        CHECK(syn_map.erase(keys[i]) == nat_map.erase(keys[i]));
+    }
+    CHECK(contents_match(nat_map, syn_map));
+
+    for (KeyType key : keys)
+    {
+        syn_map.erase(key);
+    }
+    CHECK(syn_map.empty());
+    CHECK(syn_map.begin() == syn_map.end());
+
+    for (KeyType key : keys)
+    {
+        syn_map.emplace(key, (uint64_t) key * 3);
+    }
+    nat_map.clear();
+    for (KeyType key : keys)
+    {
+        nat_map.emplace(key, (uint64_t) key * 3);
+    }
+    CHECK(contents_match(nat_map, syn_map));
+
+    //- Ascending insertion fills the leaves.
+    //
+    syn_map_type    syn_seq;
+
+    for (auto const& kvp : nat_map)
+    {
+        syn_seq.emplace(kvp.first, kvp.second);
+    }
+    CHECK(contents_match(nat_map, syn_seq));
+    CHECK(syn_seq.node_count() < syn_map.node_count());
+    CHECK(syn_seq.footprint() < nat_map.size() * 2 * (sizeof(KeyType) + sizeof(uint64_t)));
+
+    //- Move operations.
+    //
+    syn_map_type    syn_moved(std::move(syn_seq));
+
+    CHECK(syn_seq.empty());
+    CHECK(syn_seq.node_count() == 0u);
+    CHECK(contents_match(nat_map, syn_moved));
+
+    syn_seq = std::move(syn_moved);
+    CHECK(contents_match(nat_map, syn_seq));
+
+    syn_seq.clear();
+    CHECK(syn_seq.node_count() == 0u);
+    CHECK(syn_seq.begin() == syn_seq.end());
+}
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      do_string_btree_tests<AllocStrategy>
+//
+//  Summary:
+//      This function template tests a B+ tree map with string keys in the heap, which are
+//      searched by binary search rather than by counting.
+//--------------------------------------------------------------------------------------------------
+//
+template<typename AllocStrategy>
+void
+do_string_btree_tests(size_t nelem)
+{
+    using strategy     = AllocStrategy;
+    using key_traits   = test_data_type_traits<string, test_string<strategy>>;
+    using nat_map_type = map<string, uint64_t>;
+    using syn_map_type = btree_map<test_string<strategy>, uint64_t, strategy>;
+
+    nat_map_type    nat_map;
+    auto            p_syn_map = allocate<syn_map_type, strategy>();
+
+    for (uint64_t i = 0;  i < nelem;  ++i)
+    {
+        string                  nat_key;
+        test_string<strategy>   syn_key;
+
+        key_traits::generate(nat_key, syn_key);
+        nat_map.emplace(nat_key, i);
+        p_syn_map->emplace(syn_key, i);
+    }
+
+    CHECK(nat_map.size() == p_syn_map->size());
+
+    auto    syn_it = p_syn_map->cbegin();
+
+    for (auto const& kvp : nat_map)
+    {
+        test_string<strategy>   syn_key(kvp.first.data(), kvp.first.size());
+
+        CHECK(syn_it->first == syn_key);
+        CHECK(p_syn_map->at(syn_key) == kvp.second);
+        ++syn_it;
+    }
+    CHECK(syn_it == p_syn_map->cend());
+}
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      do_reloc_btree_tests<AllocStrategy>
+//
+//  Summary:
+//      This function template verifies that a B+ tree map survives the relocation of the
+//      heap's buffers.  The map itself is on the stack: its nodes refer to one another by
+//      segment-relative references, so it needs no synthetic pointers at all.
+//--------------------------------------------------------------------------------------------------
+//
+template<typename AllocStrategy>
+void
+do_reloc_btree_tests(size_t nelem)
+{
+    using strategy     = AllocStrategy;
+    using nat_map_type = map<uint64_t, uint64_t>;
+    using syn_map_type = btree_map<uint64_t, uint64_t, strategy>;
+
+    nat_map_type    nat_map;
+    syn_map_type    syn_map;
+
+    for (uint64_t key : generate_test_data<uint64_t>(nelem))
+    {
+        nat_map[key] = ~key;
+        syn_map[key] = ~key;
+    }
+
+    auto    pe_1 = addressof(syn_map.begin()->second);
+
+    strategy::swap_buffers();
+
+    auto    pe_2 = addressof(syn_map.begin()->second);
+
+    CHECK(pe_1 != pe_2);
+    CHECK(contents_match(nat_map, syn_map));
+
+    strategy::swap_buffers();
+}
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      run_btree_tests<AllocStrategy>
+//
+//  Summary:
+//      This function template manages the sequence of actual B+ tree map test calls.
+//--------------------------------------------------------------------------------------------------
+//
+template<typename AllocStrategy>
+void
+run_btree_tests(char const* stype)
+{
+    cout << "================================================================" << endl;
+    cout << "Running basic operation tests for " << stype << endl;
+    cout << "Using container btree_map" << endl;
+
+    do_normal_btree_tests<AllocStrategy, uint64_t>(20000);
+    do_normal_btree_tests<AllocStrategy, uint32_t>(20000);
+    do_normal_btree_tests<AllocStrategy, int64_t>(5000);
+    do_normal_btree_tests<AllocStrategy, int32_t>(5000);
+    do_string_btree_tests<AllocStrategy>(2000);
+    do_reloc_btree_tests<AllocStrategy>(5000);
+
+    AllocStrategy::reset_buffers();
+}
+
+#endif  //- CONTAINER_BTREE_TESTS_H_DEFINED
@@ -0,0 +1,20 @@
+//==================================================================================================
+//  File:
+//      container_flatmap_tests.cpp
+//
+//  Copyright (c) 2017 Bob Steagall, KEWB Computing
+//==================================================================================================
+//
+#include "container_flatmap_tests.h"
+
+#define RUN_FLATMAP_TESTS(ST, RELOC)    run_flatmap_tests<ST>(#ST, RELOC)
+
+void
+run_container_flatmap_tests()
+{
+    RUN_FLATMAP_TESTS(wrapper_strategy, false);
+    RUN_FLATMAP_TESTS(based_2d_strategy, true);
+    RUN_FLATMAP_TESTS(based_2dxl_strategy, true);
+    RUN_FLATMAP_TESTS(offset_strategy, false);
+    RUN_FLATMAP_TESTS(based_2d_slab_strategy, true);
+}
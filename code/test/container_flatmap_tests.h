@@ -0,0 +1,327 @@
+//==================================================================================================
+//  File:
+//      container_flatmap_tests.h
+//
+//  Copyright (c) 2017 Bob Steagall, KEWB Computing
+//==================================================================================================
+//
+#ifndef CONTAINER_FLATMAP_TESTS_H_DEFINED
+#define CONTAINER_FLATMAP_TESTS_H_DEFINED
+
+#include "container_tests.h"
+
+//- This function template compares the contents of an unordered map with those of a flat hash
+//  map, key by key, since the order of elements in either is unspecified.
+//
+template<typename K, typename V1, typename H1, typename EQ1, typename A1,
+         typename V2, typename HT, typename H2, typename EQ2>
+bool
+contents_match(unordered_map<K,V1,H1,EQ1,A1> const& c1, flat_hash_map<K,V2,HT,H2,EQ2> const& c2)
+{
+    if (!lengths_match(c1, c2)  ||  c1.size() != c2.size())
+    {
+        return false;
+    }
+
+    for (auto const& kvp : c1)
+    {
+        auto    result = c2.find(kvp.first);
+
+        if (result == c2.cend()  ||  !(kvp.second == result->second)) return false;
+    }
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      do_normal_flatmap_tests<AllocStrategy, ValueTraits>
+//
+//  Summary:
+//      This function template compares a flat hash map against a native unordered map through
+//      insertion, lookup, erasure, reinsertion, and copy and move operations.
+//--------------------------------------------------------------------------------------------------
+//
+template<typename AllocStrategy, typename ValueTraits>
+void
+do_normal_flatmap_tests(size_t nelem)
+{
+    //- Various type aliases to aid readability.
+    //
+    using strategy       = AllocStrategy;
+    using nat_value_type = typename ValueTraits::nat_type;
+    using syn_value_type = typename ValueTraits::syn_type;
+    using nat_map_type   = unordered_map<uint64_t, nat_value_type>;
+    using syn_map_type   = flat_hash_map<uint64_t, syn_value_type, strategy>;
+
+    vector<uint64_t>    keys(generate_test_data<uint64_t>(nelem));
+    nat_map_type        nat_map;
+    syn_map_type        syn_map_1;
+    auto                p_syn_map_A = allocate<syn_map_type, strategy>();
+
+    CHECK(syn_map_1.begin() == syn_map_1.end());
+    CHECK(syn_map_1.find(keys[0]) == syn_map_1.end());
+    CHECK(syn_map_1.erase(keys[0]) == 0u);
+
+    //- Basic operations.
+    //
+    for (uint64_t key : keys)
+    {
+        nat_value_type  nat_value_data;
+        syn_value_type  syn_value_data;
+
+        ValueTraits::generate(nat_value_data, syn_value_data);
+
+        nat_map[key]        = nat_value_data;
+        syn_map_1[key]      = syn_value_data;
+        (*p_syn_map_A)[key] = syn_value_data;
+    }
+
+    CHECK(contents_match(nat_map, syn_map_1));
+    CHECK(contents_match(nat_map, *p_syn_map_A));
+    CHECK(syn_map_1.load_factor() <= 0.875f);
+
+    for (uint64_t key : keys)
+    {
+        CHECK(syn_map_1.count(key) == 1u);
+        CHECK(nat_map.at(key) == syn_map_1.at(key));
+    }
+
+    CHECK(syn_map_1.count(0u) == nat_map.count(0u));
+    CHECK(!syn_map_1.try_emplace(keys[0]).second);
+    CHECK(syn_map_1.size() == nat_map.size());
+
+    bool    threw = false;
+
+    try
+    {
+        syn_map_1.at(~(uint64_t) 0);
+    }
+    catch (std::out_of_range&)
+    {
+        threw = true;
+    }
+    CHECK(threw  ||  nat_map.count(~(uint64_t) 0) != 0);
+
+    nat_map_type    nat_saved(nat_map);
+
+    //- Erase every other key by key, then the first remaining element by position, and put
+    //  the keys back.
+    //
+    for (size_t i = 0;  i < keys.size();  i += 2)
+    {
+        CHECK(syn_map_1.erase(keys[i]) == nat_map.erase(keys[i]));
+    }
+    CHECK(contents_match(nat_map, syn_map_1));
+
+    nat_map.erase(syn_map_1.begin()->first);
+    syn_map_1.erase(syn_map_1.cbegin());
+    CHECK(contents_match(nat_map, syn_map_1));
+
+    for (auto const& kvp : nat_saved)
+    {
+        if (nat_map.insert(kvp).second)
+        {
+            CHECK(syn_map_1.emplace(kvp.first, p_syn_map_A->at(kvp.first)).second);
+        }
+    }
+    CHECK(contents_match(nat_map, syn_map_1));
+
+    //- Copy operations.
+    //
+    syn_map_type    syn_map_2(syn_map_1);
+    syn_map_type    syn_map_3;
+
+    syn_map_3 = syn_map_1;
+
+    CHECK(contents_match(nat_map, syn_map_2));
+    CHECK(contents_match(nat_map, syn_map_3));
+    CHECK(syn_map_2.tombstones() == syn_map_1.tombstones());
+
+    auto    p_syn_map_B = allocate<syn_map_type, strategy>(syn_map_1);
+
+    CHECK(contents_match(nat_map, *p_syn_map_B));
+
+    //- Move operations.
+    //
+    syn_map_type    syn_map_4(std::move(syn_map_2));
+    syn_map_type    syn_map_5;
+
+    CHECK(syn_map_2.size() == 0u);
+    CHECK(contents_match(nat_map, syn_map_4));
+
+    syn_map_5 = std::move(syn_map_3);
+
+    CHECK(syn_map_3.size() == 0u);
+    CHECK(contents_match(nat_map, syn_map_5));
+
+    //- Clearing keeps the array.
+    //
+    size_t  cap = syn_map_5.capacity();
+
+    nat_map.clear();
+    syn_map_5.clear();
+    CHECK(contents_match(nat_map, syn_map_5));
+    CHECK(syn_map_5.capacity() == cap);
+}
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      do_churn_flatmap_tests<AllocStrategy>
+//
+//  Summary:
+//      This function template repeatedly inserts and erases keys in a map of constant size,
+//      and verifies that the map does not grow to accommodate its tombstones.
+//--------------------------------------------------------------------------------------------------
+//
+template<typename AllocStrategy>
+void
+do_churn_flatmap_tests(size_t nelem)
+{
+    using syn_map_type = flat_hash_map<uint64_t, uint64_t, AllocStrategy>;
+
+    syn_map_type    syn_map;
+    uint64_t        next = 0;
+
+    syn_map.reserve(nelem);
+
+    size_t const    cap = syn_map.capacity();
+
+    for (;  next < nelem;  ++next)
+    {
+        syn_map.emplace(next, next);
+    }
+
+    for (size_t i = 0;  i < 20 * nelem;  ++i, ++next)
+    {
+        CHECK(syn_map.erase(next - nelem) == 1u);
+        CHECK(syn_map.emplace(next, next).second);
+    }
+
+    CHECK(syn_map.size() == nelem);
+    CHECK(syn_map.capacity() == cap);
+    CHECK(syn_map.tombstones() < cap);
+
+    for (uint64_t k = next - nelem;  k < next;  ++k)
+    {
+        CHECK(syn_map.count(k) == 1u);
+    }
+}
+
+//- A hasher that sends every key to the same probe sequence, so that erasing leaves tombstones
+//  in front of the keys stored beyond them.
+//
+struct colliding_hash
+{
+    size_t  operator ()(uint64_t) const noexcept { return 0; }
+};
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      do_tombstone_copy_flatmap_tests<AllocStrategy>
+//
+//  Summary:
+//      This function template erases keys that share a single probe sequence, and verifies that
+//      copies of the map still find the keys stored beyond the resulting tombstones.
+//--------------------------------------------------------------------------------------------------
+//
+template<typename AllocStrategy>
+void
+do_tombstone_copy_flatmap_tests(size_t nelem)
+{
+    using syn_map_type = flat_hash_map<uint64_t, uint64_t, AllocStrategy, colliding_hash>;
+
+    syn_map_type    syn_map_1;
+
+    for (uint64_t k = 0;  k < nelem;  ++k)
+    {
+        syn_map_1.emplace(k, k);
+    }
+    for (uint64_t k = 0;  k < nelem;  k += 3)
+    {
+        CHECK(syn_map_1.erase(k) == 1u);
+    }
+    CHECK(syn_map_1.tombstones() != 0);
+
+    syn_map_type    syn_map_2(syn_map_1);
+    syn_map_type    syn_map_3;
+
+    syn_map_3 = syn_map_1;
+
+    for (uint64_t k = 0;  k < nelem;  ++k)
+    {
+        size_t  expected = (k % 3 == 0) ? 0u : 1u;
+
+        CHECK(syn_map_2.count(k) == expected);
+        CHECK(syn_map_3.count(k) == expected);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      do_reloc_flatmap_tests<AllocStrategy>
+//
+//  Summary:
+//      This function template verifies that a flat hash map placed in the heap survives the
+//      relocation of the heap's buffers.
+//--------------------------------------------------------------------------------------------------
+//
+template<typename AllocStrategy>
+void
+do_reloc_flatmap_tests(size_t nelem)
+{
+    using strategy     = AllocStrategy;
+    using nat_map_type = unordered_map<uint64_t, uint64_t>;
+    using syn_map_type = flat_hash_map<uint64_t, uint64_t, strategy>;
+
+    nat_map_type    nat_map;
+    auto            p_syn_map = allocate<syn_map_type, strategy>();
+
+    for (uint64_t key : generate_test_data<uint64_t>(nelem))
+    {
+        nat_map[key]      = ~key;
+        (*p_syn_map)[key] = ~key;
+    }
+
+    auto    pe_1 = addressof(*p_syn_map->begin());
+
+    strategy::swap_buffers();
+
+    auto    pe_2 = addressof(*p_syn_map->begin());
+
+    CHECK(pe_1 != pe_2);
+    CHECK(contents_match(nat_map, *p_syn_map));
+
+    strategy::swap_buffers();
+}
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      run_flatmap_tests<AllocStrategy>
+//
+//  Summary:
+//      This function template manages the sequence of actual flat hash map test calls.
+//--------------------------------------------------------------------------------------------------
+//
+template<typename AllocStrategy>
+void
+run_flatmap_tests(char const* stype, bool relocatable)
+{
+    cout << "================================================================" << endl;
+    cout << "Running basic operation tests for " << stype << endl;
+    cout << "Using container flat_hash_map" << endl;
+
+    do_normal_flatmap_tests<AllocStrategy, test_data_type_traits<test_struct, AllocStrategy>>(1000);
+    do_normal_flatmap_tests<AllocStrategy, test_data_type_traits<string, test_string<AllocStrategy>>>(200);
+    do_churn_flatmap_tests<AllocStrategy>(100);
+    do_tombstone_copy_flatmap_tests<AllocStrategy>(40);
+
+    if (relocatable)
+    {
+        do_reloc_flatmap_tests<AllocStrategy>(5000);
+    }
+
+    AllocStrategy::reset_buffers();
+}
+
+#endif  //- CONTAINER_FLATMAP_TESTS_H_DEFINED
@@ -0,0 +1,25 @@
+//==================================================================================================
+//  File:
+//      container_flatsorted_tests.cpp
+//
+//  Copyright (c) 2017 Bob Steagall, KEWB Computing
+//==================================================================================================
+//
+#include "container_flatsorted_tests.h"
+
+#define RUN_FLATSORTED_TESTS(ST, SS, RELOC)     run_flatsorted_tests<ST, SS>(#ST, #SS, RELOC)
+
+void
+run_container_flatsorted_tests()
+{
+    RUN_FLATSORTED_TESTS(wrapper_strategy, flat_binary_search, false);
+    RUN_FLATSORTED_TESTS(based_2d_strategy, flat_binary_search, true);
+    RUN_FLATSORTED_TESTS(based_2dxl_strategy, flat_binary_search, true);
+    RUN_FLATSORTED_TESTS(based_2d_slab_strategy, flat_binary_search, true);
+    RUN_FLATSORTED_TESTS(offset_strategy, flat_binary_search, false);
+
+    RUN_FLATSORTED_TESTS(wrapper_strategy, flat_eytzinger_search, false);
+    RUN_FLATSORTED_TESTS(based_2d_strategy, flat_eytzinger_search, true);
+    RUN_FLATSORTED_TESTS(based_2dxl_strategy, flat_eytzinger_search, true);
+    RUN_FLATSORTED_TESTS(offset_strategy, flat_eytzinger_search, false);
+}
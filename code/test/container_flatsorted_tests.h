@@ -0,0 +1,339 @@
+//==================================================================================================
+//  File:
+//      container_flatsorted_tests.h
+//
+//  Copyright (c) 2017 Bob Steagall, KEWB Computing
+//==================================================================================================
+//
+#ifndef CONTAINER_FLATSORTED_TESTS_H_DEFINED
+#define CONTAINER_FLATSORTED_TESTS_H_DEFINED
+
+#include "container_tests.h"
+
+//- This function template compares the contents of a map with those of a flat map, element by
+//  element in key order.
+//
+template<typename K, typename V1, typename C1, typename A1,
+         typename V2, typename HT, typename C2, typename S>
+bool
+contents_match(map<K,V1,C1,A1> const& c1, flat_map<K,V2,HT,C2,S> const& c2)
+{
+    if (!lengths_match(c1, c2)  ||  c1.size() != c2.size())
+    {
+        return false;
+    }
+
+    auto    it2 = c2.cbegin();
+
+    for (auto const& kvp : c1)
+    {
+        if (!(kvp.first == it2->first)  ||  !(kvp.second == it2->second)) return false;
+        ++it2;
+    }
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      do_normal_flatsorted_map_tests<AllocStrategy, Search, ValueTraits>
+//
+//  Summary:
+//      This function template compares a flat map against a native map through bulk and
+//      single-element insertion, lookup, lower-bound searches, erasure, and copy and move
+//      operations.
+//--------------------------------------------------------------------------------------------------
+//
+template<typename AllocStrategy, typename Search, typename ValueTraits>
+void
+do_normal_flatsorted_map_tests(size_t nelem)
+{
+    //- Various type aliases to aid readability.
+    //
+    using strategy       = AllocStrategy;
+    using nat_value_type = typename ValueTraits::nat_type;
+    using syn_value_type = typename ValueTraits::syn_type;
+    using nat_map_type   = map<uint64_t, nat_value_type>;
+    using syn_map_type   = flat_map<uint64_t, syn_value_type, strategy, less<uint64_t>, Search>;
+    using syn_pair_type  = pair<uint64_t, syn_value_type>;
+
+    vector<uint64_t>        keys(generate_test_data<uint64_t>(nelem));
+    vector<syn_pair_type>   syn_pairs;
+    nat_map_type            nat_map;
+
+    //- Bulk construction from unsorted pairs, with a duplicate key whose first value must win.
+    //
+    for (uint64_t key : keys)
+    {
+        nat_value_type  nat_value_data;
+        syn_value_type  syn_value_data;
+
+        ValueTraits::generate(nat_value_data, syn_value_data);
+        nat_map.emplace(key, nat_value_data);
+        syn_pairs.emplace_back(key, syn_value_data);
+    }
+    syn_pairs.emplace_back(keys[0], syn_pairs[1].second);
+    syn_pairs.push_back(syn_pairs[1]);
+
+    syn_map_type    syn_map_1(syn_pairs.begin(), syn_pairs.end());
+
+    CHECK(contents_match(nat_map, syn_map_1));
+
+    for (uint64_t key : keys)
+    {
+        CHECK(syn_map_1.count(key) == 1u);
+        CHECK(nat_map.at(key) == syn_map_1.at(key));
+    }
+
+    for (size_t i = 0;  i < keys.size();  i += 7)
+    {
+        uint64_t    probe  = keys[i] + 1;
+        auto        nat_it = nat_map.lower_bound(probe);
+        auto        syn_it = syn_map_1.lower_bound(probe);
+
+        CHECK((nat_it == nat_map.end()) == (syn_it == syn_map_1.end()));
+        CHECK(nat_it == nat_map.end()  ||  nat_it->first == syn_it->first);
+        CHECK(syn_map_1.count(probe) == nat_map.count(probe));
+    }
+    CHECK(syn_map_1.lower_bound(0u) == syn_map_1.begin());
+    CHECK(syn_map_1.find(nat_map.rbegin()->first + 1) == syn_map_1.end());
+
+    bool    threw = false;
+
+    try
+    {
+        syn_map_1.at(nat_map.rbegin()->first + 1);
+    }
+    catch (std::out_of_range&)
+    {
+        threw = true;
+    }
+    CHECK(threw);
+
+    //- Construction from separate vectors of keys and values, and from a sorted range.
+    //
+    typename syn_map_type::key_container_type       syn_keys;
+    typename syn_map_type::mapped_container_type    syn_values;
+
+    for (auto const& sp : syn_pairs)
+    {
+        syn_keys.push_back(sp.first);
+        syn_values.push_back(sp.second);
+    }
+
+    syn_map_type    syn_map_2(std::move(syn_keys), std::move(syn_values));
+    syn_map_type    syn_map_3(flat_sorted_unique, syn_map_1.begin(), syn_map_1.end());
+
+    CHECK(contents_match(nat_map, syn_map_2));
+    CHECK(contents_match(nat_map, syn_map_3));
+    CHECK(syn_map_3.find(keys[0])->second == syn_map_1.at(keys[0]));
+
+    //- Erase every other key and put the keys back one at a time.
+    //
+    nat_map_type    nat_saved(nat_map);
+
+    for (size_t i = 0;  i < keys.size();  i += 2)
+    {
+        CHECK(syn_map_1.erase(keys[i]) == nat_map.erase(keys[i]));
+    }
+    CHECK(contents_match(nat_map, syn_map_1));
+
+    for (auto const& kvp : nat_saved)
+    {
+        if (nat_map.insert(kvp).second)
+        {
+            CHECK(syn_map_1.emplace(kvp.first, syn_map_2.at(kvp.first)).second);
+        }
+        else
+        {
+            CHECK(!syn_map_1.try_emplace(kvp.first).second);
+        }
+    }
+    CHECK(contents_match(nat_map, syn_map_1));
+
+    //- Bulk insertion keeps the elements already present.
+    //
+    syn_map_type    syn_map_4;
+
+    syn_map_4.insert(syn_pairs.begin(), syn_pairs.begin() + syn_pairs.size() / 2);
+    syn_map_4.insert(syn_pairs.begin(), syn_pairs.end());
+    CHECK(contents_match(nat_map, syn_map_4));
+
+    //- Copy operations.
+    //
+    syn_map_type    syn_map_5(syn_map_1);
+    syn_map_type    syn_map_6;
+
+    syn_map_6 = syn_map_1;
+    CHECK(contents_match(nat_map, syn_map_5));
+    CHECK(contents_match(nat_map, syn_map_6));
+
+    auto    p_syn_map = allocate<syn_map_type, strategy>(syn_map_1);
+
+    CHECK(contents_match(nat_map, *p_syn_map));
+    CHECK(p_syn_map->count(keys[1]) == 1u);
+
+    //- Move operations.
+    //
+    syn_map_type    syn_map_7(std::move(syn_map_5));
+
+    CHECK(syn_map_5.size() == 0u);
+    CHECK(contents_match(nat_map, syn_map_7));
+    CHECK(syn_map_7.count(keys[1]) == 1u);
+
+    syn_map_6 = std::move(syn_map_7);
+    CHECK(contents_match(nat_map, syn_map_6));
+
+    nat_map.clear();
+    syn_map_6.clear();
+    CHECK(contents_match(nat_map, syn_map_6));
+    CHECK(syn_map_6.find(keys[1]) == syn_map_6.end());
+}
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      do_normal_flatsorted_set_tests<AllocStrategy, Search, DataTraits>
+//
+//  Summary:
+//      This function template compares a flat set against a native set through bulk and
+//      single-element insertion, lookup, and erasure.
+//--------------------------------------------------------------------------------------------------
+//
+template<typename AllocStrategy, typename Search, typename DataTraits>
+void
+do_normal_flatsorted_set_tests(size_t nelem)
+{
+    using strategy      = AllocStrategy;
+    using nat_data_type = typename DataTraits::nat_type;
+    using syn_data_type = typename DataTraits::syn_type;
+    using nat_set_type  = set<nat_data_type>;
+    using syn_set_type  = flat_set<syn_data_type, strategy, less<syn_data_type>, Search>;
+
+    vector<syn_data_type>   syn_data;
+    nat_set_type            nat_set;
+
+    for (size_t i = 0;  i < nelem;  ++i)
+    {
+        nat_data_type   nat_data;
+        syn_data_type   syn_data_item;
+
+        DataTraits::generate(nat_data, syn_data_item);
+        nat_set.insert(nat_data);
+        syn_data.push_back(syn_data_item);
+    }
+    syn_data.push_back(syn_data.front());
+
+    syn_set_type    syn_set_1(syn_data.begin(), syn_data.end());
+
+    CHECK(contents_match(nat_set, syn_set_1));
+
+    for (auto const& item : syn_data)
+    {
+        CHECK(syn_set_1.count(item) == 1u);
+        CHECK(*syn_set_1.find(item) == item);
+        CHECK(*syn_set_1.lower_bound(item) == item);
+    }
+
+    //- Erase every other element and put the elements back.
+    //
+    syn_set_type    syn_set_2(syn_set_1);
+
+    for (size_t i = 0;  i < syn_data.size();  i += 2)
+    {
+        syn_set_1.erase(syn_data[i]);
+    }
+    CHECK(syn_set_1.size() < nat_set.size());
+    CHECK(syn_set_1.find(syn_data[0]) == syn_set_1.end());
+
+    for (auto const& item : syn_data)
+    {
+        syn_set_1.insert(item);
+    }
+    CHECK(contents_match(nat_set, syn_set_1));
+    CHECK(!syn_set_1.insert(syn_data[0]).second);
+
+    syn_set_type    syn_set_3(flat_sorted_unique, syn_set_2.begin(), syn_set_2.end());
+    syn_set_type    syn_set_4;
+
+    syn_set_4.insert(syn_data.begin(), syn_data.end());
+    CHECK(contents_match(nat_set, syn_set_3));
+    CHECK(contents_match(nat_set, syn_set_4));
+
+    syn_set_4.clear();
+    CHECK(syn_set_4.empty());
+    CHECK(syn_set_4.find(syn_data[0]) == syn_set_4.end());
+}
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      do_reloc_flatsorted_tests<AllocStrategy, Search>
+//
+//  Summary:
+//      This function template verifies that a flat map placed in the heap, along with its
+//      index, survives the relocation of the heap's buffers.
+//--------------------------------------------------------------------------------------------------
+//
+template<typename AllocStrategy, typename Search>
+void
+do_reloc_flatsorted_tests(size_t nelem)
+{
+    using strategy     = AllocStrategy;
+    using nat_map_type = map<uint64_t, uint64_t>;
+    using syn_map_type = flat_map<uint64_t, uint64_t, strategy, less<uint64_t>, Search>;
+
+    nat_map_type    nat_map;
+
+    for (uint64_t key : generate_test_data<uint64_t>(nelem))
+    {
+        nat_map[key] = ~key;
+    }
+
+    auto    p_syn_map = allocate<syn_map_type, strategy>(nat_map.begin(), nat_map.end());
+    auto    pe_1 = addressof(p_syn_map->begin()->second);
+
+    strategy::swap_buffers();
+
+    auto    pe_2 = addressof(p_syn_map->begin()->second);
+
+    CHECK(pe_1 != pe_2);
+    CHECK(contents_match(nat_map, *p_syn_map));
+
+    for (auto const& kvp : nat_map)
+    {
+        CHECK(p_syn_map->at(kvp.first) == kvp.second);
+    }
+
+    strategy::swap_buffers();
+}
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      run_flatsorted_tests<AllocStrategy, Search>
+//
+//  Summary:
+//      This function template manages the sequence of actual flat map and flat set test calls
+//      for one kind of search index.
+//--------------------------------------------------------------------------------------------------
+//
+template<typename AllocStrategy, typename Search>
+void
+run_flatsorted_tests(char const* stype, char const* search, bool relocatable)
+{
+    cout << "================================================================" << endl;
+    cout << "Running basic operation tests for " << stype << endl;
+    cout << "Using containers flat_map and flat_set with " << search << endl;
+
+    do_normal_flatsorted_map_tests<AllocStrategy, Search, test_data_type_traits<test_struct, AllocStrategy>>(1000);
+    do_normal_flatsorted_map_tests<AllocStrategy, Search, test_data_type_traits<string, test_string<AllocStrategy>>>(200);
+    do_normal_flatsorted_set_tests<AllocStrategy, Search, test_data_type_traits<test_struct, AllocStrategy>>(1000);
+    do_normal_flatsorted_set_tests<AllocStrategy, Search, test_data_type_traits<string, test_string<AllocStrategy>>>(200);
+
+    if (relocatable)
+    {
+        do_reloc_flatsorted_tests<AllocStrategy, Search>(5000);
+    }
+
+    AllocStrategy::reset_buffers();
+}
+
+#endif  //- CONTAINER_FLATSORTED_TESTS_H_DEFINED
@@ -0,0 +1,21 @@
+//==================================================================================================
+//  File:
+//      container_rhxstring_tests.cpp
+//
+//  Copyright (c) 2017 Bob Steagall, KEWB Computing
+//==================================================================================================
+//
+#include "container_rhxstring_tests.h"
+
+#define RUN_RHXSTRING_TESTS(ST, RELOC)      run_rhxstring_tests<ST>(#ST, RELOC)
+
+void
+run_container_rhxstring_tests()
+{
+    RUN_RHXSTRING_TESTS(wrapper_strategy, false);
+    RUN_RHXSTRING_TESTS(based_2d_strategy, true);
+    RUN_RHXSTRING_TESTS(based_2dxl_strategy, true);
+    RUN_RHXSTRING_TESTS(offset_strategy, false);
+    RUN_RHXSTRING_TESTS(based_2d_slab_strategy, true);
+    RUN_RHXSTRING_TESTS(based_2d_numa_strategy, true);
+}
@@ -0,0 +1,217 @@
+//==================================================================================================
+//  File:
+//      container_rhxstring_tests.h
+//
+//  Copyright (c) 2017 Bob Steagall, KEWB Computing
+//==================================================================================================
+//
+#ifndef CONTAINER_RHXSTRING_TESTS_H_DEFINED
+#define CONTAINER_RHXSTRING_TESTS_H_DEFINED
+
+#include "container_tests.h"
+
+//- Determines whether a string's characters are stored within the string object itself.
+//
+template<typename S>
+inline bool
+is_inline(S const& str)
+{
+    char const*     p = reinterpret_cast<char const*>(&str);
+
+    return str.data() >= p  &&  str.data() < p + sizeof(S);
+}
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      do_normal_rhxstring_tests<AllocStrategy>
+//
+//  Summary:
+//      This function template compares an rhx_string against a native string through
+//      construction, assignment, appending, resizing, searching, and copy and move operations,
+//      and checks where the characters of short and long strings are kept.
+//--------------------------------------------------------------------------------------------------
+//
+template<typename AllocStrategy>
+void
+do_normal_rhxstring_tests(size_t nelem)
+{
+    using strategy      = AllocStrategy;
+    using syn_string    = rhx_string<strategy>;
+
+    //- Short and long strings.  The inline capacity depends on the size of the synthetic
+    //  pointer, and is the capacity of an empty string.
+    //
+    syn_string  s0;
+    size_t      local = s0.capacity();
+    string      long_str("0123456789abcdefghijklmnopqrstuvwxyz");
+    syn_string  s1(long_str.data(), local);
+    syn_string  s2(long_str.data(), local + 1);
+
+    CHECK(s0.empty()  &&  s0.size() == 0u  &&  *s0.c_str() == '\0');
+    CHECK(local >= 15u  &&  local + 1 < long_str.size());
+    CHECK(s1.size() == local  &&  s1 == long_str.substr(0, local));
+    CHECK(s2.size() == local + 1  &&  s2 == long_str.substr(0, local + 1));
+    CHECK(is_inline(s0)  &&  is_inline(s1)  &&  !is_inline(s2));
+    CHECK(s1.c_str()[s1.size()] == '\0'  &&  s2.c_str()[s2.size()] == '\0');
+
+    //- Copying and moving short strings leaves them inline; moving a long string takes its
+    //  buffer.
+    //
+    syn_string  s3(s1);
+    syn_string  s4(std::move(s3));
+    char const* p2 = s2.data();
+    syn_string  s5(std::move(s2));
+
+    CHECK(is_inline(s4)  &&  s4 == s1  &&  s3.empty());
+    CHECK(s5.data() == p2  &&  s2.empty()  &&  is_inline(s2));
+
+    s2 = s5;
+    s3 = std::move(s5);
+    CHECK(s2 == s3  &&  s3.data() == p2  &&  s5.empty());
+
+    s3.swap(s1);
+    CHECK(s1 == s2  &&  s3.size() == local  &&  is_inline(s3));
+
+    //- Growing, shrinking, and self-referential appends, checked against a native string.
+    //
+    string      nat;
+    syn_string  syn;
+
+    for (size_t i = 0;  i < nelem;  ++i)
+    {
+        string  piece = generate_test_string(8);
+
+        nat += piece;
+        syn += piece.c_str();
+        nat.push_back('x');
+        syn.push_back('x');
+    }
+    CHECK(nat == syn  &&  syn.capacity() >= syn.size());
+
+    nat.append(nat.data(), 10);
+    syn.append(syn.data(), 10);
+    CHECK(nat == syn);
+
+    nat.assign(nat.data() + 5, 12);
+    syn.assign(syn.data() + 5, 12);
+    CHECK(nat == syn);
+
+    syn.shrink_to_fit();
+    CHECK(nat == syn  &&  is_inline(syn));
+
+    nat.resize(local + 20, 'z');
+    syn.resize(local + 20, 'z');
+    CHECK(nat == syn  &&  !is_inline(syn));
+
+    nat.resize(3);
+    syn.resize(3);
+    syn.shrink_to_fit();
+    CHECK(nat == syn  &&  is_inline(syn));
+
+    syn.reserve(100);
+    CHECK(syn.capacity() >= 100u  &&  nat == syn);
+
+    nat.pop_back();
+    syn.pop_back();
+    syn.clear();
+    nat.clear();
+    CHECK(nat == syn  &&  syn.empty());
+
+    //- Element access, comparison, and searching.
+    //
+    syn_string  a("alpha beta gamma delta epsilon");
+    syn_string  b("alpha beta");
+    bool        threw = false;
+
+    CHECK(a.front() == 'a'  &&  a.back() == 'n'  &&  a[6] == 'b'  &&  a.at(11) == 'g');
+    CHECK(b < a  &&  a > b  &&  b <= a  &&  a >= b  &&  a != b);
+    CHECK(a.compare(a) == 0  &&  b.compare(a) < 0);
+    CHECK(a.find("gamma") == 11u  &&  a.find('z') == syn_string::npos);
+    CHECK(a.find(b) == 0u  &&  a.find("", 30) == 30u  &&  a.find("a", 31) == syn_string::npos);
+    CHECK(a.substr(6, 4) == "beta"  &&  a.substr(23) == "epsilon");
+    CHECK(string("alpha beta") == b  &&  b == string("alpha beta"));
+    CHECK(syn_string(string(20, 'q')) == syn_string(20, 'q'));
+    CHECK(hash<syn_string>()(a) == hash<syn_string>()(syn_string(a.c_str())));
+
+    try
+    {
+        a.at(a.size());
+    }
+    catch (std::out_of_range&)
+    {
+        threw = true;
+    }
+    CHECK(threw);
+}
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      do_reloc_rhxstring_tests<AllocStrategy>
+//
+//  Summary:
+//      This function template verifies that a vector of short and long strings placed in the
+//      heap survives the relocation of the heap's buffers.
+//--------------------------------------------------------------------------------------------------
+//
+template<typename AllocStrategy>
+void
+do_reloc_rhxstring_tests(size_t nelem)
+{
+    using strategy        = AllocStrategy;
+    using syn_string      = rhx_string<strategy>;
+    using syn_vector_type = vector<syn_string, rhx_allocator<syn_string, strategy>>;
+
+    vector<string>  nat_vector;
+    auto            p_syn_vector = allocate<syn_vector_type, strategy>();
+
+    for (size_t i = 0;  i < nelem;  ++i)
+    {
+        nat_vector.push_back(generate_data<string>());
+        p_syn_vector->emplace_back(nat_vector.back());
+    }
+
+    size_t  local = syn_string().capacity();
+    auto    pe_1  = p_syn_vector->front().data();
+
+    strategy::swap_buffers();
+
+    auto    pe_2  = p_syn_vector->front().data();
+
+    CHECK(pe_1 != pe_2);
+    CHECK(contents_match(nat_vector, *p_syn_vector));
+
+    for (auto const& str : *p_syn_vector)
+    {
+        CHECK(is_inline(str) == (str.size() <= local));
+    }
+
+    strategy::swap_buffers();
+}
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      run_rhxstring_tests<AllocStrategy>
+//
+//  Summary:
+//      This function template manages the sequence of actual rhx_string test calls.
+//--------------------------------------------------------------------------------------------------
+//
+template<typename AllocStrategy>
+void
+run_rhxstring_tests(char const* stype, bool relocatable)
+{
+    cout << "================================================================" << endl;
+    cout << "Running basic operation tests for " << stype << endl;
+    cout << "Using container rhx_string" << endl;
+
+    do_normal_rhxstring_tests<AllocStrategy>(1000);
+
+    if (relocatable)
+    {
+        do_reloc_rhxstring_tests<AllocStrategy>(1000);
+    }
+
+    AllocStrategy::reset_buffers();
+}
+
+#endif  //- CONTAINER_RHXSTRING_TESTS_H_DEFINED
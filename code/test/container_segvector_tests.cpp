@@ -0,0 +1,24 @@
+//==================================================================================================
+//  File:
+//      container_segvector_tests.cpp
+//
+//  Copyright (c) 2017 Bob Steagall, KEWB Computing
+//==================================================================================================
+//
+#include "container_segvector_tests.h"
+
+#define RUN_SEGVECTOR_TESTS(ST, RELOC)  run_segvector_tests<ST>(#ST, RELOC)
+
+void
+run_container_segvector_tests()
+{
+    RUN_SEGVECTOR_TESTS(wrapper_strategy, false);
+    RUN_SEGVECTOR_TESTS(based_2d_strategy, true);
+    RUN_SEGVECTOR_TESTS(based_2dxl_strategy, true);
+    RUN_SEGVECTOR_TESTS(based_1d_strategy, true);
+    RUN_SEGVECTOR_TESTS(offset_strategy, false);
+    RUN_SEGVECTOR_TESTS(based_2d_slab_strategy, true);
+
+    do_spanning_segvector_tests<based_2d_strategy>();
+    do_spanning_segvector_tests<based_1d_strategy>();
+}
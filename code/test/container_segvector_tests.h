@@ -0,0 +1,267 @@
+//==================================================================================================
+//  File:
+//      container_segvector_tests.h
+//
+//  Copyright (c) 2017 Bob Steagall, KEWB Computing
+//==================================================================================================
+//
+#ifndef CONTAINER_SEGVECTOR_TESTS_H_DEFINED
+#define CONTAINER_SEGVECTOR_TESTS_H_DEFINED
+
+#include "strategy_tests.h"
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      do_normal_segvector_tests<AllocStrategy, DataType>
+//
+//  Summary:
+//      This function template compares a segmented vector with small chunks against a native
+//      vector: growth, iterator arithmetic across chunk boundaries, standard algorithms, and the
+//      chunk-local ranges presented by for_each_segment().
+//--------------------------------------------------------------------------------------------------
+//
+template<typename AllocStrategy, typename DataType>
+void
+do_normal_segvector_tests(size_t nelem, size_t chunk_cap)
+{
+    //- Various type aliases to aid readability.
+    //
+    using strategy        = AllocStrategy;
+    using nat_vector_type = vector<DataType>;
+    using syn_vector_type = segmented_vector<DataType, strategy>;
+
+    nat_vector_type     nat_vector(generate_test_data<DataType>(nelem));
+    auto                p_syn_vector = allocate<syn_vector_type, strategy>(chunk_cap);
+    syn_vector_type&    syn_vector   = *p_syn_vector;
+
+    CHECK(syn_vector.begin() == syn_vector.end());
+    CHECK(syn_vector.size() == 0u);
+
+    for (DataType const& value : nat_vector)
+    {
+        syn_vector.push_back(value);
+    }
+
+    CHECK(syn_vector.size() == nelem);
+    CHECK(syn_vector.chunk_count() == (nelem + chunk_cap - 1) / chunk_cap);
+    CHECK(contents_match(nat_vector, syn_vector));
+    PRINT(nat_vector, syn_vector);
+
+    //- Random access, forward and backward, from both ends.
+    //
+    auto    first = syn_vector.begin();
+    auto    last  = syn_vector.end();
+
+    CHECK(last - first == (ptrdiff_t) nelem);
+    CHECK(*(last - 1) == nat_vector.back());
+    CHECK(*--syn_vector.end() == nat_vector.back());
+
+    for (size_t i = 0;  i < nelem;  i += 7)
+    {
+        auto    it = first + (ptrdiff_t) i;
+
+        CHECK(*it == nat_vector[i]);
+        CHECK(syn_vector[i] == nat_vector[i]);
+        CHECK(it - first == (ptrdiff_t) i);
+        CHECK(last - it == (ptrdiff_t)(nelem - i));
+        CHECK((last - (ptrdiff_t)(nelem - i)) == it);
+        CHECK(first <= it  &&  it < last);
+    }
+
+    CHECK(equal(nat_vector.rbegin(), nat_vector.rend(),
+                make_reverse_iterator(syn_vector.cend()), make_reverse_iterator(syn_vector.cbegin())));
+
+    //- Every chunk-local range lies within one chunk, and together they cover the sub-range.
+    //
+    size_t      offset = min(nelem, (size_t) 3);
+    size_t      nparts = 0;
+    size_t      ncover = 0;
+    bool        local  = true;
+
+    for_each_segment(first + (ptrdiff_t) offset, last, [&](DataType* pb, DataType* pe)
+    {
+        local   = local  &&  (pe - pb) > 0  &&  (size_t)(pe - pb) <= chunk_cap;
+        local   = local  &&  equal(pb, pe, nat_vector.begin() + (ptrdiff_t)(offset + ncover));
+        ncover += pe - pb;
+        ++nparts;
+    });
+    CHECK(local);
+    CHECK(ncover == nelem - offset);
+    CHECK(nparts == (nelem + chunk_cap - 1) / chunk_cap - offset / chunk_cap);
+
+    //- Standard algorithms work through the segmented iterator.
+    //
+    sort(nat_vector.begin(), nat_vector.end());
+    sort(syn_vector.begin(), syn_vector.end());
+    CHECK(contents_match(nat_vector, syn_vector));
+
+    //- Shrinking keeps the chunks until asked to release them.
+    //
+    size_t  nchunks = syn_vector.chunk_count();
+
+    nat_vector.resize(nelem / 2);
+    syn_vector.resize(nelem / 2);
+    CHECK(contents_match(nat_vector, syn_vector));
+    CHECK(syn_vector.chunk_count() == nchunks);
+
+    syn_vector.shrink_to_fit();
+    CHECK(syn_vector.chunk_count() == (nelem / 2 + chunk_cap - 1) / chunk_cap);
+    CHECK(contents_match(nat_vector, syn_vector));
+
+    syn_vector_type     moved(std::move(syn_vector));
+
+    CHECK(syn_vector.empty());
+    CHECK(syn_vector.begin() == syn_vector.end());
+    CHECK(contents_match(nat_vector, moved));
+
+    moved.clear();
+    CHECK(moved.begin() == moved.end());
+    CHECK(moved.capacity() != 0);
+}
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      do_reloc_segvector_tests<AllocStrategy>
+//
+//  Summary:
+//      This function template verifies that a segmented vector placed in the heap survives the
+//      relocation of the heap's buffers.
+//--------------------------------------------------------------------------------------------------
+//
+template<typename AllocStrategy>
+void
+do_reloc_segvector_tests(size_t nelem, size_t chunk_cap)
+{
+    using strategy        = AllocStrategy;
+    using syn_vector_type = segmented_vector<uint64_t, strategy>;
+
+    vector<uint64_t>    nat_vector(generate_test_data<uint64_t>(nelem));
+    auto                p_syn_vector = allocate<syn_vector_type, strategy>(chunk_cap);
+
+    for (uint64_t v : nat_vector)
+    {
+        p_syn_vector->push_back(v);
+    }
+
+    auto    pe_1 = addressof(p_syn_vector->back());
+
+    strategy::swap_buffers();
+
+    auto    pe_2 = addressof(p_syn_vector->back());
+
+    CHECK(pe_1 != pe_2);
+    CHECK(contents_match(nat_vector, *p_syn_vector));
+
+    strategy::swap_buffers();
+}
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      do_spanning_segvector_tests<AllocStrategy>
+//
+//  Summary:
+//      This function template builds a segmented vector with the default chunk capacity that
+//      is larger than a segment, and verifies that each of its chunks occupies a segment of its
+//      own.  For a storage model limited to a single segment, it verifies instead that growing
+//      the vector past the segment fails with std::bad_alloc, leaving its elements intact.  It
+//      re-creates the segments afterward to release the memory.
+//--------------------------------------------------------------------------------------------------
+//
+template<typename AllocStrategy>
+void
+do_spanning_segvector_tests()
+{
+    using strategy        = AllocStrategy;
+    using storage_model   = typename strategy::storage_model;
+    using syn_vector_type = segmented_vector<uint32_t, strategy>;
+
+    if (storage_model::max_segment_count() == 1)
+    {
+        //- Chunks of a quarter of a segment each; the chunk table takes some of the segment,
+        //  so only three of them fit.
+        //
+        syn_vector_type     syn_vector(syn_vector_type().chunk_capacity() / 4);
+        size_t              nelem  = 0;
+        bool                caught = false;
+
+        try
+        {
+            for (;  ;  ++nelem)
+            {
+                syn_vector.push_back((uint32_t) nelem);
+            }
+        }
+        catch (std::bad_alloc const&)
+        {
+            caught = true;
+        }
+        CHECK(caught);
+        CHECK(syn_vector.chunk_count() == 3u);
+        CHECK(syn_vector.size() == nelem);
+        CHECK(nelem == 3 * syn_vector.chunk_capacity());
+        CHECK(syn_vector[nelem - 1] == (uint32_t)(nelem - 1));
+    }
+    else
+    {
+        syn_vector_type     syn_vector;
+        size_t const        nelem = syn_vector.chunk_capacity() + 1000;
+        uint64_t            nat_sum = 0;
+        uint64_t            syn_sum = 0;
+        size_t              nparts  = 0;
+
+        for (size_t i = 0;  i < nelem;  ++i)
+        {
+            syn_vector.push_back((uint32_t) i);
+            nat_sum += (uint32_t) i;
+        }
+
+        CHECK(syn_vector.chunk_count() == 2u);
+        CHECK(syn_vector.chunk_segment(0) != 0);
+        CHECK(syn_vector.chunk_segment(1) != 0);
+        CHECK(syn_vector.chunk_segment(0) != syn_vector.chunk_segment(1));
+
+        for_each_segment(syn_vector.cbegin(), syn_vector.cend(), [&](uint32_t const* pb, uint32_t const* pe)
+        {
+            syn_sum = accumulate(pb, pe, syn_sum);
+            ++nparts;
+        });
+
+        CHECK(nparts == 2u);
+        CHECK(syn_sum == nat_sum);
+        CHECK(syn_vector[nelem - 1] == (uint32_t)(nelem - 1));
+        CHECK(*(syn_vector.begin() + (ptrdiff_t) syn_vector.chunk_capacity()) == (uint32_t) syn_vector.chunk_capacity());
+    }
+
+    rebuild_segments();
+}
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      run_segvector_tests<AllocStrategy>
+//
+//  Summary:
+//      This function template manages the sequence of actual segmented vector test calls.
+//--------------------------------------------------------------------------------------------------
+//
+template<typename AllocStrategy>
+void
+run_segvector_tests(char const* stype, bool relocatable)
+{
+    cout << "================================================================" << endl;
+    cout << "Running basic operation tests for " << stype << endl;
+    cout << "Using container segmented_vector" << endl;
+
+    do_normal_segvector_tests<AllocStrategy, uint64_t>(1000, 64);
+    do_normal_segvector_tests<AllocStrategy, uint64_t>(1024, 64);
+    do_normal_segvector_tests<AllocStrategy, test_struct>(500, 7);
+    do_normal_segvector_tests<AllocStrategy, string>(300, 10);
+
+    if (relocatable)
+    {
+        do_reloc_segvector_tests<AllocStrategy>(5000, 1000);
+    }
+
+    AllocStrategy::reset_buffers();
+}
+
+#endif  //- CONTAINER_SEGVECTOR_TESTS_H_DEFINED
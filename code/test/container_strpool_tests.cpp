@@ -0,0 +1,20 @@
+//==================================================================================================
+//  File:
+//      container_strpool_tests.cpp
+//
+//  Copyright (c) 2017 Bob Steagall, KEWB Computing
+//==================================================================================================
+//
+#include "container_strpool_tests.h"
+
+#define RUN_STRPOOL_TESTS(ST, RELOC)    run_strpool_tests<ST>(#ST, RELOC)
+
+void
+run_container_strpool_tests()
+{
+    RUN_STRPOOL_TESTS(wrapper_strategy, false);
+    RUN_STRPOOL_TESTS(based_2d_strategy, true);
+    RUN_STRPOOL_TESTS(based_2dxl_strategy, true);
+    RUN_STRPOOL_TESTS(offset_strategy, false);
+    RUN_STRPOOL_TESTS(based_2d_slab_strategy, true);
+}
@@ -0,0 +1,240 @@
+//==================================================================================================
+//  File:
+//      container_strpool_tests.h
+//
+//  Copyright (c) 2017 Bob Steagall, KEWB Computing
+//==================================================================================================
+//
+#ifndef CONTAINER_STRPOOL_TESTS_H_DEFINED
+#define CONTAINER_STRPOOL_TESTS_H_DEFINED
+
+#include "container_tests.h"
+
+//- Generates test strings in which each distinct string recurs about ten times, with a few
+//  strings too long to share a chunk of the pool.
+//
+inline vector<string>
+generate_symbol_strings(size_t nelem)
+{
+    vector<string>  distinct;
+    vector<string>  symbols;
+
+    for (size_t i = 0;  i < nelem / 10 + 1;  ++i)
+    {
+        distinct.push_back(generate_data<string>());
+    }
+    distinct.push_back(string(6000, 'L'));
+    distinct.push_back(string(6001, 'L'));
+
+    for (size_t i = 0;  i < nelem;  ++i)
+    {
+        symbols.push_back(distinct[(i * 7919) % distinct.size()]);
+    }
+    return symbols;
+}
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      do_normal_strpool_tests<AllocStrategy>
+//
+//  Summary:
+//      This function template interns strings with many duplicates, and checks that handles
+//      are equal exactly when their strings are, that the strings are recovered from their
+//      handles, and that copies of the pool keep the same handles.
+//--------------------------------------------------------------------------------------------------
+//
+template<typename AllocStrategy>
+void
+do_normal_strpool_tests(size_t nelem)
+{
+    using strategy  = AllocStrategy;
+    using pool_type = string_pool<strategy>;
+
+    vector<string>              symbols(generate_symbol_strings(nelem));
+    map<string, string_handle>  nat_index;
+    pool_type                   pool;
+
+    CHECK(pool.size() == 1u);
+    CHECK(pool.intern("") == string_handle()  &&  pool.length(string_handle()) == 0u);
+    CHECK(pool.find("absent") == string_handle::none()  &&  !pool.find("absent").valid());
+
+    for (auto const& str : symbols)
+    {
+        string_handle   h = pool.intern(str);
+        auto            r = nat_index.emplace(str, h);
+
+        CHECK(r.first->second == h);
+        CHECK(pool.c_str(h) == str  &&  pool.length(h) == str.size());
+    }
+    CHECK(pool.size() == nat_index.size() + (nat_index.count(string()) ? 0 : 1));
+
+    for (auto const& kvp : nat_index)
+    {
+        CHECK(pool.find(kvp.first.data(), kvp.first.size()) == kvp.second);
+        CHECK(pool.intern(rhx_string<strategy>(kvp.first)) == kvp.second);
+    }
+
+    //- Comparison of handles agrees with comparison of their strings.
+    //
+    auto    it1 = nat_index.begin();
+
+    for (auto it2 = next(it1);  it2 != nat_index.end();  ++it1, ++it2)
+    {
+        CHECK(it1->second != it2->second);
+        CHECK(pool.compare(it1->second, it2->second) < 0);
+        CHECK(pool.compare(it2->second, it1->second) > 0);
+        CHECK(pool.compare(it2->second, it2->second) == 0);
+    }
+
+    //- Copies and moves keep the handles.
+    //
+    pool_type   copy(pool);
+    pool_type   moved(std::move(copy));
+
+    for (auto const& kvp : nat_index)
+    {
+        CHECK(moved.find(kvp.first) == kvp.second);
+        CHECK(moved.c_str(kvp.second) == kvp.first);
+    }
+
+    moved.clear();
+    CHECK(moved.size() == 1u  &&  moved.find(symbols[0]).valid() == symbols[0].empty());
+    CHECK(moved.intern(symbols[0]) == string_handle(symbols[0].empty() ? 0 : 1));
+}
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      do_symbol_map_strpool_tests<AllocStrategy>
+//
+//  Summary:
+//      This function template repeats the map-of-lists-of-strings construction of the simple
+//      map test with interned strings, and compares its footprint with that of the strings.
+//--------------------------------------------------------------------------------------------------
+//
+template<typename AllocStrategy>
+void
+do_symbol_map_strpool_tests()
+{
+    using strategy      = AllocStrategy;
+    using pool_type     = string_pool<strategy>;
+    using handle_list   = list<string_handle, rhx_allocator<string_handle, strategy>>;
+    using handle_map    = map<string_handle, handle_list, less<string_handle>,
+                              rhx_allocator<pair<string_handle const, handle_list>, strategy>>;
+
+    pool_type       pool;
+    handle_map      syn_map;
+    size_t          str_bytes = 0;
+    char            key_str[128], val_str[128];
+
+    for (int i = 961;  i <= 971;  ++i)
+    {
+        sprintf(key_str, "this is key string #%d", i);
+
+        for (int j = 101;  j <= 106;  ++j)
+        {
+            sprintf(val_str, "this is very long value string #%d created for map<string,list<string>>", j);
+            syn_map[pool.intern(key_str)].push_back(pool.intern(val_str));
+            str_bytes += strlen(val_str) + 1;
+        }
+        str_bytes += strlen(key_str) + 1;
+    }
+
+    CHECK(syn_map.size() == 11u);
+    CHECK(pool.size() == 1u + 11u + 6u);
+
+    for (auto const& elem : syn_map)
+    {
+        int     j = 101;
+
+        CHECK(strncmp(pool.c_str(elem.first), "this is key string #", 20) == 0);
+
+        for (auto h : elem.second)
+        {
+            sprintf(val_str, "this is very long value string #%d created for map<string,list<string>>", j++);
+            CHECK(h == pool.find(val_str)  &&  strcmp(pool.c_str(h), val_str) == 0);
+        }
+    }
+
+    //- The pool's characters take a fraction of the space of the copies.
+    //
+    size_t  pool_chars = 0;
+
+    for (string_handle::id_type id = 0;  id < pool.size();  ++id)
+    {
+        pool_chars += pool.length(string_handle(id)) + 1;
+    }
+    CHECK(pool_chars * 5 < str_bytes);
+}
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      do_reloc_strpool_tests<AllocStrategy>
+//
+//  Summary:
+//      This function template verifies that a string pool placed in the heap, and the handles
+//      held by a vector in the heap, survive the relocation of the heap's buffers.
+//--------------------------------------------------------------------------------------------------
+//
+template<typename AllocStrategy>
+void
+do_reloc_strpool_tests(size_t nelem)
+{
+    using strategy        = AllocStrategy;
+    using pool_type       = string_pool<strategy>;
+    using syn_vector_type = vector<string_handle, rhx_allocator<string_handle, strategy>>;
+
+    vector<string>  symbols(generate_symbol_strings(nelem));
+    auto            p_pool    = allocate<pool_type, strategy>();
+    auto            p_handles = allocate<syn_vector_type, strategy>();
+
+    for (auto const& str : symbols)
+    {
+        p_handles->push_back(p_pool->intern(str));
+    }
+
+    auto    pe_1 = p_pool->c_str(p_handles->front());
+
+    strategy::swap_buffers();
+
+    auto    pe_2 = p_pool->c_str(p_handles->front());
+
+    CHECK(pe_1 != pe_2);
+
+    for (size_t i = 0;  i < symbols.size();  ++i)
+    {
+        CHECK(p_pool->c_str((*p_handles)[i]) == symbols[i]);
+        CHECK(p_pool->find(symbols[i]) == (*p_handles)[i]);
+    }
+    CHECK(p_pool->intern(symbols.back()) == p_handles->back());
+
+    strategy::swap_buffers();
+}
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      run_strpool_tests<AllocStrategy>
+//
+//  Summary:
+//      This function template manages the sequence of actual string pool test calls.
+//--------------------------------------------------------------------------------------------------
+//
+template<typename AllocStrategy>
+void
+run_strpool_tests(char const* stype, bool relocatable)
+{
+    cout << "================================================================" << endl;
+    cout << "Running basic operation tests for " << stype << endl;
+    cout << "Using container string_pool" << endl;
+
+    do_normal_strpool_tests<AllocStrategy>(20000);
+    do_symbol_map_strpool_tests<AllocStrategy>();
+
+    if (relocatable)
+    {
+        do_reloc_strpool_tests<AllocStrategy>(5000);
+    }
+
+    AllocStrategy::reset_buffers();
+}
+
+#endif  //- CONTAINER_STRPOOL_TESTS_H_DEFINED
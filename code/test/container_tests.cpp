@@ -10,9 +10,15 @@
 void    run_container_deque_tests();
 void    run_container_fwdlist_tests();
 void    run_container_list_tests();
+void    run_container_segvector_tests();
 void    run_container_vector_tests();
 
+void    run_container_btree_tests();
+void    run_container_flatmap_tests();
+void    run_container_flatsorted_tests();
 void    run_container_map_tests();
+void    run_container_rhxstring_tests();
+void    run_container_strpool_tests();
 void    run_container_umap_tests();
 
 void
@@ -21,9 +27,15 @@ run_container_tests()
     run_container_deque_tests();
     run_container_fwdlist_tests();
     run_container_list_tests();
+    run_container_segvector_tests();
     run_container_vector_tests();
 
+    run_container_btree_tests();
+    run_container_flatmap_tests();
+    run_container_flatsorted_tests();
     run_container_map_tests();
+    run_container_rhxstring_tests();
+    run_container_strpool_tests();
     run_container_umap_tests();
 
     printf("\n\n\n");
@@ -144,4 +144,23 @@ test_data_type_traits<string,test_string<AS>>::generate(nat_type& nat, syn_type&
     syn.assign(nat.data(), nat.size());
 }
 
+//- Partial specialization to handle case of rhx_string, whose short strings are held inline.
+//
+template<typename AS>
+struct test_data_type_traits<string, rhx_string<AS>>
+{
+    using nat_type = string;
+    using syn_type = rhx_string<AS>;
+
+    static  void    generate(nat_type& nat, syn_type& syn);
+};
+
+template<typename AS>
+void
+test_data_type_traits<string,rhx_string<AS>>::generate(nat_type& nat, syn_type& syn)
+{
+    nat = generate_data<string>();
+    syn.assign(nat.data(), nat.size());
+}
+
 #endif  //- CONTAINER_TESTS_H_DEFINED
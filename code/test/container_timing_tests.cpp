@@ -0,0 +1,20 @@
+//==================================================================================================
+//  File:
+//      container_timing_tests.cpp
+//
+//  Copyright (c) 2017 Bob Steagall, KEWB Computing
+//==================================================================================================
+//
+#include "container_timing_tests.h"
+
+#define RUN_CONTAINER_TIMING_TESTS(ST)  run_container_timing_tests<ST>(#ST)
+
+void
+run_container_timing_tests()
+{
+    RUN_CONTAINER_TIMING_TESTS(wrapper_strategy);
+    RUN_CONTAINER_TIMING_TESTS(based_2dxl_strategy);
+    RUN_CONTAINER_TIMING_TESTS(based_2d_strategy);
+    RUN_CONTAINER_TIMING_TESTS(based_1d_strategy);
+    RUN_CONTAINER_TIMING_TESTS(offset_strategy);
+}
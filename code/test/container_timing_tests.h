@@ -0,0 +1,527 @@
+//==================================================================================================
+//  File:
+//      container_timing_tests.h
+//
+//  Copyright (c) 2017 Bob Steagall, KEWB Computing
+//==================================================================================================
+//
+#ifndef CONTAINER_TIMING_TESTS_H_DEFINED
+#define CONTAINER_TIMING_TESTS_H_DEFINED
+
+#include "container_tests.h"
+#include "pointer_tests.h"
+
+//- The container operations that are timed.
+//
+enum class container_op
+{
+    insert,         //- Insert every key into an empty container
+    lookup,         //- Look up keys (or positions) in a filled container
+    erase,          //- Erase every element from a filled container
+    iterate         //- Visit every element of a filled container
+};
+
+inline char const*
+container_op_name(container_op op)
+{
+    switch (op)
+    {
+        case container_op::insert:  return "insert";
+        case container_op::lookup:  return "lookup";
+        case container_op::erase:   return "erase";
+        default:                    return "iterate";
+    }
+}
+
+//- The set of containers being timed, parameterized by an allocator alias template.  The
+//  std::allocator baseline and each rhx_allocator strategy instantiate the same set.
+//
+template<template<class> class Alloc>
+struct timing_containers
+{
+    using vector_type  = vector<uint64_t, Alloc<uint64_t>>;
+    using deque_type   = deque<uint64_t, Alloc<uint64_t>>;
+    using list_type    = list<uint64_t, Alloc<uint64_t>>;
+    using fwdlist_type = forward_list<uint64_t, Alloc<uint64_t>>;
+    using map_type     = map<uint64_t, uint64_t, less<uint64_t>, Alloc<pair<uint64_t const, uint64_t>>>;
+    using umap_type    = unordered_map<uint64_t, uint64_t, hash<uint64_t>, equal_to<uint64_t>,
+                                       Alloc<pair<uint64_t const, uint64_t>>>;
+    using string_type  = basic_string<char, char_traits<char>, Alloc<char>>;
+};
+
+//- The minimum number of elements processed per sample; small containers are timed in batches
+//  of this many elements.
+//
+size_t const    container_timing_volume = 50'000;
+
+template<class T>
+using std_timing_alloc = std::allocator<T>;
+
+template<class AS>
+struct rhx_timing_alloc
+{
+    template<class T>
+    using type = rhx_allocator<T, AS>;
+};
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      timed_insert / timed_lookup / timed_erase / timed_iterate
+//
+//  Summary:
+//      These function templates implement the timed operations for each kind of container.
+//      Lookups are by position for the random-access containers, by key for the associative
+//      containers, and are a fixed number of linear searches for the lists.  All of them
+//      return a value derived from the elements, so that the work cannot be optimized away.
+//      Insertion into a flat map is its construction from unsorted vectors of keys and values.
+//--------------------------------------------------------------------------------------------------
+//
+size_t const    list_lookup_count = 16;
+
+template<typename C>
+void
+timed_insert(C& c, vector<uint64_t> const& keys)
+{
+    for (auto k : keys) c.push_back(static_cast<typename C::value_type>(k));
+}
+
+template<typename T, typename A>
+void
+timed_insert(forward_list<T, A>& c, vector<uint64_t> const& keys)
+{
+    for (auto k : keys) c.push_front(k);
+}
+
+template<typename K, typename V, typename C, typename A>
+void
+timed_insert(map<K, V, C, A>& c, vector<uint64_t> const& keys)
+{
+    for (auto k : keys) c.emplace(k, k);
+}
+
+template<typename K, typename V, typename H, typename E, typename A>
+void
+timed_insert(unordered_map<K, V, H, E, A>& c, vector<uint64_t> const& keys)
+{
+    for (auto k : keys) c.emplace(k, k);
+}
+
+template<typename K, typename V, typename HT, typename H, typename E>
+void
+timed_insert(flat_hash_map<K, V, HT, H, E>& c, vector<uint64_t> const& keys)
+{
+    for (auto k : keys) c.emplace(k, k);
+}
+
+template<typename K, typename V, typename HT, typename C, size_t B>
+void
+timed_insert(btree_map<K, V, HT, C, B>& c, vector<uint64_t> const& keys)
+{
+    for (auto k : keys) c.emplace(k, k);
+}
+
+template<typename K, typename V, typename HT, typename C, typename S>
+void
+timed_insert(flat_map<K, V, HT, C, S>& c, vector<uint64_t> const& keys)
+{
+    using map_type = flat_map<K, V, HT, C, S>;
+
+    c = map_type(typename map_type::key_container_type(keys.begin(), keys.end()),
+                 typename map_type::mapped_container_type(keys.begin(), keys.end()));
+}
+
+//------
+//
+template<typename C>
+uint64_t
+timed_lookup(C& c, vector<uint64_t> const& keys)
+{
+    uint64_t    sum = 0;
+
+    for (auto k : keys) sum += static_cast<uint64_t>(c[k % c.size()]);
+    return sum;
+}
+
+template<typename T, typename A>
+uint64_t
+timed_lookup(list<T, A>& c, vector<uint64_t> const& keys)
+{
+    uint64_t    sum = 0;
+
+    for (size_t i = 0;  i < list_lookup_count  &&  i < keys.size();  ++i)
+    {
+        sum += *find(c.begin(), c.end(), keys[keys.size() - 1 - i]);
+    }
+    return sum;
+}
+
+template<typename T, typename A>
+uint64_t
+timed_lookup(forward_list<T, A>& c, vector<uint64_t> const& keys)
+{
+    uint64_t    sum = 0;
+
+    for (size_t i = 0;  i < list_lookup_count  &&  i < keys.size();  ++i)
+    {
+        sum += *find(c.begin(), c.end(), keys[i]);
+    }
+    return sum;
+}
+
+template<typename K, typename V, typename C, typename A>
+uint64_t
+timed_lookup(map<K, V, C, A>& c, vector<uint64_t> const& keys)
+{
+    uint64_t    sum = 0;
+
+    for (auto k : keys) sum += c.find(k)->second;
+    return sum;
+}
+
+template<typename K, typename V, typename H, typename E, typename A>
+uint64_t
+timed_lookup(unordered_map<K, V, H, E, A>& c, vector<uint64_t> const& keys)
+{
+    uint64_t    sum = 0;
+
+    for (auto k : keys) sum += c.find(k)->second;
+    return sum;
+}
+
+template<typename K, typename V, typename HT, typename H, typename E>
+uint64_t
+timed_lookup(flat_hash_map<K, V, HT, H, E>& c, vector<uint64_t> const& keys)
+{
+    uint64_t    sum = 0;
+
+    for (auto k : keys) sum += c.find(k)->second;
+    return sum;
+}
+
+template<typename K, typename V, typename HT, typename C, size_t B>
+uint64_t
+timed_lookup(btree_map<K, V, HT, C, B>& c, vector<uint64_t> const& keys)
+{
+    uint64_t    sum = 0;
+
+    for (auto k : keys) sum += c.find(k)->second;
+    return sum;
+}
+
+template<typename K, typename V, typename HT, typename C, typename S>
+uint64_t
+timed_lookup(flat_map<K, V, HT, C, S>& c, vector<uint64_t> const& keys)
+{
+    uint64_t    sum = 0;
+
+    for (auto k : keys) sum += c.find(k)->second;
+    return sum;
+}
+
+//------
+//
+template<typename C>
+void
+timed_erase(C& c, vector<uint64_t> const&)
+{
+    while (!c.empty()) c.pop_back();
+}
+
+template<typename T, typename A>
+void
+timed_erase(deque<T, A>& c, vector<uint64_t> const&)
+{
+    while (!c.empty()) c.pop_front();
+}
+
+template<typename T, typename A>
+void
+timed_erase(list<T, A>& c, vector<uint64_t> const&)
+{
+    while (!c.empty()) c.pop_front();
+}
+
+template<typename T, typename A>
+void
+timed_erase(forward_list<T, A>& c, vector<uint64_t> const&)
+{
+    while (!c.empty()) c.pop_front();
+}
+
+template<typename K, typename V, typename C, typename A>
+void
+timed_erase(map<K, V, C, A>& c, vector<uint64_t> const& keys)
+{
+    for (auto k : keys) c.erase(k);
+}
+
+template<typename K, typename V, typename H, typename E, typename A>
+void
+timed_erase(unordered_map<K, V, H, E, A>& c, vector<uint64_t> const& keys)
+{
+    for (auto k : keys) c.erase(k);
+}
+
+template<typename K, typename V, typename HT, typename H, typename E>
+void
+timed_erase(flat_hash_map<K, V, HT, H, E>& c, vector<uint64_t> const& keys)
+{
+    for (auto k : keys) c.erase(k);
+}
+
+template<typename K, typename V, typename HT, typename C, size_t B>
+void
+timed_erase(btree_map<K, V, HT, C, B>& c, vector<uint64_t> const& keys)
+{
+    for (auto k : keys) c.erase(k);
+}
+
+template<typename K, typename V, typename HT, typename C, typename S>
+void
+timed_erase(flat_map<K, V, HT, C, S>& c, vector<uint64_t> const& keys)
+{
+    for (auto k : keys) c.erase(k);
+}
+
+//------
+//
+template<typename C>
+uint64_t
+timed_iterate(C& c)
+{
+    uint64_t    sum = 0;
+
+    for (auto const& v : c) sum += static_cast<uint64_t>(v);
+    return sum;
+}
+
+template<typename K, typename V, typename C, typename A>
+uint64_t
+timed_iterate(map<K, V, C, A>& c)
+{
+    uint64_t    sum = 0;
+
+    for (auto const& kv : c) sum += kv.second;
+    return sum;
+}
+
+template<typename K, typename V, typename H, typename E, typename A>
+uint64_t
+timed_iterate(unordered_map<K, V, H, E, A>& c)
+{
+    uint64_t    sum = 0;
+
+    for (auto const& kv : c) sum += kv.second;
+    return sum;
+}
+
+template<typename K, typename V, typename HT, typename H, typename E>
+uint64_t
+timed_iterate(flat_hash_map<K, V, HT, H, E>& c)
+{
+    uint64_t    sum = 0;
+
+    for (auto const& kv : c) sum += kv.second;
+    return sum;
+}
+
+template<typename K, typename V, typename HT, typename C, size_t B>
+uint64_t
+timed_iterate(btree_map<K, V, HT, C, B>& c)
+{
+    uint64_t    sum = 0;
+
+    for (auto const& kv : c) sum += kv.second;
+    return sum;
+}
+
+template<typename K, typename V, typename HT, typename C, typename S>
+uint64_t
+timed_iterate(flat_map<K, V, HT, C, S>& c)
+{
+    uint64_t    sum = 0;
+
+    for (auto const& kv : c) sum += kv.second;
+    return sum;
+}
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      time_container_op<C>
+//
+//  Summary:
+//      This function template measures one operation on each of several identical containers,
+//      so that the timed region is long enough to measure reliably at small element counts.
+//      Except when timing insertion, the containers are filled before timing starts; they are
+//      destroyed after timing stops.
+//--------------------------------------------------------------------------------------------------
+//
+template<typename Container>
+int64_t
+time_container_op(container_op op, vector<uint64_t> const& keys, size_t nreps,
+                  counter_values& pcv)
+{
+    //- Make sure the compiler doesn't optimize the lookups and iterations away.
+    //
+    static  volatile uint64_t   dummy = 0;
+
+    perf_counters&      pc = bench_counters();
+    stopwatch           sw;
+    vector<Container>   cs(nreps);
+
+    if (op != container_op::insert)
+    {
+        for (auto& c : cs) timed_insert(c, keys);
+    }
+
+    pc.start();
+    sw.start();
+    for (auto& c : cs)
+    {
+        switch (op)
+        {
+            case container_op::insert:  timed_insert(c, keys);              break;
+            case container_op::lookup:  dummy += timed_lookup(c, keys);     break;
+            case container_op::erase:   timed_erase(c, keys);               break;
+            case container_op::iterate: dummy += timed_iterate(c);          break;
+        }
+    }
+    sw.stop();
+    pc.stop();
+
+    pcv = pc.values();
+    return sw.elapsed_nsec();
+}
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      do_container_timing_test<NC,SC,AS>
+//
+//  Summary:
+//      This function template measures one operation on containers using std::allocator and
+//      on the same containers using rhx_allocator, alternating which goes first.  The
+//      std::allocator time takes the place of the native time in the timing pair.  The heap
+//      is rolled back to its starting point afterwards, which is much cheaper than resetting
+//      the buffers before every sample.
+//--------------------------------------------------------------------------------------------------
+//
+template<typename NatContainer, typename SynContainer, typename AllocStrategy>
+timing_pair
+do_container_timing_test(container_op op, vector<uint64_t> const& keys, size_t nreps)
+{
+    static bool     native_first = true;
+    timing_pair     tp;
+    auto            start = AllocStrategy::mark();
+
+    if (native_first)
+    {
+        tp.m_el_nat = time_container_op<NatContainer>(op, keys, nreps, tp.m_pc_nat);
+        tp.m_el_syn = time_container_op<SynContainer>(op, keys, nreps, tp.m_pc_syn);
+    }
+    else
+    {
+        tp.m_el_syn = time_container_op<SynContainer>(op, keys, nreps, tp.m_pc_syn);
+        tp.m_el_nat = time_container_op<NatContainer>(op, keys, nreps, tp.m_pc_nat);
+    }
+
+    AllocStrategy::rollback(start);
+    native_first = !native_first;
+
+    return tp;
+}
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      run_container_timing_test<NC,SC,AS>
+//
+//  Summary:
+//      This function template times each of the operations on one kind of container, for each
+//      of the element counts, and reports the rhx_allocator-to-std::allocator ratios.  Counts
+//      whose containers outgrow the heap are reported as n/a.  A container for which some
+//      operation is not meaningful to time may be given a shorter list of operations.
+//--------------------------------------------------------------------------------------------------
+//
+template<typename NatContainer, typename SynContainer, typename AllocStrategy>
+void
+run_container_timing_test(char const* stype, char const* ctype,
+                          std::initializer_list<container_op> ops = { container_op::insert,
+                                                                      container_op::lookup,
+                                                                      container_op::erase,
+                                                                      container_op::iterate })
+{
+    for (container_op op : ops)
+    {
+        for (size_t i = 0;  i < max_element_index();  ++i)
+        {
+            size_t              nelem = elem_counts[i];
+            size_t              nreps = max((size_t) 1, container_timing_volume/nelem);
+            vector<uint64_t>    keys(generate_test_data<uint64_t>(nelem));
+            timing_vector       samples;
+            timing_summary      summary;
+
+            AllocStrategy::reset_buffers();
+            try
+            {
+                samples = collect_timings([&]()
+                {
+                    return do_container_timing_test<NatContainer, SynContainer, AllocStrategy>(op, keys, nreps);
+                });
+            }
+            catch (std::bad_alloc&)
+            {
+                print_unavailable(container_op_name(op), stype, ctype, nelem);
+                continue;
+            }
+            summary = summarize_timings(samples);
+
+            print_timings(container_op_name(op), stype, ctype, nelem, summary);
+            report_timings(container_op_name(op), stype, ctype, nelem, nreps, samples, summary);
+        }
+        cout << endl;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      run_container_timing_tests<AS>
+//
+//  Summary:
+//      This function template manages the sequence of container timing test calls for one
+//      allocation strategy.  The flat hash map is timed against the same std::unordered_map
+//      baseline as the node-based unordered map, so that the two rows can be compared directly;
+//      likewise, the B+ tree map and the flat maps share the std::map baseline with the
+//      node-based map.  Erasing keys one at a time from a flat map takes quadratic time, so the
+//      flat maps are not timed for erasure.  The rhx_string row shares the std::string baseline
+//      with the string that uses rhx_allocator.
+//--------------------------------------------------------------------------------------------------
+//
+template<typename AllocStrategy>
+void
+run_container_timing_tests(char const* stype)
+{
+    using nat = timing_containers<std_timing_alloc>;
+    using syn = timing_containers<rhx_timing_alloc<AllocStrategy>::template type>;
+
+    using flat_umap_type = flat_hash_map<uint64_t, uint64_t, AllocStrategy>;
+    using btree_map_type = btree_map<uint64_t, uint64_t, AllocStrategy>;
+    using flat_map_type  = flat_map<uint64_t, uint64_t, AllocStrategy>;
+    using eytz_map_type  = flat_map<uint64_t, uint64_t, AllocStrategy, less<uint64_t>, flat_eytzinger_search>;
+    using rhx_str_type   = rhx_string<AllocStrategy>;
+
+    auto const  flat_ops = { container_op::insert, container_op::lookup, container_op::iterate };
+
+    run_container_timing_test<typename nat::vector_type,  typename syn::vector_type,  AllocStrategy>(stype, "vector");
+    run_container_timing_test<typename nat::deque_type,   typename syn::deque_type,   AllocStrategy>(stype, "deque");
+    run_container_timing_test<typename nat::list_type,    typename syn::list_type,    AllocStrategy>(stype, "list");
+    run_container_timing_test<typename nat::fwdlist_type, typename syn::fwdlist_type, AllocStrategy>(stype, "forward_list");
+    run_container_timing_test<typename nat::map_type,     typename syn::map_type,     AllocStrategy>(stype, "map");
+    run_container_timing_test<typename nat::map_type,     btree_map_type,             AllocStrategy>(stype, "btree_map");
+    run_container_timing_test<typename nat::map_type,     flat_map_type,              AllocStrategy>(stype, "flat_map", flat_ops);
+    run_container_timing_test<typename nat::map_type,     eytz_map_type,              AllocStrategy>(stype, "flat_map_eytzinger", flat_ops);
+    run_container_timing_test<typename nat::umap_type,    typename syn::umap_type,    AllocStrategy>(stype, "unordered_map");
+    run_container_timing_test<typename nat::umap_type,    flat_umap_type,             AllocStrategy>(stype, "flat_hash_map");
+    run_container_timing_test<typename nat::string_type,  typename syn::string_type,  AllocStrategy>(stype, "string");
+    run_container_timing_test<typename nat::string_type,  rhx_str_type,               AllocStrategy>(stype, "rhx_string");
+}
+
+#endif  //- CONTAINER_TIMING_TESTS_H_DEFINED
@@ -26,6 +26,7 @@ run_container_vector_tests()
     RUN_VECTOR_TESTS(wrapper_strategy);
     RUN_VECTOR_TESTS(based_2d_strategy);
     RUN_VECTOR_RELOC_TESTS(based_2d_strategy);
+    RUN_VECTOR_TESTS(offset_strategy);
 
     //- Vary POCCA and POCMA, holding POCS as true_type.
     //
@@ -173,6 +173,124 @@ do_normal_vector_tests(size_t nelem)
     CHECK(contents_match(nat_vector, *p_syn_vector_E));
 }
 
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      do_erase_vector_tests<AllocStrategy, DataType>
+//
+//  Summary:
+//      This function template erases and inserts elements in the middle of a vector, which
+//      moves the elements that follow through temporary iterators, and checks the contents
+//      against a native vector after each step.
+//--------------------------------------------------------------------------------------------------
+//
+template<typename AllocStrategy, typename DataType>
+void
+do_erase_vector_tests(size_t nelem)
+{
+    using strategy        = AllocStrategy;
+    using data_traits     = test_data_type_traits<DataType, AllocStrategy>;
+    using nat_data_type   = typename data_traits::nat_type;
+    using syn_data_type   = typename data_traits::syn_type;
+    using nat_vector_type = vector<nat_data_type>;
+    using syn_vector_type = vector<syn_data_type, rhx_allocator<syn_data_type, strategy>>;
+
+    nat_vector_type     nat_vector;
+    syn_vector_type     syn_vector;
+
+    for (size_t i = 0;  i < nelem;  ++i)
+    {
+        nat_data_type   nat_data;
+        syn_data_type   syn_data;
+
+        data_traits::generate(nat_data, syn_data);
+
+        nat_vector.push_back(nat_data);
+        syn_vector.push_back(syn_data);
+    }
+
+    for (size_t i = 3;  i < nat_vector.size();  i += 3)
+    {
+        nat_vector.erase(nat_vector.begin() + i);
+        syn_vector.erase(syn_vector.begin() + i);
+        CHECK(contents_match(nat_vector, syn_vector));
+    }
+
+    for (size_t i = 1;  i < nat_vector.size();  i += 4)
+    {
+        nat_vector.insert(nat_vector.begin() + i, nat_vector.back());
+        syn_vector.insert(syn_vector.begin() + i, syn_vector.back());
+        CHECK(contents_match(nat_vector, syn_vector));
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      do_expand_vector_tests<AllocStrategy>
+//
+//  Summary:
+//      This function template exercises in-place buffer growth.  It grows a buffer by doubling
+//      its capacity, as vector::push_back() does, using the rhx-aware reallocate() facility.
+//--------------------------------------------------------------------------------------------------
+//
+template<typename AllocStrategy>
+void
+do_expand_vector_tests(size_t nelem)
+{
+    //- Various type aliases to aid readability.
+    //
+    using strategy   = AllocStrategy;
+    using alloc_type = rhx_allocator<test_struct, strategy>;
+    using pointer    = typename alloc_type::pointer;
+
+    alloc_type          alloc;
+    vector<test_struct> nat_vector;
+    pointer             p_data  = nullptr;
+    size_t              n_used  = 0;
+    size_t              n_cap   = 0;
+    size_t              n_moved = 0;
+
+    //- Nothing else is allocated while the buffer grows, so every growth step after the first
+    //  should be satisfied in place.
+    //
+    for (size_t i = 0;  i < nelem;  ++i)
+    {
+        if (n_used == n_cap)
+        {
+            size_t      new_cap = (n_cap == 0) ? 1 : 2*n_cap;
+            pointer     p_new   = reallocate(alloc, p_data, n_used, n_cap, new_cap);
+
+            if (n_cap != 0  &&  p_new != p_data)
+            {
+                ++n_moved;
+            }
+            p_data = p_new;
+            n_cap  = new_cap;
+        }
+
+        test_struct     ts = generate_test_struct();
+
+        alloc.construct(static_cast<test_struct*>(p_data + n_used), ts);
+        nat_vector.push_back(ts);
+        ++n_used;
+    }
+
+    CHECK(n_moved == 0);
+    CHECK(equal(cbegin(nat_vector), cend(nat_vector), static_cast<test_struct*>(p_data)));
+
+    //- After an intervening allocation the buffer no longer borders the free space, so the
+    //  next growth step must move the contents to a new buffer.
+    //
+    auto        p_other = alloc.allocate(1);
+    pointer     p_new   = reallocate(alloc, p_data, n_used, n_cap, 2*n_cap);
+
+    CHECK(p_new != p_data);
+    CHECK(equal(cbegin(nat_vector), cend(nat_vector), static_cast<test_struct*>(p_new)));
+
+    destroy_range(static_cast<test_struct*>(p_new), static_cast<test_struct*>(p_new + n_used));
+    alloc.deallocate(p_new, 2*n_cap);
+    alloc.deallocate(p_other, 1);
+}
+
 //--------------------------------------------------------------------------------------------------
 //  Function:
 //      run_vector_normal_tests<AllocStrategy>
@@ -199,26 +317,30 @@ run_vector_normal_tests(char const* stype)
     }
 
     do_normal_vector_tests<AllocStrategy, string>(10);
+    do_erase_vector_tests<AllocStrategy, test_struct>(20);
+    do_erase_vector_tests<AllocStrategy, string>(20);
+    do_expand_vector_tests<AllocStrategy>(100);
 
     AllocStrategy::reset_buffers();
 }
 
 //--------------------------------------------------------------------------------------------------
 //  Function:
-//      do_reloc_vector_tests<AllocStrategy, DataType>
+//      do_reloc_vector_tests<AllocStrategy, DataType, DataTraits>
 //
 //  Summary:
 //      This function template performs basic functionality testing (basic/copy/move ops).
 //--------------------------------------------------------------------------------------------------
 //
-template<typename AllocStrategy, typename DataType>
+template<typename AllocStrategy, typename DataType,
+         typename DataTraits = test_data_type_traits<DataType, AllocStrategy>>
 void
 do_reloc_vector_tests(size_t nelem)
 {
     //- Various type aliases to aid readability.
     //
     using strategy        = AllocStrategy;
-    using data_traits     = test_data_type_traits<DataType, AllocStrategy>;
+    using data_traits     = DataTraits;
     using nat_data_type   = typename data_traits::nat_type;
     using syn_data_type   = typename data_traits::syn_type;
     using nat_vector_type = vector<nat_data_type>;
@@ -284,7 +406,9 @@ run_vector_reloc_tests(char const* stype)
         cout << "------------------------------------------------" << endl << endl;
     }
 
-    do_reloc_vector_tests<AllocStrategy, string>(10);
+    //- The strings must be rhx_strings, so that their characters are relocated with the heap.
+    //
+    do_reloc_vector_tests<AllocStrategy, string, test_data_type_traits<string, rhx_string<AllocStrategy>>>(10);
 
     AllocStrategy::reset_buffers();
 }
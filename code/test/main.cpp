@@ -9,12 +9,30 @@
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include "storage_base.h"
+#include "allocation_trace.h"
+#include "bench_registry.h"
+#include "bench_runner.h"
+
+void    dump_allocation_stats_at_exit();
+bool    run_trace_replay(char const* file_name);
+bool    set_report_format(char const* fmt_name);
+void    set_report_file(char const* file_name);
+
+void    register_pointer_benches();
 
 void    run_container_tests();
+void    run_container_timing_tests();
+void    run_pointer_op_tests();
 void    run_pointer_tests();
+void    run_strategy_tests();
+void    run_strategy_timing_tests();
 
 bool    contnrs_only = false;
 bool    timings_only = false;
+bool    ptr_ops_only = false;
+bool    benches_only = false;
+bool    list_only    = false;
 bool    verbose_flag = false;
 size_t  max_elem_idx = 13;
 
@@ -33,12 +51,20 @@ max_ptr_op_count_index()
 void
 print_help()
 {
-    printf("usage: alloc [-c] [-t] [-p N]\n");
+    printf("usage: alloc [-c] [-t] [-m] [-p N] [-H mode] [-o fmt] [-f file] [-S]\n");
+    printf("             [-T file] [-R file]\n");
+    printf("       alloc -b [--ops list] [--strategies list] [--types list] [--counts list]\n");
+    printf("                [--reps N] [--list]\n");
     printf("\n");
     printf("       -c       run only allocator awareness conformance tests\n\n");
-    printf("       -t       run only synthetic pointer timing tests\n\n");
-    printf("       -p N     run synthetic pointer performance tests on the first thru\n");
-    printf("                the Nth element set, where N = [1, 13] and the element\n");
+    printf("       -t       run only synthetic pointer and container timing tests\n\n");
+    printf("       -m       run only the synthetic pointer operation microbenchmarks, which\n");
+    printf("                print lines of the form:\n");
+    printf("                  ptrop, op, strategy, native ns/op, synthetic ns/op,\n");
+    printf("                  native cycles/op, synthetic cycles/op, ratio, samples,\n");
+    printf("                  cycle source (pmu, tsc, or none)\n\n");
+    printf("       -p N     run synthetic pointer and container performance tests on the first thru\n");
+    printf("                the Nth element set, where N = [1, 19] and the element\n");
     printf("                counts are:\n");
     printf("                   N     Elem Count\n");
     printf("                  ---    ----------\n");
@@ -54,12 +80,71 @@ print_help()
     printf("                  10       100000\n");
     printf("                  11       200000\n");
     printf("                  12       500000\n");
-    printf("                  13      1000000\n\n");
+    printf("                  13      1000000\n");
+    printf("                  14      2000000\n");
+    printf("                  15      5000000\n");
+    printf("                  16     10000000\n");
+    printf("                  17     20000000\n");
+    printf("                  18     50000000\n");
+    printf("                  19    100000000\n");
+    printf("                the default is 13; arrays larger than a heap segment are\n");
+    printf("                copied into a segmented_vector, one segment at a time, and\n");
+    printf("                also across the segment boundaries through its iterators,\n");
+    printf("                reported as copy_span; they are n/a for sort and stable_sort,\n");
+    printf("                and for copy if they do not fit in the heap at all\n\n");
+    printf("       -H mode  back the heap segments with huge pages, where mode is one of:\n");
+    printf("                   none   normal pages (the default)\n");
+    printf("                   thp    transparent huge pages, via madvise()\n");
+    printf("                   2m     explicit 2 MB huge pages (Linux only)\n");
+    printf("                   1g     explicit 1 GB huge pages (Linux only)\n");
+    printf("                unavailable page sizes fall back to smaller ones\n\n");
+    printf("       -o fmt   also write synthetic pointer timings, with every sample, to\n");
+    printf("                a report file, where fmt is csv or json (one object per line)\n\n");
+    printf("       -f file  name of the report file; the default is alloc-timings.csv or\n");
+    printf("                alloc-timings.json\n\n");
+    printf("       -S       print allocation statistics for each strategy at exit; they are\n");
+    printf("                collected only when built with RHX_ALLOCATION_STATS defined\n\n");
+    printf("       -T file  record the allocations made through rhx_allocator during the run\n");
+    printf("                in an allocation trace; they are recorded only when built with\n");
+    printf("                RHX_ALLOCATION_TRACE defined\n\n");
+    printf("       -b       run only the selected synthetic pointer timing tests; each list is\n");
+    printf("                comma-separated, and an omitted list selects everything:\n");
+    printf("                  --ops         copy, sort, stable_sort\n");
+    printf("                  --strategies  wrapper, based_2dxl, based_2d, based_1d, offset\n");
+    printf("                                (with or without the _strategy suffix)\n");
+    printf("                  --types       uint32_t, uint64_t, string, test_struct\n");
+    printf("                  --counts      any element counts; the default is those of -p\n");
+    printf("                  --reps N      take exactly N samples of each test, rather than\n");
+    printf("                                sampling until the ratio is precise\n");
+    printf("                  --list        list the registered tests and exit\n\n");
+    printf("       -R file  replay an allocation trace against each strategy and report the\n");
+    printf("                time taken and the resulting fragmentation, then exit\n\n");
+}
+
+bool
+set_page_mode(char const* pname)
+{
+    using page_mode = storage_model_base::page_mode;
+
+    if (strcmp(pname, "none") == 0)
+        storage_model_base::set_page_mode(page_mode::normal);
+    else if (strcmp(pname, "thp") == 0)
+        storage_model_base::set_page_mode(page_mode::transparent);
+    else if (strcmp(pname, "2m") == 0)
+        storage_model_base::set_page_mode(page_mode::huge_2mb);
+    else if (strcmp(pname, "1g") == 0)
+        storage_model_base::set_page_mode(page_mode::huge_1gb);
+    else
+        return false;
+
+    return true;
 }
 
 int 
 main(int argc, char* argv[])
 {
+    bench_selection     sel;
+
     if (argc == 1)
     {
         print_help();
@@ -81,6 +166,47 @@ main(int argc, char* argv[])
             {
                 timings_only = true;
             }
+            else if (strcmp(argv[i], "-m") == 0)
+            {
+                ptr_ops_only = true;
+            }
+            else if (strcmp(argv[i], "-b") == 0)
+            {
+                benches_only = true;
+            }
+            else if (strcmp(argv[i], "--list") == 0)
+            {
+                list_only = true;
+            }
+            else if (strcmp(argv[i], "--ops") == 0  ||  strcmp(argv[i], "--strategies") == 0  ||
+                     strcmp(argv[i], "--types") == 0)
+            {
+                vector<string>& names = (argv[i][2] == 'o') ? sel.m_ops
+                                      : (argv[i][2] == 's') ? sel.m_stypes : sel.m_dtypes;
+
+                if (++i >= argc  ||  !parse_name_list(argv[i], names))
+                {
+                    print_help();
+                    return 1;
+                }
+            }
+            else if (strcmp(argv[i], "--counts") == 0)
+            {
+                if (++i >= argc  ||  !parse_count_list(argv[i], sel.m_counts))
+                {
+                    print_help();
+                    return 1;
+                }
+            }
+            else if (strcmp(argv[i], "--reps") == 0)
+            {
+                if (++i >= argc  ||  atoi(argv[i]) <= 0)
+                {
+                    print_help();
+                    return 1;
+                }
+                bench_fixed_samples() = (size_t) atoi(argv[i]);
+            }
             else if (strcmp(argv[i], "-v") == 0)
             {
                 verbose_flag = true;
@@ -93,16 +219,90 @@ main(int argc, char* argv[])
 
                 }
             }
+            else if (strcmp(argv[i], "-o") == 0)
+            {
+                if (++i >= argc  ||  !set_report_format(argv[i]))
+                {
+                    print_help();
+                    return 1;
+                }
+            }
+            else if (strcmp(argv[i], "-f") == 0)
+            {
+                if (++i < argc)
+                {
+                    set_report_file(argv[i]);
+                }
+            }
+            else if (strcmp(argv[i], "-S") == 0)
+            {
+                dump_allocation_stats_at_exit();
+            }
+            else if (strcmp(argv[i], "-T") == 0)
+            {
+                if (++i >= argc  ||  !allocation_trace::start(argv[i]))
+                {
+                    print_help();
+                    return 1;
+                }
+                atexit(allocation_trace::stop);
+#ifndef RHX_ALLOCATION_TRACE
+                printf("allocation trace: not compiled in; define RHX_ALLOCATION_TRACE to record one\n");
+#endif
+            }
+            else if (strcmp(argv[i], "-R") == 0)
+            {
+                return (++i < argc  &&  run_trace_replay(argv[i])) ? 0 : 1;
+            }
+            else if (strcmp(argv[i], "-H") == 0)
+            {
+                if (++i >= argc  ||  !set_page_mode(argv[i]))
+                {
+                    print_help();
+                    return 1;
+                }
+            }
+        }
+
+        if (storage_model_base::requested_page_mode() != storage_model_base::page_mode::normal)
+        {
+            storage_model_base::init_segments();
+            printf("page mode: requested %s, obtained %s\n\n",
+                   storage_model_base::page_mode_name(storage_model_base::requested_page_mode()),
+                   storage_model_base::page_mode_name(storage_model_base::segment_page_mode(
+                        storage_model_base::first_segment_index())));
+        }
+
+        if (benches_only  ||  list_only)
+        {
+            register_pointer_benches();
+
+            if (list_only)
+            {
+                list_benches();
+                return 0;
+            }
+            return (run_benches(sel) != 0) ? 0 : 1;
+        }
+
+        if (ptr_ops_only)
+        {
+            run_pointer_op_tests();
+            return 0;
         }
 
         if (!timings_only)
         {
             run_container_tests();
+            run_strategy_tests();
         }
 
         if (!contnrs_only)
         {
             run_pointer_tests();
+            run_pointer_op_tests();
+            run_container_timing_tests();
+            run_strategy_timing_tests();
         }
     }
     return 0;
@@ -0,0 +1,286 @@
+//==================================================================================================
+//  File:
+//      perf_counters.h
+//
+//  Summary:
+//      Defines a simple set of hardware performance counters for use in timing tests.
+//
+//  Copyright (c) 2017 Bob Steagall, KEWB Computing
+//==================================================================================================
+//
+#ifndef PERF_COUNTERS_H_DEFINED
+#define PERF_COUNTERS_H_DEFINED
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#ifdef __linux__
+    #include <linux/perf_event.h>
+    #include <sys/ioctl.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+#endif
+
+//- The values of the counters over one measured phase.  A counter that could not be opened has
+//  no value, and is reported as zero.  When the kernel has had to multiplex a counter with other
+//  events, its count is scaled up by the ratio of the time it was enabled to the time it was
+//  actually running, and the values are flagged as multiplexed, since they are then estimates.
+//
+struct counter_values
+{
+    enum : size_t
+    {
+        cycles,
+        instructions,
+        branch_misses,
+        l1d_misses,
+        llc_misses,
+        dtlb_misses,
+        counter_count
+    };
+
+    uint64_t    m_values[counter_count];
+    bool        m_multiplexed;
+
+    static  char const*     name(size_t counter);
+};
+
+inline char const*
+counter_values::name(size_t counter)
+{
+    static char const* const    names[counter_count] =
+    {
+        "cycles", "instructions", "branch_misses", "l1d_misses", "llc_misses", "dtlb_misses"
+    };
+
+    return (counter < counter_count) ? names[counter] : "unknown";
+}
+
+//--------------------------------------------------------------------------------------------------
+//  Class:
+//      perf_counters
+//
+//  Summary:
+//      This class measures cycles, instructions, branch misses, L1D, LLC, and dTLB read misses
+//      for the calling thread, in user mode, using perf_event_open() on Linux.  Each counter is
+//      opened separately, so that those the CPU or the kernel's perf_event_paranoid setting do
+//      not allow are simply unavailable.  Since the counters are not scheduled as a group, each
+//      one also reads its enabled and running times, and is scaled if it was multiplexed during
+//      the measured phase.  On
+//      other platforms, or when no counter can be opened, nothing is counted and the timing
+//      tests report wall time only.
+//--------------------------------------------------------------------------------------------------
+//
+class perf_counters
+{
+  public:
+    perf_counters();
+    ~perf_counters();
+
+    perf_counters(perf_counters const&) = delete;
+    perf_counters&  operator =(perf_counters const&) = delete;
+
+    bool    available() const;
+    bool    available(size_t counter) const;
+
+    void    start();
+    void    stop();
+
+    counter_values const&   values() const;
+
+  private:
+    int             m_fds[counter_values::counter_count];
+    uint64_t        m_enabled[counter_values::counter_count];   //- Times enabled at start()
+    uint64_t        m_running[counter_values::counter_count];   //- Times running at start()
+    counter_values  m_values;
+};
+
+#ifdef __linux__
+
+inline
+perf_counters::perf_counters()
+:   m_fds{}
+,   m_enabled{}
+,   m_running{}
+,   m_values{}
+{
+    static uint32_t const   types[counter_values::counter_count] =
+    {
+        PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE,
+        PERF_TYPE_HW_CACHE, PERF_TYPE_HW_CACHE, PERF_TYPE_HW_CACHE
+    };
+    static uint64_t const   configs[counter_values::counter_count] =
+    {
+        PERF_COUNT_HW_CPU_CYCLES,
+        PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_BRANCH_MISSES,
+        PERF_COUNT_HW_CACHE_L1D  | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16),
+        PERF_COUNT_HW_CACHE_LL   | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16),
+        PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)
+    };
+
+    for (size_t i = 0;  i < counter_values::counter_count;  ++i)
+    {
+        perf_event_attr     attr;
+
+        memset(&attr, 0, sizeof(attr));
+        attr.type           = types[i];
+        attr.size           = sizeof(attr);
+        attr.config         = configs[i];
+        attr.disabled       = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv     = 1;
+        attr.read_format    = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        m_fds[i] = (int) syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+    }
+}
+
+inline
+perf_counters::~perf_counters()
+{
+    for (int fd : m_fds)
+    {
+        if (fd >= 0) close(fd);
+    }
+}
+
+inline bool
+perf_counters::available(size_t counter) const
+{
+    return m_fds[counter] >= 0;
+}
+
+//- Resetting a counter clears its count but not its enabled and running times, which accumulate
+//  from when it was opened; so those are recorded here, and stop() works from their changes.
+//
+inline void
+perf_counters::start()
+{
+    for (size_t i = 0;  i < counter_values::counter_count;  ++i)
+    {
+        if (m_fds[i] >= 0)
+        {
+            uint64_t    data[3];    //- value, time enabled, time running
+
+            ioctl(m_fds[i], PERF_EVENT_IOC_RESET, 0);
+
+            if (read(m_fds[i], data, sizeof(data)) == sizeof(data))
+            {
+                m_enabled[i] = data[1];
+                m_running[i] = data[2];
+            }
+            else
+            {
+                m_enabled[i] = 0;
+                m_running[i] = 0;
+            }
+            ioctl(m_fds[i], PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+}
+
+//- Each read returns the count, followed by the times the counter was enabled and running.  A
+//  counter that never ran while enabled during the phase has no meaningful count, and is
+//  reported as zero.
+//
+inline void
+perf_counters::stop()
+{
+    m_values.m_multiplexed = false;
+
+    for (size_t i = 0;  i < counter_values::counter_count;  ++i)
+    {
+        m_values.m_values[i] = 0;
+
+        if (m_fds[i] >= 0)
+        {
+            uint64_t    data[3];    //- value, time enabled, time running
+
+            ioctl(m_fds[i], PERF_EVENT_IOC_DISABLE, 0);
+
+            if (read(m_fds[i], data, sizeof(data)) != sizeof(data))
+            {
+                continue;
+            }
+
+            uint64_t const  enabled = data[1] - m_enabled[i];
+            uint64_t const  running = data[2] - m_running[i];
+
+            if (running < enabled)
+            {
+                m_values.m_multiplexed = true;
+                m_values.m_values[i]   = (running == 0) ? 0 : (uint64_t) ((double) data[0] * enabled / running);
+            }
+            else
+            {
+                m_values.m_values[i] = data[0];
+            }
+        }
+    }
+}
+
+#else
+
+inline
+perf_counters::perf_counters()
+:   m_fds{}
+,   m_enabled{}
+,   m_running{}
+,   m_values{}
+{
+    for (int& fd : m_fds)
+    {
+        fd = -1;
+    }
+}
+
+inline
+perf_counters::~perf_counters()
+{}
+
+inline bool
+perf_counters::available(size_t) const
+{
+    return false;
+}
+
+inline void
+perf_counters::start()
+{}
+
+inline void
+perf_counters::stop()
+{}
+
+#endif
+
+//------
+//
+inline bool
+perf_counters::available() const
+{
+    for (size_t i = 0;  i < counter_values::counter_count;  ++i)
+    {
+        if (available(i)) return true;
+    }
+    return false;
+}
+
+inline counter_values const&
+perf_counters::values() const
+{
+    return m_values;
+}
+
+//- The counters shared by all of the timing tests, opened on first use.
+//
+inline perf_counters&
+bench_counters()
+{
+    static perf_counters    counters;
+    return counters;
+}
+
+#endif  //- PERF_COUNTERS_H_DEFINED
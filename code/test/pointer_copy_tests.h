@@ -116,6 +116,11 @@ do_pointer_copy_test(size_t nelem, size_t nreps)
     stopwatch   sw;
     int64_t     el_nat, el_syn;
 
+    //- Count hardware events alongside the elapsed times, where the platform permits.
+    //
+    perf_counters&  pc = bench_counters();
+    counter_values  pc_nat, pc_syn;
+
     //- Do a dummy copy and touch all the pages to minimize the effects of cache misses later.
     //
     test_copy(cbegin(random_data), cend(random_data), pnat_begin, pnat_end);
@@ -125,24 +130,30 @@ do_pointer_copy_test(size_t nelem, size_t nreps)
     //
     if (native_first)
     {
+        pc.start();
         sw.start();
         for (size_t i = 0;  i < nreps;  ++i)
         {
             test_copy(cbegin(random_data), cend(random_data), pnat_begin, pnat_end);
         }
         sw.stop();
+        pc.stop();
         el_nat = sw.elapsed_nsec();
+        pc_nat = pc.values();
 
         auto    mm1 = mismatch(cbegin(random_data), cend(random_data), pnat_begin, pnat_end);
         CHECK(mm1.first == cend(random_data));
 
+        pc.start();
         sw.start();
         for (size_t i = 0;  i < nreps;  ++i)
         {
             test_copy(cbegin(random_data), cend(random_data), psyn_begin, psyn_end);
         }
         sw.stop();
+        pc.stop();
         el_syn = sw.elapsed_nsec();
+        pc_syn = pc.values();
 
         auto    mm2 = mismatch(cbegin(random_data), cend(random_data), psyn_begin, psyn_end);
         CHECK(mm2.first == cend(random_data));
@@ -151,26 +162,32 @@ do_pointer_copy_test(size_t nelem, size_t nreps)
     }
     else    //- synthetic first
     {
+        pc.start();
         sw.start();
         for (size_t i = 0;  i < nreps;  ++i)
         {
             test_copy(cbegin(random_data), cend(random_data), psyn_begin, psyn_end);
         }
         sw.stop();
+        pc.stop();
         el_syn = sw.elapsed_nsec();
+        pc_syn = pc.values();
 
         auto    mm2 = mismatch(cbegin(random_data), cend(random_data), psyn_begin, psyn_end);
         CHECK(mm2.first == cend(random_data));
         auto    mm3 = mismatch(cbegin(random_data), cend(random_data), pnat_begin, pnat_end);
         CHECK(mm3.first == cend(random_data));
 
+        pc.start();
         sw.start();
         for (size_t i = 0;  i < nreps;  ++i)
         {
             test_copy(cbegin(random_data), cend(random_data), pnat_begin, pnat_end);
         }
         sw.stop();
+        pc.stop();
         el_nat = sw.elapsed_nsec();
+        pc_nat = pc.values();
 
         auto    mm1 = mismatch(cbegin(random_data), cend(random_data), pnat_begin, pnat_end);
         CHECK(mm1.first == cend(random_data));
@@ -180,74 +197,209 @@ do_pointer_copy_test(size_t nelem, size_t nreps)
     heap.reset_buffers();
     native_first = !native_first;
 
-    return timing_pair{el_nat, el_syn};
+    return timing_pair{el_nat, el_syn, pc_nat, pc_syn};
 }
 
 //--------------------------------------------------------------------------------------------------
 //  Function:
-//      run_pointer_copy_test<AS,DT>
+//      do_segmented_copy_test<AS,DT>
 //
 //  Summary:
-//      This function template manages the process of calling do_pointer_copy_test() multiple
-//      times, accumulating the timings, and reporting the results.
+//      This function template measures the time it takes to copy elements from a source vector
+//      to a destination too large for a single segment.  The destination is a segmented_vector,
+//      each of whose chunks fills a segment of its own, and for_each_segment() presents it as
+//      one contiguous range per chunk.  The native copy fills the chunks in turn through native
+//      pointers.  The synthetic copy fills them in turn through synthetic pointers, as
+//      do_pointer_copy_test() fills its single array, or, when spanning, copies the whole range
+//      through the vector's iterators, which cross the segment boundaries by way of the chunk
+//      table's synthetic pointers.
 //--------------------------------------------------------------------------------------------------
 //
 template<typename AllocStrategy, typename DataType>
-void
-run_pointer_copy_tests(char const* stype, char const* dtype)
+timing_pair
+do_segmented_copy_test(size_t nelem, size_t nreps, bool spanning)
 {
-    std::ios    old_state(nullptr);
-    old_state.copyfmt(std::cout);
+    using syn_ptr_data = typename AllocStrategy::template rebind_pointer<DataType>;
+    using syn_vector   = segmented_vector<DataType, AllocStrategy>;
+    using nat_range    = pair<DataType*, DataType*>;
+    using syn_range    = pair<syn_ptr_data, syn_ptr_data>;
 
-    size_t const    stat_repeats = 16;      //- Times to repeat the test.
-    size_t const    stat_rejects = 6;       //- Measurements to drop; highest & lowest.
+    vector<DataType>    random_data(generate_test_data<DataType>(nelem));
 
-    //- Time the copy operation for variously-sized arrays.
+    //- Copies the source data into each part of the destination in turn, and then checks the
+    //  parts against the source.
     //
-    for (size_t i = 0;  i < max_element_index();  ++i)
+    auto    copy_parts = [&random_data](auto const& parts)
+    {
+        auto    src = cbegin(random_data);
+
+        for (auto const& part : parts)
+        {
+            auto    n = part.second - part.first;
+
+            test_copy(src, src + n, part.first, part.second);
+            src += n;
+        }
+    };
+    auto    check_parts = [&random_data](auto const& parts)
     {
-        size_t          nelem    = elem_counts[i];
-        size_t          run_reps = max((size_t)1, (size_t)(10'000'000/nelem));
-        timing_pair     timing;
-        timing_vector   timings;
+        auto    src = cbegin(random_data);
 
-        for (size_t j = 0;  j < stat_repeats;  ++j)
+        for (auto const& part : parts)
         {
-            timing = do_pointer_copy_test<AllocStrategy, DataType>(nelem, run_reps);
-            timings.push_back(timing);
+            auto    n = part.second - part.first;
+
+            CHECK(equal(part.first, part.second, src));
+            src += n;
         }
+    };
 
-        //- Sort the timings vector so we can reject highest/lowest timings.
+    static bool native_first = true;
+    stopwatch       sw;
+    int64_t         el_nat = 0;
+    int64_t         el_syn = 0;
+    perf_counters&  pc = bench_counters();
+    counter_values  pc_nat, pc_syn;
+
+    {
+        syn_vector          dst;
+        vector<nat_range>   nat_parts;
+        vector<syn_range>   syn_parts;
+
+        //- Size the destination, and record the native and synthetic bounds of each chunk.
         //
-        sort(begin(timings), end(timings));
+        dst.resize(nelem);
+        for_each_segment(dst.begin(), dst.end(), [&](DataType* first, DataType* last)
+        {
+            syn_ptr_data    psyn(first);
+
+            nat_parts.emplace_back(first, last);
+            syn_parts.emplace_back(psyn, psyn + (last - first));
+        });
 
-        //- Compute the synthetic-to-natural ratio, dropping outliers.
+        //- Do a dummy copy to touch all the pages, and then time the two kinds of copy, in
+        //  alternating order across calls.
         //
-        double      ratio;
-        int64_t     el_nat_total = 0;
-        int64_t     el_syn_total = 0;
+        copy_parts(nat_parts);
 
-        for (size_t j = 0;  j < timings.size();  ++j)
+        for (int pass = 0;  pass < 2;  ++pass)
         {
-            el_nat_total += timings[j].m_el_nat;
-            el_syn_total += timings[j].m_el_syn;
+            bool    native = ((pass == 0) == native_first);
+
+            pc.start();
+            sw.start();
+            for (size_t i = 0;  i < nreps;  ++i)
+            {
+                if (native)
+                    copy_parts(nat_parts);
+                else if (spanning)
+                    test_copy(cbegin(random_data), cend(random_data), dst.begin(), dst.end());
+                else
+                    copy_parts(syn_parts);
+            }
+            sw.stop();
+            pc.stop();
+
+            if (native)
+            {
+                el_nat = sw.elapsed_nsec();
+                pc_nat = pc.values();
+                check_parts(nat_parts);
+            }
+            else
+            {
+                el_syn = sw.elapsed_nsec();
+                pc_syn = pc.values();
+                check_parts(syn_parts);
+                CHECK(equal(dst.cbegin(), dst.cend(), cbegin(random_data)));
+            }
         }
+    }
 
-        el_nat_total = 0;
-        el_syn_total = 0;
+    AllocStrategy::reset_buffers();
+    native_first = !native_first;
 
-        for (size_t j = (stat_rejects/2);  j < (timings.size() - stat_rejects);  ++j)
+    return timing_pair{el_nat, el_syn, pc_nat, pc_syn};
+}
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      run_pointer_copy_test<AS,DT>
+//
+//  Summary:
+//      This function template manages the process of calling do_pointer_copy_test() for one
+//      element count until its timings are sufficiently precise, and reporting the results.
+//      Element counts too large for a single segment are timed by do_segmented_copy_test()
+//      instead, and are reported as n/a if they do not fit in the heap at all.  For those, the
+//      copy across segment boundaries through the vector's iterators is also reported, as
+//      copy_span.
+//--------------------------------------------------------------------------------------------------
+//
+template<typename AllocStrategy, typename DataType>
+void
+run_pointer_copy_test(char const* stype, char const* dtype, size_t nelem)
+{
+    bool const      segmented = !fits_in_segment<AllocStrategy, DataType>(nelem);
+    size_t          run_reps  = max((size_t)1, (size_t)(10'000'000/nelem));
+    timing_vector   samples;
+    timing_summary  summary;
+
+    try
+    {
+        samples = collect_timings([=]()
+        {
+            return segmented ? do_segmented_copy_test<AllocStrategy, DataType>(nelem, run_reps, false)
+                             : do_pointer_copy_test<AllocStrategy, DataType>(nelem, run_reps);
+        });
+    }
+    catch (std::bad_alloc&)
+    {
+        AllocStrategy::reset_buffers();
+        print_unavailable("copy", stype, dtype, nelem);
+        return;
+    }
+    summary = summarize_timings(samples);
+
+    print_timings("copy", stype, dtype, nelem, summary);
+    report_timings("copy", stype, dtype, nelem, run_reps, samples, summary);
+
+    if (segmented)
+    {
+        try
+        {
+            samples = collect_timings([=]()
+            {
+                return do_segmented_copy_test<AllocStrategy, DataType>(nelem, run_reps, true);
+            });
+        }
+        catch (std::bad_alloc&)
         {
-            el_nat_total += timings[j].m_el_nat;
-            el_syn_total += timings[j].m_el_syn;
+            AllocStrategy::reset_buffers();
+            print_unavailable("copy_span", stype, dtype, nelem);
+            return;
         }
+        summary = summarize_timings(samples);
 
-        ratio = (double) el_syn_total / (double) el_nat_total;
+        print_timings("copy_span", stype, dtype, nelem, summary);
+        report_timings("copy_span", stype, dtype, nelem, run_reps, samples, summary);
+    }
+}
 
-        cout << "copy, " << stype << ", " << dtype << ", "
-             << showpoint << setw(7) << setprecision((ratio >= 1.0) ? 5 : 4) << ratio << ", "
-             << nelem << endl;
-        cout.copyfmt(old_state);
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      run_pointer_copy_tests<AS,DT>
+//
+//  Summary:
+//      This function template times the copy operation for variously-sized arrays.
+//--------------------------------------------------------------------------------------------------
+//
+template<typename AllocStrategy, typename DataType>
+void
+run_pointer_copy_tests(char const* stype, char const* dtype)
+{
+    for (size_t i = 0;  i < max_element_index();  ++i)
+    {
+        run_pointer_copy_test<AllocStrategy, DataType>(stype, dtype, elem_counts[i]);
     }
     cout << endl;
 }
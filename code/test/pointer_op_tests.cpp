@@ -0,0 +1,20 @@
+//==================================================================================================
+//  File:
+//      pointer_op_tests.cpp
+//
+//  Copyright (c) 2017 Bob Steagall, KEWB Computing
+//==================================================================================================
+//
+#include "pointer_op_tests.h"
+
+#define RUN_POINTER_OP_TESTS(ST)    run_pointer_op_tests<ST>(#ST)
+
+void
+run_pointer_op_tests()
+{
+    RUN_POINTER_OP_TESTS(wrapper_strategy);
+    RUN_POINTER_OP_TESTS(based_2dxl_strategy);
+    RUN_POINTER_OP_TESTS(based_2d_strategy);
+    RUN_POINTER_OP_TESTS(based_1d_strategy);
+    RUN_POINTER_OP_TESTS(offset_strategy);
+}
@@ -0,0 +1,288 @@
+//==================================================================================================
+//  File:
+//      pointer_op_tests.h
+//
+//  Copyright (c) 2017 Bob Steagall, KEWB Computing
+//==================================================================================================
+//
+#ifndef POINTER_OP_TESTS_H_DEFINED
+#define POINTER_OP_TESTS_H_DEFINED
+
+#include "pointer_tests.h"
+
+//- The individual pointer operations that are timed.
+//
+enum class pointer_op
+{
+    deref,          //- Read the element a pointer addresses
+    increment,      //- Advance a pointer by one element
+    difference,     //- Subtract two pointers
+    compare,        //- Order two pointers with operator <
+    to_raw,         //- Convert to a native pointer
+    assign_from,    //- Assign from a native pointer
+    copy            //- Copy-assign one pointer object to another
+};
+
+inline char const*
+pointer_op_name(pointer_op op)
+{
+    switch (op)
+    {
+        case pointer_op::deref:         return "deref";
+        case pointer_op::increment:     return "increment";
+        case pointer_op::difference:    return "difference";
+        case pointer_op::compare:       return "compare";
+        case pointer_op::to_raw:        return "to_raw";
+        case pointer_op::assign_from:   return "assign_from";
+        default:                        return "copy";
+    }
+}
+
+//- The number of pointers in the working set of each test, and the number of operations timed
+//  in each sample.  The working set is small enough to stay in the L1 cache, so that the tests
+//  measure the cost of the operations rather than that of the memory they touch.
+//
+size_t const    ptr_op_set_size   = 1024;
+size_t const    ptr_op_per_sample = 1u << 20;
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      time_pointer_op<P>
+//
+//  Summary:
+//      This function template times a pointer operation, applied nreps times to each of the
+//      pointers in an array.  P is either a native or a synthetic pointer to uint64_t; the raw
+//      pointers give the addresses held by the array, and are the source for assign_from.  The
+//      copies array is the destination for copy.  Every result passes through do_not_optimize(),
+//      so the compiler can neither hoist the operations out of the loop nor discard them.
+//--------------------------------------------------------------------------------------------------
+//
+template<typename P>
+int64_t
+time_pointer_op(pointer_op op, P* ptrs, P* copies, uint64_t* const* raws, size_t nreps,
+                counter_values& pcv)
+{
+    size_t const    mask = ptr_op_set_size - 1;
+    perf_counters&  pc   = bench_counters();
+    stopwatch       sw;
+
+    pc.start();
+    sw.start();
+    for (size_t r = 0;  r < nreps;  ++r)
+    {
+        switch (op)
+        {
+          case pointer_op::deref:
+            for (size_t i = 0;  i < ptr_op_set_size;  ++i)
+            {
+                do_not_optimize_load(*ptrs[i]);
+            }
+            break;
+
+          case pointer_op::increment:
+            {
+                P   p = ptrs[0];
+
+                for (size_t i = 0;  i < ptr_op_set_size;  ++i)
+                {
+                    ++p;
+                    do_not_optimize(p);
+                }
+            }
+            break;
+
+          case pointer_op::difference:
+            for (size_t i = 0;  i < ptr_op_set_size;  ++i)
+            {
+                do_not_optimize(ptrs[(i + 1) & mask] - ptrs[i]);
+            }
+            break;
+
+          case pointer_op::compare:
+            for (size_t i = 0;  i < ptr_op_set_size;  ++i)
+            {
+                do_not_optimize(ptrs[i] < ptrs[(i + 1) & mask]);
+            }
+            break;
+
+          case pointer_op::to_raw:
+            for (size_t i = 0;  i < ptr_op_set_size;  ++i)
+            {
+                uint64_t*   p = ptrs[i];
+                do_not_optimize(p);
+            }
+            break;
+
+          case pointer_op::assign_from:
+            for (size_t i = 0;  i < ptr_op_set_size;  ++i)
+            {
+                ptrs[i] = raws[i];
+                clobber_memory();
+            }
+            break;
+
+          case pointer_op::copy:
+            for (size_t i = 0;  i < ptr_op_set_size;  ++i)
+            {
+                copies[i] = ptrs[i];
+                clobber_memory();
+            }
+            break;
+        }
+    }
+    sw.stop();
+    pc.stop();
+
+    pcv = pc.values();
+    return sw.elapsed_nsec();
+}
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      do_pointer_op_test<AS>
+//
+//  Summary:
+//      This function template measures one pointer operation using native pointers and using
+//      the strategy's synthetic pointers, alternating which goes first.  The synthetic pointer
+//      objects, like the data they address, are placed in the strategy's heap, as they would be
+//      inside a relocatable data structure.  The heap is rolled back to where it started when
+//      the test is done.
+//--------------------------------------------------------------------------------------------------
+//
+template<typename AllocStrategy>
+timing_pair
+do_pointer_op_test(pointer_op op, size_t nreps)
+{
+    using syn_ptr_data = typename AllocStrategy::template rebind_pointer<uint64_t>;
+    using syn_ptr_ptr  = typename AllocStrategy::template rebind_pointer<syn_ptr_data>;
+
+    static bool     native_first = true;
+    AllocStrategy   heap;
+    timing_pair     tp;
+    auto            start = AllocStrategy::mark();
+
+    //- Allocate the data, and two arrays of synthetic pointers to it, from the heap.  The native
+    //  pointers address the same data, but live in ordinary memory.
+    //
+    syn_ptr_data    data   = static_cast<syn_ptr_data>(heap.allocate(ptr_op_set_size*sizeof(uint64_t)));
+    syn_ptr_ptr     sptrs  = static_cast<syn_ptr_ptr>(heap.allocate(ptr_op_set_size*sizeof(syn_ptr_data)));
+    syn_ptr_ptr     scopy  = static_cast<syn_ptr_ptr>(heap.allocate(ptr_op_set_size*sizeof(syn_ptr_data)));
+    uint64_t*       pdata  = data;
+
+    vector<uint64_t*>   nptrs(ptr_op_set_size);
+    vector<uint64_t*>   ncopy(ptr_op_set_size);
+
+    for (size_t i = 0;  i < ptr_op_set_size;  ++i)
+    {
+        pdata[i] = i;
+        nptrs[i] = pdata + i;
+        new (addressof(sptrs[i])) syn_ptr_data(data + i);
+        new (addressof(scopy[i])) syn_ptr_data();
+    }
+
+    syn_ptr_data*   psptrs = sptrs;
+    syn_ptr_data*   pscopy = scopy;
+
+    if (native_first)
+    {
+        tp.m_el_nat = time_pointer_op(op, nptrs.data(), ncopy.data(), nptrs.data(), nreps, tp.m_pc_nat);
+        tp.m_el_syn = time_pointer_op(op, psptrs, pscopy, nptrs.data(), nreps, tp.m_pc_syn);
+    }
+    else
+    {
+        tp.m_el_syn = time_pointer_op(op, psptrs, pscopy, nptrs.data(), nreps, tp.m_pc_syn);
+        tp.m_el_nat = time_pointer_op(op, nptrs.data(), ncopy.data(), nptrs.data(), nreps, tp.m_pc_nat);
+    }
+
+    //- Make sure the synthetic pointers still address the data after assign_from and copy.
+    //
+    for (size_t i = 0;  i < ptr_op_set_size;  ++i)
+    {
+        CHECK(*psptrs[i] == i);
+        CHECK(op != pointer_op::copy  ||  pscopy[i] == psptrs[i]);
+    }
+
+    AllocStrategy::rollback(start);
+    native_first = !native_first;
+
+    return tp;
+}
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      print_pointer_op_timings
+//
+//  Summary:
+//      Prints the per-operation costs for one pointer operation: nanoseconds per operation for
+//      native and synthetic pointers, the corresponding cycles per operation, and the ratio.
+//      Cycles come from the hardware cycle counter when it is available, and are otherwise
+//      converted from wall time using the time-stamp counter rate; the last column says which.
+//--------------------------------------------------------------------------------------------------
+//
+inline void
+print_pointer_op_timings(char const* op, char const* stype, timing_summary const& summary)
+{
+    std::ios    old_state(nullptr);
+    old_state.copyfmt(cout);
+
+    double const    nops    = (double) ptr_op_per_sample;
+    double const    ns_nat  = (double) summary.m_el_nat_median / nops;
+    double const    ns_syn  = (double) summary.m_el_syn_median / nops;
+    bool const      have_pc = bench_counters().available(counter_values::cycles);
+    double const    tpns    = tsc_ticks_per_nsec();
+    double          cy_nat  = ns_nat * tpns;
+    double          cy_syn  = ns_syn * tpns;
+
+    if (have_pc)
+    {
+        cy_nat = (double) summary.m_pc_nat_median.m_values[counter_values::cycles] / nops;
+        cy_syn = (double) summary.m_pc_syn_median.m_values[counter_values::cycles] / nops;
+    }
+
+    cout << "ptrop, " << op << ", " << stype << ", " << fixed << setprecision(3)
+         << ns_nat << ", " << ns_syn << ", " << cy_nat << ", " << cy_syn << ", "
+         << setprecision(4) << summary.m_ratio << ", " << summary.m_samples << ", "
+         << (have_pc ? "pmu" : (tpns > 0.0) ? "tsc" : "none") << endl;
+
+    cout.copyfmt(old_state);
+}
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      run_pointer_op_tests<AS>
+//
+//  Summary:
+//      This function template times each of the pointer operations for one strategy's
+//      addressing model, and reports the per-operation costs.
+//--------------------------------------------------------------------------------------------------
+//
+template<typename AllocStrategy>
+void
+run_pointer_op_tests(char const* stype)
+{
+    pointer_op const    ops[] = { pointer_op::deref,   pointer_op::increment,
+                                  pointer_op::difference, pointer_op::compare,
+                                  pointer_op::to_raw,  pointer_op::assign_from,
+                                  pointer_op::copy };
+    size_t const        nreps = ptr_op_per_sample / ptr_op_set_size;
+
+    AllocStrategy::reset_buffers();
+
+    for (pointer_op op : ops)
+    {
+        timing_vector   samples;
+        timing_summary  summary;
+
+        samples = collect_timings([=]()
+        {
+            return do_pointer_op_test<AllocStrategy>(op, nreps);
+        });
+        summary = summarize_timings(samples);
+
+        print_pointer_op_timings(pointer_op_name(op), stype, summary);
+        report_timings(pointer_op_name(op), stype, "uint64_t", ptr_op_per_sample, nreps, samples, summary);
+    }
+    cout << endl;
+}
+
+#endif  //- POINTER_OP_TESTS_H_DEFINED
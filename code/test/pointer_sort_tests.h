@@ -59,6 +59,11 @@ do_pointer_sort_test(size_t nelem)
     stopwatch   sw;
     int64_t     el_nat, el_syn;
 
+    //- Count hardware events alongside the elapsed times, where the platform permits.
+    //
+    perf_counters&  pc = bench_counters();
+    counter_values  pc_nat, pc_syn;
+
     //- We're going to alternate between native operations first and synthetic operations first
     //  in order to avoid any bias in the average due to the order.
     //
@@ -72,10 +77,13 @@ do_pointer_sort_test(size_t nelem)
 
         //- Sort the buffer using native pointers as iterators.
         //
+        pc.start();
         sw.start();
         sort(pnat_begin, pnat_end);
         sw.stop();
+        pc.stop();
         el_nat = sw.elapsed_nsec();
+        pc_nat = pc.values();
 
         //- Verify that the newly-sorted buffer matches the sorted reference vector.
         //
@@ -93,10 +101,13 @@ do_pointer_sort_test(size_t nelem)
 
         //- Sort the buffer using synthetic pointers as iterators.
         //
+        pc.start();
         sw.start();
         sort(psyn_begin, psyn_end);
         sw.stop();
+        pc.stop();
         el_syn = sw.elapsed_nsec();
+        pc_syn = pc.values();
 
         //- Verify that the newly-sorted buffer matches the sorted reference vector.
         //
@@ -118,10 +129,13 @@ do_pointer_sort_test(size_t nelem)
 
         //- Sort the buffer using synthetic pointers as iterators.
         //
+        pc.start();
         sw.start();
         sort(psyn_begin, psyn_end);
         sw.stop();
+        pc.stop();
         el_syn = sw.elapsed_nsec();
+        pc_syn = pc.values();
 
         //- Verify that the newly-sorted buffer matches the sorted reference vector.
         //
@@ -138,10 +152,13 @@ do_pointer_sort_test(size_t nelem)
 
         //- Sort the buffer using native pointers as iterators.
         //
+        pc.start();
         sw.start();
         sort(pnat_begin, pnat_end);
         sw.stop();
+        pc.stop();
         el_nat = sw.elapsed_nsec();
+        pc_nat = pc.values();
 
         //- Verify that the newly-sorted buffer matches the sorted reference vector.
         //
@@ -153,7 +170,7 @@ do_pointer_sort_test(size_t nelem)
     heap.reset_buffers();
     native_first = !native_first;
 
-    return timing_pair{el_nat, el_syn};
+    return timing_pair{el_nat, el_syn, pc_nat, pc_syn};
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -161,65 +178,49 @@ do_pointer_sort_test(size_t nelem)
 //      run_pointer_sort_test<AS,DT>
 //
 //  Summary:
-//      This function template manages the process of calling do_pointer_sort_test() multiple
-//      times, accumulating the timings, and reporting the results.
+//      This function template manages the process of calling do_pointer_sort_test() for one
+//      element count until its timings are sufficiently precise, and reporting the results.
+//      Element counts too large for a single segment are reported as n/a.
 //--------------------------------------------------------------------------------------------------
 //
 template<typename AllocStrategy, typename DataType>
 void
-run_pointer_sort_tests(char const* stype, char const* dtype)
+run_pointer_sort_test(char const* stype, char const* dtype, size_t nelem)
 {
-    std::ios    old_state(nullptr);
-    old_state.copyfmt(std::cout);
+    if (!fits_in_segment<AllocStrategy, DataType>(nelem))
+    {
+        print_unavailable("sort", stype, dtype, nelem);
+        return;
+    }
 
-    size_t const    stat_repeats = 16;      //- Times to repeat the test.
-    size_t const    stat_rejects = 6;       //- Measurements to drop; highest & lowest.
+    timing_vector   samples;
+    timing_summary  summary;
 
-    //- Time the sort operation for variously-sized arrays.
-    //
-    for (size_t i = 0;  i < max_element_index();  ++i)
+    samples = collect_timings([=]()
     {
-        size_t          nelem = elem_counts[i];
-        timing_pair     timing;
-        timing_vector   timings;
-
-        for (size_t j = 0;  j < stat_repeats;  ++j)
-        {
-            timing = do_pointer_sort_test<AllocStrategy, DataType>(nelem);
-            timings.push_back(timing);
-        }
+        return do_pointer_sort_test<AllocStrategy, DataType>(nelem);
+    });
+    summary = summarize_timings(samples);
 
-        //- Sort the timings vector so we can reject highest/lowest timings.
-        //
-        sort(begin(timings), end(timings));
+    print_timings("sort", stype, dtype, nelem, summary);
+    report_timings("sort", stype, dtype, nelem, 1, samples, summary);
+}
 
-        //- Compute the synthetic-to-natural ratio, dropping outliers.
-        //
-        double      ratio;
-        int64_t     el_nat_total = 0;
-        int64_t     el_syn_total = 0;
-
-        for (size_t j = 0;  j < timings.size();  ++j)
-        {
-            el_nat_total += timings[j].m_el_nat;
-            el_syn_total += timings[j].m_el_syn;
-        }
-
-        el_nat_total = 0;
-        el_syn_total = 0;
-
-        for (size_t j = (stat_rejects/2);  j < (timings.size() - stat_rejects);  ++j)
-        {
-            el_nat_total += timings[j].m_el_nat;
-            el_syn_total += timings[j].m_el_syn;
-        }
-
-        ratio = (double) el_syn_total / (double) el_nat_total;
-
-        cout << "sort, " << stype << ", " << dtype << ", "
-             << showpoint << setw(7) << setprecision((ratio >= 1.0) ? 5 : 4) << ratio << ", "
-             << nelem << endl;
-        cout.copyfmt(old_state);
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      run_pointer_sort_tests<AS,DT>
+//
+//  Summary:
+//      This function template times the sort operation for variously-sized arrays.
+//--------------------------------------------------------------------------------------------------
+//
+template<typename AllocStrategy, typename DataType>
+void
+run_pointer_sort_tests(char const* stype, char const* dtype)
+{
+    for (size_t i = 0;  i < max_element_index();  ++i)
+    {
+        run_pointer_sort_test<AllocStrategy, DataType>(stype, dtype, elem_counts[i]);
     }
     cout << endl;
 }
@@ -6,6 +6,7 @@
 //==================================================================================================
 //
 #include "pointer_tests.h"
+#include "bench_registry.h"
 #include "pointer_cast_tests.h"
 #include "pointer_copy_tests.h"
 #include "pointer_sort_tests.h"
@@ -47,6 +48,55 @@ extra_test_2()
 #define RUN_SORT_TESTS(ST, DT)          run_pointer_sort_tests<ST,DT>(#ST, #DT)
 #define RUN_STABLE_SORT_TESTS(ST, DT)   run_pointer_stable_sort_tests<ST,DT>(#ST, #DT)
 
+#define REGISTER_BENCHES(OP, ST)            \
+    REGISTER_BENCH(OP, ST, uint32_t);       \
+    REGISTER_BENCH(OP, ST, uint64_t);       \
+    REGISTER_BENCH(OP, ST, string);         \
+    REGISTER_BENCH(OP, ST, test_struct)
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      register_pointer_benches
+//
+//  Summary:
+//      Registers the copy, sort, and stable sort timing tests with the benchmark driver, for the
+//      same strategies and data types as run_pointer_tests().
+//--------------------------------------------------------------------------------------------------
+//
+void
+register_pointer_benches()
+{
+    REGISTER_BENCHES(copy, wrapper_strategy);
+    REGISTER_BENCHES(copy, based_2dxl_strategy);
+    REGISTER_BENCHES(copy, based_2d_strategy);
+    REGISTER_BENCHES(copy, based_1d_strategy);
+    REGISTER_BENCHES(copy, offset_strategy);
+
+    REGISTER_BENCHES(sort, wrapper_strategy);
+    REGISTER_BENCHES(sort, based_2dxl_strategy);
+    REGISTER_BENCHES(sort, based_2d_strategy);
+    REGISTER_BENCHES(sort, based_1d_strategy);
+#ifndef POSSIBLE_GCC6_CODEGEN_BUG
+    REGISTER_BENCH(sort, offset_strategy, uint32_t);
+#endif
+    REGISTER_BENCH(sort, offset_strategy, uint64_t);
+    REGISTER_BENCH(sort, offset_strategy, string);
+#ifndef POSSIBLE_GCC5_CODEGEN_BUG
+    REGISTER_BENCH(sort, offset_strategy, test_struct);
+#endif
+
+    REGISTER_BENCHES(stable_sort, wrapper_strategy);
+    REGISTER_BENCHES(stable_sort, based_2dxl_strategy);
+    REGISTER_BENCHES(stable_sort, based_2d_strategy);
+    REGISTER_BENCHES(stable_sort, based_1d_strategy);
+    REGISTER_BENCH(stable_sort, offset_strategy, uint32_t);
+    REGISTER_BENCH(stable_sort, offset_strategy, uint64_t);
+    REGISTER_BENCH(stable_sort, offset_strategy, string);
+#ifndef POSSIBLE_GCC5_CODEGEN_BUG
+    REGISTER_BENCH(stable_sort, offset_strategy, test_struct);
+#endif
+}
+
 #if 1
 void
 run_pointer_tests()
@@ -9,6 +9,7 @@
 #define POINTER_TESTS_H_DEFINED
 
 #include "common.h"
+#include "bench_runner.h"
 
 #if defined(COMPILER_GCC) && defined(__OPTIMIZE__) && (__GNUC__ == 5)
     #define POSSIBLE_GCC5_CODEGEN_BUG
@@ -24,7 +25,9 @@ namespace
                                       1000u, 2000u, 5000u,
                                       10000u, 20000u, 50000u,
                                       100000u, 200000u, 500000u,
-                                      1000000u };
+                                      1000000u, 2000000u, 5000000u,
+                                      10000000u, 20000000u, 50000000u,
+                                      100000000u };
 }
 
 inline size_t
@@ -33,4 +36,16 @@ max_element_index()
     return min(array_size(elem_counts), max_ptr_op_count_index());
 }
 
+//- Returns true if an array of the given number of elements can be allocated as a single chunk.
+//  No strategy lets a chunk span segments.  The sort timing tests operate on one contiguous
+//  range, so they report larger arrays as n/a; the copy timing test copies larger arrays into a
+//  segmented_vector, one segment at a time.
+//
+template<typename AllocStrategy, typename DataType>
+bool
+fits_in_segment(size_t nelem)
+{
+    return nelem <= AllocStrategy().max_size() / sizeof(DataType);
+}
+
 #endif  //- POINTER_TESTS_H_DEFINED
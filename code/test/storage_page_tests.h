@@ -0,0 +1,107 @@
+//==================================================================================================
+//  File:
+//      storage_page_tests.h
+//
+//  Copyright (c) 2017 Bob Steagall, KEWB Computing
+//==================================================================================================
+//
+#ifndef STORAGE_PAGE_TESTS_H_DEFINED
+#define STORAGE_PAGE_TESTS_H_DEFINED
+
+#include "strategy_tests.h"
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      do_page_mode_tests<AS>
+//
+//  Summary:
+//      This function template verifies that segments can be created with each page mode, that
+//      unavailable page sizes fall back to smaller ones, and that containers work normally in
+//      segments backed by huge pages.
+//--------------------------------------------------------------------------------------------------
+//
+template<typename AllocStrategy>
+void
+do_page_mode_tests(storage_model_base::page_mode mode)
+{
+    using page_mode       = storage_model_base::page_mode;
+    using strategy        = AllocStrategy;
+    using storage_model   = typename strategy::storage_model;
+    using syn_data_vector = vector<test_struct, rhx_allocator<test_struct, strategy>>;
+    using size_type       = typename storage_model::size_type;
+
+    size_type const     first = storage_model::first_segment_index();
+    size_type const     last  = storage_model::last_segment_index();
+
+    storage_model_base::set_page_mode(mode);
+    rebuild_segments();
+    CHECK(storage_model::requested_page_mode() == mode);
+
+    //- Each segment obtains the requested mode or a smaller one, and is suitably aligned.
+    //
+    for (size_type i = first;  i <= last;  ++i)
+    {
+        page_mode   obtained = storage_model::segment_page_mode(i);
+        uintptr_t   addr     = reinterpret_cast<uintptr_t>(storage_model::segment_address(i));
+
+        CHECK(static_cast<int>(obtained) <= static_cast<int>(mode));
+        CHECK(addr % storage_model::segment_alignment == 0);
+        if (obtained != page_mode::normal)
+        {
+            CHECK(addr % (1u << 21) == 0);
+        }
+
+        if (verbose_output())
+        {
+            printf("  segment %d: requested %s, obtained %s\n", (int) i,
+                   storage_model::page_mode_name(mode), storage_model::page_mode_name(obtained));
+        }
+    }
+
+    //- Containers behave normally, and the page modes follow their buffers when swapped.
+    //
+    syn_data_vector     sv;
+    page_mode           before = storage_model::segment_page_mode(first);
+
+    for (size_t i = 0;  i < 1000;  ++i)
+    {
+        sv.push_back(generate_test_struct());
+    }
+    CHECK(sv.size() == 1000u);
+
+    storage_model::swap_buffers();
+    storage_model::swap_buffers();
+    CHECK(storage_model::segment_page_mode(first) == before);
+    CHECK(sv.size() == 1000u);
+}
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      run_page_mode_tests<AS>
+//
+//  Summary:
+//      This function template manages the sequence of actual page mode test function calls,
+//      restoring the originally requested page mode when done.
+//--------------------------------------------------------------------------------------------------
+//
+template<typename AllocStrategy>
+void
+run_page_mode_tests(char const* stype)
+{
+    using page_mode = storage_model_base::page_mode;
+
+    page_mode   orig_mode = storage_model_base::requested_page_mode();
+
+    cout << "================================================================" << endl;
+    cout << "Running page mode tests for " << stype << endl << endl;
+
+    do_page_mode_tests<AllocStrategy>(page_mode::transparent);
+    do_page_mode_tests<AllocStrategy>(page_mode::huge_2mb);
+    do_page_mode_tests<AllocStrategy>(page_mode::huge_1gb);
+
+    storage_model_base::set_page_mode(orig_mode);
+    rebuild_segments();
+    cout << endl;
+}
+
+#endif  //- STORAGE_PAGE_TESTS_H_DEFINED
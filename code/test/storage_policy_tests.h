@@ -0,0 +1,283 @@
+//==================================================================================================
+//  File:
+//      storage_policy_tests.h
+//
+//  Copyright (c) 2017 Bob Steagall, KEWB Computing
+//==================================================================================================
+//
+#ifndef STORAGE_POLICY_TESTS_H_DEFINED
+#define STORAGE_POLICY_TESTS_H_DEFINED
+
+#include "strategy_tests.h"
+
+//- Storage models composed from each segment provider.  The last two differ only in their tags,
+//  and so are separate heaps.
+//
+struct second_heap_tag {};
+
+using heap_2d_storage_model      = policy_storage_model<heap_segment_provider, based_2d_addressing_model>;
+using mmap_2d_storage_model      = policy_storage_model<mmap_segment_provider, based_2d_addressing_model>;
+using shm_2dxl_storage_model     = policy_storage_model<shm_segment_provider, based_2dxl_addressing_model>;
+using file_1d_storage_model      = policy_storage_model<file_segment_provider, based_1d_addressing_model>;
+using mmap_offset_storage_model  = policy_storage_model<mmap_segment_provider, offset_addressing_policy>;
+using mmap_offset2_storage_model = policy_storage_model<mmap_segment_provider, offset_addressing_policy, second_heap_tag>;
+
+using heap_2d_policy_strategy      = leaky_allocation_strategy<heap_2d_storage_model>;
+using mmap_2d_policy_slab_strategy = slab_allocation_strategy<mmap_2d_storage_model>;
+using shm_2dxl_policy_strategy     = leaky_allocation_strategy<shm_2dxl_storage_model>;
+using file_1d_policy_strategy      = leaky_allocation_strategy<file_1d_storage_model>;
+using mmap_offset_policy_strategy  = leaky_allocation_strategy<mmap_offset_storage_model>;
+using mmap_offset2_policy_strategy = slab_allocation_strategy<mmap_offset2_storage_model>;
+
+//- Returns true if every byte of a range is zero.
+//
+inline bool
+all_zero(char const* p, size_t n)
+{
+    return std::all_of(p, p + n, [](char c) { return c == 0; });
+}
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      do_policy_storage_tests<AS1, AS2>
+//
+//  Summary:
+//      This function template builds containers in two policy-based storage models, and then
+//      verifies that the models' segments are disjoint from each other and from those of
+//      storage_model_base, and that swapping, resetting, and clearing one model's segments
+//      leaves the other's containers, and the global segments, untouched.
+//--------------------------------------------------------------------------------------------------
+//
+template<typename AllocStrategy1, typename AllocStrategy2>
+void
+do_policy_storage_tests()
+{
+    using sm1_type       = typename AllocStrategy1::storage_model;
+    using sm2_type       = typename AllocStrategy2::storage_model;
+    using char_pointer   = syn_ptr<char, typename sm1_type::addressing_model>;
+    using syn_vector     = vector<test_struct, rhx_allocator<test_struct, AllocStrategy1>>;
+    using syn_list       = list<test_struct, rhx_allocator<test_struct, AllocStrategy2>>;
+
+    size_t const    first = sm1_type::first_segment_index();
+    char* const     global_base = storage_model_base::segment_address(first);
+
+    //- The models' names identify their addressing models and segment providers.
+    //
+    CHECK(strchr(sm1_type::model_name(), ':') != nullptr);
+
+    //- Pointers made from a segment and offset refer to that location.
+    //
+    sm1_type::init_segments();
+    CHECK(static_cast<char*>(char_pointer(sm1_type::segment_pointer(first, 128))) ==
+          sm1_type::segment_address(first) + 128);
+
+    //- Newly created segments are aligned and zero-filled.  A model limited to one segment
+    //  refuses to create a second, so its freshly reset first segment is checked instead.
+    //
+    size_t const    seg = (sm2_type::max_segment_count() > 1) ? first + 1 : first;
+
+    sm2_type::init_segments();
+    CHECK(sm2_type::ensure_segment(first + 1) == (seg != first));
+
+    char const*     pseg = sm2_type::segment_address(seg);
+    size_t          size = sm2_type::segment_size(seg);
+
+    CHECK(reinterpret_cast<uintptr_t>(pseg) % sm2_type::segment_alignment == 0);
+    CHECK(size == sm2_type::max_segment_size());
+    CHECK(all_zero(pseg, 8192)  &&  all_zero(pseg + size - 8192, 8192));
+
+    //- Containers in each model lie only within that model's segments.
+    //
+    auto    p_vec = allocate<syn_vector, AllocStrategy1>();
+    auto    p_lst = allocate<syn_list, AllocStrategy2>();
+
+    vector<test_struct>     data;
+
+    for (size_t i = 0;  i < 2000;  ++i)
+    {
+        data.push_back(generate_test_struct());
+        p_vec->push_back(data.back());
+        p_lst->push_back(data.back());
+    }
+
+    void const*     pv = static_cast<void const*>(&p_vec->front());
+    void const*     pl = static_cast<void const*>(&p_lst->back());
+
+    CHECK(sm1_type::address_segment(pv) != 0  &&  sm2_type::address_segment(pv) == 0);
+    CHECK(sm2_type::address_segment(pl) != 0  &&  sm1_type::address_segment(pl) == 0);
+    CHECK(storage_model_base::address_segment(pv) == 0  &&  storage_model_base::address_segment(pl) == 0);
+
+    //- Swapping one model's buffers moves only its containers.
+    //
+    char*   base1 = sm1_type::segment_address(first);
+    char*   base2 = sm2_type::segment_address(first);
+
+    AllocStrategy1::swap_buffers();
+
+    CHECK(sm1_type::segment_address(first) != base1);
+    CHECK(sm2_type::segment_address(first) == base2);
+    CHECK(std::equal(data.begin(), data.end(), p_vec->begin(), p_vec->end()));
+    CHECK(std::equal(data.begin(), data.end(), p_lst->begin(), p_lst->end()));
+
+    //- Resetting or clearing one model's segments leaves the other model's containers intact.
+    //
+    AllocStrategy2::reset_buffers();
+
+    CHECK(all_zero(sm2_type::segment_address(first), 65536));
+    CHECK(std::equal(data.begin(), data.end(), p_vec->begin(), p_vec->end()));
+
+    sm2_type::clear_segments();
+
+    CHECK(sm2_type::segment_address(first) == nullptr  &&  sm2_type::address_segment(pv) == 0);
+    CHECK(std::equal(data.begin(), data.end(), p_vec->begin(), p_vec->end()));
+    CHECK(storage_model_base::segment_address(first) == global_base);
+
+    sm2_type::init_segments();
+    AllocStrategy2::reset_buffers();
+}
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      do_policy_rollover_tests<AS>
+//
+//  Summary:
+//      This function template fills the first segment of a policy-based storage model with
+//      chunks, and then verifies that the contents of the chunks survive swap_buffers().  For
+//      a model limited to one segment, it verifies that filling the segment fails with
+//      std::bad_alloc instead of placing chunks in a second segment.
+//--------------------------------------------------------------------------------------------------
+//
+template<typename AllocStrategy>
+void
+do_policy_rollover_tests()
+{
+    using strategy      = AllocStrategy;
+    using storage_model = typename strategy::storage_model;
+    using void_pointer  = typename strategy::void_pointer;
+
+    size_t const    first = storage_model::first_segment_index();
+    size_t const    csize = storage_model::max_segment_size() / 4;
+    strategy        heap;
+    size_t          count  = 0;
+    bool            caught = false;
+
+    storage_model::clear_segments();
+    storage_model::init_segments();
+    strategy::reset_buffers();
+
+    //- Based 1D pointers are offsets from the first segment, and would reach another segment
+    //  only while the two happened to stay the same distance apart, so the model must be
+    //  limited to its first segment.
+    //
+    if (std::is_same<typename storage_model::addressing_model, based_1d_addressing_model<storage_model>>::value)
+    {
+        CHECK(storage_model::max_segment_count() == 1);
+        CHECK(!storage_model::ensure_segment(first + 1));
+    }
+
+    //- The table of chunks is kept in the first segment, so that it moves with the segment and
+    //  is found again by its offset after the swap.
+    //
+    void_pointer*   table = static_cast<void_pointer*>(static_cast<void*>(heap.allocate(4 * sizeof(void_pointer))));
+    size_t const    table_offset = (char*) table - storage_model::segment_address(first);
+
+    for (size_t i = 0;  i < 4;  ++i)
+    {
+        new (table + i) void_pointer(nullptr);
+    }
+
+    //- Four chunks of a quarter segment cannot all fit in the first segment, so the last one
+    //  lands in a second segment or is refused.
+    //
+    try
+    {
+        for (;  count < 4;  ++count)
+        {
+            table[count] = heap.allocate(csize);
+            memset(static_cast<void*>(table[count]), (int)(count + 1), csize);
+        }
+    }
+    catch (std::bad_alloc const&)
+    {
+        caught = true;
+    }
+
+    if (storage_model::max_segment_count() == 1)
+    {
+        CHECK(caught);
+        CHECK(count == 3u);
+        CHECK(storage_model::segment_address(first + 1) == nullptr);
+    }
+    else
+    {
+        CHECK(!caught);
+        CHECK(storage_model::segment_address(first + 1) != nullptr);
+    }
+
+    //- Every chunk lies within the model's segments, and keeps its contents when the buffers
+    //  are swapped.  A self-relative pointer from one segment into another does not survive a
+    //  swap, since the segments' new buffers need not lie the same distance apart, so for the
+    //  offset model only the chunks in the table's own segment are checked.
+    //
+    bool const      self_relative = std::is_same<typename storage_model::addressing_model, offset_addressing_model>::value;
+    size_t          segments[4];
+
+    for (size_t i = 0;  i < count;  ++i)
+    {
+        segments[i] = storage_model::address_segment(static_cast<void*>(table[i]));
+    }
+
+    strategy::swap_buffers();
+    table = reinterpret_cast<void_pointer*>(storage_model::segment_address(first) + table_offset);
+
+    for (size_t i = 0;  i < count;  ++i)
+    {
+        if (self_relative  &&  segments[i] != first)
+        {
+            continue;
+        }
+
+        char const*     pc = static_cast<char const*>(static_cast<void*>(table[i]));
+
+        CHECK(storage_model::address_segment(pc) != 0);
+        CHECK(storage_model::address_segment(pc + csize - 1) == storage_model::address_segment(pc));
+        CHECK(pc[0] == (char)(i + 1)  &&  pc[csize - 1] == (char)(i + 1));
+    }
+
+    //- Release the segments that were created.
+    //
+    storage_model::clear_segments();
+    storage_model::init_segments();
+    strategy::reset_buffers();
+}
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      run_policy_storage_tests<AS1, AS2>
+//
+//  Summary:
+//      This function template manages the sequence of actual policy storage test calls.  Each
+//      pair of strategies is run in both orders, so that each model is swapped and cleared,
+//      and then each model is filled past its first segment.
+//--------------------------------------------------------------------------------------------------
+//
+template<typename AllocStrategy1, typename AllocStrategy2>
+void
+run_policy_storage_tests(char const* stype1, char const* stype2)
+{
+    cout << "================================================================" << endl;
+    cout << "Running policy storage tests for " << stype1 << " and " << stype2 << endl << endl;
+
+    AllocStrategy1::reset_buffers();
+    AllocStrategy2::reset_buffers();
+    do_policy_storage_tests<AllocStrategy1, AllocStrategy2>();
+    AllocStrategy1::reset_buffers();
+    AllocStrategy2::reset_buffers();
+    do_policy_storage_tests<AllocStrategy2, AllocStrategy1>();
+    AllocStrategy1::reset_buffers();
+    AllocStrategy2::reset_buffers();
+    do_policy_rollover_tests<AllocStrategy1>();
+    do_policy_rollover_tests<AllocStrategy2>();
+}
+
+#endif  //- STORAGE_POLICY_TESTS_H_DEFINED
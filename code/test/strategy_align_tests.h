@@ -0,0 +1,120 @@
+//==================================================================================================
+//  File:
+//      strategy_align_tests.h
+//
+//  Copyright (c) 2017 Bob Steagall, KEWB Computing
+//==================================================================================================
+//
+#ifndef STRATEGY_ALIGN_TESTS_H_DEFINED
+#define STRATEGY_ALIGN_TESTS_H_DEFINED
+
+#include "strategy_tests.h"
+
+//- Some over-aligned types, of the kind used for SIMD buffers and for counters padded out to a
+//  cache line to avoid false sharing.
+//
+struct alignas(32) simd_block
+{
+    float   m_lanes[8];
+};
+
+struct alignas(64) padded_counter
+{
+    uint64_t    m_count;
+};
+
+inline bool
+is_aligned(void const* p, size_t alignment)
+{
+    return (reinterpret_cast<uintptr_t>(p) % alignment) == 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      do_alignment_tests<AS>
+//
+//  Summary:
+//      This function template verifies that the strategy honors requested alignments, both when
+//      called directly and through rhx_allocator for over-aligned types.
+//--------------------------------------------------------------------------------------------------
+//
+template<typename AllocStrategy>
+void
+do_alignment_tests()
+{
+    //- Various type aliases to aid readability.
+    //
+    using strategy       = AllocStrategy;
+    using simd_vector    = vector<simd_block, rhx_allocator<simd_block, strategy>>;
+    using counter_vector = vector<padded_counter, rhx_allocator<padded_counter, strategy>>;
+    using counter_list   = list<padded_counter, rhx_allocator<padded_counter, strategy>>;
+
+    strategy    heap;
+
+    //- Direct requests, interleaved with small ones that disturb the alignment of the next
+    //  free position.
+    //
+    size_t const    alignments[] = { 1u, 16u, 32u, 64u, 128u, 4096u };
+
+    for (size_t alignment : alignments)
+    {
+        heap.allocate(24);
+        void*   p = heap.allocate(40, alignment);
+        CHECK(is_aligned(p, max(alignment, (size_t) 16)));
+    }
+
+    //- Containers of over-aligned types.
+    //
+    auto    p_simd = allocate<simd_vector, strategy>();
+    auto    p_ctrs = allocate<counter_vector, strategy>();
+    auto    p_list = allocate<counter_list, strategy>();
+
+    for (size_t i = 0;  i < 100;  ++i)
+    {
+        heap.allocate(8);
+        p_simd->push_back(simd_block());
+        p_ctrs->push_back(padded_counter{i});
+        p_list->push_back(padded_counter{i});
+
+        CHECK(is_aligned(p_simd->data(), alignof(simd_block)));
+        CHECK(is_aligned(p_ctrs->data(), alignof(padded_counter)));
+        CHECK(is_aligned(addressof(p_list->back()), alignof(padded_counter)));
+    }
+
+    //- Impossible alignments are rejected.
+    //
+    bool    caught = false;
+
+    try
+    {
+        heap.allocate(16, 48);
+    }
+    catch (std::bad_alloc const&)
+    {
+        caught = true;
+    }
+    CHECK(caught);
+}
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      run_alignment_tests<AS>
+//
+//  Summary:
+//      This function template manages the sequence of actual alignment test function calls.
+//--------------------------------------------------------------------------------------------------
+//
+template<typename AllocStrategy>
+void
+run_alignment_tests(char const* stype)
+{
+    cout << "================================================================" << endl;
+    cout << "Running alignment tests for " << stype << endl << endl;
+
+    AllocStrategy::reset_buffers();
+    do_alignment_tests<AllocStrategy>();
+
+    AllocStrategy::reset_buffers();
+}
+
+#endif  //- STRATEGY_ALIGN_TESTS_H_DEFINED
@@ -0,0 +1,107 @@
+//==================================================================================================
+//  File:
+//      strategy_arena_tests.h
+//
+//  Copyright (c) 2017 Bob Steagall, KEWB Computing
+//==================================================================================================
+//
+#ifndef STRATEGY_ARENA_TESTS_H_DEFINED
+#define STRATEGY_ARENA_TESTS_H_DEFINED
+
+#include "strategy_tests.h"
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      do_arena_scope_tests<AS>
+//
+//  Summary:
+//      This function template verifies that arena scopes roll back their allocations, destroy
+//      the objects they create, and nest properly.
+//--------------------------------------------------------------------------------------------------
+//
+template<typename AllocStrategy>
+void
+do_arena_scope_tests()
+{
+    //- Various type aliases to aid readability.
+    //
+    using strategy        = AllocStrategy;
+    using scope_type      = typename strategy::scope;
+    using syn_data_vector = vector<test_struct, rhx_allocator<test_struct, strategy>>;
+
+    strategy    heap;
+    void*       p_first;
+    void*       p_inner;
+
+    //- Allocations made in a scope, by create() or otherwise, are released when it ends.
+    //
+    {
+        scope_type  outer;
+        auto        p_vec = outer.template create<syn_data_vector>();
+
+        p_first = p_vec;
+
+        for (size_t i = 0;  i < 100;  ++i)
+        {
+            p_vec->push_back(generate_test_struct());
+        }
+        CHECK(p_vec->size() == 100u);
+
+        //- Objects created in a nested scope are destroyed when it ends, and the outer scope
+        //  continues allocating from where the nested scope started.
+        //
+        {
+            scope_type  inner;
+            auto        p_obj = inner.template create<counted_object>();
+            auto        p_raw = inner.template create<uint64_t>(42u);
+
+            p_inner = p_obj;
+
+            CHECK(counted_object::sm_live == 1);
+            CHECK(*p_raw == 42u);
+        }
+        CHECK(counted_object::sm_live == 0);
+
+        void*   p_next = heap.allocate(sizeof(counted_object));
+        CHECK(p_next == p_inner);
+    }
+
+    void*   p_after = heap.allocate(sizeof(syn_data_vector));
+    CHECK(p_after == p_first);
+
+    //- Releasing a scope explicitly leaves it usable.
+    //
+    scope_type  outer;
+
+    outer.template create<counted_object>();
+    outer.template create<counted_object>();
+    CHECK(counted_object::sm_live == 2);
+    outer.release();
+    CHECK(counted_object::sm_live == 0);
+
+    outer.template create<counted_object>();
+    CHECK(counted_object::sm_live == 1);
+}
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      run_arena_scope_tests<AS>
+//
+//  Summary:
+//      This function template manages the sequence of actual arena scope test function calls.
+//--------------------------------------------------------------------------------------------------
+//
+template<typename AllocStrategy>
+void
+run_arena_scope_tests(char const* stype)
+{
+    cout << "================================================================" << endl;
+    cout << "Running arena scope tests for " << stype << endl << endl;
+
+    do_arena_scope_tests<AllocStrategy>();
+    CHECK(counted_object::sm_live == 0);
+
+    AllocStrategy::reset_buffers();
+}
+
+#endif  //- STRATEGY_ARENA_TESTS_H_DEFINED
@@ -0,0 +1,155 @@
+//==================================================================================================
+//  File:
+//      strategy_check_tests.h
+//
+//  Copyright (c) 2017 Bob Steagall, KEWB Computing
+//==================================================================================================
+//
+#ifndef STRATEGY_CHECK_TESTS_H_DEFINED
+#define STRATEGY_CHECK_TESTS_H_DEFINED
+
+#include "strategy_tests.h"
+
+//- An addressing fault handler that records the faults instead of aborting.
+//
+inline vector<addressing_fault>&
+recorded_faults()
+{
+    static vector<addressing_fault>     faults;
+    return faults;
+}
+
+inline void
+record_fault(addressing_fault const& fault)
+{
+    recorded_faults().push_back(fault);
+}
+
+//- Returns true if exactly one fault of the given kind was recorded, and clears the record.
+//
+inline bool
+take_fault(addressing_fault::kind_type kind)
+{
+    bool    found = recorded_faults().size() == 1u  &&  recorded_faults()[0].m_kind == kind;
+
+    recorded_faults().clear();
+    return found;
+}
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      do_checked_addressing_tests<AS>
+//
+//  Summary:
+//      This function template exercises the addressing checks directly, and then through the
+//      strategy's pointers: ordinary use must pass, while arithmetic leaving a segment and, in
+//      the based models, pointers to missing segments or beyond the end of a segment must be
+//      reported when the checks are compiled in.
+//--------------------------------------------------------------------------------------------------
+//
+template<typename AllocStrategy>
+void
+do_checked_addressing_tests(bool based)
+{
+    using strategy     = AllocStrategy;
+    using sm_type      = typename strategy::storage_model;
+    using am_type      = typename strategy::addressing_model;
+    using char_pointer = syn_ptr<char, am_type>;
+
+    constexpr bool  checked = addressing_checks::enabled();
+    constexpr bool  is_1d   = std::is_same<sm_type, based_1d_storage_model>::value;
+
+    strategy    heap;
+    auto        prev = addressing_checks::set_handler(&record_fault);
+    size_t      seg  = sm_type::first_segment_index();
+    char_pointer    p = static_cast<char_pointer>(heap.allocate(64));
+    size_t      size = sm_type::segment_size(seg);
+    char        local[16];
+
+    recorded_faults().clear();
+
+    //- The checks themselves.
+    //
+    CHECK(addressing_checks::check_location<sm_type>(seg, 0));
+    CHECK(addressing_checks::check_location<sm_type>(seg, size));
+    CHECK(addressing_checks::check_location<sm_type>(0, 12345));
+    addressing_checks::check_step<sm_type>(seg, 16, -16);
+    addressing_checks::check_step<sm_type>(seg, size - 16, 16);
+    addressing_checks::check_native_step(local, 1 << 20);
+    CHECK(recorded_faults().empty());
+
+    CHECK(!addressing_checks::check_location<sm_type>(seg, size + 1));
+    CHECK(take_fault(addressing_fault::offset_overflow));
+    CHECK(!addressing_checks::check_location<sm_type>(sm_type::last_segment_index() + 1, 0));
+    CHECK(take_fault(addressing_fault::missing_segment));
+    addressing_checks::check_step<sm_type>(seg, 16, -32);
+    CHECK(take_fault(addressing_fault::segment_crossing));
+    addressing_checks::check_step<sm_type>(seg, size - 16, 32);
+    CHECK(take_fault(addressing_fault::segment_crossing));
+    addressing_checks::check_native_step(sm_type::segment_address(seg) + 16, -32);
+    CHECK(take_fault(addressing_fault::segment_crossing));
+
+    //- Ordinary use of the strategy's pointers, including a pointer one past the end of a
+    //  chunk and a null pointer, raises no faults.
+    //
+    char_pointer    end = p + 64;
+    char_pointer    nil = nullptr;
+
+    for (char_pointer q = p;  q != end;  ++q)
+    {
+        *q = 'x';
+    }
+    CHECK(end - p == 64  &&  *--end == 'x');
+    CHECK(static_cast<char*>(nil) == nullptr  &&  nil != p);
+    CHECK(recorded_faults().empty());
+
+    //- Arithmetic that leaves a segment.
+    //
+    char_pointer    last  = char_pointer(sm_type::segment_pointer(seg, size - 16));
+    char_pointer    first = char_pointer(sm_type::segment_pointer(seg, 16));
+
+    last += 32;
+    CHECK(take_fault(addressing_fault::segment_crossing) == checked);
+    first -= 32;
+    CHECK(take_fault(addressing_fault::segment_crossing) == checked);
+
+    //- Corrupt based pointers convert to null once their faults are reported.  Without the
+    //  checks, converting them is undefined, so it is not attempted.
+    //
+    if (based  &&  checked)
+    {
+        char_pointer    past    = char_pointer(sm_type::segment_pointer(seg, size + 64));
+        char_pointer    missing = char_pointer(sm_type::segment_pointer(sm_type::last_segment_index() + 5, 64));
+
+        CHECK(static_cast<char*>(past) == nullptr);
+        CHECK(take_fault(addressing_fault::offset_overflow));
+
+        static_cast<void>(static_cast<char*>(missing));
+        CHECK(is_1d ? recorded_faults().empty() : take_fault(addressing_fault::missing_segment));
+    }
+
+    recorded_faults().clear();
+    addressing_checks::set_handler(prev);
+}
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      run_checked_addressing_tests<AS>
+//
+//  Summary:
+//      This function template manages the sequence of actual addressing check test calls.
+//--------------------------------------------------------------------------------------------------
+//
+template<typename AllocStrategy>
+void
+run_checked_addressing_tests(char const* stype, bool based)
+{
+    cout << "================================================================" << endl;
+    cout << "Running checked addressing tests for " << stype << endl << endl;
+
+    AllocStrategy::reset_buffers();
+    do_checked_addressing_tests<AllocStrategy>(based);
+    AllocStrategy::reset_buffers();
+}
+
+#endif  //- STRATEGY_CHECK_TESTS_H_DEFINED
@@ -0,0 +1,410 @@
+//==================================================================================================
+//  File:
+//      strategy_compact_tests.h
+//
+//  Copyright (c) 2017 Bob Steagall, KEWB Computing
+//==================================================================================================
+//
+#ifndef STRATEGY_COMPACT_TESTS_H_DEFINED
+#define STRATEGY_COMPACT_TESTS_H_DEFINED
+
+#include "strategy_tests.h"
+
+//- A doubly-linked list node, a binary tree node with a parent link, and a large table of
+//  pointers allocated outside the slabs, with their trace registrations.
+//
+template<typename AM>
+struct compact_list_node
+{
+    syn_ptr<compact_list_node, AM>  m_next = nullptr;
+    syn_ptr<compact_list_node, AM>  m_prev = nullptr;
+    uint64_t                        m_value;
+};
+
+template<typename AM>
+struct compact_tree_node
+{
+    syn_ptr<compact_tree_node, AM>  m_left   = nullptr;
+    syn_ptr<compact_tree_node, AM>  m_right  = nullptr;
+    syn_ptr<compact_tree_node, AM>  m_parent = nullptr;
+    uint64_t                        m_key;
+    uint64_t                        m_pad[4];
+};
+
+template<typename AM>
+struct compact_table
+{
+    syn_ptr<compact_list_node<AM>, AM>  m_entries[64];
+};
+
+template<typename AM>
+struct rhx_trace<compact_list_node<AM>>
+{
+    template<class V>
+    static void
+    trace(compact_list_node<AM>& node, V& visit)
+    {
+        visit(node.m_next);
+        visit(node.m_prev);
+    }
+};
+
+template<typename AM>
+struct rhx_trace<compact_tree_node<AM>>
+{
+    template<class V>
+    static void
+    trace(compact_tree_node<AM>& node, V& visit)
+    {
+        visit(node.m_left);
+        visit(node.m_right);
+        visit(node.m_parent);
+    }
+};
+
+template<typename AM>
+struct rhx_trace<compact_table<AM>>
+{
+    template<class V>
+    static void
+    trace(compact_table<AM>& table, V& visit)
+    {
+        for (auto& entry : table.m_entries)
+        {
+            visit(entry);
+        }
+    }
+};
+
+//- Registers an array of list heads, so that the array can be a root.
+//
+template<typename AM, size_t N>
+struct rhx_trace<syn_ptr<compact_list_node<AM>, AM>[N]>
+{
+    template<class V>
+    static void
+    trace(syn_ptr<compact_list_node<AM>, AM> (&heads)[N], V& visit)
+    {
+        for (auto& head : heads)
+        {
+            visit(head);
+        }
+    }
+};
+
+//- Allocates an object of type T directly from a strategy.
+//
+template<typename T, typename AllocStrategy>
+T*
+compact_new(AllocStrategy& heap)
+{
+    return ::new (static_cast<void*>(heap.allocate(sizeof(T)))) T();
+}
+
+//- Inserts a key into an unbalanced binary tree of compact_tree_nodes.
+//
+template<typename AM, typename AllocStrategy>
+void
+compact_tree_insert(syn_ptr<compact_tree_node<AM>, AM>& root, uint64_t key, AllocStrategy& heap)
+{
+    using node_type = compact_tree_node<AM>;
+
+    node_type*  node   = compact_new<node_type>(heap);
+    node_type*  parent = nullptr;
+    node_type*  curr   = root;
+
+    node->m_key = key;
+
+    while (curr != nullptr)
+    {
+        parent = curr;
+        curr   = (key < curr->m_key) ? static_cast<node_type*>(curr->m_left) : static_cast<node_type*>(curr->m_right);
+    }
+
+    node->m_parent = parent;
+
+    if (parent == nullptr)
+    {
+        root = node;
+    }
+    else if (key < parent->m_key)
+    {
+        parent->m_left = node;
+    }
+    else
+    {
+        parent->m_right = node;
+    }
+}
+
+//- Verifies a tree of compact_tree_nodes in order, including its parent links.
+//
+template<typename AM>
+bool
+compact_tree_matches(compact_tree_node<AM> const* node, compact_tree_node<AM> const* parent,
+                     multiset<uint64_t>::const_iterator& it)
+{
+    if (node == nullptr)
+    {
+        return true;
+    }
+    if (node->m_parent != parent  ||  !compact_tree_matches<AM>(node->m_left, node, it))
+    {
+        return false;
+    }
+    if (node->m_key != *it++)
+    {
+        return false;
+    }
+    return compact_tree_matches<AM>(node->m_right, node, it);
+}
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      do_compact_list_tests<AS>
+//
+//  Summary:
+//      This function template fragments the slabs of a size class by freeing most of the nodes
+//      of a list, compacts them, and verifies that the list is intact, that it occupies less
+//      memory, that its links are all still usable, and that unreachable blocks stay put.
+//--------------------------------------------------------------------------------------------------
+//
+template<typename AllocStrategy>
+void
+do_compact_list_tests(size_t nelem)
+{
+    using strategy     = AllocStrategy;
+    using am_type      = typename strategy::addressing_model;
+    using node_type    = compact_list_node<am_type>;
+    using node_pointer = syn_ptr<node_type, am_type>;
+    using table_type   = compact_table<am_type>;
+
+    strategy            heap;
+    vector<node_type*>  nodes;
+
+    //- Allocate the nodes, then keep one in eight in a list and free the rest.
+    //
+    for (size_t i = 0;  i < 8 * nelem;  ++i)
+    {
+        nodes.push_back(compact_new<node_type>(heap));
+        nodes.back()->m_value = i;
+    }
+
+    node_pointer    head = nullptr;
+    node_type*      tail = nullptr;
+    char*           lo_before = reinterpret_cast<char*>(~uintptr_t(0));
+    char*           hi_before = nullptr;
+
+    for (size_t i = 0;  i < nodes.size();  ++i)
+    {
+        if (i % 8 == 5)
+        {
+            nodes[i]->m_prev = tail;
+            (tail ? tail->m_next : head) = nodes[i];
+            tail = nodes[i];
+            lo_before = std::min(lo_before, reinterpret_cast<char*>(nodes[i]));
+            hi_before = std::max(hi_before, reinterpret_cast<char*>(nodes[i]));
+        }
+        else if (i != 3)
+        {
+            heap.deallocate(typename strategy::void_pointer(nodes[i]), sizeof(node_type));
+        }
+    }
+
+    //- Node 3 is allocated but unreachable, so it must be left where it is.  A table allocated
+    //  outside the slabs, and registered as a root, refers to some of the nodes.
+    //
+    node_type*  unreachable = nodes[3];
+    auto        p_table     = static_cast<table_type*>(static_cast<void*>(heap.allocate(sizeof(table_type))));
+
+    ::new (p_table) table_type();
+    unreachable->m_value = 0xDEADBEEF;
+
+    for (size_t i = 0;  i < 64;  ++i)
+    {
+        p_table->m_entries[i] = nodes[(i * 8 * 7) % nodes.size() / 8 * 8 + 5];
+    }
+
+    slab_compactor<typename strategy::storage_model>    compactor;
+
+    compactor.add_root(head);
+    compactor.add_root(*p_table);
+
+    compaction_stats    stats = compactor.compact();
+
+    CHECK(stats.m_live_blocks == nelem);
+    CHECK(stats.m_pinned_blocks == 1u);
+    CHECK(stats.m_moved_blocks > 0u);
+    CHECK(stats.m_released_slabs > 0u);
+    CHECK(unreachable->m_value == 0xDEADBEEF);
+
+    //- The list is intact in both directions, and is packed into a much smaller range.
+    //
+    size_t      count = 0;
+    node_type*  prev  = nullptr;
+    char*       lo_after = reinterpret_cast<char*>(~uintptr_t(0));
+    char*       hi_after = nullptr;
+
+    for (node_type* p = head;  p != nullptr;  prev = p, p = p->m_next, ++count)
+    {
+        CHECK(p->m_value == 8 * count + 5);
+        CHECK(p->m_prev == prev);
+        lo_after = std::min(lo_after, reinterpret_cast<char*>(p));
+        hi_after = std::max(hi_after, reinterpret_cast<char*>(p));
+    }
+    CHECK(count == nelem);
+    CHECK(4 * (hi_after - lo_after) < hi_before - lo_before);
+
+    for (size_t i = 0;  i < 64;  ++i)
+    {
+        CHECK(p_table->m_entries[i]->m_value == (i * 8 * 7) % nodes.size() / 8 * 8 + 5);
+    }
+
+    //- The rebuilt free list and the spare slabs are usable: new nodes fill the remaining holes
+    //  and then the spares, without disturbing the list.
+    //
+    for (size_t i = 0;  i < 8 * nelem;  ++i)
+    {
+        node_type*  node = compact_new<node_type>(heap);
+
+        node->m_value = ~uint64_t(0);
+        node->m_next  = nullptr;
+    }
+
+    count = 0;
+
+    for (node_type* p = head;  p != nullptr;  p = p->m_next, ++count)
+    {
+        CHECK(p->m_value == 8 * count + 5);
+    }
+    CHECK(count == nelem);
+    CHECK(unreachable->m_value == 0xDEADBEEF);
+}
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      do_compact_tree_tests<AS>
+//
+//  Summary:
+//      This function template compacts a binary tree with parent links, interleaved with lists
+//      in another size class, and verifies both afterward.
+//--------------------------------------------------------------------------------------------------
+//
+template<typename AllocStrategy>
+void
+do_compact_tree_tests(size_t nelem)
+{
+    using strategy     = AllocStrategy;
+    using am_type      = typename strategy::addressing_model;
+    using tree_node    = compact_tree_node<am_type>;
+    using tree_pointer = syn_ptr<tree_node, am_type>;
+    using list_node    = compact_list_node<am_type>;
+    using list_pointer = syn_ptr<list_node, am_type>;
+
+    strategy            heap;
+    tree_pointer        root = nullptr;
+    list_pointer        lists[2] = {nullptr, nullptr};
+    multiset<uint64_t>  keys;
+    vector<uint64_t>    data(generate_test_data<uint64_t>(2 * nelem));
+
+    //- Build the tree and two lists at once, then remove the second list entirely and remove
+    //  half of the tree's keys by rebuilding it.
+    //
+    for (size_t i = 0;  i < data.size();  ++i)
+    {
+        compact_tree_insert<am_type>(root, data[i], heap);
+
+        list_node*  node = compact_new<list_node>(heap);
+
+        node->m_value = i;
+        node->m_next  = lists[i % 2];
+        lists[i % 2]  = node;
+    }
+
+    for (list_node* p = lists[1];  p != nullptr;  )
+    {
+        list_node*  next = p->m_next;
+
+        heap.deallocate(typename strategy::void_pointer(p), sizeof(list_node));
+        p = next;
+    }
+    lists[1] = nullptr;
+
+    vector<tree_node*>  old_nodes;
+    tree_pointer        old_root = root;
+
+    for (vector<tree_node*> pending(1, old_root);  !pending.empty();  )
+    {
+        tree_node*  p = pending.back();
+
+        pending.pop_back();
+        if (p != nullptr)
+        {
+            old_nodes.push_back(p);
+            pending.push_back(p->m_left);
+            pending.push_back(p->m_right);
+        }
+    }
+
+    root = nullptr;
+
+    for (size_t i = 0;  i < data.size();  i += 2)
+    {
+        compact_tree_insert<am_type>(root, data[i], heap);
+        keys.insert(data[i]);
+    }
+    for (tree_node* p : old_nodes)
+    {
+        heap.deallocate(typename strategy::void_pointer(p), sizeof(tree_node));
+    }
+
+    slab_compactor<typename strategy::storage_model>    compactor;
+
+    compactor.add_root(root);
+    compactor.add_root(lists);
+
+    compaction_stats    stats = compactor.compact();
+
+    CHECK(stats.m_live_blocks == keys.size() + nelem);
+    CHECK(stats.m_pinned_blocks == 0u);
+    CHECK(stats.m_moved_blocks > 0u);
+
+    auto    it = keys.cbegin();
+
+    CHECK(compact_tree_matches<am_type>(root, nullptr, it));
+    CHECK(it == keys.cend());
+
+    size_t  count = 0;
+
+    for (list_node* p = lists[0];  p != nullptr;  p = p->m_next, ++count)
+    {
+        CHECK(p->m_value == data.size() - 2 - 2 * count);
+    }
+    CHECK(count == nelem);
+}
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      run_compaction_tests<AS>
+//
+//  Summary:
+//      This function template manages the sequence of actual compaction test function calls.
+//--------------------------------------------------------------------------------------------------
+//
+template<typename AllocStrategy>
+void
+run_compaction_tests(char const* stype)
+{
+    cout << "================================================================" << endl;
+    cout << "Running slab compaction tests for " << stype << endl << endl;
+
+    AllocStrategy::reset_buffers();
+    do_compact_list_tests<AllocStrategy>(5000);
+
+    AllocStrategy::reset_buffers();
+    do_compact_tree_tests<AllocStrategy>(5000);
+
+    AllocStrategy::reset_buffers();
+}
+
+#endif  //- STRATEGY_COMPACT_TESTS_H_DEFINED
@@ -0,0 +1,285 @@
+//==================================================================================================
+//  File:
+//      strategy_numa_tests.h
+//
+//  Copyright (c) 2017 Bob Steagall, KEWB Computing
+//==================================================================================================
+//
+#ifndef STRATEGY_NUMA_TESTS_H_DEFINED
+#define STRATEGY_NUMA_TESTS_H_DEFINED
+
+#include <cstdio>
+#include "strategy_tests.h"
+#include "strategy_slab_tests.h"
+
+#ifdef __linux__
+    #include <sched.h>
+#endif
+
+//- Moves the calling thread to the given node.  With simulated nodes this only changes the
+//  node the thread reports; otherwise the thread is pinned to the CPUs listed for the node.
+//
+inline void
+run_on_node(int node)
+{
+    storage_model_base::set_current_node(node);
+
+#ifdef __linux__
+    if (!storage_model_base::nodes_simulated())
+    {
+        char        fname[64];
+        cpu_set_t   cpus;
+        int         lo, hi;
+        char        sep = ',';
+
+        snprintf(fname, sizeof(fname), "/sys/devices/system/node/node%d/cpulist", node);
+        CPU_ZERO(&cpus);
+
+        if (FILE* fp = fopen(fname, "r"))
+        {
+            while (sep == ','  &&  fscanf(fp, "%d", &lo) == 1)
+            {
+                hi  = lo;
+                sep = '\n';
+                if (fscanf(fp, "%c", &sep) == 1  &&  sep == '-')
+                {
+                    if (fscanf(fp, "%d", &hi) != 1  ||  fscanf(fp, "%c", &sep) != 1) sep = '\n';
+                }
+                for (int cpu = lo;  cpu <= hi  &&  cpu < CPU_SETSIZE;  ++cpu) CPU_SET(cpu, &cpus);
+            }
+            fclose(fp);
+            sched_setaffinity(0, sizeof(cpus), &cpus);
+        }
+    }
+#endif
+}
+
+//- Releases the calling thread from any node it was moved to.
+//
+inline void
+run_on_any_node()
+{
+    storage_model_base::set_current_node(0);
+
+#ifdef __linux__
+    if (!storage_model_base::nodes_simulated())
+    {
+        cpu_set_t   cpus;
+
+        CPU_ZERO(&cpus);
+        for (int cpu = 0;  cpu < CPU_SETSIZE;  ++cpu) CPU_SET(cpu, &cpus);
+        sched_setaffinity(0, sizeof(cpus), &cpus);
+    }
+#endif
+}
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      do_numa_placement_tests<AS>
+//
+//  Summary:
+//      This function template verifies, using two simulated nodes, that segments are assigned
+//      to nodes round-robin and that the NUMA strategy allocates from the calling thread's node.
+//--------------------------------------------------------------------------------------------------
+//
+template<typename AllocStrategy>
+void
+do_numa_placement_tests()
+{
+    using strategy        = AllocStrategy;
+    using storage_model   = typename strategy::storage_model;
+    using size_type       = typename storage_model::size_type;
+    using syn_data_vector = vector<test_struct, rhx_allocator<test_struct, strategy>>;
+
+    strategy    heap;
+
+    storage_model::simulate_nodes(2);
+    rebuild_segments();
+
+    CHECK(storage_model::nodes_simulated());
+    CHECK(storage_model::node_count() == 2);
+
+    for (size_type i = storage_model::first_segment_index();  i <= storage_model::last_segment_index();  ++i)
+    {
+        CHECK(storage_model::segment_node(i) == (int)(i - storage_model::first_segment_index()) % 2);
+    }
+
+    //- Allocations follow the calling thread's node.
+    //
+    for (int node = 0;  node < 2;  ++node)
+    {
+        run_on_node(node);
+        CHECK(storage_model::current_node() == node);
+
+        auto    p = heap.allocate(100);
+        CHECK(strategy::node_of(p) == node);
+        CHECK(storage_model::address_node(static_cast<void*>(p)) == node);
+    }
+
+    //- A container built on one node keeps its memory there when used from another.  It is
+    //  destroyed before the segments are rebuilt below.
+    //
+    {
+        run_on_node(1);
+        syn_data_vector     sv;
+
+        for (size_t i = 0;  i < 1000;  ++i)
+        {
+            sv.push_back(generate_test_struct());
+        }
+
+        run_on_node(0);
+        sv.push_back(generate_test_struct());
+        CHECK(strategy::node_of(sv.data()) == 1);
+        CHECK(sv.size() == 1001u);
+    }
+
+    //- A request too large for the node's segments is refused.
+    //
+    bool    refused = false;
+
+    try
+    {
+        heap.allocate(storage_model::max_segment_size());
+    }
+    catch (std::bad_alloc&)
+    {
+        refused = true;
+    }
+    CHECK(refused);
+
+    //- Pointers outside the segments have no node.
+    //
+    int     local;
+    CHECK(storage_model::address_node(&local) == -1);
+
+    run_on_any_node();
+    storage_model::simulate_nodes(0);
+    rebuild_segments();
+}
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      run_numa_placement_tests<AS>
+//
+//  Summary:
+//      This function template manages the sequence of actual NUMA placement test calls.
+//--------------------------------------------------------------------------------------------------
+//
+template<typename AllocStrategy>
+void
+run_numa_placement_tests(char const* stype)
+{
+    cout << "================================================================" << endl;
+    cout << "Running NUMA placement tests for " << stype << endl << endl;
+
+    do_numa_placement_tests<AllocStrategy>();
+}
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      do_numa_walk_test<AS>
+//
+//  Summary:
+//      This function template builds a map on one node, then measures the time taken to walk
+//      it and look up every key from another node, keeping the fastest of several runs.
+//--------------------------------------------------------------------------------------------------
+//
+template<typename AllocStrategy>
+int64_t
+do_numa_walk_test(vector<uint64_t> const& keys, int build_node, int walk_node, size_t nreps)
+{
+    using walk_map = churn_map<AllocStrategy>;
+
+    //- Make sure the compiler doesn't optimize the walk away.
+    //
+    static  volatile uint64_t   dummy = 0;
+
+    stopwatch   sw;
+    int64_t     best = numeric_limits<int64_t>::max();
+    uint64_t    sum  = 0;
+
+    AllocStrategy::reset_buffers();
+    run_on_node(build_node);
+
+    walk_map    m;
+
+    for (auto k : keys)
+    {
+        m.emplace(k, k);
+    }
+
+    run_on_node(walk_node);
+
+    for (size_t i = 0;  i < nreps;  ++i)
+    {
+        sw.start();
+        for (auto const& kv : m)
+        {
+            sum += kv.second;
+        }
+        for (auto k : keys)
+        {
+            sum += m.find(k)->second;
+        }
+        sw.stop();
+
+        best = min(best, sw.elapsed_nsec());
+    }
+
+    dummy += sum;
+    run_on_any_node();
+    return best;
+}
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      run_numa_walk_tests<SM>
+//
+//  Summary:
+//      This function template times map walks for every combination of build and walk node.
+//      On single-node machines, two nodes are simulated; the placement is then exercised, but
+//      all memory is local, so the timings show only the cost of node-aware allocation.
+//--------------------------------------------------------------------------------------------------
+//
+template<typename SM>
+void
+run_numa_walk_tests(char const* smodel)
+{
+    using strategy = numa_allocation_strategy<SM>;
+
+    size_t const    counts[] = { 1000u, 10000u, 100000u };
+    size_t const    nreps    = 3;
+    bool const      simulate = SM::node_count() < 2;
+
+    if (simulate)
+    {
+        SM::simulate_nodes(2);
+    }
+    rebuild_segments();
+
+    int const       nnodes    = min(SM::node_count(), (int) strategy::max_nodes);
+    char const*     placement = simulate ? "simulated" : "bound";
+
+    for (size_t nelem : counts)
+    {
+        vector<uint64_t>    keys(generate_test_data<uint64_t>(nelem));
+
+        for (int build_node = 0;  build_node < nnodes;  ++build_node)
+        {
+            for (int walk_node = 0;  walk_node < nnodes;  ++walk_node)
+            {
+                int64_t     elapsed = do_numa_walk_test<strategy>(keys, build_node, walk_node, nreps);
+
+                cout << "numa, map, " << smodel << ", " << build_node << ", " << walk_node << ", "
+                     << elapsed << ", " << nelem << ", " << placement << endl;
+            }
+        }
+    }
+
+    SM::simulate_nodes(0);
+    rebuild_segments();
+    cout << endl;
+}
+
+#endif  //- STRATEGY_NUMA_TESTS_H_DEFINED
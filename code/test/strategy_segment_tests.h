@@ -0,0 +1,135 @@
+//==================================================================================================
+//  File:
+//      strategy_segment_tests.h
+//
+//  Copyright (c) 2017 Bob Steagall, KEWB Computing
+//==================================================================================================
+//
+#ifndef STRATEGY_SEGMENT_TESTS_H_DEFINED
+#define STRATEGY_SEGMENT_TESTS_H_DEFINED
+
+#include "strategy_tests.h"
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      do_segment_growth_tests<AS>
+//
+//  Summary:
+//      This function template verifies that segments beyond the first are created only when a
+//      strategy moves into them, that requests larger than a segment are rejected, and, when
+//      asked, that allocation fails cleanly once every segment is full.  For a model limited to
+//      a single segment, it verifies that filling the segment fails rather than rolling over.
+//      Filling every segment takes a great deal of memory, so it is only done for one strategy.
+//--------------------------------------------------------------------------------------------------
+//
+template<typename AllocStrategy>
+void
+do_segment_growth_tests(bool exhaust)
+{
+    using strategy      = AllocStrategy;
+    using storage_model = typename strategy::storage_model;
+    using size_type     = typename storage_model::size_type;
+
+    size_type const     first = storage_model::first_segment_index();
+    strategy            heap;
+
+    rebuild_segments();
+    CHECK(storage_model::segment_address(first) != nullptr);
+
+    for (size_type i = first + 1;  i <= storage_model::last_segment_index();  ++i)
+    {
+        CHECK(storage_model::segment_address(i) == nullptr);
+    }
+
+    //- Requests larger than a segment are rejected without disturbing the cursor.
+    //
+    bool    caught = false;
+    auto    start  = strategy::mark();
+
+    try
+    {
+        heap.allocate(heap.max_size() + 1);
+    }
+    catch (std::bad_alloc const&)
+    {
+        caught = true;
+    }
+    CHECK(caught);
+    CHECK(strategy::mark().m_segment == start.m_segment);
+    CHECK(strategy::mark().m_offset == start.m_offset);
+
+    //- A chunk of the largest size fills a segment of its own, and the next one is created.  A
+    //  model limited to a single segment refuses the chunk instead.
+    //
+    heap.allocate(100);
+    CHECK(storage_model::segment_address(first + 1) == nullptr);
+
+    if (storage_model::max_segment_count() == 1)
+    {
+        caught = false;
+        try
+        {
+            heap.allocate(heap.max_size());
+        }
+        catch (std::bad_alloc const&)
+        {
+            caught = true;
+        }
+        CHECK(caught);
+        CHECK(!storage_model::ensure_segment(first + 1));
+        CHECK(storage_model::segment_address(first + 1) == nullptr);
+    }
+    else
+    {
+        char*   p = static_cast<char*>(static_cast<void*>(heap.allocate(heap.max_size())));
+
+        CHECK(storage_model::segment_address(first + 1) != nullptr);
+        CHECK(p == storage_model::segment_address(first + 1) + 64);
+        CHECK(storage_model::segment_address(first + 2) == nullptr);
+    }
+
+    if (exhaust)
+    {
+        size_type   count = 0;
+
+        caught = false;
+        try
+        {
+            for (;  count < storage_model::max_segment_count();  ++count)
+            {
+                heap.allocate(heap.max_size());
+            }
+        }
+        catch (std::bad_alloc const&)
+        {
+            caught = true;
+        }
+        CHECK(caught);
+        CHECK(count == storage_model::max_segment_count() - 2);
+        CHECK(storage_model::segment_address(storage_model::last_segment_index()) != nullptr);
+    }
+
+    //- Release the segments that were created, so they do not cost every later reset.
+    //
+    rebuild_segments();
+}
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      run_segment_growth_tests<AS>
+//
+//  Summary:
+//      This function template manages the sequence of actual segment growth test calls.
+//--------------------------------------------------------------------------------------------------
+//
+template<typename AllocStrategy>
+void
+run_segment_growth_tests(char const* stype, bool exhaust)
+{
+    cout << "================================================================" << endl;
+    cout << "Running segment growth tests for " << stype << endl << endl;
+
+    do_segment_growth_tests<AllocStrategy>(exhaust);
+}
+
+#endif  //- STRATEGY_SEGMENT_TESTS_H_DEFINED
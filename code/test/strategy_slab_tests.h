@@ -0,0 +1,479 @@
+//==================================================================================================
+//  File:
+//      strategy_slab_tests.h
+//
+//  Copyright (c) 2017 Bob Steagall, KEWB Computing
+//==================================================================================================
+//
+#ifndef STRATEGY_SLAB_TESTS_H_DEFINED
+#define STRATEGY_SLAB_TESTS_H_DEFINED
+
+#include "strategy_tests.h"
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      do_slab_block_tests<AS>
+//
+//  Summary:
+//      This function template verifies size-class packing, block reuse, and in-place resizing
+//      directly against the strategy's interface.
+//--------------------------------------------------------------------------------------------------
+//
+template<typename AllocStrategy>
+void
+do_slab_block_tests()
+{
+    using strategy = AllocStrategy;
+
+    strategy    heap;
+
+    //- Blocks of the same size class are packed together, regardless of what other sizes are
+    //  allocated in between.
+    //
+    char*   p1 = static_cast<char*>(static_cast<void*>(heap.allocate(40)));
+    char*   p2 = static_cast<char*>(static_cast<void*>(heap.allocate(100)));
+    char*   p3 = static_cast<char*>(static_cast<void*>(heap.allocate(48)));
+    char*   p4 = static_cast<char*>(static_cast<void*>(heap.allocate(4096)));
+
+    CHECK(p3 - p1 == 48);
+    CHECK(p2 != nullptr  &&  p4 != nullptr);
+
+    //- Freed blocks are reused, most recently freed first.
+    //
+    heap.deallocate(typename strategy::void_pointer(p1), 40);
+    heap.deallocate(typename strategy::void_pointer(p3), 48);
+
+    void*   p5 = heap.allocate(33);
+    void*   p6 = heap.allocate(48);
+    void*   p7 = heap.allocate(48);
+
+    CHECK(p5 == p3);
+    CHECK(p6 == p1);
+    CHECK(p7 != p1  &&  p7 != p3);
+
+    //- Small blocks can be resized in place only within their size class.
+    //
+    CHECK(heap.try_expand(typename strategy::void_pointer(p2), 100, 112));
+    CHECK(!heap.try_expand(typename strategy::void_pointer(p2), 100, 120));
+    CHECK(!heap.try_expand(typename strategy::void_pointer(p2), 100, 1000));
+
+    //- Resetting the buffers discards the free lists.
+    //
+    heap.deallocate(typename strategy::void_pointer(p5), 48);
+    strategy::reset_buffers();
+
+    void*   p8 = heap.allocate(48);
+    void*   p9 = heap.allocate(48);
+
+    CHECK(static_cast<char*>(p9) - static_cast<char*>(p8) == 48);
+}
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      do_slab_pool_tests<AS>
+//
+//  Summary:
+//      This function template verifies that requests tagged with different types of the same
+//      size class are packed into pools of their own, and that rhx_allocator<T> tags them.
+//--------------------------------------------------------------------------------------------------
+//
+struct slab_pool_node_a { char m_data[48]; };
+struct slab_pool_node_b { char m_data[40]; };
+
+template<typename AllocStrategy>
+void
+do_slab_pool_tests()
+{
+    using strategy = AllocStrategy;
+    using tag_a    = rhx_type_tag<slab_pool_node_a>;
+    using tag_b    = rhx_type_tag<slab_pool_node_b>;
+
+    strategy    heap;
+    size_t      pool_a = strategy::template type_pool<slab_pool_node_a>();
+    size_t      pool_b = strategy::template type_pool<slab_pool_node_b>();
+
+    //- Each type keeps its pool.  Types that arrive after the type pools have all been given out
+    //  share pool 0 with untagged requests, and there is then nothing more to check.
+    //
+    CHECK(pool_a == strategy::template type_pool<slab_pool_node_a>());
+    CHECK(pool_a != pool_b  ||  pool_a == 0);
+
+    if (pool_a == 0  ||  pool_b == 0)
+    {
+        return;
+    }
+
+    //- Blocks of the same type are packed together, whatever else of the same size class is
+    //  allocated in between.
+    //
+    char*   pa1 = static_cast<char*>(static_cast<void*>(heap.allocate(48, strategy::min_alignment, tag_a())));
+    char*   pb1 = static_cast<char*>(static_cast<void*>(heap.allocate(40, strategy::min_alignment, tag_b())));
+    char*   pu1 = static_cast<char*>(static_cast<void*>(heap.allocate(48)));
+    char*   pa2 = static_cast<char*>(static_cast<void*>(heap.allocate(48, strategy::min_alignment, tag_a())));
+    char*   pb2 = static_cast<char*>(static_cast<void*>(heap.allocate(40, strategy::min_alignment, tag_b())));
+    char*   pu2 = static_cast<char*>(static_cast<void*>(heap.allocate(48)));
+
+    CHECK(pa2 - pa1 == 48);
+    CHECK(pb2 - pb1 == 48);
+    CHECK(pu2 - pu1 == 48);
+
+    //- A freed block is reused only by its own type.
+    //
+    heap.deallocate(typename strategy::void_pointer(pa1), 48, strategy::min_alignment, tag_a());
+
+    void*   pb3 = heap.allocate(40, strategy::min_alignment, tag_b());
+    void*   pa3 = heap.allocate(48, strategy::min_alignment, tag_a());
+
+    CHECK(pb3 != pa1);
+    CHECK(pa3 == pa1);
+
+    //- rhx_allocator<T> makes its requests with a tag for T, and returns blocks the same way.
+    //
+    rhx_allocator<slab_pool_node_a, strategy>   alloc;
+
+    auto    pa4 = alloc.allocate(1);
+
+    CHECK(static_cast<char*>(static_cast<void*>(pa4)) - pa2 == 48);
+
+    alloc.deallocate(pa4, 1);
+    CHECK(static_cast<void*>(heap.allocate(48, strategy::min_alignment, tag_a())) == static_cast<void*>(pa4));
+}
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      do_slab_reloc_tests<AS>
+//
+//  Summary:
+//      This function template verifies that the free lists remain usable after the buffers
+//      have been swapped.
+//--------------------------------------------------------------------------------------------------
+//
+template<typename AllocStrategy>
+void
+do_slab_reloc_tests()
+{
+    using strategy = AllocStrategy;
+
+    strategy    heap;
+    void*       p1 = heap.allocate(48);
+    void*       p2 = heap.allocate(48);
+
+    heap.deallocate(typename strategy::void_pointer(p2), 48);
+    heap.deallocate(typename strategy::void_pointer(p1), 48);
+    strategy::swap_buffers();
+
+    char*   pa    = static_cast<char*>(static_cast<void*>(heap.allocate(48)));
+    char*   pb    = static_cast<char*>(static_cast<void*>(heap.allocate(48)));
+    char*   pbase = strategy::storage_model::segment_address(strategy::storage_model::first_segment_index());
+
+    CHECK(pbase <= pa  &&  pa < pbase + strategy::storage_model::max_segment_size());
+    CHECK(pb - pa == 48);
+}
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      do_slab_container_tests<AS>
+//
+//  Summary:
+//      This function template churns node-based containers that use the slab strategy, and
+//      verifies their contents against their natural counterparts.
+//--------------------------------------------------------------------------------------------------
+//
+template<typename AllocStrategy>
+void
+do_slab_container_tests(size_t nelem)
+{
+    //- Various type aliases to aid readability.
+    //
+    using strategy     = AllocStrategy;
+    using nat_map_type = map<uint64_t, test_struct>;
+    using syn_map_type = map<uint64_t, test_struct, less<uint64_t>,
+                             rhx_allocator<pair<uint64_t const, test_struct>, strategy>>;
+    using nat_lst_type = list<test_struct>;
+    using syn_lst_type = list<test_struct, rhx_allocator<test_struct, strategy>>;
+
+    vector<uint64_t>    keys(generate_test_data<uint64_t>(nelem));
+    nat_map_type        nat_map;
+    nat_lst_type        nat_lst;
+    auto                p_syn_map = allocate<syn_map_type, strategy>();
+    auto                p_syn_lst = allocate<syn_lst_type, strategy>();
+
+    for (int round = 0;  round < 4;  ++round)
+    {
+        for (size_t i = 0;  i < nelem;  ++i)
+        {
+            test_struct     ts = generate_test_struct();
+
+            nat_map.emplace(keys[i], ts);
+            p_syn_map->emplace(keys[i], ts);
+            nat_lst.push_back(ts);
+            p_syn_lst->push_back(ts);
+        }
+
+        CHECK(contents_match(nat_map, *p_syn_map));
+        CHECK(contents_match(nat_lst, *p_syn_lst));
+
+        for (size_t i = round % 2;  i < nelem;  i += 2)
+        {
+            nat_map.erase(keys[i]);
+            p_syn_map->erase(keys[i]);
+            nat_lst.pop_front();
+            p_syn_lst->pop_front();
+        }
+
+        CHECK(contents_match(nat_map, *p_syn_map));
+        CHECK(contents_match(nat_lst, *p_syn_lst));
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      run_slab_tests<AS>
+//
+//  Summary:
+//      This function template manages the sequence of actual slab strategy test function calls.
+//--------------------------------------------------------------------------------------------------
+//
+template<typename AllocStrategy>
+void
+run_slab_tests(char const* stype)
+{
+    cout << "================================================================" << endl;
+    cout << "Running slab strategy tests for " << stype << endl << endl;
+
+    AllocStrategy::reset_buffers();
+    do_slab_block_tests<AllocStrategy>();
+
+    AllocStrategy::reset_buffers();
+    do_slab_pool_tests<AllocStrategy>();
+
+    AllocStrategy::reset_buffers();
+    do_slab_container_tests<AllocStrategy>(1000);
+
+    AllocStrategy::reset_buffers();
+}
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      run_slab_reloc_tests<AS>
+//
+//  Summary:
+//      This function template manages the sequence of slab strategy relocation test calls.
+//--------------------------------------------------------------------------------------------------
+//
+template<typename AllocStrategy>
+void
+run_slab_reloc_tests(char const* stype)
+{
+    cout << "================================================================" << endl;
+    cout << "Running slab strategy relocation tests for " << stype << endl << endl;
+
+    AllocStrategy::reset_buffers();
+    do_slab_reloc_tests<AllocStrategy>();
+
+    AllocStrategy::reset_buffers();
+}
+
+//- Containers used by the node churn timings.
+//
+template<typename AS>
+using churn_list = list<uint64_t, rhx_allocator<uint64_t, AS>>;
+
+template<typename AS>
+using churn_fwdlist = forward_list<uint64_t, rhx_allocator<uint64_t, AS>>;
+
+template<typename AS>
+using churn_map = map<uint64_t, uint64_t, less<uint64_t>, rhx_allocator<pair<uint64_t const, uint64_t>, AS>>;
+
+template<typename AS>
+using churn_umap = unordered_map<uint64_t, uint64_t, hash<uint64_t>, equal_to<uint64_t>,
+                                 rhx_allocator<pair<uint64_t const, uint64_t>, AS>>;
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      node_churn<C>
+//
+//  Summary:
+//      These function templates implement a node-heavy workload for each of the node-based
+//      containers: fill the container, then repeatedly erase every other element and insert
+//      replacements.
+//--------------------------------------------------------------------------------------------------
+//
+template<typename T, typename A>
+void
+node_churn(list<T, A>& c, vector<uint64_t> const& keys, size_t nrounds)
+{
+    for (auto k : keys) c.push_back(k);
+
+    for (size_t r = 0;  r < nrounds;  ++r)
+    {
+        for (auto it = c.begin();  it != c.end();  )
+        {
+            it = c.erase(it);
+            if (it != c.end()) ++it;
+        }
+        for (size_t i = r % 2;  i < keys.size();  i += 2) c.push_back(keys[i]);
+    }
+}
+
+template<typename T, typename A>
+void
+node_churn(forward_list<T, A>& c, vector<uint64_t> const& keys, size_t nrounds)
+{
+    for (auto k : keys) c.push_front(k);
+
+    for (size_t r = 0;  r < nrounds;  ++r)
+    {
+        for (auto it = c.begin();  it != c.end()  &&  next(it) != c.end();  )
+        {
+            it = c.erase_after(it);
+        }
+        for (size_t i = r % 2;  i < keys.size();  i += 2) c.push_front(keys[i]);
+    }
+}
+
+template<typename K, typename V, typename C, typename A>
+void
+node_churn(map<K, V, C, A>& c, vector<uint64_t> const& keys, size_t nrounds)
+{
+    for (auto k : keys) c.emplace(k, k);
+
+    for (size_t r = 0;  r < nrounds;  ++r)
+    {
+        for (size_t i = r % 2;  i < keys.size();  i += 2) c.erase(keys[i]);
+        for (size_t i = r % 2;  i < keys.size();  i += 2) c.emplace(keys[i], keys[i]);
+    }
+}
+
+template<typename K, typename V, typename H, typename E, typename A>
+void
+node_churn(unordered_map<K, V, H, E, A>& c, vector<uint64_t> const& keys, size_t nrounds)
+{
+    for (auto k : keys) c.emplace(k, k);
+
+    for (size_t r = 0;  r < nrounds;  ++r)
+    {
+        for (size_t i = r % 2;  i < keys.size();  i += 2) c.erase(keys[i]);
+        for (size_t i = r % 2;  i < keys.size();  i += 2) c.emplace(keys[i], keys[i]);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      do_node_churn_test<C,AS>
+//
+//  Summary:
+//      This function template measures the time taken by the node churn workload for a given
+//      container type, keeping the fastest of several runs.  It also measures the number of
+//      bytes consumed from the segments by the workload.
+//--------------------------------------------------------------------------------------------------
+//
+struct churn_result
+{
+    int64_t     m_elapsed;
+    size_t      m_footprint;
+};
+
+template<typename Container, typename AllocStrategy>
+churn_result
+do_node_churn_test(vector<uint64_t> const& keys, size_t nrounds, size_t nreps)
+{
+    using storage_model = typename AllocStrategy::storage_model;
+    using bump_strategy = leaky_allocation_strategy<storage_model>;
+
+    stopwatch       sw;
+    churn_result    result{numeric_limits<int64_t>::max(), 0};
+
+    for (size_t i = 0;  i < nreps;  ++i)
+    {
+        AllocStrategy::reset_buffers();
+
+        auto    start = bump_strategy::mark();
+        {
+            Container   c;
+
+            sw.start();
+            node_churn(c, keys, nrounds);
+            sw.stop();
+        }
+        auto    stop = bump_strategy::mark();
+
+        result.m_elapsed   = min(result.m_elapsed, sw.elapsed_nsec());
+        result.m_footprint = (stop.m_segment - start.m_segment) * storage_model::max_segment_size()
+                           + stop.m_offset - start.m_offset;
+    }
+
+    AllocStrategy::reset_buffers();
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      report_node_churn_test
+//
+//  Summary:
+//      This function reports the leaky and slab timings for one container and element count,
+//      along with the slab-to-leaky time ratio and the footprints in KB.
+//--------------------------------------------------------------------------------------------------
+//
+inline void
+report_node_churn_test(char const* ctype, char const* smodel, churn_result const& leaky,
+                       churn_result const& slab, size_t nelem)
+{
+    std::ios    old_state(nullptr);
+    old_state.copyfmt(std::cout);
+
+    double  ratio = (double) slab.m_elapsed / (double) leaky.m_elapsed;
+
+    cout << "churn, " << ctype << ", " << smodel << ", " << leaky.m_elapsed << ", "
+         << slab.m_elapsed << ", " << showpoint << setw(7) << setprecision((ratio >= 1.0) ? 5 : 4)
+         << ratio << ", ";
+    cout.copyfmt(old_state);
+    cout << leaky.m_footprint/1024 << ", " << slab.m_footprint/1024 << ", " << nelem << endl;
+}
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      run_node_churn_tests<SM>
+//
+//  Summary:
+//      This function template times the node churn workload for each of the node-based
+//      containers, using the leaky and slab strategies over the same storage model.
+//--------------------------------------------------------------------------------------------------
+//
+template<typename SM>
+void
+run_node_churn_tests(char const* smodel)
+{
+    using leaky = leaky_allocation_strategy<SM>;
+    using slab  = slab_allocation_strategy<SM>;
+
+    size_t const    counts[] = { 1000u, 10000u, 100000u };
+    size_t const    nrounds  = 8;
+    size_t const    nreps    = 3;
+
+    for (size_t nelem : counts)
+    {
+        vector<uint64_t>    keys(generate_test_data<uint64_t>(nelem));
+        churn_result        res_leaky, res_slab;
+
+        res_leaky = do_node_churn_test<churn_list<leaky>, leaky>(keys, nrounds, nreps);
+        res_slab  = do_node_churn_test<churn_list<slab>, slab>(keys, nrounds, nreps);
+        report_node_churn_test("list", smodel, res_leaky, res_slab, nelem);
+
+        res_leaky = do_node_churn_test<churn_fwdlist<leaky>, leaky>(keys, nrounds, nreps);
+        res_slab  = do_node_churn_test<churn_fwdlist<slab>, slab>(keys, nrounds, nreps);
+        report_node_churn_test("forward_list", smodel, res_leaky, res_slab, nelem);
+
+        res_leaky = do_node_churn_test<churn_map<leaky>, leaky>(keys, nrounds, nreps);
+        res_slab  = do_node_churn_test<churn_map<slab>, slab>(keys, nrounds, nreps);
+        report_node_churn_test("map", smodel, res_leaky, res_slab, nelem);
+
+        res_leaky = do_node_churn_test<churn_umap<leaky>, leaky>(keys, nrounds, nreps);
+        res_slab  = do_node_churn_test<churn_umap<slab>, slab>(keys, nrounds, nreps);
+        report_node_churn_test("unordered_map", smodel, res_leaky, res_slab, nelem);
+    }
+    cout << endl;
+}
+
+#endif  //- STRATEGY_SLAB_TESTS_H_DEFINED
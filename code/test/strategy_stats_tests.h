@@ -0,0 +1,125 @@
+//==================================================================================================
+//  File:
+//      strategy_stats_tests.h
+//
+//  Copyright (c) 2017 Bob Steagall, KEWB Computing
+//==================================================================================================
+//
+#ifndef STRATEGY_STATS_TESTS_H_DEFINED
+#define STRATEGY_STATS_TESTS_H_DEFINED
+
+#include "strategy_tests.h"
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      do_allocation_stats_tests<SM>
+//
+//  Summary:
+//      This function template verifies the statistics kept by the leaky and slab strategies for
+//      a storage model: rounding and alignment waste, bytes in use through rollbacks, expansion,
+//      and segment rollover, the high-water mark, and the size class and histogram counts.
+//      When statistics are not compiled in, it verifies that nothing is recorded.
+//--------------------------------------------------------------------------------------------------
+//
+template<typename SM>
+void
+do_allocation_stats_tests()
+{
+    using leaky = leaky_allocation_strategy<SM>;
+    using slab  = slab_allocation_strategy<SM>;
+
+    leaky   heap;
+    slab    slab_heap;
+
+    leaky::reset_buffers();
+    slab::reset_buffers();
+    leaky::stats().clear();
+    slab::stats().clear();
+
+    allocation_stats const&     ls = leaky::stats();
+    allocation_stats const&     ss = slab::stats();
+
+    //- Rounding, alignment, and rolling back.
+    //
+    heap.allocate(10);
+    heap.allocate(100, 64);
+
+    auto    m = leaky::mark();
+    heap.allocate(1000);
+    leaky::rollback(m);
+
+    //- Expanding the most recent chunk.
+    //
+    auto    p = heap.allocate(32);
+    CHECK(heap.try_expand(p, 32, 64));
+
+    //- Rolling over to the next segment.
+    //
+    heap.allocate(SM::max_segment_size() - 1000);
+    heap.allocate(1000);
+
+    //- Small blocks from the slab strategy.
+    //
+    auto    q = slab_heap.allocate(24);
+    slab_heap.deallocate(q, 24);
+
+#ifdef RHX_ALLOCATION_STATS
+    using size_type = typename SM::size_type;
+
+    auto        pos      = leaky::mark();
+    size_type   position = (pos.m_segment - SM::first_segment_index()) * SM::max_segment_size() + pos.m_offset;
+
+    CHECK(ls.m_allocations == 7u);
+    CHECK(ls.m_expansions == 1u);
+    CHECK(ls.m_rollovers == 1u);
+    CHECK(ls.m_bytes_rounding == 6u + 12u + 8u + 8u + 8u);
+    CHECK(ls.m_bytes_padding == 48u);
+    CHECK(ls.m_bytes_in_use + 64 == position);
+    CHECK(ls.m_high_water == ls.m_bytes_in_use);
+    CHECK(ls.m_class_allocs[0] == 1u);
+    CHECK(ls.m_histogram[allocation_stats::histogram_bin(10)] == 1u);
+    CHECK(allocation_stats::histogram_bin(10) == 3u);
+    CHECK(ls.fill_level(SM::first_segment_index()) > 0.99);
+    CHECK(ls.fill_level(SM::first_segment_index() + 1) > 0.0);
+
+    CHECK(ss.m_allocations == 1u  &&  ss.m_deallocations == 1u);
+    CHECK(ss.m_class_allocs[1] == 1u  &&  ss.m_class_frees[1] == 1u);
+    CHECK(ss.m_bytes_in_use == 0u  &&  ss.m_high_water == 32u);
+
+    if (verbose_output())
+    {
+        ls.print(stdout);
+        ss.print(stdout);
+    }
+
+    leaky::reset_buffers();
+    CHECK(ls.m_bytes_in_use == 0u);
+#else
+    CHECK(ls.empty());
+    CHECK(ss.empty());
+
+    leaky::reset_buffers();
+#endif
+
+    slab::reset_buffers();
+}
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      run_allocation_stats_tests<SM>
+//
+//  Summary:
+//      This function template manages the sequence of actual allocation statistics test calls.
+//--------------------------------------------------------------------------------------------------
+//
+template<typename SM>
+void
+run_allocation_stats_tests(char const* smodel)
+{
+    cout << "================================================================" << endl;
+    cout << "Running allocation statistics tests for " << smodel << endl << endl;
+
+    do_allocation_stats_tests<SM>();
+}
+
+#endif  //- STRATEGY_STATS_TESTS_H_DEFINED
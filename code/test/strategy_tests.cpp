@@ -0,0 +1,125 @@
+//==================================================================================================
+//  File:
+//      strategy_tests.cpp
+//
+//  Copyright (c) 2017 Bob Steagall, KEWB Computing
+//==================================================================================================
+//
+#include "strategy_tests.h"
+#include "strategy_align_tests.h"
+#include "strategy_arena_tests.h"
+#include "strategy_check_tests.h"
+#include "strategy_compact_tests.h"
+#include "strategy_numa_tests.h"
+#include "strategy_segment_tests.h"
+#include "strategy_slab_tests.h"
+#include "strategy_stats_tests.h"
+#include "strategy_trace_tests.h"
+#include "strategy_verify_tests.h"
+#include "storage_page_tests.h"
+#include "storage_policy_tests.h"
+
+int     counted_object::sm_live = 0;
+
+#define RUN_ALIGNMENT_TESTS(ST)         run_alignment_tests<ST>(#ST)
+#define RUN_ALLOCATION_STATS_TESTS(SM)  run_allocation_stats_tests<SM>(#SM)
+#define RUN_ALLOCATION_TRACE_TESTS(ST)  run_allocation_trace_tests<ST>(#ST)
+#define RUN_ARENA_SCOPE_TESTS(ST)       run_arena_scope_tests<ST>(#ST)
+#define RUN_CHECKED_ADDRESSING_TESTS(ST, BASED) run_checked_addressing_tests<ST>(#ST, BASED)
+#define RUN_COMPACTION_TESTS(ST)        run_compaction_tests<ST>(#ST)
+#define RUN_HEAP_VERIFY_TESTS(ST)       run_heap_verify_tests<ST>(#ST)
+#define RUN_SLAB_TESTS(ST)              run_slab_tests<ST>(#ST)
+#define RUN_SLAB_RELOC_TESTS(ST)        run_slab_reloc_tests<ST>(#ST)
+#define RUN_NODE_CHURN_TESTS(SM)        run_node_churn_tests<SM>(#SM)
+#define RUN_NUMA_PLACEMENT_TESTS(ST)    run_numa_placement_tests<ST>(#ST)
+#define RUN_NUMA_WALK_TESTS(SM)         run_numa_walk_tests<SM>(#SM)
+#define RUN_PAGE_MODE_TESTS(ST)         run_page_mode_tests<ST>(#ST)
+#define RUN_POLICY_STORAGE_TESTS(ST1, ST2)  run_policy_storage_tests<ST1, ST2>(#ST1, #ST2)
+#define RUN_SEGMENT_GROWTH_TESTS(ST, X)  run_segment_growth_tests<ST>(#ST, X)
+
+void
+run_strategy_tests()
+{
+    RUN_ARENA_SCOPE_TESTS(wrapper_strategy);
+    RUN_ARENA_SCOPE_TESTS(based_2d_strategy);
+    RUN_ARENA_SCOPE_TESTS(based_2dxl_strategy);
+    RUN_ARENA_SCOPE_TESTS(offset_strategy);
+
+    RUN_SLAB_TESTS(wrapper_slab_strategy);
+    RUN_SLAB_TESTS(based_2d_slab_strategy);
+    RUN_SLAB_TESTS(based_2dxl_slab_strategy);
+    RUN_SLAB_TESTS(based_1d_slab_strategy);
+    RUN_SLAB_TESTS(offset_slab_strategy);
+
+    RUN_SLAB_RELOC_TESTS(based_2d_slab_strategy);
+    RUN_SLAB_RELOC_TESTS(based_2dxl_slab_strategy);
+    RUN_SLAB_RELOC_TESTS(based_1d_slab_strategy);
+    RUN_SLAB_RELOC_TESTS(offset_slab_strategy);
+
+    RUN_COMPACTION_TESTS(wrapper_slab_strategy);
+    RUN_COMPACTION_TESTS(based_2d_slab_strategy);
+    RUN_COMPACTION_TESTS(based_2dxl_slab_strategy);
+    RUN_COMPACTION_TESTS(based_1d_slab_strategy);
+    RUN_COMPACTION_TESTS(offset_slab_strategy);
+
+    RUN_HEAP_VERIFY_TESTS(based_2d_strategy);
+    RUN_HEAP_VERIFY_TESTS(based_2dxl_strategy);
+    RUN_HEAP_VERIFY_TESTS(based_1d_strategy);
+    RUN_HEAP_VERIFY_TESTS(offset_strategy);
+    RUN_HEAP_VERIFY_TESTS(based_2d_slab_strategy);
+    RUN_HEAP_VERIFY_TESTS(offset_slab_strategy);
+
+    RUN_CHECKED_ADDRESSING_TESTS(wrapper_strategy, false);
+    RUN_CHECKED_ADDRESSING_TESTS(based_2d_strategy, true);
+    RUN_CHECKED_ADDRESSING_TESTS(based_2dxl_strategy, true);
+    RUN_CHECKED_ADDRESSING_TESTS(based_1d_strategy, true);
+    RUN_CHECKED_ADDRESSING_TESTS(offset_strategy, false);
+
+    RUN_ALIGNMENT_TESTS(wrapper_strategy);
+    RUN_ALIGNMENT_TESTS(based_2d_strategy);
+    RUN_ALIGNMENT_TESTS(based_2dxl_strategy);
+    RUN_ALIGNMENT_TESTS(based_1d_strategy);
+    RUN_ALIGNMENT_TESTS(offset_strategy);
+    RUN_ALIGNMENT_TESTS(based_2d_slab_strategy);
+    RUN_ALIGNMENT_TESTS(offset_slab_strategy);
+
+    RUN_ALLOCATION_STATS_TESTS(based_2d_storage_model);
+    RUN_ALLOCATION_STATS_TESTS(offset_storage_model);
+
+    RUN_ALLOCATION_TRACE_TESTS(based_2d_strategy);
+    RUN_ALLOCATION_TRACE_TESTS(offset_slab_strategy);
+
+    RUN_PAGE_MODE_TESTS(based_2d_strategy);
+    RUN_PAGE_MODE_TESTS(offset_strategy);
+
+    RUN_POLICY_STORAGE_TESTS(heap_2d_policy_strategy, mmap_2d_policy_slab_strategy);
+    RUN_POLICY_STORAGE_TESTS(shm_2dxl_policy_strategy, file_1d_policy_strategy);
+    RUN_POLICY_STORAGE_TESTS(mmap_offset_policy_strategy, mmap_offset2_policy_strategy);
+
+    RUN_SEGMENT_GROWTH_TESTS(wrapper_strategy, false);
+    RUN_SEGMENT_GROWTH_TESTS(based_2d_strategy, false);
+    RUN_SEGMENT_GROWTH_TESTS(based_2dxl_strategy, false);
+    RUN_SEGMENT_GROWTH_TESTS(based_1d_strategy, false);
+    RUN_SEGMENT_GROWTH_TESTS(offset_strategy, true);
+
+    RUN_NUMA_PLACEMENT_TESTS(wrapper_numa_strategy);
+    RUN_NUMA_PLACEMENT_TESTS(based_2d_numa_strategy);
+    RUN_NUMA_PLACEMENT_TESTS(based_2dxl_numa_strategy);
+    RUN_NUMA_PLACEMENT_TESTS(offset_numa_strategy);
+
+    printf("\n\n\n");
+}
+
+void
+run_strategy_timing_tests()
+{
+    RUN_NODE_CHURN_TESTS(wrapper_storage_model);
+    RUN_NODE_CHURN_TESTS(based_2dxl_storage_model);
+    RUN_NODE_CHURN_TESTS(based_2d_storage_model);
+    RUN_NODE_CHURN_TESTS(based_1d_storage_model);
+    RUN_NODE_CHURN_TESTS(offset_storage_model);
+
+    RUN_NUMA_WALK_TESTS(wrapper_storage_model);
+    RUN_NUMA_WALK_TESTS(based_2d_storage_model);
+    RUN_NUMA_WALK_TESTS(offset_storage_model);
+}
@@ -0,0 +1,50 @@
+//==================================================================================================
+//  File:
+//      strategy_tests.h
+//
+//  Copyright (c) 2017 Bob Steagall, KEWB Computing
+//==================================================================================================
+//
+#ifndef STRATEGY_TESTS_H_DEFINED
+#define STRATEGY_TESTS_H_DEFINED
+
+#include "container_tests.h"
+
+//- A simple type that counts its live instances, used to verify that objects are destroyed when
+//  expected.
+//
+struct counted_object
+{
+    static  int     sm_live;
+
+    test_struct     m_data;
+
+    counted_object()                        { ++sm_live; }
+    counted_object(counted_object const& o) : m_data(o.m_data) { ++sm_live; }
+    ~counted_object()                       { --sm_live; }
+};
+
+//- Re-creates the segments, picking up any change in the page mode or the simulated node count.
+//  Since every strategy allocates from the same segments, all of the strategies' cursors must
+//  be reset afterward.
+//
+inline void
+rebuild_segments()
+{
+    storage_model_base::clear_segments();
+    storage_model_base::init_segments();
+
+    wrapper_strategy::reset_buffers();
+    based_2d_strategy::reset_buffers();
+    based_2dxl_strategy::reset_buffers();
+    based_1d_strategy::reset_buffers();
+    offset_strategy::reset_buffers();
+
+    wrapper_numa_strategy::reset_buffers();
+    based_2d_numa_strategy::reset_buffers();
+    based_2dxl_numa_strategy::reset_buffers();
+    based_1d_numa_strategy::reset_buffers();
+    offset_numa_strategy::reset_buffers();
+}
+
+#endif  //- STRATEGY_TESTS_H_DEFINED
@@ -0,0 +1,156 @@
+//==================================================================================================
+//  File:
+//      strategy_trace_tests.h
+//
+//  Copyright (c) 2017 Bob Steagall, KEWB Computing
+//==================================================================================================
+//
+#ifndef STRATEGY_TRACE_TESTS_H_DEFINED
+#define STRATEGY_TRACE_TESTS_H_DEFINED
+
+#include <cstdio>
+#include "segmented_vector.h"
+#include "strategy_tests.h"
+#include "trace_replay.h"
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      do_allocation_trace_tests<AS>
+//
+//  Summary:
+//      This function template writes a small trace, reads it back, and replays it against a
+//      strategy.  When tracing is compiled in, it also verifies that a container's allocations
+//      through rhx_allocator are recorded with their call site, or with the container's default
+//      site when no site has been entered.
+//--------------------------------------------------------------------------------------------------
+//
+template<typename AllocStrategy>
+void
+do_allocation_trace_tests()
+{
+    using syn_data_vector = vector<uint64_t, rhx_allocator<uint64_t, AllocStrategy>>;
+
+    char const* const   fname = "alloc-test.trace";
+    trace_file          tf;
+    uint16_t            type  = trace_type_id<uint64_t>();
+    uint16_t            site  = allocation_trace::register_site("trace test");
+
+    //- Two chunks, one expanded and one released, plus a release of a chunk the trace never
+    //  saw allocated.
+    //
+    CHECK(allocation_trace::start(fname));
+    {
+        trace_site_scope    scope(site);
+
+        allocation_trace::record(trace_record::allocate_op,   (void*) 0x1000, 100, type);
+        allocation_trace::record(trace_record::allocate_op,   (void*) 0x2000, 200, type);
+        allocation_trace::record(trace_record::expand_op,     (void*) 0x2000, 400, type);
+        allocation_trace::record(trace_record::deallocate_op, (void*) 0x1000, 100, type);
+        allocation_trace::record(trace_record::deallocate_op, (void*) 0x3000, 100, type);
+    }
+    CHECK(allocation_trace::current_site() == 0);
+    allocation_trace::stop();
+
+    CHECK(tf.read(fname));
+    CHECK(tf.m_records.size() == 5u);
+    CHECK(tf.m_records[2].op() == trace_record::expand_op);
+    CHECK(tf.m_records[2].m_size == 400u);
+    CHECK(tf.m_records[0].site() == site);
+    CHECK(tf.m_sites[site] == "trace test");
+    CHECK(tf.m_types[type].m_size == sizeof(uint64_t));
+
+    //- The unmatched release is dropped, and the chunk slots are reused.
+    //
+    replay_program  prog = prepare_replay(tf);
+
+    CHECK(prog.m_ops.size() == 4u);
+    CHECK(prog.m_dropped == 1u);
+    CHECK(prog.m_slots == 2u);
+    CHECK(prog.m_peak_live == 500u);
+
+    replay_result   res = replay_trace<AllocStrategy>(prog);
+
+    CHECK(!res.m_failed);
+    CHECK(res.m_footprint >= prog.m_peak_live);
+
+    //- A name keeps its id when registered again, and a default site is entered only when no
+    //  other site is current.
+    //
+    uint16_t    dflt = allocation_trace::register_site("trace test default");
+
+    CHECK(allocation_trace::register_site("trace test") == site);
+    {
+        trace_site_scope    dflt_scope(dflt, true);
+        CHECK(allocation_trace::current_site() == dflt);
+    }
+    {
+        trace_site_scope    scope(site);
+        {
+            trace_site_scope    dflt_scope(dflt, true);
+            CHECK(allocation_trace::current_site() == site);
+        }
+    }
+    CHECK(allocation_trace::current_site() == 0);
+
+#ifdef RHX_ALLOCATION_TRACE
+    CHECK(allocation_trace::start(fname));
+    {
+        RHX_TRACE_SITE("trace test vector");
+        syn_data_vector     v;
+
+        for (uint64_t i = 0;  i < 100;  ++i)
+        {
+            v.push_back(i);
+        }
+    }
+    allocation_trace::stop();
+
+    CHECK(tf.read(fname));
+    CHECK(!tf.m_records.empty());
+    CHECK(tf.m_records.front().op() == trace_record::allocate_op);
+    CHECK(tf.m_records.back().op() == trace_record::deallocate_op);
+    CHECK(tf.m_sites[tf.m_records.front().site()] == "trace test vector");
+    CHECK(prepare_replay(tf).m_dropped == 0u);
+
+    CHECK(allocation_trace::start(fname));
+    {
+        segmented_vector<uint64_t, AllocStrategy>   sv;
+
+        for (uint64_t i = 0;  i < 100;  ++i)
+        {
+            sv.push_back(i);
+        }
+    }
+    allocation_trace::stop();
+
+    CHECK(tf.read(fname));
+    CHECK(!tf.m_records.empty());
+    CHECK(tf.m_sites[tf.m_records.front().site()] == "segmented_vector chunk");
+#else
+    syn_data_vector     v(100u);
+    CHECK(!allocation_trace::active());
+#endif
+
+    remove(fname);
+    AllocStrategy::reset_buffers();
+}
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      run_allocation_trace_tests<AS>
+//
+//  Summary:
+//      This function template manages the sequence of actual allocation trace test calls.
+//--------------------------------------------------------------------------------------------------
+//
+template<typename AllocStrategy>
+void
+run_allocation_trace_tests(char const* stype)
+{
+    cout << "================================================================" << endl;
+    cout << "Running allocation trace tests for " << stype << endl << endl;
+
+    do_allocation_trace_tests<AllocStrategy>();
+}
+
+#endif  //- STRATEGY_TRACE_TESTS_H_DEFINED
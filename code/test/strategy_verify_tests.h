@@ -0,0 +1,171 @@
+//==================================================================================================
+//  File:
+//      strategy_verify_tests.h
+//
+//  Copyright (c) 2017 Bob Steagall, KEWB Computing
+//==================================================================================================
+//
+#ifndef STRATEGY_VERIFY_TESTS_H_DEFINED
+#define STRATEGY_VERIFY_TESTS_H_DEFINED
+
+#include "strategy_compact_tests.h"
+
+//- Finds the segment and offset of an address within the segments.
+//
+inline void
+verify_locate(void const* p, size_t& segment, size_t& offset)
+{
+    segment = storage_model_base::address_segment(p);
+    offset  = (segment == 0) ? 0 : (static_cast<char const*>(p) - storage_model_base::segment_address(segment));
+}
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      do_heap_verify_tests<AS>
+//
+//  Summary:
+//      This function template builds a doubly-linked list in the heap, verifies that it is
+//      found clean, and then plants a native address, a wild pointer, a pointer copied as bytes,
+//      and a pointer to a freed block, verifying that each is reported at its location.
+//--------------------------------------------------------------------------------------------------
+//
+template<typename AllocStrategy>
+void
+do_heap_verify_tests(size_t nelem)
+{
+    using strategy     = AllocStrategy;
+    using sm_type      = typename strategy::storage_model;
+    using am_type      = typename strategy::addressing_model;
+    using node_type    = compact_list_node<am_type>;
+    using node_pointer = syn_ptr<node_type, am_type>;
+    using vector_type  = vector<uint64_t, rhx_allocator<uint64_t, strategy>>;
+
+    constexpr bool  is_offset = std::is_same<am_type, offset_addressing_model>::value;
+    constexpr bool  is_slab   = std::is_same<strategy, slab_allocation_strategy<sm_type>>::value;
+
+    strategy            heap;
+    vector<node_type*>  nodes;
+    node_pointer        head = nullptr;
+    vector<uint64_t>    data(generate_test_data<uint64_t>(nelem));
+    auto                p_data = allocate<vector_type, strategy>(data.begin(), data.end());
+
+    for (size_t i = 0;  i < nelem;  ++i)
+    {
+        nodes.push_back(compact_new<node_type>(heap));
+        nodes[i]->m_value = i;
+        nodes[i]->m_prev  = (i == 0) ? nullptr : nodes[i - 1];
+        (i == 0 ? head : nodes[i - 1]->m_next) = nodes[i];
+    }
+
+    heap_verifier<sm_type>  verifier;
+
+    verifier.add_root(head);
+
+    //- A clean heap.
+    //
+    heap_report     report = verifier.verify(4);
+
+    CHECK(report.ok()  &&  report.m_issues.empty());
+    CHECK(report.m_pointers_checked == 2 * nelem - 1);
+    CHECK(report.m_bytes_scanned >= nelem * sizeof(node_type) + p_data->size() * sizeof(uint64_t));
+
+    //- A native address stored in the heap is found by any number of threads.
+    //
+    size_t  seg, off;
+
+    nodes[nelem / 2]->m_value = reinterpret_cast<uintptr_t>(nodes[7]);
+    verify_locate(&nodes[nelem / 2]->m_value, seg, off);
+
+    for (unsigned threads : {1u, 3u, 0u})
+    {
+        report = verifier.scan_raw_addresses(threads);
+
+        CHECK(report.m_issue_count == 1u  &&  report.m_issues.size() == 1u);
+        CHECK(report.m_issues[0].m_kind == heap_issue::raw_address);
+        CHECK(report.m_issues[0].m_segment == seg  &&  report.m_issues[0].m_offset == off);
+        CHECK(report.m_issues[0].m_value == nodes[7]);
+    }
+    nodes[nelem / 2]->m_value = nelem / 2;
+
+    //- Only the first issues are recorded, in order of location.
+    //
+    for (node_type* p : nodes)
+    {
+        p->m_value = reinterpret_cast<uintptr_t>(p);
+    }
+
+    report = verifier.scan_raw_addresses();
+
+    CHECK(report.m_issue_count == nelem);
+    CHECK(report.m_issues.size() == std::min<size_t>(nelem, heap_verifier<sm_type>::max_issues));
+    CHECK(std::is_sorted(report.m_issues.begin(), report.m_issues.end(),
+                         [](heap_issue const& a, heap_issue const& b)
+                         { return a.m_segment < b.m_segment  ||  (a.m_segment == b.m_segment  &&  a.m_offset < b.m_offset); }));
+
+    for (size_t i = 0;  i < nelem;  ++i)
+    {
+        nodes[i]->m_value = i;
+    }
+
+    //- A pointer beyond the bump strategy's cursor is wild, and is not followed.
+    //
+    auto    mark = leaky_allocation_strategy<sm_type>::mark();
+    char*   beyond = sm_type::segment_address(mark.m_segment) + mark.m_offset + 256;
+
+    nodes[10]->m_prev = reinterpret_cast<node_type*>(beyond);
+    verify_locate(&nodes[10]->m_prev, seg, off);
+    report = verifier.check_pointers();
+
+    CHECK(report.m_issue_count == 1u);
+    CHECK(report.m_issues[0].m_kind == heap_issue::wild_pointer);
+    CHECK(report.m_issues[0].m_segment == seg  &&  report.m_issues[0].m_offset == off);
+    CHECK(report.m_issues[0].m_value == beyond);
+    nodes[10]->m_prev = nodes[9];
+
+    //- A pointer copied as bytes to the last node keeps its target only if its representation
+    //  does not depend on its location; an offset pointer then refers past the last block.
+    //
+    std::memcpy(static_cast<void*>(&nodes.back()->m_next), &nodes[0]->m_next, sizeof(node_pointer));
+    report = verifier.check_pointers();
+
+    CHECK(report.ok() == !is_offset);
+    CHECK(is_offset  ||  nodes.back()->m_next == nodes[1]);
+    nodes.back()->m_next = nullptr;
+
+    //- A pointer to a freed block is caught when the strategy reuses blocks, and the rest of the
+    //  list is then unreachable.
+    //
+    heap.deallocate(typename strategy::void_pointer(nodes[20]), sizeof(node_type));
+    report = verifier.check_pointers();
+
+    CHECK(report.m_issue_count == (is_slab ? 1u : 0u));
+    CHECK(!is_slab  ||  report.m_pointers_checked == 2 * 20);
+    CHECK(!is_slab  ||  report.m_issues[0].m_kind == heap_issue::freed_pointer);
+    CHECK(!is_slab  ||  report.m_issues[0].m_value == nodes[20]);
+
+    nodes[19]->m_next = nodes[21];
+    nodes[21]->m_prev = nodes[19];
+    CHECK(verifier.verify().ok());
+}
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      run_heap_verify_tests<AS>
+//
+//  Summary:
+//      This function template manages the sequence of actual heap verifier test function calls.
+//--------------------------------------------------------------------------------------------------
+//
+template<typename AllocStrategy>
+void
+run_heap_verify_tests(char const* stype)
+{
+    cout << "================================================================" << endl;
+    cout << "Running heap verifier tests for " << stype << endl << endl;
+
+    AllocStrategy::reset_buffers();
+    do_heap_verify_tests<AllocStrategy>(5000);
+    AllocStrategy::reset_buffers();
+}
+
+#endif  //- STRATEGY_VERIFY_TESTS_H_DEFINED
@@ -0,0 +1,225 @@
+//==================================================================================================
+//  File:
+//      trace_replay.cpp
+//
+//  Summary:
+//      Implements the allocation trace replay tool, run with "alloc -R file".
+//
+//  Copyright (c) 2017 Bob Steagall, KEWB Computing
+//==================================================================================================
+//
+#include <unordered_map>
+
+#include "trace_replay.h"
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      prepare_replay
+//
+//  Summary:
+//      Converts the records of a trace into replay steps, assigning a slot to each chunk when
+//      it is allocated and releasing the slot when the chunk is deallocated.
+//--------------------------------------------------------------------------------------------------
+//
+replay_program
+prepare_replay(trace_file const& tf)
+{
+    unordered_map<uint64_t, uint32_t>   live;
+    vector<uint32_t>                    free_slots;
+    vector<uint32_t>                    slot_sizes;
+    replay_program                      prog{{}, 0, 0, 0};
+    uint64_t                            live_bytes = 0;
+
+    prog.m_ops.reserve(tf.m_records.size());
+
+    for (trace_record const& rec : tf.m_records)
+    {
+        replay_op   op;
+
+        op.m_op    = rec.op();
+        op.m_size  = rec.m_size;
+        op.m_align = (rec.m_type < tf.m_types.size()) ? (uint16_t) tf.m_types[rec.m_type].m_align : 16;
+
+        if (op.m_op == trace_record::allocate_op)
+        {
+            if (free_slots.empty())
+            {
+                free_slots.push_back((uint32_t) slot_sizes.size());
+                slot_sizes.push_back(0);
+            }
+            op.m_slot = free_slots.back();
+            free_slots.pop_back();
+
+            live[rec.m_address]     = op.m_slot;
+            slot_sizes[op.m_slot]   = op.m_size;
+            live_bytes             += op.m_size;
+        }
+        else
+        {
+            auto    it = live.find(rec.m_address);
+
+            if (it == live.end())
+            {
+                ++prog.m_dropped;
+                continue;
+            }
+
+            op.m_slot   = it->second;
+            live_bytes -= slot_sizes[op.m_slot];
+
+            if (op.m_op == trace_record::deallocate_op)
+            {
+                free_slots.push_back(op.m_slot);
+                live.erase(it);
+            }
+            else
+            {
+                slot_sizes[op.m_slot]  = op.m_size;
+                live_bytes            += op.m_size;
+            }
+        }
+
+        prog.m_peak_live = max(prog.m_peak_live, live_bytes);
+        prog.m_ops.push_back(op);
+    }
+
+    prog.m_slots = slot_sizes.size();
+    return prog;
+}
+
+//------
+//
+void
+print_replay_result(char const* stype, replay_program const& prog, replay_result const& res,
+                    bool has_footprint)
+{
+    double const    nops = prog.m_ops.empty() ? 1.0 : (double) prog.m_ops.size();
+
+    printf("replay, %-26s, %9zu, %10.3f, %8.2f, ", stype, prog.m_ops.size(),
+           res.m_elapsed / 1.0e6, res.m_elapsed / nops);
+
+    if (res.m_failed)
+    {
+        printf("%12s, %12s, %s\n", "n/a", "n/a", "out of memory");
+    }
+    else if (!has_footprint)
+    {
+        printf("%12llu, %12s, %s\n", (unsigned long long) prog.m_peak_live, "n/a", "n/a");
+    }
+    else
+    {
+        double  frag = (res.m_footprint == 0) ? 0.0
+                     : 100.0 * (1.0 - (double) prog.m_peak_live / (double) res.m_footprint);
+
+        printf("%12llu, %12llu, %.2f%%\n", (unsigned long long) prog.m_peak_live,
+               (unsigned long long) res.m_footprint, frag);
+    }
+}
+
+//- Replays a program using the global operator new and delete, as a baseline for the times.
+//
+replay_result
+replay_trace_std(replay_program const& prog)
+{
+    vector<void*>   slots(prog.m_slots);
+    replay_result   res{0, 0, false};
+    stopwatch       sw;
+
+    sw.start();
+    for (replay_op const& op : prog.m_ops)
+    {
+        void*&  p = slots[op.m_slot];
+
+        if (op.m_op == trace_record::allocate_op)
+        {
+            p = ::operator new(op.m_size);
+        }
+        else if (op.m_op == trace_record::deallocate_op)
+        {
+            ::operator delete(p);
+        }
+        else
+        {
+            ::operator delete(p);
+            p = ::operator new(op.m_size);
+        }
+    }
+    sw.stop();
+
+    res.m_elapsed = sw.elapsed_nsec();
+    return res;
+}
+
+#define RUN_REPLAY(ST)  print_replay_result(#ST, prog, replay_trace<ST>(prog), true)
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      run_trace_replay
+//
+//  Summary:
+//      Reads a trace, summarizes it by call site, and replays it against the leaky and slab
+//      strategies for every storage model, and against operator new as a baseline.  Prints one
+//      line per strategy: the operation count, the time in milliseconds and nanoseconds per
+//      operation, the peak bytes live, the footprint, and the fragmentation.
+//--------------------------------------------------------------------------------------------------
+//
+bool
+run_trace_replay(char const* file_name)
+{
+    trace_file  tf;
+
+    if (!tf.read(file_name))
+    {
+        printf("unable to read allocation trace '%s'\n", file_name);
+        return false;
+    }
+
+    vector<uint64_t>    site_allocs(tf.m_sites.size());
+    vector<uint64_t>    site_bytes(tf.m_sites.size());
+
+    for (trace_record const& rec : tf.m_records)
+    {
+        if (rec.op() == trace_record::allocate_op  &&  rec.site() < tf.m_sites.size())
+        {
+            ++site_allocs[rec.site()];
+            site_bytes[rec.site()] += rec.m_size;
+        }
+    }
+
+    printf("trace '%s': %zu records, %zu types, %zu sites\n",
+           file_name, tf.m_records.size(), tf.m_types.size(), tf.m_sites.size());
+
+    for (size_t i = 0;  i < tf.m_sites.size();  ++i)
+    {
+        if (site_allocs[i] != 0)
+        {
+            printf("site, %-32s, %12llu allocations, %14llu bytes\n", tf.m_sites[i].c_str(),
+                   (unsigned long long) site_allocs[i], (unsigned long long) site_bytes[i]);
+        }
+    }
+
+    replay_program  prog = prepare_replay(tf);
+
+    if (prog.m_dropped != 0)
+    {
+        printf("%zu operations on chunks allocated before the trace started were dropped\n",
+               prog.m_dropped);
+    }
+    printf("\nreplay, strategy, ops, ms, ns/op, peak live, footprint, fragmentation\n");
+
+    print_replay_result("operator_new", prog, replay_trace_std(prog), false);
+
+    RUN_REPLAY(wrapper_strategy);
+    RUN_REPLAY(based_2dxl_strategy);
+    RUN_REPLAY(based_2d_strategy);
+    RUN_REPLAY(based_1d_strategy);
+    RUN_REPLAY(offset_strategy);
+
+    RUN_REPLAY(wrapper_slab_strategy);
+    RUN_REPLAY(based_2dxl_slab_strategy);
+    RUN_REPLAY(based_2d_slab_strategy);
+    RUN_REPLAY(based_1d_slab_strategy);
+    RUN_REPLAY(offset_slab_strategy);
+
+    return true;
+}
@@ -0,0 +1,135 @@
+//==================================================================================================
+//  File:
+//      trace_replay.h
+//
+//  Summary:
+//      Declares facilities for replaying allocation traces against the allocation strategies.
+//
+//  Copyright (c) 2017 Bob Steagall, KEWB Computing
+//==================================================================================================
+//
+#ifndef TRACE_REPLAY_H_DEFINED
+#define TRACE_REPLAY_H_DEFINED
+
+#include "common.h"
+#include "allocation_trace.h"
+
+//- One step of a replay.  Each chunk in the trace is given a slot, and slots are reused once
+//  their chunks are deallocated, so that a replay can find a chunk by indexing rather than
+//  by searching.  The alignment is that of the traced type.
+//
+struct replay_op
+{
+    uint32_t    m_slot;
+    uint32_t    m_size;
+    uint16_t    m_op;
+    uint16_t    m_align;
+};
+
+//- A trace prepared for replay.  Deallocations and expansions of chunks allocated before the
+//  trace started cannot be replayed, and are dropped.  The peak is the greatest number of bytes
+//  requested and not yet released at any point in the trace.
+//
+struct replay_program
+{
+    vector<replay_op>   m_ops;
+    size_t              m_slots;
+    size_t              m_dropped;
+    uint64_t            m_peak_live;
+};
+
+//- The outcome of replaying a program against one strategy.  The footprint is the number of
+//  bytes the strategy consumed from its segments, and fragmentation is the fraction of that
+//  footprint that was never needed at once; a strategy that ran out of memory has failed.
+//
+struct replay_result
+{
+    int64_t     m_elapsed;
+    uint64_t    m_footprint;
+    bool        m_failed;
+};
+
+replay_program  prepare_replay(trace_file const& tf);
+void            print_replay_result(char const* stype, replay_program const& prog,
+                                    replay_result const& res, bool has_footprint);
+
+//--------------------------------------------------------------------------------------------------
+//  Function:
+//      replay_trace<AS>
+//
+//  Summary:
+//      This function template replays a prepared trace against an allocation strategy, starting
+//      from empty buffers, and measures the time taken and the footprint.  An expansion that
+//      the strategy cannot perform in place is replayed as allocating a new chunk and releasing
+//      the old one, as rhx_allocator's reallocate() would do.  The footprint is measured from
+//      the position of the leaky strategy's cursor, which every strategy other than the NUMA
+//      strategy ultimately allocates from.
+//--------------------------------------------------------------------------------------------------
+//
+template<typename AllocStrategy>
+replay_result
+replay_trace(replay_program const& prog)
+{
+    using void_pointer  = typename AllocStrategy::void_pointer;
+    using storage_model = typename AllocStrategy::storage_model;
+    using bump_strategy = leaky_allocation_strategy<storage_model>;
+
+    AllocStrategy           heap;
+    vector<void_pointer>    slots(prog.m_slots);
+    vector<uint32_t>        sizes(prog.m_slots);
+    replay_result           res{0, 0, false};
+    stopwatch               sw;
+
+    //- Create the segments, if need be, before starting the clock.
+    //
+    storage_model::init_segments();
+    AllocStrategy::reset_buffers();
+
+    sw.start();
+    try
+    {
+        for (replay_op const& op : prog.m_ops)
+        {
+            void_pointer&   p = slots[op.m_slot];
+
+            switch (op.m_op)
+            {
+              case trace_record::allocate_op:
+                p = heap.allocate(op.m_size, op.m_align);
+                sizes[op.m_slot] = op.m_size;
+                break;
+
+              case trace_record::deallocate_op:
+                heap.deallocate(p, sizes[op.m_slot], op.m_align);
+                break;
+
+              case trace_record::expand_op:
+                if (!heap.try_expand(p, sizes[op.m_slot], op.m_size))
+                {
+                    void_pointer    q = heap.allocate(op.m_size, op.m_align);
+
+                    heap.deallocate(p, sizes[op.m_slot], op.m_align);
+                    p = q;
+                }
+                sizes[op.m_slot] = op.m_size;
+                break;
+            }
+        }
+    }
+    catch (std::bad_alloc&)
+    {
+        res.m_failed = true;
+    }
+    sw.stop();
+
+    auto    pos = bump_strategy::mark();
+
+    res.m_elapsed   = sw.elapsed_nsec();
+    res.m_footprint = (pos.m_segment - storage_model::first_segment_index()) * storage_model::max_segment_size()
+                    + pos.m_offset - 64;
+
+    AllocStrategy::reset_buffers();
+    return res;
+}
+
+#endif  //- TRACE_REPLAY_H_DEFINED